@@ -63,6 +63,9 @@ endif ()
 if (OGRE_BUILD_PLUGIN_BSP)
 	set(_plugins "${_plugins}  + BSP scene manager\n")
 endif ()
+if (OGRE_BUILD_PLUGIN_BVH)
+	set(_plugins "${_plugins}  + BVH scene manager\n")
+endif ()
 if (OGRE_BUILD_PLUGIN_CG)
 	set(_plugins "${_plugins}  + Cg program manager\n")
 endif ()
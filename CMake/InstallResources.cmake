@@ -90,6 +90,9 @@ endif ()
 if (NOT OGRE_BUILD_PLUGIN_BSP)
   set(OGRE_COMMENT_PLUGIN_BSP "#")
 endif ()
+if (NOT OGRE_BUILD_PLUGIN_BVH)
+  set(OGRE_COMMENT_PLUGIN_BVH "#")
+endif ()
 if (NOT OGRE_BUILD_PLUGIN_OCTREE)
   set(OGRE_COMMENT_PLUGIN_OCTREE "#")
 endif ()
@@ -25,7 +25,7 @@
 #
 # Additionally this script searches for the following optional
 # parts of the Ogre package:
-#  Plugin_BSPSceneManager, Plugin_CgProgramManager,
+#  Plugin_BSPSceneManager, Plugin_BVHSceneManager, Plugin_CgProgramManager,
 #  Plugin_OctreeSceneManager, Plugin_OctreeZone,
 #  Plugin_ParticleFX, Plugin_PCZSceneManager,
 #  RenderSystem_GL, RenderSystem_GL3Plus,
@@ -149,7 +149,7 @@ endif ()
 
 # redo search if any of the environmental hints changed
 set(OGRE_COMPONENTS Paging Terrain Volume Overlay MeshLodGenerator HLMS
-  Plugin_BSPSceneManager Plugin_CgProgramManager Plugin_OctreeSceneManager
+  Plugin_BSPSceneManager Plugin_BVHSceneManager Plugin_CgProgramManager Plugin_OctreeSceneManager
   Plugin_OctreeZone Plugin_PCZSceneManager Plugin_ParticleFX
   RenderSystem_Direct3D11 RenderSystem_Direct3D9 RenderSystem_GL RenderSystem_GL3Plus RenderSystem_GLES RenderSystem_GLES2)
 set(OGRE_RESET_VARS 
@@ -517,6 +517,7 @@ endmacro(ogre_find_plugin)
 ogre_find_plugin(Plugin_PCZSceneManager OgrePCZSceneManager.h PCZ PlugIns/PCZSceneManager/include)
 ogre_find_plugin(Plugin_OctreeZone OgreOctreeZone.h PCZ PlugIns/OctreeZone/include)
 ogre_find_plugin(Plugin_BSPSceneManager OgreBspSceneManager.h PlugIns/BSPSceneManager/include)
+ogre_find_plugin(Plugin_BVHSceneManager OgreBVHSceneManager.h PlugIns/BVHSceneManager/include)
 ogre_find_plugin(Plugin_CgProgramManager OgreCgProgram.h PlugIns/CgProgramManager/include)
 ogre_find_plugin(Plugin_OctreeSceneManager OgreOctreeSceneManager.h PlugIns/OctreeSceneManager/include)
 ogre_find_plugin(Plugin_ParticleFX OgreParticleFXPrerequisites.h PlugIns/ParticleFX/include)
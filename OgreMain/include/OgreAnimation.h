@@ -500,6 +500,16 @@ namespace Ogre {
         
         /// Internal method to adjust keyframes relative to a base keyframe (@see setUseBaseKeyFrame) */
         void _applyBaseKeyFrame();
+
+        /** Internal method to build the data which apply otherwise builds on
+            demand: the base keyframe adjustment, the keyframe time list and
+            the interpolation splines of the node tracks.
+        @remarks
+            Once this has been called, and until the animation is changed
+            again, the node tracks can be applied to distinct skeletons from
+            several threads at once.
+        */
+        void _prepareForApply(void);
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
@@ -0,0 +1,151 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __AnimationPoseCache_H__
+#define __AnimationPoseCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSkeleton.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Shares the bone matrices of skeletons posed identically within a frame.
+    @remarks
+        Crowds of entities often play the same animations of the same
+        skeleton, at the same time positions. Each entity would still evaluate
+        its own pose, so when a SceneManager has pose caching enabled, its
+        entities look their pose up here first. A pose is identified by the
+        master skeleton, its blend mode and, for each enabled animation state
+        in order, the animation, the time position, the weight and the
+        contents of the blend mask. The first entity to need a pose in a frame
+        evaluates it, and every other entity in the same state copies its bone
+        matrices. Entities whose states differ simply get poses of their own.
+    @par
+        The time positions may be quantised, so that entities whose animations
+        are only slightly apart share a pose too; the pose is then evaluated
+        at the quantised time positions. By default they are not, and the bone
+        matrices are those the entities would have computed themselves.
+    @par
+        Skeletons with manual bones are never shared, since their pose does
+        not depend on the animation states alone. The cache may be used from
+        several threads at once, such as by the EntityAnimationUpdater.
+    */
+    class _OgreExport AnimationPoseCache : public AnimationAlloc
+    {
+    public:
+        AnimationPoseCache();
+        ~AnimationPoseCache();
+
+        /** Sets the step the time positions are rounded to before poses are
+            compared (default 0, no rounding).
+        */
+        void setTimeQuantum(Real quantum) { mTimeQuantum = quantum; }
+        /// Gets the step the time positions are rounded to before poses are compared
+        Real getTimeQuantum(void) const { return mTimeQuantum; }
+
+        /** Gets the bone matrices of a skeleton posed by a set of animation
+            states, evaluating the pose unless it already was in this frame.
+        @remarks
+            When the pose is evaluated, it is by the skeleton's
+            SkeletonPoseEvaluator if possible, and the Bone nodes otherwise.
+        @param skeleton
+            The skeleton to pose.
+        @param animSet
+            The animation states to apply.
+        @param frameNumber
+            The current frame number, poses of earlier frames are discarded.
+        @param boneMatrices
+            The bone matrices to write, indexed by bone handle.
+        @return
+            false if the skeleton's pose can't be shared, in which case nothing
+            is written.
+        */
+        bool getBoneMatrices(SkeletonInstance* skeleton, const AnimationStateSet& animSet,
+            unsigned long frameNumber, Matrix4* boneMatrices);
+
+        /// Gets the number of poses evaluated in the current frame
+        size_t getNumPoses(void) const;
+        /// Gets the number of times a pose was shared in the current frame
+        size_t getNumHits(void) const;
+
+        /// Discards all the poses
+        void clear(void);
+
+    protected:
+        /// An enabled animation state, as far as the pose is concerned
+        struct StateKey
+        {
+            const Animation* animation;
+            Real timePos;
+            Real weight;
+            /// Orders the keys quickly, equal hashes still compare the masks
+            uint32 blendMaskHash;
+            AnimationState::BoneBlendMask blendMask;
+
+            bool operator<(const StateKey& rhs) const;
+        };
+        typedef vector<StateKey>::type StateKeyList;
+
+        /// Everything the bone matrices of a skeleton depend on
+        struct PoseKey
+        {
+            ResourceHandle skeleton;
+            SkeletonAnimationBlendMode blendMode;
+            StateKeyList states;
+
+            bool operator<(const PoseKey& rhs) const;
+        };
+        typedef vector<Matrix4>::type MatrixList;
+        typedef map<PoseKey, MatrixList>::type PoseMap;
+
+        PoseMap mPoses;
+        unsigned long mFrameNumber;
+        size_t mNumHits;
+        Real mTimeQuantum;
+        OGRE_MUTEX(mMutex);
+
+        /// Rounds a time position to the time quantum
+        Real quantise(Real timePos) const;
+        /// Evaluates a pose on the calling thread
+        void evaluate(SkeletonInstance* skeleton, const AnimationStateSet& animSet,
+            Matrix4* boneMatrices) const;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
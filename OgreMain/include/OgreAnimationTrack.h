@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreSimpleSpline.h"
 #include "OgreRotationalSpline.h"
 #include "OgrePose.h"
+#include "Threading/OgreThreadHeaders.h"
 
 namespace Ogre 
 {
@@ -352,6 +353,18 @@ namespace Ogre
         virtual void applyToNode(Node* node, const TimeIndex& timeIndex, Real weight = 1.0, 
             Real scale = 1.0f);
 
+        /** Gets the transform which applyToNode would apply to a node.
+        @remarks
+            The translation is to be added to the position of the node, the
+            rotation combined with its orientation in local space and the
+            scale multiplied with its scale.
+        @return
+            false if there is nothing to apply, in which case the transform
+            is left untouched.
+        */
+        bool _getTransformToApply(const TimeIndex& timeIndex, Real weight, Real scale,
+            Vector3& translate, Quaternion& rotate, Vector3& scaling) const;
+
         /** Sets the method of rotation calculation */
         virtual void setUseShortestRotationPath(bool useShortestPath);
 
@@ -367,8 +380,106 @@ namespace Ogre
         /// @copydoc AnimationTrack::_keyFrameDataChanged
         void _keyFrameDataChanged(void) const;
 
-        /** Returns the KeyFrame at the specified index. */
-        virtual TransformKeyFrame* getNodeKeyFrame(unsigned short index) const;
+        /** Builds the interpolation splines now if they are out of date,
+            rather than on the next spline interpolation. */
+        void _buildInterpolationSplines(void) const;
+
+        /** Returns the KeyFrame at the specified index, for reading it.
+        @remarks
+            If the track is compressed, this is a decoded copy of the keyframe,
+            which the track keeps until it is compressed or decompressed again.
+        */
+        virtual const TransformKeyFrame* getNodeKeyFrame(unsigned short index) const;
+
+        /** Returns the KeyFrame at the specified index, for changing it.
+        @remarks
+            If the track is compressed, it is decompressed first, so that the
+            keyframe returned is the track's own. Like decompress, this must not
+            be called while the track is being applied on another thread.
+        */
+        virtual TransformKeyFrame* getNodeKeyFrame(unsigned short index);
+
+        /** Compresses the keyframes of this track, to save memory.
+        @remarks
+            The TransformKeyFrame objects are replaced by a CompressedTransformTrack,
+            which takes a fraction of the memory and is quicker to sample, at
+            the cost of a small loss of precision. Individual keyframes are not
+            kept: the const accessors return decoded copies, and creating,
+            removing or getting one to change it decompresses the track again,
+            so it is best to compress tracks once they are complete.
+        @param tolerance Largest difference between the components of the
+            values of a channel for it to be stored only once, also used when
+            the track is compressed again by _applyBaseKeyFrame
+        */
+        void compress(Real tolerance = 1e-4f);
+
+        /** Replaces the compressed keyframes by TransformKeyFrame objects again.
+        @remarks
+            Call this before changing the keyframes of a compressed track. Like
+            any other change of the keyframes, it must not happen while the
+            track is being applied on another thread.
+        */
+        void decompress(void);
+
+        /** Returns whether the keyframes of this track are compressed. */
+        bool isCompressed(void) const { return mCompressed != 0; }
+
+        /** Returns the compressed keyframes, or null if the track is not compressed. */
+        const CompressedTransformTrack* getCompressedKeyFrames(void) const { return mCompressed; }
+
+        /** Replaces all the keyframes by compressed ones (internal use only).
+        @remarks
+            The track takes ownership of the compressed keyframes.
+        */
+        void _setCompressedKeyFrames(CompressedTransformTrack* keyFrames);
+
+        /// @copydoc AnimationTrack::getNumKeyFrames
+        virtual unsigned short getNumKeyFrames(void) const;
+
+        /** Returns the KeyFrame at the specified index, for reading it.
+        @remarks
+            If the track is compressed, this is a decoded copy of the keyframe,
+            which the track keeps until it is compressed or decompressed again.
+            Changing it has no effect on the track, use the non-const overload
+            to do that.
+        */
+        virtual KeyFrame* getKeyFrame(unsigned short index) const;
+
+        /** Returns the KeyFrame at the specified index, for changing it.
+        @remarks
+            As the non-const getNodeKeyFrame, this decompresses the track first.
+        */
+        KeyFrame* getKeyFrame(unsigned short index);
+
+        /** @copydoc AnimationTrack::getKeyFramesAtTime
+        @remarks
+            If the track is compressed, the keyframes are decoded copies, as
+            returned by the const getKeyFrame.
+        */
+        virtual Real getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
+            unsigned short* firstKeyIndex = 0) const;
+
+        /** @copydoc AnimationTrack::getKeyFramesAtTime
+        @remarks
+            As the non-const getNodeKeyFrame, this decompresses the track first.
+        */
+        Real getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1, KeyFrame** keyFrame2,
+            unsigned short* firstKeyIndex = 0);
+
+        /// @copydoc AnimationTrack::createKeyFrame
+        virtual KeyFrame* createKeyFrame(Real timePos);
+
+        /// @copydoc AnimationTrack::removeKeyFrame
+        virtual void removeKeyFrame(unsigned short index);
+
+        /// @copydoc AnimationTrack::removeAllKeyFrames
+        virtual void removeAllKeyFrames(void);
+
+        /// @copydoc AnimationTrack::_collectKeyFrameTimes
+        virtual void _collectKeyFrameTimes(vector<Real>::type& keyFrameTimes);
+
+        /// @copydoc AnimationTrack::_buildKeyFrameIndexMap
+        virtual void _buildKeyFrameIndexMap(const vector<Real>::type& keyFrameTimes);
 
 
         /** Method to determine if this track has any KeyFrames which are
@@ -390,6 +501,15 @@ namespace Ogre
         KeyFrame* createKeyFrameImpl(Real time);
         // Flag indicating we need to rebuild the splines next time
         virtual void buildInterpolationSplines(void) const;
+        /// Finds the compressed keyframes around a time, as getKeyFramesAtTime does
+        Real getCompressedKeyFramesAtTime(const TimeIndex& timeIndex,
+            size_t& keyIndex1, size_t& keyIndex2) const;
+        /// Interpolates the compressed keyframes
+        void getCompressedInterpolatedKeyFrame(const TimeIndex& timeIndex, TransformKeyFrame* kf) const;
+        /// Decodes the compressed keyframes into mDecodedKeyFrames, unless done already
+        void decodeKeyFrames(void) const;
+        /// Destroys the decoded copies of the compressed keyframes
+        void destroyDecodedKeyFrames(void);
 
         // Struct for store splines, allocate on demand for better memory footprint
         struct Splines
@@ -405,6 +525,13 @@ namespace Ogre
         mutable bool mSplineBuildNeeded;
         /// Defines if rotation is done using shortest path
         mutable bool mUseShortestRotationPath ;
+        /// Compressed keyframes, replacing mKeyFrames if present
+        CompressedTransformTrack* mCompressed;
+        /// Tolerance the keyframes were last compressed with
+        Real mCompressionTolerance;
+        /// Copies of the compressed keyframes, decoded on demand by const accessors
+        mutable KeyFrameList mDecodedKeyFrames;
+        OGRE_MUTEX(mDecodeMutex);
     };
 
     /** Type of vertex animation.
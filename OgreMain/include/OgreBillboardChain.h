@@ -197,6 +197,51 @@ namespace Ogre {
             for dynamic alteration.
         */
         virtual bool getDynamic(void) const { return mDynamic; }
+
+        /** Sets whether only the vertices of the elements which changed are
+            written to the vertex buffer.
+        @remarks
+            By default the whole vertex buffer is rewritten whenever an element
+            changes. With streaming enabled, adding, removing or updating elements
+            only marks the vertices of these elements and their neighbours, and
+            the chain is drawn from the buffers of a BillboardChainBatch, which
+            appends just those vertices after the ones written before, in a single
+            lock. See BillboardChainBatch for how the buffers are managed.
+        @par
+            The whole chain is still written again when the camera the chain is
+            rendered from moves, if the chain faces the camera, since all the 
+            vertices depend on its position. Streaming therefore helps most 
+            with chains which don't face the camera, or which are seen from a
+            still camera.
+        */
+        virtual void setStreamingEnabled(bool streaming);
+
+        /** Gets whether only the vertices of the elements which changed are
+            written to the vertex buffer.
+        */
+        virtual bool getStreamingEnabled(void) const { return mStreaming; }
+
+        /** Sets whether this chain shares its buffers with other chains, when
+            streaming.
+        @remarks
+            A streaming chain normally has a BillboardChainBatch of its own. With
+            sharing enabled, it is instead streamed into the batch of the other
+            such chains of the same scene manager, material, render queue group
+            and vertex format, so that the vertices changed in all of them are
+            written in a single lock and all of them are drawn in a single render
+            operation. This suits many small chains, such as a RibbonTrail per
+            character, which would otherwise each lock and draw their own buffers.
+        @par
+            Shared buffers hold vertices in world space, so all the vertices of
+            a chain are written again whenever its node moves. This has no effect
+            unless streaming is enabled.
+        */
+        virtual void setBufferSharingEnabled(bool share);
+
+        /** Gets whether this chain shares its buffers with other chains, when
+            streaming.
+        */
+        virtual bool getBufferSharingEnabled(void) const { return mShareBuffers; }
         
         /** Add an element to the 'head' of a chain.
         @remarks
@@ -265,6 +310,7 @@ namespace Ogre {
         const AxisAlignedBox& getBoundingBox(void) const;
         const MaterialPtr& getMaterial(void) const;
         const String& getMovableType(void) const;
+        void _notifyCurrentCamera(Camera* cam);
         void _updateRenderQueue(RenderQueue *);
         void getRenderOperation(RenderOperation &);
         virtual bool preRender(SceneManager* sm, RenderSystem* rsys);
@@ -277,6 +323,7 @@ namespace Ogre {
 
 
     protected:
+        friend class BillboardChainBatch;
 
         /// Maximum length of each chain
         size_t mMaxElementsPerChain;
@@ -302,6 +349,22 @@ namespace Ogre {
         bool mIndexContentDirty;
         /// Is the vertex buffer dirty?
         bool mVertexContentDirty;
+        /// Only write the vertices of changed elements?
+        bool mStreaming;
+        /// Share the streamed buffers with other chains?
+        bool mShareBuffers;
+        /// Elements whose vertices are out of date, when streaming
+        vector<bool>::type mDirtyElements;
+        /// Indices of the elements set in mDirtyElements
+        vector<size_t>::type mDirtyElementList;
+        /// Slot of the vertices of each element in the buffers of mBatch, when streaming
+        vector<uint32>::type mElementSlots;
+        /// Buffers the chain is streamed into and drawn from, when streaming
+        BillboardChainBatch* mBatch;
+        /// Generation of the buffers of mBatch which mElementSlots refer to
+        size_t mBatchGeneration;
+        /// Camera the chain is being queued for
+        Camera* mCurrentCamera;
         /// AABB
         mutable AxisAlignedBox mAABB;
         /// Bounding radius
@@ -315,6 +378,10 @@ namespace Ogre {
         Real mOtherTexCoordRange[2];
         /// Camera last used to build the vertex buffer
         Camera *mVertexCameraUsed;
+        /// Camera position in local space last used to build the vertex buffer
+        Vector3 mVertexEyePosUsed;
+        /// Transform last used to write the vertices in world space, when streaming
+        Matrix4 mVertexTransformUsed;
         /// When true, the billboards always face the camera
         bool mFaceCamera;
         /// Used when mFaceCamera == false; determines the billboard's "normal". i.e.
@@ -353,6 +420,49 @@ namespace Ogre {
         virtual void setupBuffers(void);
         /// Update the contents of the vertex buffer
         virtual void updateVertexBuffer(Camera* cam);
+        /** Writes the two vertices of an element.
+        @param seg The segment of the element
+        @param e The index of the element, relative to the start of the segment
+        @param eyePos The camera position in local space
+        @param pDest Where to write the vertices
+        */
+        void writeElementVertices(const ChainSegment& seg, size_t e,
+            const Vector3& eyePos, void* pDest);
+        /** Marks the vertices of an element as out of date.
+        @remarks
+            The direction of the vertices of an element depends on its
+            neighbours, so these are marked too. Unless streaming, this marks
+            the whole vertex buffer.
+        @param seg The segment of the element
+        @param e The index of the element, relative to the start of the segment
+        */
+        void markElementDirty(const ChainSegment& seg, size_t e);
+        /// Joins the batch the chain must be streamed into, leaving any other
+        void updateBatch(void);
+        /// Leaves the batch the chain was streamed into, if any
+        void leaveBatch(void);
+        /// Returns whether any segment has the two elements needed to draw something
+        bool hasQuads(void) const;
+        /** Works out which elements must be written to the buffers of the batch.
+        @param cam The camera the chain is rendered from
+        @param worldSpace Whether the vertices must be written in world space
+        @param generation The generation of the buffers of the batch, whose
+            change means that all the elements must be written again
+        @return The number of elements to write
+        */
+        size_t prepareStreamedVertices(Camera* cam, bool worldSpace, size_t generation);
+        /** Writes the elements found by prepareStreamedVertices to consecutive slots.
+        @param pDest Where to write the vertices of the first element
+        @param firstSlot The slot of the first element in the buffers of the batch
+        @param vertexSize The size of a vertex
+        @param worldSpace Whether the vertices must be written in world space
+        @return The number of elements written
+        */
+        size_t writeStreamedVertices(char* pDest, uint32 firstSlot, size_t vertexSize,
+            bool worldSpace);
+        /** Appends the slots of the two elements of each quad to draw.
+        */
+        void collectStreamedQuads(vector<uint32>::type& quads) const;
         /// Update the contents of the index buffer
         virtual void updateIndexBuffer(void);
         virtual void updateBoundingBox(void) const;
@@ -362,20 +472,141 @@ namespace Ogre {
     };
 
 
+    /** Buffers which streaming BillboardChain objects are written to, and
+        drawn from in a single render operation.
+    @remarks
+        A streaming chain writes the vertices of the elements which changed
+        after the vertices written before, in a part of the vertex buffer which
+        nothing has used since the buffer was last discarded, rather than over
+        the previous vertices of these elements, which a frame still being
+        drawn may be reading. Only that range is locked, with
+        HardwareBuffer::HBL_NO_OVERWRITE. Once the buffer is full it is
+        discarded, and the vertices of all the visible chains are written again
+        from the start, so the buffer works as a ring buffer. The indices, which
+        refer to the latest vertices of each element, are written in full
+        whenever these move, after the indices used before in the same way.
+    @par
+        Each streaming chain has a batch of its own, in its local space, unless
+        it shares its buffers (see BillboardChain::setBufferSharingEnabled), in
+        which case the batch holds all the sharing chains of the same scene
+        manager, material, render queue group and vertex format, in world space.
+        The batch is the renderable added to the render queue, once for all of
+        its chains found visible, and its buffers are updated when it is first
+        rendered.
+    */
+    class _OgreExport BillboardChainBatch : public Renderable, public FXAlloc
+    {
+    public:
+        /** Constructor (internal use only, chains create their batches).
+        @param chain The first chain of the batch, which sets its scene manager,
+            material, render queue group and vertex format
+        @param shared Whether other chains may be added, in which case the
+            vertices are in world space rather than in the space of the chain
+        */
+        BillboardChainBatch(BillboardChain* chain, bool shared);
+        ~BillboardChainBatch();
+
+        /// Returns whether other chains may be added
+        bool isShared(void) const { return mShared; }
+        /// Returns whether a chain can be drawn with this batch
+        bool isCompatible(const BillboardChain* chain) const;
+
+        /// Adds a chain to the batch (internal use only)
+        void _addChain(BillboardChain* chain);
+        /// Removes a chain from the batch, returns the number of chains left (internal use only)
+        size_t _removeChain(BillboardChain* chain);
+        /** Notes that one of the chains is visible (internal use only).
+        @return Whether the batch must be added to the render queue, because the
+            chain is the first one found visible from this camera
+        */
+        bool _notifyChainVisible(BillboardChain* chain, Camera* cam);
+        /** Writes the changed vertices of the visible chains, and their indices
+            (internal use only).
+        @remarks
+            This is done by preRender the first time the batch is rendered after
+            being queued.
+        */
+        void _updateBuffers(Camera* cam);
+
+        // Overridden members follow
+        const MaterialPtr& getMaterial(void) const;
+        void getRenderOperation(RenderOperation& op);
+        bool preRender(SceneManager* sm, RenderSystem* rsys);
+        void getWorldTransforms(Matrix4* xform) const;
+        Real getSquaredViewDepth(const Camera* cam) const;
+        const LightList& getLights(void) const;
+
+    protected:
+        typedef vector<BillboardChain*>::type ChainList;
+
+        /// (Re)creates the buffers, to hold twice the elements of all the chains
+        void setupBuffers(size_t numElements);
+        /// Writes the indices of the quads in mQuads
+        void writeIndices(void);
+
+        /// Whether other chains may be added
+        bool mShared;
+        /// What the chains must have in common
+        SceneManager* mManager;
+        MaterialPtr mMaterial;
+        uint8 mRenderQueueID;
+        bool mUseTexCoords;
+        bool mUseVertexColour;
+        /// All the chains of the batch
+        ChainList mChains;
+        /// Chains found visible since the batch was queued
+        ChainList mVisibleChains;
+        /// Chains whose quads the index buffer holds
+        ChainList mIndexedChains;
+        /// World bounds of mVisibleChains
+        AxisAlignedBox mVisibleBounds;
+        VertexData* mVertexData;
+        IndexData* mIndexData;
+        /// Number of elements the vertex buffer can hold
+        size_t mVertexCapacity;
+        /// First element of the vertex buffer not written since it was discarded
+        size_t mVertexCursor;
+        /// First index of the index buffer not written since it was discarded
+        size_t mIndexCursor;
+        /// Incremented whenever the vertex buffer is discarded or recreated
+        size_t mGeneration;
+        /// Whether the batch was queued and not rendered since
+        bool mQueued;
+        /// Frame and camera the batch was queued for
+        unsigned long mQueuedFrame;
+        Camera* mQueuedCamera;
+        /// Slots of the elements of each quad, for writing the indices
+        vector<uint32>::type mQuads;
+        /// Lights of a batch with no visible chain
+        LightList mNoLights;
+    };
+
     /** Factory object for creating BillboardChain instances */
     class _OgreExport BillboardChainFactory : public MovableObjectFactory
     {
     protected:
+        typedef vector<BillboardChainBatch*>::type BatchList;
+        /// Batches shared by several chains
+        BatchList mSharedBatches;
+
         MovableObject* createInstanceImpl( const String& name, const NameValuePairList* params);
     public:
         BillboardChainFactory() {}
-        ~BillboardChainFactory() {}
+        ~BillboardChainFactory();
 
         static String FACTORY_TYPE_NAME;
 
         const String& getType(void) const;
         void destroyInstance( MovableObject* obj);  
 
+        /** Returns the shared batch a chain can be drawn with, creating it if
+            needed (internal use only).
+        @remarks
+            The chains of all types share the batches of this factory.
+        */
+        BillboardChainBatch* _getSharedBatch(BillboardChain* chain);
+        /// Destroys a shared batch once its last chain has left (internal use only)
+        void _releaseSharedBatch(BillboardChainBatch* batch);
     };
 
     /** @} */
@@ -250,6 +250,19 @@ namespace Ogre {
         */
         void genVertices(const Vector3* const offsets, const Billboard& pBillboard);
 
+        /** Internal method queueing a billboard for generateBillboardVertices.
+        @remarks
+            Billboards using the offsets in mVOffset and no rotation are
+            gathered here, and their vertices generated together by
+            flushBatchedBillboards as long as they use the same texture
+            coordinates.
+        */
+        void batchBillboard(const Billboard& bb);
+
+        /** Internal method writing the vertices of the batched billboards.
+        */
+        void flushBatchedBillboards(void);
+
         /** Internal method generates vertex offsets.
         @remarks
             Takes in parametric offsets as generated from getParametericOffsets, width and height values
@@ -284,9 +297,38 @@ namespace Ogre {
 
         static RadixSort<ActiveBillboardList, Billboard*, float> mRadixSorter;
 
+        typedef vector<uint32>::type SortOrder;
+        /// Sorts the indices of the billboards by their depth keys
+        ParallelRadixSort<SortOrder> mSortOrderSorter;
+        /// The active billboards, their positions and depth keys, gathered for sorting
+        vector<Billboard*>::type mSortBillboards;
+        vector<Real>::type mSortPositions;
+        vector<Real>::type mSortKeys;
+        SortOrder mSortOrder;
+        /// Largest change of depth for which the current order is kept
+        Real mSortingReuseDistance;
+        /// Whether the active billboards are in the order of the last sort
+        bool mSortOrderValid;
+        /// Sort mode, camera position and direction, and radius of the last sort
+        SortMode mLastSortMode;
+        Vector3 mLastSortCamPos;
+        Vector3 mLastSortDir;
+        Real mLastSortRadius;
+
         /// Use point rendering?
         bool mPointRendering;
 
+        /// Can billboards using mVOffset be batched in the current update?
+        bool mBatchingBillboards;
+        /// mVOffset as floats, for generateBillboardVertices
+        float mBatchOffsets[12];
+        /// Texture coordinates of the batched billboards
+        FloatRect mBatchTexcoordRect;
+        /// Centre and colour of the batched billboards, four values each
+        vector<float>::type mBatchedBillboards;
+        /// Number of billboards in mBatchedBillboards
+        size_t mNumBatchedBillboards;
+
 
 
     private:
@@ -418,6 +460,26 @@ namespace Ogre {
         */
         virtual bool getSortingEnabled(void) const;
 
+        /** Sets how far the camera can move before the billboards are sorted again.
+        @remarks
+            When sorting is enabled, the billboards are sorted each time they are
+            updated. If the depths of the billboards from the camera have changed
+            by less than this distance since the last sort, which happens when the
+            camera moves or turns a little, the previous order is kept instead.
+            Billboards created or moved with Billboard::setPosition since the
+            last sort always cause a new one. Changes made to Billboard::mPosition
+            directly are not noticed, so use setPosition on sets reusing the order.
+        @par
+            The default is 0, which sorts the billboards on every update.
+        */
+        virtual void setSortingReuseDistance(Real distance);
+
+        /** Gets how far the camera can move before the billboards are sorted again.
+        @see
+            BillboardSet::setSortingReuseDistance
+        */
+        virtual Real getSortingReuseDistance(void) const;
+
         /** Adjusts the size of the pool of billboards available in this set.
         @remarks
             See the BillboardSet::setAutoextend method for full details of the billboard pool. This method adjusts
@@ -609,6 +671,10 @@ namespace Ogre {
         */
         virtual void _notifyBillboardRotated(void);
 
+        /** Internal callback used by Billboards to notify their parent that they have been moved.
+        */
+        virtual void _notifyBillboardMoved(void);
+
         /** Returns whether or not billboards in this are tested individually for culling. */
         virtual bool getCullIndividually(void) const;
         /** Sets whether culling tests billboards in this individually as well as in a group.
@@ -598,6 +598,9 @@ namespace Ogre {
         bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const;
         /// @copydoc Frustum::isVisible(const Vector3&, FrustumPlane*) const
         bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
+        /// @copydoc Frustum::isVisible(const Vector3*, const Vector3*, size_t, uint32*) const
+        void isVisible(const Vector3* centres, const Vector3* halfSizes, 
+            size_t count, uint32* visibilityMask) const;
         /// @copydoc Frustum::getWorldSpaceCorners
         const Vector3* getWorldSpaceCorners(void) const;
         /// @copydoc Frustum::getFrustumPlane
@@ -0,0 +1,159 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __CompressedTransformTrack_H__
+#define __CompressedTransformTrack_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreQuaternion.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre 
+{
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Compact, read only storage for the keyframes of a NodeAnimationTrack.
+    @remarks
+        Rather than one TransformKeyFrame object per keyframe, the keyframes are
+        kept in separate arrays: one of times, and one per animated channel.
+        Rotations are quantised with the 'smallest three' method: the largest
+        component of the unit quaternion is dropped, since it can be recomputed
+        from the others, and the other three are stored in 15 bits each, with
+        the index of the dropped component and the sign of the quaternion in
+        the remaining bits. Translations and scales are quantised to 16 bits per
+        component over the range the track covers. A channel which doesn't
+        change over the track is stored only once, at full precision.
+    @par
+        This takes 6 bytes per rotation and per animated translation or scale
+        instead of the 40 bytes of keyframe data, plus the object overheads. The
+        largest errors are about 2e-5 on each rotation component, and 1/131070
+        of the range on translations and scales.
+    @note
+        Use NodeAnimationTrack::compress to compress a track, rather than this
+        class directly.
+    */
+    class _OgreExport CompressedTransformTrack : public AnimationAlloc
+    {
+    public:
+        typedef vector<Real>::type TimeList;
+        /// Quantised values, 3 per keyframe
+        typedef vector<uint16>::type QuantisedList;
+
+        CompressedTransformTrack();
+
+        /** Compresses keyframes, replacing any current contents.
+        @param numKeyFrames Number of keyframes
+        @param times Times of the keyframes, in increasing order
+        @param rotations, translates, scales Transforms of the keyframes
+        @param tolerance Largest difference between the components of the
+            values of a channel for it to be taken as constant
+        */
+        void compress(size_t numKeyFrames, const Real* times, const Quaternion* rotations,
+            const Vector3* translates, const Vector3* scales, Real tolerance);
+
+        /// Gets the number of keyframes
+        size_t getNumKeyFrames(void) const { return mTimes.size(); }
+        /// Gets the times of the keyframes
+        const TimeList& getTimes(void) const { return mTimes; }
+
+        /// Whether the rotation is the same for all keyframes
+        bool isRotationConstant(void) const { return mRotations.empty(); }
+        /// Whether the translation is the same for all keyframes
+        bool isTranslateConstant(void) const { return mTranslates.empty(); }
+        /// Whether the scale is the same for all keyframes
+        bool isScaleConstant(void) const { return mScales.empty(); }
+
+        /// Gets the rotation of a keyframe
+        Quaternion getRotation(size_t index) const
+        {
+            return mRotations.empty() ? mConstantRotation : decodeRotation(&mRotations[index * 3]);
+        }
+        /// Gets the translation of a keyframe
+        Vector3 getTranslate(size_t index) const
+        {
+            return mTranslates.empty() ? mTranslateBase :
+                decodeVector(&mTranslates[index * 3], mTranslateBase, mTranslateStep);
+        }
+        /// Gets the scale of a keyframe
+        Vector3 getScale(size_t index) const
+        {
+            return mScales.empty() ? mScaleBase :
+                decodeVector(&mScales[index * 3], mScaleBase, mScaleStep);
+        }
+
+        /** Finds the first keyframe at or after a time.
+        @return The index of the keyframe, or getNumKeyFrames() if all the
+            keyframes are before the time
+        */
+        size_t findKeyFrame(Real timePos) const;
+
+        /// Gets the memory used by the keyframes, in bytes
+        size_t getMemoryUsage(void) const;
+
+        /// Quantises a unit quaternion to 3 values
+        static void encodeRotation(const Quaternion& q, uint16* dest);
+        /// Restores a unit quaternion from its quantised values
+        static Quaternion decodeRotation(const uint16* src);
+
+    protected:
+        friend class SkeletonSerializer;
+
+        static Vector3 decodeVector(const uint16* src, const Vector3& base, const Vector3& step)
+        {
+            return Vector3(base.x + src[0] * step.x, base.y + src[1] * step.y, base.z + src[2] * step.z);
+        }
+        /// Quantises a channel, or leaves it empty if it is constant
+        static void compressVectors(size_t numKeyFrames, const Vector3* values, Real tolerance,
+            QuantisedList& dest, Vector3& base, Vector3& step);
+
+        TimeList mTimes;
+        QuantisedList mRotations;
+        QuantisedList mTranslates;
+        QuantisedList mScales;
+        /// Rotation of all the keyframes, if mRotations is empty
+        Quaternion mConstantRotation;
+        /// Minimum of the translations, or translation of all the keyframes if mTranslates is empty
+        Vector3 mTranslateBase;
+        /// Translation for one quantisation step
+        Vector3 mTranslateStep;
+        Vector3 mScaleBase;
+        Vector3 mScaleStep;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -475,6 +475,38 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Common subclass of DataStream for handling data from a file mapped 
+        into memory.
+    @remarks
+        The file is mapped read-only and its pages are loaded by the operating
+        system as they are first read, with no intermediate buffer. Since it is
+        a MemoryDataStream, getPtr gives the contents of the whole file, so 
+        that they can be parsed in place instead of read into a copy.
+    */
+    class _OgreExport MappedFileDataStream : public MemoryDataStream
+    {
+    protected:
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        /// The file and mapping handles
+        void* mFileHandle;
+        void* mMappingHandle;
+#endif
+    public:
+        /** Map a file into a named stream.
+        @param name The name to give the stream
+        @param path The path of the file to map
+        @throws Exception(ERR_FILE_NOT_FOUND) if the file could not be opened
+        @throws Exception(ERR_INTERNAL_ERROR) if the file could not be mapped
+        */
+        MappedFileDataStream(const String& name, const String& path);
+
+        ~MappedFileDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
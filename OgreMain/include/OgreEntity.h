@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreHardwareBufferManager.h"
 #include "OgreRenderable.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreMeshTriangleBVH.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -82,6 +83,7 @@ namespace Ogre {
         // Allow EntityFactory full access
         friend class EntityFactory;
         friend class SubEntity;
+        friend class EntityAnimationUpdater;
     public:
         
         typedef set<Entity*>::type EntitySet;
@@ -225,6 +227,19 @@ namespace Ogre {
         bool mAlwaysUpdateMainSkeleton;
         /// Flag indicating whether to update the bounding box from the bones of the skeleton.
         bool mUpdateBoundingBoxFromSkeleton;
+        /// Flag indicating whether to pose the skeleton with a SkeletonPoseEvaluator.
+        bool mUseSkeletonPoseEvaluator;
+        /// Number of software skeletal blends done, to tell when mPoseTriangleBVH is out of date
+        unsigned long mSkelAnimBlendCount;
+        /// Triangle BVH of the mesh refitted to the software skinned pose, created on demand
+        MeshTriangleBVH* mPoseTriangleBVH;
+        /// Value of mSkelAnimBlendCount when mPoseTriangleBVH was last refitted
+        unsigned long mPoseTriangleBVHBlendCount;
+
+        /** Internal method to get the triangle BVH matching the current pose, 
+            which is that of the mesh unless software skinned positions are available.
+        */
+        const MeshTriangleBVH* getPoseTriangleBVH(void);
 
 #if !OGRE_NO_MESHLOD
         /// The LOD number of the mesh to use, calculated by _notifyCurrentCamera.
@@ -885,6 +900,58 @@ namespace Ogre {
             return mUpdateBoundingBoxFromSkeleton;
         }
 
+        /** Sets whether the skeleton is posed by a SkeletonPoseEvaluator, which
+            writes the bone matrices without updating the Bone nodes.
+        @remarks
+            This is faster, but the derived transforms of the bones are then
+            out of date. The Bone nodes are still used whenever something
+            depends on them: objects attached to bones, the bounding box
+            updated from the skeleton, a displayed skeleton, the main skeleton
+            always updated for level of detail, animation state
+            updates skipped to pose the bones manually, and skeletons the
+            evaluator can't handle, such as those with manually controlled
+            bones. The default is false.
+        */
+        void setUseSkeletonPoseEvaluator(bool use) { mUseSkeletonPoseEvaluator = use; }
+
+        /// Gets whether the skeleton is posed by a SkeletonPoseEvaluator
+        bool getUseSkeletonPoseEvaluator(void) const { return mUseSkeletonPoseEvaluator; }
+
+        /** Finds the nearest triangle of this entity hit by a ray.
+        @remarks
+            Unlike scene queries, which stop at the bounding box, this tests the
+            triangles of the mesh, using the tree of Mesh::getTriangleBVH.
+            Skeletally animated entities are tested in their current pose when
+            they are software skinned, that is when hardware animation is not
+            used or software animation was requested with
+            addSoftwareAnimationRequest; otherwise the binding pose is used.
+        @param ray
+            The ray, in world space.
+        @param hit
+            Receives the nearest hit. Its distance is along the world space ray,
+            as for RaySceneQuery.
+        @return
+            True if a triangle was hit.
+        */
+        bool intersectTriangles(const Ray& ray, MeshTriangleBVH::Hit& hit);
+
+        /** Finds the nearest triangle of this entity hit by each of a batch of rays.
+        @remarks
+            Gives the same results as calling intersectTriangles on every ray,
+            but the rays are sent through the tree in packets, which is faster
+            for many rays in the same area.
+        @param rays
+            The rays, in world space.
+        @param numRays
+            The number of rays.
+        @param hits
+            Receives one hit per ray, with distance Math::POS_INFINITY for the
+            rays which did not hit anything.
+        @return
+            The number of rays which hit a triangle.
+        */
+        size_t intersectTriangles(const Ray* rays, size_t numRays, MeshTriangleBVH::Hit* hits);
+
         
     };
 
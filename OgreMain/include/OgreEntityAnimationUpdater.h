@@ -0,0 +1,119 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __EntityAnimationUpdater_H__
+#define __EntityAnimationUpdater_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreWorkQueue.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Updates the animation of the visible entities using several threads.
+    @remarks
+        Entity::_updateRenderQueue normally updates the entity's animation
+        straight away, so every animated entity is posed and skinned in turn
+        on the rendering thread. When a SceneManager has parallel animation
+        enabled, the entities are queued here instead, and once all the
+        visible objects have been found the skeleton poses are computed on
+        the threads of the WorkQueue: the enabled animation states are
+        applied to each SkeletonInstance and its bone matrices are cached.
+        The rest of Entity::updateAnimation, which binds and locks hardware
+        buffers for software animation and updates scene nodes, then runs on
+        the calling thread in queue order, and finds the bone matrices
+        already cached for the frame.
+    @par
+        A pose is only computed when the entity's animation is dirty, as
+        Entity::updateAnimation would, and a SkeletonInstance shared by
+        several entities is posed once. Entities with objects attached to
+        their bones are not queued, since their tag points read the
+        transform of the entity's scene node.
+    */
+    class _OgreExport EntityAnimationUpdater : public AnimationAlloc
+    {
+    public:
+        EntityAnimationUpdater();
+        ~EntityAnimationUpdater();
+
+        /** Queues an entity whose animation must be updated before it is rendered.
+        @remarks
+            The entity is the one displayed, which for manual LOD may not be
+            the one which was found visible.
+        */
+        void queueEntity(Entity* ent) { mEntities.push_back(ent); }
+
+        /// Removes an entity from the queue, if it is destroyed before the update
+        void removeEntity(Entity* ent);
+
+        /** Updates the animation of all the queued entities, and empties the queue.
+        @param workQueue
+            The WorkQueue which computes the poses, if null all the work is
+            done on the calling thread.
+        */
+        void update(WorkQueue* workQueue);
+
+        /** Sets the number of skeletons posed by a single thread at once (default 4).
+        */
+        void setBatchSize(size_t size) { mBatchSize = size; }
+        /// Gets the number of skeletons posed by a single thread at once
+        size_t getBatchSize() const { return mBatchSize; }
+
+    protected:
+        typedef vector<Entity*>::type EntityList;
+
+        /// Computes the poses of a range of skeletons
+        class PoseTask : public WorkQueue::ParallelTask
+        {
+        public:
+            EntityAnimationUpdater* mUpdater;
+            void execute(size_t begin, size_t end);
+        };
+
+        /// Entities queued since the last update, in queue order
+        EntityList mEntities;
+        /// One entity for each skeleton instance to pose
+        EntityList mPoseEntities;
+        size_t mBatchSize;
+
+        /// Whether the pose of an entity's skeleton can be computed on another thread
+        static bool canPoseInParallel(Entity* ent);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -120,7 +120,26 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /** Set the size from which files opened read-only are mapped into memory.
+        @remarks
+            Files at least this large are returned as a MappedFileDataStream,
+            whose contents can be parsed in place rather than copied. If a 
+            file can't be mapped it is read as usual. The default is 0, which 
+            never maps files.
+        */
+        static void setMemoryMappingThreshold(size_t bytes)
+        {
+            msMemoryMappingThreshold = bytes;
+        }
+
+        /// Get the size from which files opened read-only are mapped into memory.
+        static size_t getMemoryMappingThreshold()
+        {
+            return msMemoryMappingThreshold;
+        }
+
         static bool msIgnoreHidden;
+        static size_t msMemoryMappingThreshold;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
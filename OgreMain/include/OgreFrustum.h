@@ -149,6 +149,12 @@ namespace Ogre
         /// Implementation of updateView (called if out of date)
         virtual void updateViewImpl(void) const;
         virtual void updateFrustumPlanes(void) const;
+        /** Implements the batch visibility test by calling the single box test
+            on each box, for subclasses which override the latter.
+        @see isVisible(const Vector3*, const Vector3*, size_t, uint32*) const
+        */
+        void isVisibleOneByOne(const Vector3* centres, const Vector3* halfSizes, 
+            size_t count, uint32* visibilityMask) const;
         /// Implementation of updateFrustumPlanes (called if out of date)
         virtual void updateFrustumPlanesImpl(void) const;
         virtual void updateWorldSpaceCorners(void) const;
@@ -471,6 +477,30 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether each of a batch of boxes is visible in the Frustum.
+        @remarks
+            Gives the same results as calling isVisible(const AxisAlignedBox&, FrustumPlane*)
+            on every box, but the planes are tested by OptimisedUtil, which handles
+            several boxes at once when SIMD instructions are available. The boxes
+            are given by their centres and half sizes, so null and infinite boxes
+            have to be dealt with by the caller.
+        @par
+            Subclasses which override the single box test must override this
+            method as well, or the batch test will not agree with theirs; 
+            isVisibleOneByOne does so by calling the single box test.
+        @param centres
+            Centres of the boxes (world space).
+        @param halfSizes
+            Half sizes of the boxes.
+        @param count
+            Number of boxes.
+        @param visibilityMask
+            Receives the results, bit (i % 32) of element (i / 32) is set when box i
+            is visible. Must have room for (count + 31) / 32 elements.
+        */
+        virtual void isVisible(const Vector3* centres, const Vector3* halfSizes, 
+            size_t count, uint32* visibilityMask) const;
+
         /// Overridden from MovableObject::getTypeFlags
         uint32 getTypeFlags(void) const;
 
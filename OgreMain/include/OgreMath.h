@@ -455,7 +455,18 @@ namespace Ogre
         static Real SymmetricRandom ();
 
         static void SetRandomValueProvider(RandomValueProvider* provider);
-       
+
+        /** Sets a random value provider for the calling thread only.
+        @remarks
+            While set, it takes precedence over the one given to SetRandomValueProvider
+            for the random numbers generated on this thread, which lets work running
+            on several threads at once draw from sequences of its own. Pass 0 to
+            go back to the shared provider. The thread's provider is only looked
+            up while at least one thread has one set, so random numbers cost no
+            more than before the rest of the time.
+        */
+        static void SetThreadRandomValueProvider(RandomValueProvider* provider);
+
         /** Tangent function.
             @param fValue
                 Angle in radians
@@ -289,6 +289,7 @@ namespace Ogre
     typedef GeneralAllocatedObject      ImageAlloc;
     typedef GeometryAllocatedObject     IndexDataAlloc;
     typedef GeneralAllocatedObject      LogAlloc;
+    typedef GeometryAllocatedObject     MeshTriangleBVHAlloc;
     typedef SceneObjAllocatedObject     MovableAlloc;
     typedef SceneCtlAllocatedObject     NodeAlloc;
     typedef SceneObjAllocatedObject     OverlayAlloc;
@@ -175,6 +175,8 @@ namespace Ogre {
         bool mPreparedForShadowVolumes;
         bool mEdgeListsBuilt;
         bool mAutoBuildEdgeLists;
+        /// Triangles for ray picking, built on demand
+        MeshTriangleBVH* mTriangleBVH;
 
         /// Storage of morph animations, lookup by name
         typedef map<String, Animation*>::type AnimationList;
@@ -190,11 +192,18 @@ namespace Ogre {
         PoseList mPoseList;
         mutable bool mPosesIncludeNormals;
 
+        /// Owns the system memory buffers of geometry parsed by prepareImpl, until loadImpl
+        HardwareBufferManagerBase* mStagingBufferManager;
+
 
         /** Loads the mesh from disk.  This call only performs IO, it
             does not parse the bytestream or check for any errors therein.
             It also does not set up submeshes, etc.  You have to call load()
             to do that.
+        @remarks
+            If MeshManager::getDeferHardwareBufferCreation is set and the mesh is only
+            being prepared, it is parsed here as well, into buffers in system memory
+            which loadImpl then copies to hardware buffers.
          */
         void prepareImpl(void);
         /** Destroys data cached by prepareImpl.
@@ -208,6 +217,8 @@ namespace Ogre {
         void unloadImpl(void);
         /// @copydoc Resource::calculateSize
         size_t calculateSize(void) const;
+        /// Moves the geometry parsed by prepareImpl to hardware buffers
+        void uploadStagedGeometry(void);
 
         void mergeAdjacentTexcoords( unsigned short finalTexCoordSet,
                                      unsigned short texCoordSetToDestroy, VertexData *vertexData );
@@ -739,6 +750,20 @@ namespace Ogre {
         /** Returns whether this mesh has an attached edge list. */
         bool isEdgeListBuilt(void) const { return mEdgeListsBuilt; }
 
+        /** Return the triangle BVH of this mesh, building it if required.
+        @remarks
+            The tree holds a copy of the positions and triangles of the highest
+            LOD, and is used to find the exact triangles hit by a ray, see
+            Entity::intersectTriangles. It is built from the vertex and index
+            buffers the first time it is needed, which reads them back: keep
+            shadow buffers if the buffers are write only. If the geometry of the
+            mesh is changed afterwards, call freeTriangleBVH so that the tree is
+            built again.
+        */
+        const MeshTriangleBVH* getTriangleBVH(void);
+        /** Destroys the triangle BVH of this mesh, if it was built. */
+        void freeTriangleBVH(void);
+
         /** Prepare matrices for software indexed vertex blend.
         @remarks
             This function organise bone indexed matrices to blend indexed matrices,
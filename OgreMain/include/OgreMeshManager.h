@@ -383,6 +383,26 @@ namespace Ogre {
         /** Retrieves whether all Meshes should prepare themselves for shadow volumes. */
         bool getPrepareAllMeshesForShadowVolumes(void);
 
+        /** Sets whether meshes are parsed when prepared, creating their hardware buffers
+            only when loaded.
+        @remarks
+            Normally preparing a Mesh only reads its file into memory, and all of the
+            parsing happens on load, which must be on the rendering thread since it
+            creates and fills hardware buffers. When this is enabled, Mesh::prepare
+            parses the file into buffers in system memory, so it can be done by a
+            background thread (see ResourceBackgroundQueue and
+            ResourceGroupManager::setParallelGroupLoading), and the file data is released
+            afterwards. Mesh::load then only has to copy the buffers to the hardware.
+            A skeleton the mesh links to is prepared along with it and loaded with it.
+            Meshes loaded without being prepared first are parsed on load as usual.
+        @note
+            This affects meshes prepared after the call. The MeshSerializerListener,
+            if any, is called from the thread preparing the mesh. Disabled by default.
+        */
+        void setDeferHardwareBufferCreation(bool defer);
+        /** Gets whether meshes are parsed when prepared, see setDeferHardwareBufferCreation. */
+        bool getDeferHardwareBufferCreation(void) const;
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -494,6 +514,7 @@ namespace Ogre {
         void loadManualCurvedIllusionPlane(Mesh* pMesh, MeshBuildParams& params);
 
         bool mPrepAllMeshesForShadowVolumes;
+        bool mDeferHardwareBufferCreation;
     
         //the factor by which the bounding box of an entity is padded   
         Real mBoundsPaddingFactor;
@@ -160,6 +160,19 @@ namespace Ogre {
         void setListener(MeshSerializerListener *listener);
         /// Returns the current listener
         MeshSerializerListener *getListener();
+
+        /** Sets the manager creating the buffers of imported meshes.
+        @remarks
+            By default the buffers are created by the HardwareBufferManager singleton.
+            Passing a DefaultHardwareBufferManagerBase instead builds the mesh in system
+            memory without touching the render system, which allows importing meshes on
+            other threads. The buffers hold a pointer to their manager, so it must outlive
+            the mesh data.
+        @param mgr The manager, or 0 for the HardwareBufferManager singleton
+        */
+        void setBufferManager(HardwareBufferManagerBase* mgr);
+        /// Returns the manager set with setBufferManager, 0 by default
+        HardwareBufferManagerBase* getBufferManager(void) const;
         
     protected:
         
@@ -182,6 +195,8 @@ namespace Ogre {
 
         MeshSerializerListener *mListener;
 
+        HardwareBufferManagerBase* mBufferManager;
+
     };
 
     /** 
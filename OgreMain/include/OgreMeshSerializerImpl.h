@@ -82,7 +82,15 @@ namespace Ogre {
         */
         void importMesh(DataStreamPtr& stream, Mesh* pDest, MeshSerializerListener *listener);
 
+        /// Sets the manager creating the buffers of imported meshes, 0 for the singleton
+        void setBufferManager(HardwareBufferManagerBase* mgr);
+
     protected:
+        /// The manager creating the buffers of imported meshes, 0 for the singleton
+        HardwareBufferManagerBase* mBufferManager;
+
+        /// Returns the manager to create the buffers of imported meshes with
+        HardwareBufferManagerBase* getBufferManager(void) const;
 
         // Internal methods
         virtual void writeSubMeshNameTable(const Mesh* pMesh);
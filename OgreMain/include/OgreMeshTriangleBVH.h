@@ -0,0 +1,229 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MeshTriangleBVH_H__
+#define __MeshTriangleBVH_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreAxisAlignedBox.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Bounding volume hierarchy over the triangles of a Mesh, for exact ray picking.
+    @remarks
+        Scene queries only test bounding volumes. This class copies the vertex
+        positions and triangles of all the submeshes of a mesh, at full detail,
+        and sorts the triangles into a binary tree of boxes built with the
+        surface area heuristic, so a ray only has to be tested against a few of
+        them. Mesh::getTriangleBVH builds one the first time it is needed and
+        keeps it with the mesh.
+    @par
+        The positions can be replaced afterwards with updatePositions, which
+        keeps the tree and only recomputes its boxes. This is how Entity tests
+        its software skinned pose against the tree of its mesh.
+    @par
+        Only triangle lists, strips and fans are used; other render
+        operations are ignored. Positions must be 3 floats.
+    */
+    class _OgreExport MeshTriangleBVH : public MeshTriangleBVHAlloc
+    {
+    public:
+        /// Details of a ray hitting a triangle
+        struct Hit
+        {
+            /// Distance along the ray, Math::POS_INFINITY if nothing was hit
+            Real distance;
+            /// The submesh the triangle belongs to
+            unsigned short subMeshIndex;
+            /// Index of the triangle in the index data of the submesh
+            uint32 triangleIndex;
+            /** Barycentric coordinates of the hit, the weights of the second and
+                third vertices of the triangle (the first one is 1 - u - v)
+            */
+            Real u, v;
+        };
+
+        /// Number of rays traversing the tree together in the batch intersect
+        static const size_t PACKET_SIZE = 4;
+
+        MeshTriangleBVH();
+        ~MeshTriangleBVH();
+
+        /** Builds the tree from the vertex and index data of a mesh.
+        @remarks
+            The buffers are locked for reading, which uses their shadow
+            buffers when they have one.
+        */
+        void build(const Mesh* mesh);
+
+        /** Replaces the vertex positions and refits the boxes of the tree.
+        @remarks
+            The vertex data must have the same number of vertices as those of
+            the mesh the tree was built from, as is the case for the blended
+            copies of an animated Entity.
+        @param sharedVertexData
+            Replaces the positions of the shared vertex data of the mesh, may be
+            null to keep them.
+        @param subMeshVertexData
+            One entry per submesh, replacing the positions of the submeshes with
+            their own vertex data; null entries keep the positions.
+        */
+        void updatePositions(const VertexData* sharedVertexData,
+            const VertexData* const* subMeshVertexData);
+
+        /** Finds the nearest triangle hit by a ray.
+        @param ray
+            The ray, in the space of the mesh. The distance of the hit is the
+            ray parameter, so it is only in mesh units if the direction has unit
+            length.
+        @param hit
+            Receives the nearest hit, if any.
+        @param positiveSide
+            Whether to report hits on the front faces (counter-clockwise winding).
+        @param negativeSide
+            Whether to report hits on the back faces.
+        @return
+            True if a triangle was hit.
+        */
+        bool intersect(const Ray& ray, Hit& hit,
+            bool positiveSide = true, bool negativeSide = true) const;
+
+        /** Finds the nearest triangle hit by each of a batch of rays.
+        @remarks
+            Gives the same results as calling intersect on every ray, but the
+            rays go through the tree in packets of PACKET_SIZE which share the
+            node visits. This pays off when the rays are coherent, like those of
+            a selection rectangle or a sampling pattern.
+        @param rays
+            The rays, in the space of the mesh.
+        @param numRays
+            Number of rays.
+        @param hits
+            Receives one hit per ray, with distance Math::POS_INFINITY for the
+            rays which did not hit anything.
+        @param positiveSide, negativeSide
+            Which faces are hit, as for intersect.
+        @return
+            The number of rays which hit a triangle.
+        */
+        size_t intersect(const Ray* rays, size_t numRays, Hit* hits,
+            bool positiveSide = true, bool negativeSide = true) const;
+
+        /// Gets the number of triangles in the tree
+        size_t getTriangleCount(void) const { return mTriangles.size(); }
+        /// Gets the number of nodes in the tree
+        size_t getNodeCount(void) const { return mNodes.size(); }
+        /// Gets the box of all the triangles
+        AxisAlignedBox getBounds(void) const;
+
+    protected:
+        /// Nodes with at most this many triangles are not split
+        static const size_t MAX_LEAF_SIZE = 4;
+        /// Depth at which the nodes are no longer split
+        static const size_t MAX_DEPTH = 48;
+
+        /** A node of the tree. The two children of an inner node are stored
+            next to each other, and always after their parent. */
+        struct Node
+        {
+            float minimum[3];
+            float maximum[3];
+            /// First triangle of a leaf, or first child of an inner node
+            uint32 start;
+            /// Number of triangles of a leaf, 0 for inner nodes
+            uint32 count;
+        };
+        typedef vector<Node>::type NodeList;
+
+        struct Triangle
+        {
+            /// Indices of the vertices in mPositions
+            uint32 vertex[3];
+            uint32 triangleIndex;
+            unsigned short subMeshIndex;
+        };
+        typedef vector<Triangle>::type TriangleList;
+
+        /// Range of mPositions holding the vertices of one VertexData
+        struct VertexRange
+        {
+            uint32 start;
+            uint32 count;
+        };
+        typedef vector<VertexRange>::type VertexRangeList;
+
+        /// A ray prepared for the box tests
+        struct PreparedRay
+        {
+            Vector3 origin;
+            Vector3 direction;
+            Vector3 invDirection;
+        };
+
+        NodeList mNodes;
+        /// Triangles, in leaf order once built
+        TriangleList mTriangles;
+        /// Vertex positions of the shared vertex data then of each submesh
+        vector<Vector3>::type mPositions;
+        /// Shared vertex data first, then one entry per submesh
+        VertexRangeList mVertexRanges;
+
+        /// Copy the positions of vertex data to a range of mPositions
+        void readPositions(const VertexData* vertexData, const VertexRange& range);
+        /// Add the triangles of a submesh
+        void addTriangles(const SubMesh* subMesh, unsigned short subMeshIndex, const VertexRange& range);
+        /// Build the nodes from the triangles
+        void buildNodes(void);
+        /// Recompute the boxes of all the nodes from the positions
+        void refit(void);
+
+        /// Slab test of a ray against a node, giving the entry distance
+        static bool intersectNode(const Node& node, const PreparedRay& ray,
+            Real maxDistance, Real& entryDistance);
+        /// Tests a ray against a triangle, updating the hit if it is closer
+        bool intersectTriangle(const Triangle& tri, const PreparedRay& ray,
+            bool positiveSide, bool negativeSide, Hit& hit) const;
+        /// Intersect up to PACKET_SIZE rays together
+        void intersectPacket(const PreparedRay* rays, size_t numRays, Hit* hits,
+            bool positiveSide, bool negativeSide) const;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -57,6 +57,7 @@ namespace Ogre {
     */
     class _OgreExport Node : public NodeAlloc
     {
+        friend class SceneGraphUpdater;
     public:
         /** Enumeration denoting the spaces which a transform can be relative to.
         */
@@ -72,6 +72,16 @@ namespace Ogre {
         */
         static OptimisedUtil* getImplementation(void) { return msImplementation; }
 
+        typedef map<String, OptimisedUtil*>::type ImplementationMap;
+
+        /** Gets every implementation the running CPU can use, by name.
+        @remarks
+            getImplementation returns the best of them; the others are only
+            useful to compare them with each other, in tests and benchmarks.
+            The general implementation is always present, as "General".
+        */
+        static ImplementationMap getAvailableImplementations(void);
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -203,6 +213,147 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Tests a batch of axis aligned boxes against a set of planes.
+        @remarks
+            A box is culled when it lies entirely on the negative side of
+            any of the planes, that is when Plane::getSide(centre, halfSize)
+            returns Plane::NEGATIVE_SIDE for one of them.
+        @param planes Pointer to the planes to test against.
+        @param numPlanes Number of planes.
+        @param centres Pointer to the centres of the boxes. No SIMD alignment
+            requirement.
+        @param halfSizes Pointer to the half sizes of the boxes, which must
+            not be negative. No SIMD alignment requirement.
+        @param visibilityMask Pointer to the bit mask receiving the results,
+            bit (i % 32) of element (i / 32) is set when box i is visible. It
+            must have room for (numBoxes + 31) / 32 elements; the unused bits
+            of the last element are cleared.
+        @param numBoxes Number of boxes to test.
+        */
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes) = 0;
+
+        /** Concatenates the local transforms of a bone hierarchy and
+            calculates the bone matrices, as Bone::_getOffsetTransform would.
+        @remarks
+            The transforms are stored as separate arrays of components, which
+            are position x, y, z, orientation w, x, y, z and scale x, y, z in
+            that order, each of stride elements. Slot 0 is the root of the
+            hierarchy; its derived transform must be set by the caller and is
+            left untouched, as is its bone matrix. The other slots must come
+            after their parent, and a group of four slots whose parents all
+            come before the group is processed at once.
+        @param localTransforms The transforms relative to the parents.
+        @param bindInverseTransforms The inverse binding pose transforms.
+        @param parents The parent slot of each slot.
+        @param boneHandles The index in boneMatrices of each slot.
+        @param derivedTransforms The transforms relative to the root, written
+            for all the slots but slot 0.
+        @param boneMatrices The bone matrices to write. No SIMD alignment
+            requirement.
+        @param stride Number of elements of each component array, a multiple
+            of four. The component arrays must be aligned to SIMD alignment.
+        @param numSlots Number of slots, including slot 0.
+        */
+        virtual void concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots) = 0;
+
+        /** Adds a scaled array to another, that is dst[i] += src[i] * scale.
+        @param dst Pointer to the array to add to. No SIMD alignment requirement.
+        @param src Pointer to the array to add. No SIMD alignment requirement.
+        @param scale The factor src is scaled by.
+        @param count Number of elements of the arrays.
+        */
+        virtual void addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count) = 0;
+
+        /** Scales, offsets and clamps an array in place, that is
+            data[i] = min(max(data[i] * scale + offset, minValue), maxValue).
+        @param data Pointer to the array to modify. No SIMD alignment
+            requirement.
+        @param scale The factor each element is scaled by.
+        @param offset The value added to each scaled element.
+        @param minValue The lower bound of the results.
+        @param maxValue The upper bound of the results, which must not be
+            less than minValue.
+        @param count Number of elements of the array.
+        */
+        virtual void multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count) = 0;
+
+        /** Generates the vertices of billboards sharing their corner offsets
+            and texture coordinates, in the vertex layout of BillboardSet.
+        @remarks
+            Each billboard gives four vertices, one per corner, made of the
+            position, the colour and the texture coordinates, six 32-bit
+            values in all.
+        @param billboards Pointer to the billboards, four 32-bit values each:
+            the position of the centre, then the colour in the vertex colour
+            format. No SIMD alignment requirement.
+        @param offsets Pointer to the offsets of the four corners from the
+            centre, three floats each.
+        @param texcoords Pointer to the texture coordinates of the four
+            corners, two floats each.
+        @param dest Pointer to the vertices to write. No SIMD alignment
+            requirement.
+        @param numBillboards Number of billboards.
+        */
+        virtual void generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards) = 0;
+
+        /** Calculates the keys to sort points by depth, back to front when
+            sorted in ascending order.
+        @remarks
+            With byDistance the key of a point is its negated squared distance
+            to the origin, otherwise it is the distance from the origin along
+            the direction, which should then point away from the viewer.
+        @param posX Pointer to the x coordinates of the points. No SIMD
+            alignment requirement.
+        @param posY Pointer to the y coordinates of the points. No SIMD
+            alignment requirement.
+        @param posZ Pointer to the z coordinates of the points. No SIMD
+            alignment requirement.
+        @param origin The position of the viewer.
+        @param direction The direction to sort along, ignored with byDistance.
+        @param byDistance Whether to sort by distance rather than along the
+            direction.
+        @param keys Pointer to the keys to write. No SIMD alignment requirement.
+        @param count Number of points.
+        */
+        virtual void calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
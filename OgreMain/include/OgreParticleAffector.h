@@ -110,6 +110,28 @@ namespace Ogre {
         */
         virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
 
+        /** Method called instead of _affectParticles when the system keeps its particles in arrays.
+        @remarks
+            A system using the PSM_ARRAYS storage mode calls this first. Affectors able to
+            apply their effect to whole arrays at once should override it and return true.
+            By default it returns false, and the system brings the Particle instances up to
+            date and calls _affectParticles instead, which is much slower.
+        @param
+            pSystem Pointer to the ParticleSystem to affect.
+        @param
+            data The arrays of the active particles of the system.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        @return
+            True if the particles have been affected.
+        */
+        virtual bool _affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+                {
+                    /* by default leave it to _affectParticles */
+                    (void)pSystem; (void)data; (void)timeElapsed;
+                    return false;
+                }
+
         /** Returns the name of the type of affector. 
         @remarks
             This property is useful for determining the type of affector procedurally so another
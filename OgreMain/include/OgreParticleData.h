@@ -0,0 +1,153 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParticleData_H__
+#define __ParticleData_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+    /** Contiguous storage of the particles of a ParticleSystem, one array per
+        component.
+    @remarks
+        A ParticleSystem using the PSM_ARRAYS storage mode keeps the state of
+        its particles here rather than in the Particle instances, so that its
+        motion, expiry and the affectors supporting it can process whole
+        arrays at once. Slot i of each array belongs to the particle
+        mParticles[i]. The first getCount() slots are the active particles,
+        in no particular order; the getNumFree() slots after them hold the
+        free visual particles, whose data is meaningless.
+    @par
+        The Particle instances are only brought up to date on demand, with
+        write, and the arrays updated from them with read, by the
+        ParticleSystem. Affectors working on the arrays must not rely on the
+        Particle instances, except for their type.
+    */
+    class _OgreExport ParticleData : public FXAlloc
+    {
+    public:
+        ParticleData();
+        ~ParticleData();
+
+        /// Gets the number of active particles
+        size_t getCount(void) const { return mCount; }
+        /// Gets the number of free visual particles
+        size_t getNumFree(void) const { return mNumFree; }
+
+        /** Adds a free visual particle. */
+        void addFree(Particle* p);
+
+        /** Activates the first free visual particle and returns it.
+        @remarks
+            The particle takes the last active slot, whose data is not
+            initialised; call read once the particle is.
+        */
+        Particle* activateFree(void);
+
+        /** Appends an active particle which is not one of the free ones,
+            such as an emitted emitter, and reads its data.
+        */
+        void addActive(Particle* p);
+
+        /** Frees the visual particle of an active slot.
+        @remarks
+            The last active particle is moved to the slot.
+        */
+        void deactivate(size_t index);
+
+        /** Removes the particle of an active slot, which must not be a
+            visual particle, altogether.
+        @remarks
+            The last active particle is moved to the slot.
+        */
+        void remove(size_t index);
+
+        /** Updates the arrays from the Particle instance of a slot. */
+        void read(size_t index);
+
+        /** Updates the Particle instance of a slot from the arrays. */
+        void write(size_t index) const;
+
+        /// The particle of each slot
+        Particle** mParticles;
+        /// Position
+        Real* mPositionX;
+        Real* mPositionY;
+        Real* mPositionZ;
+        /// Direction (and speed)
+        Real* mDirectionX;
+        Real* mDirectionY;
+        Real* mDirectionZ;
+        /// Colour
+        Real* mColourR;
+        Real* mColourG;
+        Real* mColourB;
+        Real* mColourA;
+        /// Whether the particle has its own dimensions
+        bool* mOwnDimensions;
+        /// Width if the particle has its own dimensions
+        Real* mWidth;
+        /// Height if the particle has its own dimensions
+        Real* mHeight;
+        /// Rotation in radians
+        Real* mRotation;
+        /// Rotation speed in radians per second
+        Real* mRotationSpeed;
+        /// Time to live in seconds
+        Real* mTimeToLive;
+        /// Total time to live in seconds
+        Real* mTotalTimeToLive;
+
+    protected:
+        /// Number of active particles
+        size_t mCount;
+        /// Number of free visual particles
+        size_t mNumFree;
+        /// Number of slots allocated
+        size_t mCapacity;
+
+        /// Makes room for at least the given number of slots
+        void reserve(size_t capacity);
+        /// Copies the data of a slot into another, not the particle
+        void copySlot(size_t dst, size_t src);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -47,6 +47,15 @@ namespace Ogre {
     /** \addtogroup Effects
     *  @{
     */
+    /** The way a ParticleSystem stores the state of its particles. */
+    enum ParticleStorageMode
+    {
+        /// In the Particle instances, in a list of the active particles
+        PSM_LIST,
+        /// In arrays of each component, see ParticleData
+        PSM_ARRAYS
+    };
+
     /** Class defining particle system based special effects.
     @remarks
         Particle systems are special effects generators which are based on a 
@@ -143,6 +152,13 @@ namespace Ogre {
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /** Command object for storage mode (see ParamCommand).*/
+        class CmdStorageMode : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         /// Default constructor required for STL creation in manager
         ParticleSystem();
@@ -347,6 +363,50 @@ namespace Ogre {
         */
         void _update(Real timeElapsed);
 
+        /** Internal method doing the part of _update which must run on the main thread.
+        @remarks
+            This is the first of the three steps of _update. It checks whether the
+            system needs updating at all, sets up the renderer and emitted emitters,
+            and brings the transform of the parent node up to date, so that
+            _updateParticles then only reads it. The time is added to the time
+            waiting for _updateParticles.
+        @param
+            timeElapsed The amount of time, in seconds, since the last frame.
+        @return
+            True if the system was not already waiting for _updateParticles and
+            needs to be updated.
+        */
+        bool _prepareUpdate(Real timeElapsed);
+
+        /** Internal method updating the particles by the time given to _prepareUpdate.
+        @remarks
+            This runs the emitters, affectors and motion of the particles and
+            calculates the bounds. It only touches this system, its emitters,
+            affectors and renderer, so the systems of the scene may be updated this
+            way on several threads at once, see ParticleSystemManager::setParallelUpdate.
+        @param
+            ownRandomSequence Whether the random numbers drawn during the update
+            come from the system's own sequence (see setRandomSeed) rather than
+            the shared one.
+        */
+        void _updateParticles(bool ownRandomSequence);
+
+        /** Internal method doing the part of _update which must run on the main
+            thread after _updateParticles, telling the parent node about new bounds.
+        */
+        void _finishUpdate(void);
+
+        /** Sets the seed of the system's own sequence of random numbers, and restarts it.
+        @remarks
+            Systems updated in parallel (see ParticleSystemManager::setParallelUpdate)
+            each draw their random numbers from their own sequence, so that the
+            result does not depend on how the systems are spread over threads. By
+            default the seed is derived from the name of the system.
+        */
+        void setRandomSeed(uint32 seed);
+        /// Gets the seed of the system's own sequence of random numbers.
+        uint32 getRandomSeed(void) const { return mRandomSeed; }
+
         /** Returns an iterator for stepping through all particles in this system.
         @remarks
             This method is designed to be used by people providing new ParticleAffector subclasses,
@@ -567,6 +627,26 @@ namespace Ogre {
         /// Gets whether particles are sorted relative to the camera.
         bool getSortingEnabled(void) const { return mSorted; }
 
+        /** Sets how the state of the particles is stored.
+        @remarks
+            By default (PSM_LIST) the particles live in their Particle instances,
+            which are visited one by one. With PSM_ARRAYS the system keeps them in
+            a ParticleData instead, an array per component, and updates the
+            arrays as a whole: the motion and expiry of the particles, and the
+            affectors which implement ParticleAffector::_affectParticleData, are
+            then much faster with large numbers of particles. The Particle
+            instances are only brought up to date when they are needed, for
+            rendering, by affectors which do not support the arrays and by
+            getParticle or _getIterator. Any change made to them through these
+            is picked up at the next update.
+        @par
+            The order of the particles is not kept in PSM_ARRAYS, an expired
+            particle is replaced by the last one.
+        */
+        void setStorageMode(ParticleStorageMode mode);
+        /// Gets how the state of the particles is stored.
+        ParticleStorageMode getStorageMode(void) const { return mParticleData ? PSM_ARRAYS : PSM_LIST; }
+
         /** Set the (initial) bounds of the particle system manually. 
         @remarks
             If you can, set the bounds of a particle system up-front and 
@@ -661,6 +741,7 @@ namespace Ogre {
         static CmdLocalSpace msLocalSpaceCmd;
         static CmdIterationInterval msIterationIntervalCmd;
         static CmdNonvisibleTimeout msNonvisibleTimeoutCmd;
+        static CmdStorageMode msStorageModeCmd;
 
 
         AxisAlignedBox mAABB;
@@ -760,6 +841,43 @@ namespace Ogre {
         */
         ParticlePool mParticlePool;
 
+        /** The particles, in the PSM_ARRAYS storage mode.
+            @remarks
+                The active and free particles live here rather than in mActiveParticles and
+                mFreeParticles, which are left empty. mActiveParticles is only filled in when
+                the Particle instances are brought up to date.
+        */
+        ParticleData* mParticleData;
+        /// Are mActiveParticles and the Particle instances up to date with mParticleData?
+        bool mParticleObjectsInSync;
+        /// May the Particle instances have been modified outside of the update?
+        bool mParticleObjectsExposed;
+        /// Have the particles moved since the renderer was last notified?
+        bool mParticlesMoved;
+
+        /// Sequence of random numbers used by Math::UnitRandom while the system updates in parallel
+        class _OgrePrivate RandomSequence : public Math::RandomValueProvider
+        {
+        public:
+            RandomSequence() : mState(1) {}
+            /// Restarts the sequence from the given seed
+            void reset(uint32 seed);
+            Real getRandomUnit();
+        protected:
+            uint32 mState;
+        };
+        RandomSequence mRandomSequence;
+        uint32 mRandomSeed;
+        /// Time scaled by the speed factor waiting for _updateParticles
+        Real mPendingUpdateTime;
+        /// Is the system waiting for _updateParticles?
+        bool mUpdatePending;
+        /// Must the parent node be told about new bounds by _finishUpdate?
+        bool mParentNodeUpdatePending;
+        /// Emissions requested from the emitters and the active emitted emitters, by _triggerEmitters
+        vector<unsigned>::type mRequestedEmissions;
+        vector<unsigned>::type mEmittedRequestedEmissions;
+
         typedef list<ParticleEmitter*>::type FreeEmittedEmitterList;
         typedef list<ParticleEmitter*>::type ActiveEmittedEmitterList;
         typedef vector<ParticleEmitter*>::type EmittedEmitterList;
@@ -833,12 +951,27 @@ namespace Ogre {
         /** Updates existing particle based on their momentum. */
         void _applyMotion(Real timeElapsed);
 
+        /** Calculates the bounds as _updateBounds does, without telling the parent node.
+        @return
+            True if the bounds were calculated and the parent node needs updating.
+        */
+        bool calculateBounds(void);
+
         /** Applies the effects of affectors. */
         void _triggerAffectors(Real timeElapsed);
 
         /** Sort the particles in the system **/
         void _sortParticles(Camera* cam);
 
+        /** Activates a free particle, without initialising it. */
+        Particle* activateParticle(void);
+
+        /** Brings mActiveParticles and the Particle instances up to date with mParticleData. */
+        void syncParticleObjects(void);
+
+        /** Updates mParticleData from the Particle instances of the active particles. */
+        void readParticleObjects(void);
+
         /** Resize the internal pool of particles. */
         void increasePool(size_t size);
 
@@ -99,6 +99,15 @@ namespace Ogre {
         // Factory instance
         ParticleSystemFactory* mFactory;
 
+        /// Are the particle systems updated in parallel?
+        bool mParallelUpdate;
+        typedef vector<std::pair<ParticleSystem*, Real> >::type QueuedUpdateList;
+        /// Updates queued by the controllers of the systems, see setParallelUpdate
+        QueuedUpdateList mQueuedUpdates;
+        typedef vector<ParticleSystem*>::type ParticleSystemList;
+        /// Systems being updated by _updateQueuedSystems
+        ParticleSystemList mUpdatingSystems;
+
         /** Internal script parsing method. */
         void parseNewEmitter(const String& type, DataStreamPtr& chunk, ParticleSystem* sys);
         /** Internal script parsing method. */
@@ -341,6 +350,37 @@ namespace Ogre {
                 mSystemTemplates.begin(), mSystemTemplates.end());
         } 
 
+        /** Sets whether the particle systems are updated in parallel.
+        @remarks
+            Particle systems are independent of each other until their renderers
+            fill their buffers. When this is enabled, the controllers of the
+            systems queue their updates, and SceneManager::_renderScene runs the
+            emission, affectors, motion and bounds of all the queued systems
+            at once on the threads of the WorkQueue, see _updateQueuedSystems.
+            The renderers are then filled on the rendering thread as usual.
+        @par
+            Each system then draws its random numbers from its own sequence (see
+            ParticleSystem::setRandomSeed) rather than from Math::UnitRandom's,
+            so the result does not depend on the number of threads. Emitters,
+            affectors and renderers must not touch state shared between systems
+            during the update, which those of OGRE and of the ParticleFX plugin
+            respect. Disabled by default.
+        */
+        void setParallelUpdate(bool enabled);
+        /// Gets whether the particle systems are updated in parallel.
+        bool getParallelUpdate(void) const { return mParallelUpdate; }
+
+        /// Internal method queueing the update of a system, see setParallelUpdate.
+        void _queueUpdate(ParticleSystem* system, Real timeElapsed);
+        /// Internal method removing a system being destroyed from the queued updates.
+        void _dequeueUpdate(ParticleSystem* system);
+        /** Internal method running the queued updates of the systems.
+        @remarks
+            The parts of the update which are not thread safe run on this thread,
+            before and after the systems are updated by WorkQueue::parallelFor.
+        */
+        void _updateQueuedSystems(void);
+
         /** Get an instance of ParticleSystemFactory (internal use). */
         ParticleSystemFactory* _getFactory(void) { return mFactory; }
         
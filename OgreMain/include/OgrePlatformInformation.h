@@ -98,6 +98,15 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  1
 #endif
 
+/* Define whether or not Ogre compiled with AVX2 and FMA support. The code
+   using them is compiled for these instructions function by function, and
+   only called when the CPU reports them, so no compiler switch is needed.
+*/
+#if __OGRE_HAVE_SSE && (OGRE_COMPILER_MIN_VERSION(OGRE_COMPILER_MSVC, 1700) || \
+    OGRE_COMPILER_MIN_VERSION(OGRE_COMPILER_GNUC, 490) || OGRE_COMPILER_MIN_VERSION(OGRE_COMPILER_CLANG, 380))
+#   define __OGRE_HAVE_AVX2  1
+#endif
+
 /* Define whether or not Ogre compiled with VFP support.
  */
 #if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && defined(__ARM_ARCH_6K__) && defined(__VFP_FP__)
@@ -108,6 +117,16 @@ namespace Ogre {
  */
 #if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && defined(__ARM_ARCH_7A__) && defined(__ARM_NEON__)
 #   define __OGRE_HAVE_NEON  1
+#elif OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && defined(__aarch64__) && defined(__ARM_NEON)
+#   define __OGRE_HAVE_NEON  1
+#endif
+
+/* Define whether or not the NEON implementation of OptimisedUtil is used. It
+   has not been built and tested on an ARM device yet, so it is left out 
+   unless asked for.
+ */
+#ifndef OGRE_OPTIMISEDUTIL_NEON
+#   define OGRE_OPTIMISEDUTIL_NEON  0
 #endif
 
 /* Define whether or not Ogre compiled with MSA support.
@@ -120,6 +139,10 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+#ifndef __OGRE_HAVE_AVX2
+#   define __OGRE_HAVE_AVX2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -176,6 +199,9 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX             = 1 << 18,
+            CPU_FEATURE_AVX2            = 1 << 19,
+            CPU_FEATURE_FMA             = 1 << 20,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
@@ -139,6 +139,7 @@ namespace Ogre {
     class Angle;
     class AnimableValue;
     class Animation;
+    class AnimationPoseCache;
     class AnimationState;
     class AnimationStateSet;
     class AnimationTrack;
@@ -150,11 +151,13 @@ namespace Ogre {
     class AxisAlignedBoxSceneQuery;
     class Billboard;
     class BillboardChain;
+    class BillboardChainBatch;
     class BillboardSet;
     class Bone;
     class Camera;
     class Codec;
     class ColourValue;
+    class CompressedTransformTrack;
     class ConfigDialog;
     template <typename T> class Controller;
     template <typename T> class ControllerFunction;
@@ -169,6 +172,7 @@ namespace Ogre {
     class EdgeData;
     class EdgeListBuilder;
     class Entity;
+    class EntityAnimationUpdater;
     class ErrorDialog;
     class ExternalTextureSourceManager;
     class Factory;
@@ -220,6 +224,7 @@ namespace Ogre {
     class MeshSerializer;
     class MeshSerializerImpl;
     class MeshManager;
+    class MeshTriangleBVH;
     class MovableObject;
     class MovablePlane;
     class Node;
@@ -230,6 +235,7 @@ namespace Ogre {
     class Particle;
     class ParticleAffector;
     class ParticleAffectorFactory;
+    class ParticleData;
     class ParticleEmitter;
     class ParticleEmitterFactory;
     class ParticleSystem;
@@ -276,6 +282,8 @@ namespace Ogre {
     class ResourceManager;
     class RibbonTrail;
     class Root;
+    class SceneGraphCuller;
+    class SceneGraphUpdater;
     class SceneManager;
     class SceneManagerEnumerator;
     class SceneNode;
@@ -294,6 +302,7 @@ namespace Ogre {
     class Skeleton;
     class SkeletonInstance;
     class SkeletonManager;
+    class SkeletonPoseEvaluator;
     class Sphere;
     class SphereSceneQuery;
     class StaticGeometry;
@@ -322,6 +322,128 @@ namespace Ogre {
 
     };
 
+    /** Non-template part of ParallelRadixSort.
+    @remarks
+        Sorts an array of 64 bit keys, each paired with the index of the item
+        it was taken from, using a least significant digit radix sort with 8 bit
+        digits. The keys are split into chunks of equal size; building the
+        histograms and scattering the keys is done for all the chunks at once
+        on the threads of a WorkQueue, while the prefix sums in between are 
+        computed on the calling thread. Digits which have the same value for
+        every key are skipped.
+    */
+    class _OgreExport ParallelRadixSortBase
+    {
+    public:
+        ParallelRadixSortBase();
+        ~ParallelRadixSortBase();
+
+        /** Sets the number of keys handled by one thread at once (default 16384).
+        */
+        void setBatchSize(size_t size) { mBatchSize = size; }
+        /// Gets the number of keys handled by one thread at once
+        size_t getBatchSize() const { return mBatchSize; }
+
+    protected:
+        /// A key and the index of the item it belongs to
+        struct SortEntry
+        {
+            uint64 key;
+            uint32 index;
+        };
+        typedef std::vector<SortEntry, STLAllocator<SortEntry, GeneralAllocPolicy> > SortVector;
+        typedef std::vector<uint32, STLAllocator<uint32, GeneralAllocPolicy> > CounterVector;
+
+        /// Temp sort storage, the keys to sort are written to mSortArea1
+        SortVector mSortArea1;
+        SortVector mSortArea2;
+        /// Per-chunk digit counters, then offsets
+        CounterVector mCounters;
+        size_t mBatchSize;
+
+        /** Sorts the first count entries of mSortArea1.
+        @return The sort area holding the sorted entries
+        */
+        const SortVector& sortEntries(size_t count, WorkQueue* workQueue);
+    };
+
+    /** Radix sort of a container by a 64 bit key, which can use several threads.
+    @remarks
+        This works like RadixSort, except that the functor has to return an uint64
+        and that the sort can run on the threads of a WorkQueue. The sort is stable,
+        so several sort criteria can be packed into a single key, with the most 
+        significant one in the high bits, and the container sorted in one go.
+    @par
+        The container must provide random access, e.g. a std::vector. As with 
+        RadixSort, instances should be reused to avoid reallocating the internal 
+        storage. Separate instances can be used from different threads at the 
+        same time.
+    */
+    template <class TContainer>
+    class ParallelRadixSort : public ParallelRadixSortBase
+    {
+    protected:
+        TContainer mTmpContainer; // initial copy
+
+    public:
+        /** Main sort function
+        @param container A container of the type you declared when declaring
+        @param func A functor which returns the uint64 key of a container value
+        @param workQueue WorkQueue whose threads to use, or null to sort on the 
+            calling thread only
+        */
+        template <class TFunction>
+        void sort(TContainer& container, TFunction func, WorkQueue* workQueue = 0)
+        {
+            if (container.empty())
+                return;
+
+            size_t count = container.size();
+            mSortArea1.resize(count);
+
+            typename TContainer::iterator i = container.begin();
+            uint64 prevValue = func.operator()(*i);
+            bool needsSorting = false;
+            for (uint32 u = 0; i != container.end(); ++i, ++u)
+            {
+                uint64 val = func.operator()(*i);
+                // cheap check to see if needs sorting (temporal coherence)
+                if (!needsSorting && val < prevValue)
+                    needsSorting = true;
+
+                mSortArea1[u].key = val;
+                mSortArea1[u].index = u;
+                prevValue = val;
+            }
+
+            // early exit if already sorted
+            if (!needsSorting)
+                return;
+
+            const SortVector& sorted = sortEntries(count, workQueue);
+
+            // Copy everything back
+            mTmpContainer = container;
+            size_t c = 0;
+            for (i = container.begin(); i != container.end(); ++i, ++c)
+            {
+                *i = mTmpContainer[sorted[c].index];
+            }
+        }
+
+        /** Converts a float into an unsigned value with the same ordering, for
+            building keys.
+        */
+        static uint32 floatToKey(float val)
+        {
+            union { float f; uint32 u; } bits;
+            bits.f = val;
+            // Flip all the bits of negative values, so that they come first 
+            // in reverse order, and only the sign bit of positive ones
+            return (bits.u & 0x80000000) ? ~bits.u : (bits.u | 0x80000000);
+        }
+    };
+
     /** @} */
     /** @} */
 
@@ -141,6 +141,7 @@ namespace Ogre {
         bool mSplitPassesByLightingType;
         bool mSplitNoShadowPasses;
         bool mShadowCastersCannotBeReceivers;
+        bool mRetainSortOrder;
 
         RenderableListener* mRenderableListener;
     public:
@@ -275,6 +276,21 @@ namespace Ogre {
         */
         bool getShadowCastersCannotBeReceivers(void) const;
 
+        /** Sets whether the sorted lists are kept from one frame to the next, so 
+            that the next sort only has to deal with what has changed.
+        @remarks
+            This helps views which queue nearly the same renderables at nearly 
+            the same depths every frame, such as those of a static camera. It 
+            does not help if the queue is shared by views which differ a lot,
+            for example several cameras or shadow textures rendered in turn.
+        @see QueuedRenderableCollection::setRetainSortOrder
+        */
+        void setRetainSortOrder(bool retain);
+
+        /** Gets whether the sorted lists are kept from one frame to the next.
+        */
+        bool getRetainSortOrder(void) const;
+
         /** Set a renderable listener on the queue.
         @remarks
             There can only be a single renderable listener on the queue, since
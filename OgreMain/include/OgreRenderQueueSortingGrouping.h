@@ -195,47 +195,80 @@ namespace Ogre {
         /** Map of pass to renderable lists, this is a grouping by pass. */
         typedef map<Pass*, RenderableList*, PassGroupLess>::type PassGroupRenderableMap;
 
-        /// Functor for accessing sort value 1 for radix sort (Pass)
-        struct RadixSortFunctorPass
-        {
-            uint32 operator()(const RenderablePass& p) const
-            {
-                return p.pass->getHash();
-            }
-        };
+        typedef ParallelRadixSort<RenderablePassList> RadixSorter;
 
-        /// Radix sorter for accessing sort value 1 (Pass)
-        static RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
-
-        /// Functor for descending sort value 2 for radix sort (distance)
-        struct RadixSortFunctorDistance
+        /// Functor for the radix sort key, descending distance then pass
+        struct RadixSortFunctorDistancePass
         {
             const Camera* camera;
 
-            RadixSortFunctorDistance(const Camera* cam)
+            RadixSortFunctorDistancePass(const Camera* cam)
                 : camera(cam)
             {
             }
 
-            float operator()(const RenderablePass& p) const
+            uint64 operator()(const RenderablePass& p) const
             {
                 // Sort DESCENDING by depth (ie far objects first), use negative distance
                 // here because radix sorter always dealing with accessing sort
-                return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
+                float depth = static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
+                // Same depth, sort by pass hash (pass, then texture unit changes)
+                return (static_cast<uint64>(RadixSorter::floatToKey(depth)) << 32) | 
+                    p.pass->getHash();
             }
         };
 
-        /// Radix sorter for sort value 2 (distance)
-        static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
+        /// Radix sorter for the sorted list, owned so collections can be sorted at once
+        RadixSorter mRadixSorter;
 
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
+        /// Whether the previous sort order is used as the start of the next sort
+        bool mRetainSortOrder;
+
+        /// Item of the retained sort, with its key
+        struct RetainedEntry
+        {
+            uint64 key;
+            Renderable* renderable;
+            Pass* pass;
+        };
+        /// Orders retained items by key
+        struct RetainedEntryLess
+        {
+            bool operator()(const RetainedEntry& a, const RetainedEntry& b) const
+            {
+                return a.key < b.key;
+            }
+        };
+        typedef vector<RetainedEntry>::type RetainedEntryList;
+        /// Hash table slot giving the position of an item in the previous sort
+        struct RetainedSlot
+        {
+            Renderable* renderable;
+            Pass* pass;
+            uint32 position;
+        };
+        typedef vector<RetainedSlot>::type RetainedSlotList;
+
+        /// Items of the previous sort still queued, then the items new this time
+        RetainedEntryList mRetainedKept;
+        RetainedEntryList mRetainedAdded;
+        /// Open addressing table of the previous sort order, only holds pointer values
+        RetainedSlotList mRetainedTable;
+        /// Number of items in the previous sort
+        size_t mRetainedCount;
 
         /// Grouped 
         PassGroupRenderableMap mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
 
+        /// Sort starting from the order of the previous sort
+        void sortRetained(const Camera* cam);
+        /// Position of an item in the previous sort, or mRetainedCount if it was not there
+        size_t findRetainedPosition(Renderable* rend, Pass* pass) const;
+
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
@@ -277,6 +310,23 @@ namespace Ogre {
             mOrganisationMode |= om; 
         }
 
+        /** Sets whether the sort order is kept from one sort to the next.
+        @remarks
+            When a view changes little from frame to frame, the same renderables
+            are queued in nearly the same order every time. If this is enabled the
+            sorted list of the previous frame is kept, the renderables which are 
+            queued again are put in their previous order, which is then corrected
+            with an insertion sort, and those new to this frame are sorted on their
+            own and merged in. Large changes fall back on a full sort.
+        @par
+            The gain is lost if the collection is used for views which differ 
+            a lot, e.g. by several cameras in turn. Items at the same depth may 
+            come out in a different order than with a full sort.
+        */
+        void setRetainSortOrder(bool retain);
+        /// Gets whether the sort order is kept from one sort to the next
+        bool getRetainSortOrder(void) const { return mRetainSortOrder; }
+
         /// Add a renderable to the collection using a given pass
         void addRenderable(Pass* pass, Renderable* rend);
         
@@ -444,6 +494,19 @@ namespace Ogre {
             mShadowCastersNotReceivers = ind;
         }
 
+        /** Sets whether the sort order of the collections is kept from one sort
+            to the next.
+        @see QueuedRenderableCollection::setRetainSortOrder
+        */
+        void setRetainSortOrder(bool retain)
+        {
+            mSolidsBasic.setRetainSortOrder(retain);
+            mSolidsDiffuseSpecular.setRetainSortOrder(retain);
+            mSolidsDecal.setRetainSortOrder(retain);
+            mSolidsNoShadowReceive.setRetainSortOrder(retain);
+            mTransparents.setRetainSortOrder(retain);
+        }
+
         /** Merge group of renderables. 
         */
         void merge( const RenderPriorityGroup* rhs );
@@ -476,6 +539,8 @@ namespace Ogre {
         bool mShadowsEnabled;
         /// Bitmask of the organisation modes requested (for new priority groups)
         uint8 mOrganisationMode;
+        /// Whether sort orders are kept between sorts (for new priority groups)
+        bool mRetainSortOrder;
 
 
     public:
@@ -489,6 +554,7 @@ namespace Ogre {
             , mShadowCastersNotReceivers(shadowCastersNotReceivers)
             , mShadowsEnabled(true)
             , mOrganisationMode(0)
+            , mRetainSortOrder(false)
         {
         }
 
@@ -531,6 +597,8 @@ namespace Ogre {
                     pPriorityGrp->resetOrganisationModes();
                     pPriorityGrp->addOrganisationMode((QueuedRenderableCollection::OrganisationMode)mOrganisationMode);
                 }
+                if (mRetainSortOrder)
+                    pPriorityGrp->setRetainSortOrder(true);
 
                 mPriorityGroups.insert(PriorityMap::value_type(priority, pPriorityGrp));
             }
@@ -625,6 +693,20 @@ namespace Ogre {
                 i->second->setShadowCastersCannotBeReceivers(ind);
             }
         }
+        /** Sets whether the sort order of the collections is kept from one sort
+            to the next.
+        @see QueuedRenderableCollection::setRetainSortOrder
+        */
+        void setRetainSortOrder(bool retain)
+        {
+            mRetainSortOrder = retain;
+            PriorityMap::iterator i, iend;
+            iend = mPriorityGroups.end();
+            for (i = mPriorityGroups.begin(); i != iend; ++i)
+            {
+                i->second->setRetainSortOrder(retain);
+            }
+        }
         /** Reset the organisation modes required for the solids in this group. 
         @remarks
             You can only do this when the group is empty, ie after clearing the 
@@ -705,6 +787,8 @@ namespace Ogre {
                         pDstPriorityGrp->resetOrganisationModes();
                         pDstPriorityGrp->addOrganisationMode((QueuedRenderableCollection::OrganisationMode)mOrganisationMode);
                     }
+                    if (mRetainSortOrder)
+                        pDstPriorityGrp->setRetainSortOrder(true);
 
                     mPriorityGroups.insert(PriorityMap::value_type(priority, pDstPriorityGrp));
                 }
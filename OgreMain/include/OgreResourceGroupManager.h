@@ -422,6 +422,20 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+        /// Whether groups are prepared on the WorkQueue, see setParallelGroupLoading
+        bool mParallelGroupLoading;
+        /// Whether scripts are prepared on the WorkQueue, see setParallelScriptParsing
+        bool mParallelScriptParsing;
+
+        /** Prepares or loads a list of resources of a group in order on this thread,
+            firing the events for each of them.
+        */
+        void processResourceList(LoadUnloadResourceList& resources, const String& groupName,
+            bool load);
+        /** Prepares or loads a group, preparing the resources sharing a loading order
+            in parallel, see setParallelGroupLoading.
+        */
+        void processResourceGroupInParallel(const String& name, bool load, bool worldGeom);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -552,6 +566,48 @@ namespace Ogre {
         void loadResourceGroup(const String& name, bool loadMainResources = true, 
             bool loadWorldGeom = true);
 
+        /** Sets whether prepareResourceGroup and loadResourceGroup prepare resources in parallel.
+        @remarks
+            When enabled, the resources of a group are processed one loading order
+            (see ResourceManager::getLoadingOrder) at a time. The resources sharing
+            a loading order don't depend on each other, so they are all prepared
+            at once on the WorkQueue of Root, which covers reading their files and
+            the rest of the work done by Resource::prepare. Back on the calling thread
+            they are then loaded one after the other, as that is the part which
+            may need the render system, before moving on to the next loading order.
+            ResourceGroupListener events are fired on the calling thread
+            for every resource as usual, so progress reporting is unchanged.
+        @par
+            This requires resource preparation to be thread safe, as it is when
+            OGRE_THREAD_SUPPORT is enabled. Resources with a manual loader are
+            always prepared on the calling thread. The locks of this class are
+            released while the workers run, so the group should not be modified
+            from other threads in the meantime.
+        @note
+            Disabled by default. Groups are processed serially when there is no
+            WorkQueue either.
+        */
+        void setParallelGroupLoading(bool enabled) { mParallelGroupLoading = enabled; }
+        /** Gets whether resource groups are prepared in parallel, see setParallelGroupLoading. */
+        bool getParallelGroupLoading(void) const { return mParallelGroupLoading; }
+
+        /** Sets whether initialiseResourceGroup parses scripts in parallel.
+        @remarks
+            When enabled, the scripts of a group are all read into memory on the
+            calling thread, then ScriptLoader::prepareScript is called for all of them
+            at once on the WorkQueue of Root. For ScriptCompilerManager that is the
+            lexing and parsing. The scripts are then parsed one after the other on the
+            calling thread with ScriptLoader::parsePreparedScript, in the usual order,
+            so imports and overrides behave as before and ResourceGroupListener gets
+            the same events.
+        @note
+            Disabled by default. Scripts are parsed serially when there is no
+            WorkQueue either.
+        */
+        void setParallelScriptParsing(bool enabled) { mParallelScriptParsing = enabled; }
+        /** Gets whether scripts are parsed in parallel, see setParallelScriptParsing. */
+        bool getParallelScriptParsing(void) const { return mParallelScriptParsing; }
+
         /** Unloads a resource group.
         @remarks
             This method unloads all the resources that have been declared as
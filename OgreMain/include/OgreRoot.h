@@ -144,6 +144,10 @@ namespace Ogre
         bool mIsInitialised;
 
         WorkQueue* mWorkQueue;
+#if OGRE_THREAD_SUPPORT
+        /// Thread which created the Root
+        OGRE_THREAD_ID_TYPE mMainThread;
+#endif
 
         ///Tells whether blend indices information needs to be passed to the GPU
         bool mIsBlendIndicesGpuRedundant;
@@ -1044,6 +1048,13 @@ namespace Ogre
         */
         WorkQueue* getWorkQueue() const { return mWorkQueue; }
 
+        /** Returns whether the calling thread is the one which created the Root (internal use only).
+        @remarks
+            This is the thread expected to render the frames, as opposed to the
+            worker threads of the WorkQueue. Always true without thread support.
+        */
+        bool _isMainThread(void) const;
+
         /** Replace the current work queue with an alternative. 
             You can use this method to replace the internal implementation of
             WorkQueue with  your own, e.g. to externalise the processing of 
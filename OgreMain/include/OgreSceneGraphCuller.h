@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneGraphCuller_H__
+#define __SceneGraphCuller_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreWorkQueue.h"
+#include "OgreVector3.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    struct VisibleObjectsBoundsInfo;
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Finds the visible objects of a SceneNode hierarchy using several threads.
+    @remarks
+        SceneNode::_findVisibleObjects walks the hierarchy recursively and tests
+        every node against the camera in turn. This class flattens the nodes
+        in the same depth-first order, splits them into fixed size chunks and
+        tests the chunks on the threads of the WorkQueue. Each chunk collects the
+        objects of its visible nodes into its own local queue, and the local 
+        queues are then merged into the RenderQueue in chunk order, so the result
+        does not depend on the number of threads or on scheduling.
+    @par
+        As in the recursive walk, the descendants of a culled node are left out
+        whatever their own bounds, so cameras whose test is not consistent down
+        the hierarchy, such as occlusion or portal cameras, find the same nodes.
+        Each node records where its subtree ends in the flattened list: a chunk
+        skips the subtrees culled within it, and the merge skips those culled
+        by an earlier chunk. Only the bounds tests run on the workers: the 
+        objects are passed to RenderQueue::processVisibleObject on the 
+        calling thread, because many
+        MovableObject implementations update hardware buffers or call listeners
+        while they are queued.
+    */
+    class _OgreExport SceneGraphCuller : public SceneMgtAlloc
+    {
+    public:
+        SceneGraphCuller();
+        ~SceneGraphCuller();
+
+        /** Find the visible objects below the given node.
+        @remarks
+            The parameters are the same as those of SceneNode::_findVisibleObjects,
+            with the addition of the WorkQueue to use. If that is null all the 
+            work is done on the calling thread.
+        */
+        void findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes, 
+            bool onlyShadowCasters, WorkQueue* workQueue);
+
+        /** Sets the number of nodes tested by a single thread at once (default 512).
+        */
+        void setBatchSize(size_t size) { mBatchSize = size; }
+        /// Gets the number of nodes tested by a single thread at once
+        size_t getBatchSize() const { return mBatchSize; }
+
+    protected:
+        typedef vector<SceneNode*>::type NodeList;
+        typedef vector<MovableObject*>::type ObjectList;
+
+        /// Results of testing one chunk of nodes
+        struct LocalQueue
+        {
+            /// Nodes found visible, for debug and bounding box display
+            NodeList nodes;
+            /// Index in mNodes of each visible node
+            vector<size_t>::type nodeIndices;
+            /// End in objects of the objects of each visible node
+            vector<size_t>::type objectEnds;
+            /// Objects attached to the visible nodes, in traversal order
+            ObjectList objects;
+            /// End of the subtree of a node culled in this chunk which goes on past it, or 0
+            size_t culledEnd;
+            /// World bounds of the chunk's nodes, for Camera's batch test
+            vector<Vector3>::type centres;
+            vector<Vector3>::type halfSizes;
+            vector<uint32>::type visibilityMask;
+        };
+        typedef vector<LocalQueue>::type LocalQueueList;
+
+        /// Tests a range of chunks against the camera
+        class CullTask : public WorkQueue::ParallelTask
+        {
+        public:
+            SceneGraphCuller* mCuller;
+            const Camera* mCamera;
+            void execute(size_t begin, size_t end);
+        };
+
+        /// All the nodes in the hierarchy, in depth first order
+        NodeList mNodes;
+        /// Index in mNodes one past the last descendant of each node
+        vector<size_t>::type mSubtreeEnds;
+        /// One local queue per chunk, reused between calls
+        LocalQueueList mLocalQueues;
+        size_t mBatchSize;
+
+        /// Add a node and its descendants to mNodes
+        void addNodes(SceneNode* node);
+        /// Test a single chunk of nodes
+        void cullChunk(size_t chunk, const Camera* cam);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneGraphUpdater_H__
+#define __SceneGraphUpdater_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreWorkQueue.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Updates a SceneNode hierarchy one depth level at a time, using
+        structure-of-arrays transform storage.
+    @remarks
+        The recursive Node::_update visits one node at a time and follows parent
+        pointers for every derived transform. This class instead gathers the
+        nodes which need updating into lists ordered by their depth in the 
+        hierarchy, copies their local transforms and their parents' derived 
+        transforms into contiguous arrays, and combines them in batches. Since
+        nodes on the same level are independent of each other, each level is 
+        split across the threads of the WorkQueue.
+    @par
+        The derived positions, orientations and scales are identical to those
+        produced by Node::updateFromParentImpl. Attached objects are notified 
+        and world bounds are merged afterwards, deepest level first, and 
+        Node::Listener::nodeUpdated is called for every updated node once the 
+        whole hierarchy is up to date.
+    @note
+        Only the standard SceneNode update is reproduced, scene managers whose
+        nodes override Node::_update or updateFromParentImpl should not use it.
+    */
+    class _OgreExport SceneGraphUpdater : public SceneMgtAlloc
+    {
+    public:
+        SceneGraphUpdater();
+        ~SceneGraphUpdater();
+
+        /** Update the given node and all of its descendants which need it.
+        @param root The top of the hierarchy, usually the root scene node
+        @param queue The WorkQueue used to process levels in parallel, if null
+            all the work is done on the calling thread
+        */
+        void update(SceneNode* root, WorkQueue* queue);
+
+        /** Sets the minimum number of nodes processed by a single thread at once.
+        @remarks
+            Levels with fewer dirty nodes than this are processed on the calling
+            thread. The default is 256.
+        */
+        void setBatchSize(size_t size) { mBatchSize = size; }
+        /// Gets the minimum number of nodes processed by a single thread at once
+        size_t getBatchSize() const { return mBatchSize; }
+
+    protected:
+        typedef vector<SceneNode*>::type NodeList;
+        typedef vector<Real>::type RealArray;
+        typedef vector<uint8>::type FlagArray;
+
+        /// Transforms of the nodes on one depth level, in structure-of-arrays form
+        struct TransformArrays
+        {
+            RealArray posX, posY, posZ;
+            RealArray rotW, rotX, rotY, rotZ;
+            RealArray sclX, sclY, sclZ;
+
+            void resize(size_t n);
+        };
+
+        /// All the nodes visited on a single depth level of the hierarchy
+        struct DepthLevel
+        {
+            /// Nodes visited on this level, with the parentHasChanged flag they were reached with
+            NodeList visited;
+            FlagArray parentChanged;
+            /// The visited nodes whose derived transform must be recalculated
+            NodeList dirty;
+            /// Local transforms of the dirty nodes
+            TransformArrays local;
+            /// Derived transforms of the parents of the dirty nodes
+            TransformArrays parent;
+            /// Calculated derived transforms of the dirty nodes
+            TransformArrays derived;
+            /// Whether each dirty node inherits orientation and scale
+            FlagArray inheritOrientation;
+            FlagArray inheritScale;
+        };
+        typedef vector<DepthLevel>::type DepthLevelList;
+
+        /// Processes a range of the dirty nodes of one level
+        class LevelTask : public WorkQueue::ParallelTask
+        {
+        public:
+            DepthLevel* mLevel;
+            void execute(size_t begin, size_t end);
+        };
+
+        DepthLevelList mLevels;
+        /// Number of levels in use for the current update
+        size_t mNumLevels;
+        size_t mBatchSize;
+
+        /// Walk the hierarchy gathering nodes by depth, as Node::_update does
+        void gatherLevels(SceneNode* root);
+        /// Copy transforms of dirty nodes into the arrays
+        static void gatherTransforms(DepthLevel& level, size_t begin, size_t end);
+        /// Combine the local and parent transforms
+        static void combineTransforms(DepthLevel& level, size_t begin, size_t end);
+        /// Write the derived transforms back to the nodes
+        static void scatterTransforms(DepthLevel& level, size_t begin, size_t end);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -870,6 +870,14 @@ namespace Ogre {
         /// Visibility mask used to show / hide objects
         uint32 mVisibilityMask;
         bool mFindVisibleObjects;
+        /// Batched scene graph update, only allocated when parallel updates are enabled
+        SceneGraphUpdater* mSceneGraphUpdater;
+        /// Parallel culling, only allocated when enabled
+        SceneGraphCuller* mSceneGraphCuller;
+        /// Parallel entity animation, only allocated when enabled
+        EntityAnimationUpdater* mEntityAnimationUpdater;
+        /// Poses shared between entities, only allocated when enabled
+        AnimationPoseCache* mAnimationPoseCache;
 
         /// Suppress render state changes?
         bool mSuppressRenderStateChanges;
@@ -3379,6 +3387,87 @@ namespace Ogre {
         */
         virtual bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+        /** Sets whether the scene graph is updated one depth level at a time in
+            parallel, rather than recursively.
+        @remarks
+            When enabled, _updateSceneGraph uses a SceneGraphUpdater which gathers
+            the nodes to update into arrays ordered by depth and splits every level
+            across the threads of Root's WorkQueue. The derived transforms are the
+            same either way, but Node::Listener::nodeUpdated is only called once the
+            whole graph has been updated. This pays off for scenes with many
+            thousands of nodes; it should not be used by scene managers whose nodes
+            override Node::_update.
+        */
+        void setParallelSceneGraphUpdate(bool enabled);
+
+        /** Gets whether the scene graph is updated one depth level at a time in parallel.
+        */
+        bool getParallelSceneGraphUpdate(void) const { return mSceneGraphUpdater != 0; }
+
+        /// Gets the updater of the scene graph, null unless parallel update is enabled
+        SceneGraphUpdater* _getSceneGraphUpdater(void) const { return mSceneGraphUpdater; }
+
+        /** Sets whether _findVisibleObjects tests the scene nodes against the
+            camera on several threads.
+        @remarks
+            When enabled, the nodes are tested in chunks on the threads of Root's
+            WorkQueue using a SceneGraphCuller, and the objects of the visible
+            nodes are then queued in the same order as the recursive search would.
+            Scene managers which override _findVisibleObjects are not affected.
+        */
+        void setParallelCulling(bool enabled);
+
+        /** Gets whether _findVisibleObjects tests the scene nodes on several threads.
+        */
+        bool getParallelCulling(void) const { return mSceneGraphCuller != 0; }
+
+        /** Sets whether the animation of the visible entities is updated on
+            several threads.
+        @remarks
+            When enabled, entities found visible queue themselves in an
+            EntityAnimationUpdater instead of updating their animation straight
+            away, and _renderScene then updates them all once the visible
+            objects have been found. The skeleton poses are computed on the
+            threads of Root's WorkQueue, while software skinning, which locks
+            hardware buffers, stays on the rendering thread. The bone matrices
+            are the same either way.
+        */
+        void setParallelAnimation(bool enabled);
+
+        /** Gets whether the animation of the visible entities is updated on several threads.
+        */
+        bool getParallelAnimation(void) const { return mEntityAnimationUpdater != 0; }
+
+        /** Updates the animation of the entities queued by _findVisibleObjects.
+        @remarks
+            Called by _renderScene, and does nothing unless parallel animation
+            is enabled. It is only needed by those who call _findVisibleObjects
+            themselves.
+        */
+        void _updateEntityAnimations(void);
+
+        /// Gets the queue of entities to animate, null unless parallel animation is enabled
+        EntityAnimationUpdater* _getEntityAnimationUpdater(void) const { return mEntityAnimationUpdater; }
+
+        /** Sets whether entities posed identically in a frame share the
+            evaluation of their pose.
+        @remarks
+            When enabled, the skeletal entities of this scene manager look
+            their bone matrices up in an AnimationPoseCache before evaluating
+            them, so a crowd playing the same animations at the same time
+            positions is posed once per frame. Entities whose bones are needed
+            for something other than the bone matrices, such as objects
+            attached to them, keep evaluating their own pose.
+        */
+        void setAnimationPoseCaching(bool enabled);
+
+        /** Gets whether entities posed identically in a frame share the evaluation of their pose.
+        */
+        bool getAnimationPoseCaching(void) const { return mAnimationPoseCache != 0; }
+
+        /// Gets the cache of shared poses, null unless pose caching is enabled
+        AnimationPoseCache* getAnimationPoseCache(void) const { return mAnimationPoseCache; }
+
         /** Set whether to automatically normalise normals on objects whenever they
             are scaled.
         @remarks
@@ -3574,10 +3663,55 @@ namespace Ogre {
         IlluminationRenderStage _getCurrentRenderStage() {return mIlluminationStage;}
     };
 
-    /** Default implementation of IntersectionSceneQuery. */
+    /** Default implementation of IntersectionSceneQuery.
+    @remarks
+        This uses sweep and prune: the world bounding boxes of the objects are
+        kept sorted by their minimum along one axis, so only the objects whose
+        extents overlap along that axis are compared. The sorted list is kept
+        between executions and brought up to date with an insertion sort,
+        which costs little when the objects have not moved much, so running
+        the query every frame is roughly linear in the number of objects plus
+        the number of overlaps along the axis. Adding or removing objects
+        makes the next execution sort from scratch.
+    @par
+        The axis is the one along which the objects are the most spread out,
+        reconsidered at every execution.
+    @par
+        Pairs are reported in the order of the sweep, not in the order of the
+        objects in the scene.
+    */
     class _OgreExport DefaultIntersectionSceneQuery : 
         public IntersectionSceneQuery
     {
+    protected:
+        /// World bounding box of an object, in the sweep order
+        struct Proxy
+        {
+            MovableObject* movable;
+            float minimum[3];
+            float maximum[3];
+        };
+        typedef vector<Proxy>::type ProxyList;
+        typedef vector<MovableObject*>::type MovableObjectList;
+
+        /// Proxies sorted by minimum along mAxis
+        ProxyList mProxies;
+        /** Objects matching the query at the last execution, in scene order,
+            to tell whether mProxies still holds the same set. Only compared,
+            never dereferenced, since they may have been destroyed since. */
+        MovableObjectList mObjects;
+        /// Objects matching the query at this execution, reused between executions
+        MovableObjectList mCurrentObjects;
+        /// Axis the proxies are sorted along
+        int mAxis;
+
+        /// Gathers the objects matching the masks into mCurrentObjects
+        void gatherObjects(void);
+        /// Brings mProxies up to date with mCurrentObjects and sorts them along mAxis
+        void updateProxies(void);
+        /// Reads the world bounding box of an object into a proxy
+        static void readBounds(MovableObject* movable, Proxy& proxy);
+
     public:
         DefaultIntersectionSceneQuery(SceneManager* creator);
         ~DefaultIntersectionSceneQuery();
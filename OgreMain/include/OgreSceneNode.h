@@ -56,6 +56,8 @@ namespace Ogre {
     */
     class _OgreExport SceneNode : public Node
     {
+        friend class SceneGraphUpdater;
+        friend class SceneGraphCuller;
     public:
         typedef OGRE_HashMap<String, MovableObject*> ObjectMap;
         typedef MapIterator<ObjectMap> ObjectIterator;
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreSphere.h"
 #include "OgreRay.h"
+#include "OgreMeshTriangleBVH.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -357,6 +358,10 @@ namespace Ogre {
         MovableObject* movable;
         /// The world fragment, or NULL if this is not a fragment result
         SceneQuery::WorldFragment* worldFragment;
+        /// Whether the distance is that of a triangle hit, see RaySceneQuery::setTriangleIntersection
+        bool hasTriangle;
+        /// The triangle hit, only valid if hasTriangle is true
+        MeshTriangleBVH::Hit triangle;
         /// Comparison operator for sorting
         bool operator < (const RaySceneQueryResultEntry& rhs) const
         {
@@ -373,6 +378,7 @@ namespace Ogre {
         Ray mRay;
         bool mSortByDistance;
         ushort mMaxResults;
+        bool mTriangleIntersection;
         RaySceneQueryResult mResult;
 
     public:
@@ -406,6 +412,23 @@ namespace Ogre {
         /** Gets the maximum number of results returned from the query (only relevant if 
         results are being sorted) */
         virtual ushort getMaxResults(void) const;
+        /** Sets whether entities are tested down to their triangles.
+        @remarks
+            By default the results are based on bounding volumes, as explained in
+            setSortByDistance. When this is enabled, every Entity reported by the
+            scene manager is tested further with Entity::intersectTriangles: it
+            is dropped if the ray misses all its triangles, otherwise its distance
+            becomes that of the nearest triangle and the details of that triangle
+            are given in the result entry. Other movable objects and world
+            fragments are left as they are.
+        @par
+            This applies to the version of execute which returns the results as a
+            collection, so sorting and the maximum number of results work on the
+            exact distances.
+        */
+        virtual void setTriangleIntersection(bool enabled);
+        /** Gets whether entities are tested down to their triangles. */
+        virtual bool getTriangleIntersection(void) const;
         /** Executes the query, returning the results back in one list.
         @remarks
             This method executes the scene query as configured, gathers the results
@@ -418,6 +418,21 @@ namespace Ogre
 
         // A pointer to the specific compiler instance used
         OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+        // Returns the compiler of this thread, set up to compile
+        ScriptCompiler* getThreadCompiler();
+
+        // A parsed script in binary form, and whether it was used since the cache was loaded
+        struct ScriptCacheEntry
+        {
+            String blob;
+            bool used;
+            ScriptCacheEntry() : used(false) {}
+        };
+        // Parsed scripts, keyed by the hash of their contents
+        typedef map<String, ScriptCacheEntry>::type ScriptCacheMap;
+        ScriptCacheMap mScriptCache;
+        bool mScriptCacheEnabled;
+        bool mScriptCacheDirty;
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -455,6 +470,53 @@ namespace Ogre
         const StringVector& getScriptPatterns(void) const;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, const String& groupName);
+        /// @copydoc ScriptLoader::prepareScript
+        Any prepareScript(DataStreamPtr& stream);
+        /// @copydoc ScriptLoader::parsePreparedScript
+        void parsePreparedScript(DataStreamPtr& stream, const String& groupName, const Any& prepared);
+
+        /** Lexes and parses a script, going through the script cache if it is enabled.
+        @param stream The contents of the script
+        @param source The name of the script, given to the nodes for error reporting
+        */
+        ConcreteNodeListPtr _parseConcreteNodes(const DataStreamPtr& stream, const String& source);
+
+        /** Sets whether scripts are parsed through the script cache.
+        @remarks
+            Lexing and parsing is where most of the time of compiling scripts goes.
+            The cache keeps the parsed form of every script in a compact binary form,
+            keyed by a hash of the contents of the script, so that a script which is 
+            unchanged since the cache was saved is only deserialised. A script which
+            has changed hashes differently and is parsed again.
+        @par
+            The concrete nodes are cached rather than the result of the translation,
+            as imports, variables and inheritance are resolved after that against
+            the other scripts. The cache is kept in memory, use saveScriptCache
+            and loadScriptCache to keep it across runs.
+        */
+        void setScriptCacheEnabled(bool enabled);
+        /** Gets whether scripts are parsed through the script cache. */
+        bool getScriptCacheEnabled(void) const { return mScriptCacheEnabled; }
+        /** Returns true if scripts were added to the cache since it was loaded. */
+        bool isScriptCacheDirty(void) const { return mScriptCacheDirty; }
+        /** Removes all the scripts from the cache. */
+        void clearScriptCache(void);
+        /** Saves the script cache to a stream.
+        @remarks
+            Only the scripts parsed or found in the cache since it was loaded
+            are saved, so that the cache does not keep growing with every
+            version of the scripts which has been edited away. Save it once all
+            the scripts you use have been parsed.
+        @note
+            The cache is meant for the machine it was saved on, it is not
+            portable across endianness.
+        */
+        void saveScriptCache(DataStreamPtr stream) const;
+        /** Loads the script cache from a stream, replacing its contents.
+        @remarks
+            A cache saved by a different version of the parser is ignored.
+        */
+        void loadScriptCache(DataStreamPtr stream);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
 
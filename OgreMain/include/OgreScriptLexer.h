@@ -80,6 +80,14 @@ namespace Ogre {
 
         /** Tokenizes the given input and returns the list of tokens found */
         ScriptTokenListPtr tokenize(const String &str, const String &source);
+        /** Tokenizes the given characters and returns the list of tokens found */
+        ScriptTokenListPtr tokenize(const char *str, size_t length, const String &source);
+        /** Tokenizes the contents of a stream and returns the list of tokens found.
+        @remarks
+            The contents of a MemoryDataStream (such as a mapped file) are 
+            tokenized in place, those of other streams are read first.
+        */
+        ScriptTokenListPtr tokenize(const DataStreamPtr &stream, const String &source);
     private: // Private utility operations
         void setToken(const String &lexeme, uint32 line, const String &source, ScriptTokenList *tokens);
         bool isWhitespace(Ogre::String::value_type c) const;
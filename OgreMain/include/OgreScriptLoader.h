@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreDataStream.h"
 #include "OgreStringVector.h"
+#include "OgreAny.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -77,6 +78,32 @@ namespace Ogre {
         */
         virtual void parseScript(DataStreamPtr& stream, const String& groupName) = 0;
 
+        /** Does the part of parsing a script which depends on nothing but the script.
+        @remarks
+            When ResourceGroupManager parses the scripts of a group in parallel, it calls
+            this for all of them at once from worker threads, then calls parsePreparedScript
+            with the result for each script in order on its own thread. Override it along
+            with parsePreparedScript to move work such as tokenising off that thread. It
+            must be thread safe, and must not create anything as the script might still
+            be skipped.
+        @param stream The script, which is in memory. It is rewound before being parsed.
+        @return Whatever parsePreparedScript needs, the default does nothing and returns
+            an empty Any.
+        */
+        virtual Any prepareScript(DataStreamPtr& stream)
+        { (void)stream; return Any(); }
+
+        /** Parses a script after prepareScript was called for it.
+        @param stream The script
+        @param groupName The name of a resource group which should be used if any resources
+            are created during the parse of this script.
+        @param prepared What prepareScript returned, empty if it failed, in which case
+            the script should be parsed as usual so the error is reported here.
+        */
+        virtual void parsePreparedScript(DataStreamPtr& stream, const String& groupName,
+            const Any& prepared)
+        { (void)prepared; parseScript(stream, groupName); }
+
         /** Gets the relative loading order of scripts of this type.
         @remarks
             There are dependencies between some kinds of scripts, and to enforce
@@ -101,6 +101,22 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+                SKELETON_ANIMATION_TRACK_COMPRESSED = 0x4120,
+                // [v1.10+, instead of SKELETON_ANIMATION_TRACK_KEYFRAME]
+                // All the keyframes of the track, see CompressedTransformTrack
+
+                    // unsigned short numKeyFrames  : Number of keyframes, at least 1
+                    // float times[numKeyFrames]    : The time positions (seconds)
+                    // unsigned short channels      : Which channels vary: rotation (1), translate (2), scale (4)
+                    // Quaternion rotate            : Rotation of all the keyframes, if it doesn't vary
+                    // unsigned short rotates[numKeyFrames * 3] : Quantised rotations, if they vary
+                    // Vector3 translateBase        : Translation of all the keyframes, or minimum translation if it varies
+                    // Vector3 translateStep        : Translation per quantisation step, if it varies
+                    // unsigned short translates[numKeyFrames * 3] : Quantised translations, if they vary
+                    // Vector3 scaleBase            : As for translations
+                    // Vector3 scaleStep            : As for translations, if it varies
+                    // unsigned short scales[numKeyFrames * 3] : As for translations, if they vary
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
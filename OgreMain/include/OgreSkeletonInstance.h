@@ -117,6 +117,12 @@ namespace Ogre {
         /// @copydoc Resource::getGroup
         const String& getGroup(void) const;
 
+        /** Gets the evaluator which poses this skeleton without going through
+            the Bone nodes, creating it if need be.
+        @see SkeletonPoseEvaluator
+        */
+        SkeletonPoseEvaluator* _getPoseEvaluator(void);
+
     protected:
         /// Pointer back to master Skeleton
         SkeletonPtr mSkeleton;
@@ -145,6 +151,9 @@ namespace Ogre {
         /// TagPoint automatic handles
         unsigned short mNextTagPointAutoHandle;
 
+        /// Pose evaluator, created on demand
+        SkeletonPoseEvaluator* mPoseEvaluator;
+
         void cloneBoneAndChildren(Bone* source, Bone* parent);
         /** Overridden from Skeleton
         */
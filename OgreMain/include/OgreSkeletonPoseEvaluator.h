@@ -0,0 +1,149 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SkeletonPoseEvaluator_H__
+#define __SkeletonPoseEvaluator_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Evaluates the pose of a skeleton straight into a bone matrix palette.
+    @remarks
+        Skeleton::setAnimationState and Skeleton::_getBoneMatrices pose the
+        Bone nodes one at a time, through the general Node update. This class
+        keeps the local transforms of the bones in separate arrays of
+        components instead, with the bones ordered by depth so that every bone
+        comes after its parent. The enabled animation states are blended into
+        these arrays with their blend masks, then the hierarchy is concatenated
+        by OptimisedUtil::concatenateBoneTransforms, several bones at a time,
+        which also writes the bone matrices.
+    @par
+        The results are those of the Bone nodes, but the nodes themselves are
+        left untouched, so their derived transforms are not to be relied on
+        while the pose is evaluated here. Skeletons with manually controlled
+        bones, or with bones which don't inherit the orientation or the scale
+        of their parent, can't be evaluated; evaluate returns false for them.
+    */
+    class _OgreExport SkeletonPoseEvaluator : public AnimationAlloc
+    {
+    public:
+        /** Constructor.
+        @param skeleton
+            The skeleton to evaluate, which must outlive this object.
+        */
+        SkeletonPoseEvaluator(Skeleton* skeleton);
+        ~SkeletonPoseEvaluator();
+
+        /// Gets the skeleton evaluated
+        Skeleton* getSkeleton(void) const { return mSkeleton; }
+
+        /** Evaluates the pose given by a set of animation states, as
+            Skeleton::setAnimationState followed by Skeleton::_getBoneMatrices
+            would.
+        @param animSet
+            The animation states to apply.
+        @param boneMatrices
+            The bone matrices to write, indexed by bone handle.
+        @return
+            false if the skeleton can't be evaluated here, in which case
+            nothing is written.
+        */
+        bool evaluate(const AnimationStateSet& animSet, Matrix4* boneMatrices);
+
+        /** Tells the bones of the skeleton have been created or destroyed.
+        @remarks
+            The layout is rebuilt on the next evaluation.
+        */
+        void _notifyBonesChanged(void);
+
+    protected:
+        /// Components of the transforms, each stored in an array of its own
+        enum Component
+        {
+            POSITION_X,
+            POSITION_Y,
+            POSITION_Z,
+            ORIENTATION_W,
+            ORIENTATION_X,
+            ORIENTATION_Y,
+            ORIENTATION_Z,
+            SCALE_X,
+            SCALE_Y,
+            SCALE_Z,
+            NUM_COMPONENTS
+        };
+
+        typedef vector<unsigned short>::type IndexList;
+        typedef vector<Bone*>::type BoneList;
+
+        Skeleton* mSkeleton;
+        /// Bones by slot, slot 0 is the root and has no bone
+        BoneList mBones;
+        /// Parent slot of each slot
+        IndexList mParents;
+        /// Bone handle of each slot
+        IndexList mBoneHandles;
+        /// Slot of each bone handle
+        IndexList mSlots;
+        /// Number of elements of the component arrays
+        size_t mStride;
+        /// Transforms relative to the parents
+        Real* mLocalTransforms;
+        /// Transforms relative to the root
+        Real* mDerivedTransforms;
+        /// Inverse binding pose transforms
+        Real* mBindInverseTransforms;
+        bool mLayoutDirty;
+
+        /// Orders the bones and allocates the component arrays
+        void buildLayout(void);
+        void freeTransforms(void);
+        /** Resets the local transforms to the initial state of the bones.
+        @return
+            false if a bone can't be evaluated here.
+        */
+        bool resetTransforms(void);
+        /// Applies an animation, as Animation::apply
+        void applyAnimation(Animation* anim, Real timePos, Real weight,
+            const vector<float>::type* blendMask, Real scale);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
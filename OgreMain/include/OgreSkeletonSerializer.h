@@ -43,6 +43,8 @@ namespace Ogre {
         SKELETON_VERSION_1_0,
         /// OGRE version v1.8+
         SKELETON_VERSION_1_8,
+        /// OGRE version v1.10+, adds compressed keyframes
+        SKELETON_VERSION_1_10,
         
         /// Latest version available
         SKELETON_VERSION_LATEST = 100
@@ -65,6 +67,11 @@ namespace Ogre {
         <LI>Create a Skeleton object and populate it using it's methods.</LI>
         <LI>Call the exportSkeleton method</LI>
         </OL>
+    @par
+        Tracks compressed with NodeAnimationTrack::compress are written compressed
+        from SKELETON_VERSION_1_10, and read back compressed. Earlier versions
+        get the compressed keyframes as plain ones. SKELETON_VERSION_LATEST
+        writes a skeleton without compressed tracks as SKELETON_VERSION_1_8.
     */
     class _OgreExport SkeletonSerializer : public Serializer
     {
@@ -109,14 +116,17 @@ namespace Ogre {
     protected:
         
         void setWorkingVersion(SkeletonVersion ver);
+        /// Returns whether any animation of a skeleton has a compressed track
+        bool hasCompressedTracks(const Skeleton* pSkel) const;
         
         // Internal export methods
         void writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver);
         void writeBone(const Skeleton* pSkel, const Bone* pBone);
         void writeBoneParent(const Skeleton* pSkel, unsigned short boneId, unsigned short parentId);
         void writeAnimation(const Skeleton* pSkel, const Animation* anim, SkeletonVersion ver);
-        void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track);
+        void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track, SkeletonVersion ver);
         void writeKeyFrame(const Skeleton* pSkel, const TransformKeyFrame* key);
+        void writeCompressedKeyFrames(const Skeleton* pSkel, const CompressedTransformTrack* keyFrames);
         void writeSkeletonAnimationLink(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
 
@@ -127,14 +137,16 @@ namespace Ogre {
         void readAnimation(DataStreamPtr& stream, Skeleton* pSkel);
         void readAnimationTrack(DataStreamPtr& stream, Animation* anim, Skeleton* pSkel);
         void readKeyFrame(DataStreamPtr& stream, NodeAnimationTrack* track, Skeleton* pSkel);
+        void readCompressedKeyFrames(DataStreamPtr& stream, NodeAnimationTrack* track, Skeleton* pSkel);
         void readSkeletonAnimationLink(DataStreamPtr& stream, Skeleton* pSkel);
 
         size_t calcBoneSize(const Skeleton* pSkel, const Bone* pBone);
         size_t calcBoneSizeWithoutScale(const Skeleton* pSkel, const Bone* pBone);
         size_t calcBoneParentSize(const Skeleton* pSkel);
         size_t calcAnimationSize(const Skeleton* pSkel, const Animation* pAnim, SkeletonVersion ver);
-        size_t calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack);
+        size_t calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack, SkeletonVersion ver);
         size_t calcKeyFrameSize(const Skeleton* pSkel, const TransformKeyFrame* pKey);
+        size_t calcCompressedKeyFramesSize(const Skeleton* pSkel, const CompressedTransformTrack* keyFrames);
         size_t calcKeyFrameSizeWithoutScale(const Skeleton* pSkel, const TransformKeyFrame* pKey);
         size_t calcSkeletonAnimationLinkSize(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
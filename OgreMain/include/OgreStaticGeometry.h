@@ -154,10 +154,23 @@ namespace Ogre {
         };
         typedef vector<SubMeshLodGeometryLink>::type SubMeshLodGeometryLinkList;
         typedef map<SubMesh*, SubMeshLodGeometryLinkList*>::type SubMeshGeometryLookup;
+        /// Copies of source buffers, taken so that geometry can be built on other threads
+        typedef map<const HardwareBuffer*, vector<uchar>::type>::type SourceDataMap;
+        /// Identifies the geometry added by one call to addEntity or addSceneNode
+        typedef uint32 AdditionId;
+        // forward declarations
+        class LODBucket;
+        class MaterialBucket;
+        class Region;
+
         /// Structure recording a queued submesh for the build
         struct QueuedSubMesh : public BatchedGeometryAlloc
         {
             SubMesh* submesh;
+            /// The call to addEntity or addSceneNode this was queued by
+            AdditionId additionId;
+            /// The region this has been built into, if any
+            Region* region;
             /// Link to LOD list of geometry, potentially optimised
             SubMeshLodGeometryLinkList* geometryLodList;
             String materialName;
@@ -177,11 +190,6 @@ namespace Ogre {
             Vector3 scale;
         };
         typedef vector<QueuedGeometry*>::type QueuedGeometryList;
-        
-        // forward declarations
-        class LODBucket;
-        class MaterialBucket;
-        class Region;
 
         /** A GeometryBucket is a the lowest level bucket where geometry with 
             the same vertex & index format is stored. It also acts as the 
@@ -206,6 +214,15 @@ namespace Ogre {
             HardwareIndexBuffer::IndexType mIndexType;
             /// Maximum vertex indexable
             size_t mMaxVertexIndex;
+            /// Contents of the vertex buffers, between _prepareBuild and _createBuffers
+            vector<vector<uchar>::type>::type mPendingVertexBuffers;
+            /// Contents of the index buffer, between _prepareBuild and _createBuffers
+            vector<uchar>::type mPendingIndexes;
+
+            /// Get the contents of a source buffer, from the copies if given
+            const uchar* lockSource(HardwareBuffer* buf, const SourceDataMap* sources);
+            /// Release the contents of a source buffer got from lockSource
+            void unlockSource(HardwareBuffer* buf, const SourceDataMap* sources);
 
             template<typename T>
             void copyIndexes(const T* src, T* dst, size_t count, size_t indexOffset)
@@ -246,6 +263,19 @@ namespace Ogre {
             bool assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /** Copy the source buffers of the queued geometry which aren't 
+                in the map yet into it. */
+            void _readSources(SourceDataMap& sources) const;
+            /** Fill in the contents of the buffers in memory.
+            @remarks
+                This doesn't touch any hardware buffer when the copies of 
+                the sources are given, so it can run on any thread.
+            @param stencilShadows Whether to build for stencil shadows
+            @param sources Copies of the source buffers, or null to read them
+            */
+            void _prepareBuild(bool stencilShadows, const SourceDataMap* sources);
+            /// Create the hardware buffers from the contents filled in by _prepareBuild
+            void _createBuffers(bool stencilShadows);
             /// Dump contents for diagnostics
             void dump(std::ofstream& of) const;
         };
@@ -284,6 +314,8 @@ namespace Ogre {
             void assign(QueuedGeometry* qsm);
             /// Build
             void build(bool stencilShadows);
+            /// Load the material, the part of the build before the geometry
+            void _loadMaterial(void);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -361,6 +393,8 @@ namespace Ogre {
             void assign(QueuedSubMesh* qsm, ushort atLod);
             /// Build
             void build(bool stencilShadows);
+            /// Build the edge list, the part of the build after the geometry
+            void _buildEdgeList(bool stencilShadows);
             /// Add children to the render queue
             void addRenderables(RenderQueue* queue, uint8 group, 
                 Real lodValue);
@@ -441,6 +475,9 @@ namespace Ogre {
             void assign(QueuedSubMesh* qmesh);
             /// Build this region
             void build(bool stencilShadows);
+            /** Create the node and the LOD buckets, and assign the queued meshes 
+                to them, the part of the build before the buckets are built. */
+            void _createBuckets(void);
             /// Get the region ID of this region
             uint32 getID(void) const { return mRegionID; }
             /// Get the centre point of the region
@@ -506,6 +543,8 @@ namespace Ogre {
         uint32 mVisibilityFlags;
 
         QueuedSubMeshList mQueuedSubMeshes;
+        /// Identifier to give to the next addition
+        AdditionId mNextAdditionId;
 
         /// List of geometry which has been optimised for SubMesh use
         /// This is the primary storage used for cleaning up later
@@ -519,6 +558,18 @@ namespace Ogre {
             
         /// Map of regions
         RegionMap mRegionMap;
+        typedef set<uint32>::type RegionIndexSet;
+        /// Regions whose queued submeshes changed since the last build
+        RegionIndexSet mDirtyRegions;
+        typedef vector<Region*>::type RegionList;
+
+        /** Build a set of regions which have had their meshes assigned.
+        @remarks
+            The geometry of all the regions is prepared in parallel on the
+            WorkQueue, while the materials and hardware buffers are dealt with
+            on this thread.
+        */
+        void buildRegions(const RegionList& regions, bool stencilShadows);
 
         /** Virtual method for getting a region most suitable for the
             passed in bounds. Can be overridden by subclasses.
@@ -547,6 +598,11 @@ namespace Ogre {
         /** Get the centre of an indexed region.
         */
         virtual Vector3 getRegionCentre(ushort x, ushort y, ushort z);
+        /** Queue the submeshes of an Entity under the given addition. */
+        void queueEntity(Entity* ent, const Vector3& position,
+            const Quaternion& orientation, const Vector3& scale, AdditionId id);
+        /** Queue the entities of a SceneNode and its children under the given addition. */
+        void queueSceneNode(const SceneNode* node, AdditionId id);
         /** Calculate world bounds from a set of vertex data. */
         virtual AxisAlignedBox calculateBounds(VertexData* vertexData, 
             const Vector3& position, const Quaternion& orientation, 
@@ -607,17 +663,28 @@ namespace Ogre {
             completely safely, and destroy the Entity before destroying 
             this StaticGeometry if you like. The Entity passed in is simply 
             used as a definition.
-        @note Must be called before 'build'.
+        @note If this is called after 'build', the next call to 'build' 
+            only rebuilds the region the Entity falls in.
         @param ent The Entity to use as a definition (the Mesh and Materials 
             referenced will be recorded for the build call).
         @param position The world position at which to add this Entity
         @param orientation The world orientation at which to add this Entity
         @param scale The scale at which to add this entity
+        @return An identifier of this addition, to pass to removeAddition
         */
-        virtual void addEntity(Entity* ent, const Vector3& position,
+        virtual AdditionId addEntity(Entity* ent, const Vector3& position,
             const Quaternion& orientation = Quaternion::IDENTITY, 
             const Vector3& scale = Vector3::UNIT_SCALE);
 
+        /** Removes the geometry added by a call to addEntity or addSceneNode.
+        @remarks
+            The Entity objects the geometry was added from need not exist any 
+            more. If the geometry has been built, the next call to 'build' 
+            only rebuilds the regions it was in.
+        @param id The identifier returned by addEntity or addSceneNode
+        */
+        virtual void removeAddition(AdditionId id);
+
         /** Adds all the Entity objects attached to a SceneNode and all it's
             children to the static geometry.
         @remarks
@@ -632,11 +699,14 @@ namespace Ogre {
             of rendering <i>both</i> the original objects and their new static
             versions! We don't do this for you incase you are preparing this 
             in advance and so don't want the originals detached yet. 
-        @note Must be called before 'build'.
+        @note As with addEntity, if this is called after 'build', the next 
+            call to 'build' only rebuilds the regions the entities fall in.
         @param node Pointer to the node to use to provide a set of Entity 
             templates
+        @return An identifier of this addition, covering all the entities
+            of the sub-tree, to pass to removeAddition
         */
-        virtual void addSceneNode(const SceneNode* node);
+        virtual AdditionId addSceneNode(const SceneNode* node);
 
         /** Build the geometry. 
         @remarks
@@ -644,9 +714,15 @@ namespace Ogre {
             options which have been set, this method constructs the batched 
             geometry structures required. The batches are added to the scene 
             and will be rendered unless you specifically hide them.
-        @note
-            Once you have called this method, you can no longer add any more 
-            entities.
+        @par
+            The first build creates all the regions. After that, entities can 
+            still be added or removed, and calling this again only rebuilds 
+            the regions they affect. Call destroy() first to rebuild everything, 
+            for example after changing the region dimensions.
+        @par
+            The vertex and index data of the regions is prepared in parallel
+            on the WorkQueue, while the hardware buffers are created on the 
+            calling thread.
         */
         virtual void build(void);
 
@@ -109,6 +109,18 @@ namespace Ogre {
         */
         VertexData* clone(bool copyData = true, HardwareBufferManagerBase* mgr = 0) const;
 
+        /** Moves the declaration, binding and vertex buffers of this data to another manager.
+        @remarks
+            Every buffer is copied to a new one of the same size and usage created by
+            the given manager, and the old ones are released. This is how geometry built
+            in system memory, e.g. by a DefaultHardwareBufferManagerBase on a background
+            thread, is moved to the hardware. Unlike clone, the data stays where it is,
+            so whatever points at it remains valid.
+        @param mgr The manager to create the new declaration, binding and buffers with
+        @param useShadowBuffers Whether the new buffers have a shadow buffer
+        */
+        void transferBuffers(HardwareBufferManagerBase* mgr, bool useShadowBuffers);
+
         /** Modifies the vertex data to be suitable for use for rendering shadow geometry.
         @remarks
             Preparing vertex data to generate a shadow volume involves firstly ensuring that the 
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "OgreAny.h"
+#include "OgreAtomicScalar.h"
 #include "OgreSharedPtr.h"
 #include "OgreCommon.h"
 #include "Threading/OgreThreadHeaders.h"
@@ -345,6 +346,39 @@ namespace Ogre
         */
         virtual void shutdown() = 0;
 
+        /** Interface to a body of data-parallel work, to be run by parallelFor.
+        @remarks
+            The work is described as a range of item indices which can be split
+            into disjoint sub-ranges and processed independently. Calls to execute 
+            may therefore happen concurrently from several threads, so implementations 
+            must not write to state shared between items without synchronisation, and
+            must not raise exceptions.
+        */
+        class _OgreExport ParallelTask
+        {
+        public:
+            ParallelTask() {}
+            virtual ~ParallelTask() {}
+            /// Process the items with indices in [begin, end)
+            virtual void execute(size_t begin, size_t end) = 0;
+        };
+
+        /** Process a range of items in parallel, and wait for the result.
+        @remarks
+            The range [0, count) is split into chunks of at most grainSize items,
+            which are handed out to the worker threads. The calling thread processes 
+            chunks as well, and only returns once every chunk is complete, so it is 
+            safe to call this even when all workers are busy.
+        @par
+            As with any request, the task runs outside the main render thread and
+            must not make render system calls unless the workers are allowed to.
+            The base implementation processes the whole range on the calling thread.
+        @param task The work to perform
+        @param count The number of items in the range
+        @param grainSize The maximum number of items handed to a thread at once
+        */
+        virtual void parallelFor(ParallelTask* task, size_t count, size_t grainSize = 1);
+
         /** Get a channel ID for a given channel name. 
         @remarks
             Channels are assigned on a first-come, first-served basis and are
@@ -456,6 +490,8 @@ namespace Ogre
         virtual unsigned long getResponseProcessingTimeLimit() const { return mResposeTimeLimitMS; }
         /// @copydoc WorkQueue::setResponseProcessingTimeLimit
         virtual void setResponseProcessingTimeLimit(unsigned long ms) { mResposeTimeLimitMS = ms; }
+        /// @copydoc WorkQueue::parallelFor
+        virtual void parallelFor(ParallelTask* task, size_t count, size_t grainSize = 1);
     protected:
         String mName;
         size_t mWorkerThreadCount;
@@ -571,6 +607,30 @@ namespace Ogre
         
 
         bool processIdleRequests();
+
+        /// Shared state of a single parallelFor call, kept alive by the requests referring to it
+        struct _OgreExport ParallelForState : public UtilityAlloc
+        {
+            ParallelTask* mTask;
+            size_t mCount;
+            size_t mGrainSize;
+            size_t mNumChunks;
+            AtomicScalar<size_t> mNextChunk;
+            AtomicScalar<size_t> mCompletedChunks;
+
+            /// Process chunks until there are none left to claim
+            void run();
+        };
+        typedef SharedPtr<ParallelForState> ParallelForStatePtr;
+
+        /// Request handler which lets worker threads take part in a parallelFor
+        class _OgreExport ParallelForHandler : public RequestHandler
+        {
+        public:
+            Response* handleRequest(const Request* req, const WorkQueue* srcQ);
+        };
+        ParallelForHandler mParallelForHandler;
+        uint16 mParallelForChannel;
     };
 
 
@@ -0,0 +1,244 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OgreJobWorkQueue_H__
+#define __OgreJobWorkQueue_H__
+
+#include "../OgreWorkQueue.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Work queue with a work stealing job system, for fine grained per-frame work.
+    @remarks
+        DefaultWorkQueue keeps a single request list behind a mutex which all the
+        workers wait on, which suits long background tasks such as resource
+        loading but costs too much for many small jobs. This queue gives each
+        worker thread, and the thread which called startup, a deque of jobs of its
+        own. A thread pushes and pops jobs at one end of its deque without taking
+        any lock, and idle threads steal from the other end of the deques of the
+        others. Jobs added from any other thread go through a shared list.
+    @par
+        Jobs are grouped with a JobCounter, which counts the jobs not yet
+        finished. waitForCounter runs jobs on the calling thread until the count
+        drops to zero, so the main thread helps rather than blocking, and a job
+        may itself add jobs and wait for them. A job can also be made to wait for
+        a counter before it starts, which is how dependencies between jobs are
+        expressed.
+    @par
+        parallelFor is implemented on top of the jobs: the range is split in
+        halves recursively, so the threads which run out of work steal the
+        largest remaining pieces.
+    @par
+        The request / response API of WorkQueue works as with DefaultWorkQueue;
+        the workers process requests whenever they have no jobs to run. Since a
+        request may take long, it is better to keep requests to a few dedicated
+        queues, or to give this queue enough workers.
+    @note
+        Without thread support, jobs are run immediately when they are added.
+    */
+    class _OgreExport JobWorkQueue : public DefaultWorkQueueBase
+    {
+    public:
+        class JobCounter;
+
+        /** A unit of work for the job system.
+        @remarks
+            Jobs are owned by the caller, and must stay alive until they have been
+            run, which is known from their counter. They run on any thread, and
+            must not raise exceptions.
+        */
+        class _OgreExport Job
+        {
+        public:
+            Job() : mCounter(0), mNextWaiting(0) {}
+            virtual ~Job() {}
+            /// Performs the work
+            virtual void execute() = 0;
+
+        private:
+            friend class JobWorkQueue;
+            /// Counter to signal once the job has run
+            JobCounter* mCounter;
+            /// Next job waiting on the same counter
+            Job* mNextWaiting;
+        };
+
+        /** Counts the jobs which are still to run, to wait for them or to make
+            other jobs depend on them.
+        @remarks
+            The counter is incremented when a job is added with it, and
+            decremented once the job has run. It must outlive the jobs added with
+            it or depending on it.
+        */
+        class _OgreExport JobCounter
+        {
+        public:
+            JobCounter();
+            ~JobCounter();
+
+            /// Whether all the jobs added with this counter have run
+            bool isDone() const { return mCount.get() == 0 && mSignalling.get() == 0; }
+
+        private:
+            friend class JobWorkQueue;
+            JobCounter(const JobCounter&);
+            JobCounter& operator=(const JobCounter&);
+
+            AtomicScalar<size_t> mCount;
+            /// Number of threads which may still touch the counter after decrementing it
+            AtomicScalar<size_t> mSignalling;
+            /// Jobs waiting for the count to drop to zero, guarded by mWaitingMutex
+            Job* mWaiting;
+            OGRE_MUTEX(mWaitingMutex);
+        };
+
+        JobWorkQueue(const String& name = BLANKSTRING);
+        virtual ~JobWorkQueue();
+
+        /// @copydoc WorkQueue::startup
+        virtual void startup(bool forceRestart = true);
+        /// @copydoc WorkQueue::shutdown
+        virtual void shutdown();
+        /// Main function for each thread spawned.
+        virtual void _threadMain();
+        /// @copydoc DefaultWorkQueueBase::_processNextRequest
+        virtual void _processNextRequest();
+
+        /** Adds a job to be run by any of the threads.
+        @param job
+            The job, which must stay alive until it has run.
+        @param counter
+            Counter to increment now and decrement once the job has run, may be
+            null if nobody needs to know.
+        @param dependency
+            Counter which must be done before the job is started, may be null.
+            The job is held aside until then, without taking up any thread.
+        */
+        void addJob(Job* job, JobCounter* counter = 0, JobCounter* dependency = 0);
+
+        /** Runs jobs on the calling thread until a counter is done.
+        @remarks
+            The jobs run are not necessarily those of the counter, but the call
+            returns as soon as the counter is done and the job being run, if any,
+            has finished.
+        */
+        void waitForCounter(JobCounter* counter);
+
+        /// @copydoc WorkQueue::parallelFor
+        virtual void parallelFor(ParallelTask* task, size_t count, size_t grainSize = 1);
+
+    protected:
+        /** Job deque of a thread, a Chase-Lev deque of fixed capacity.
+        @remarks
+            Only the owning thread pushes and pops, at the bottom; other threads
+            steal from the top. The positions only grow, and the slots are used
+            modulo the capacity.
+        */
+        struct JobDeque : public UtilityAlloc
+        {
+            static const ptrdiff_t CAPACITY = 4096;
+
+            AtomicScalar<ptrdiff_t> mTop;
+            AtomicScalar<ptrdiff_t> mBottom;
+            Job* volatile mJobs[CAPACITY];
+#if OGRE_THREAD_SUPPORT
+            /// The owning thread
+            OGRE_THREAD_ID_TYPE mThread;
+#endif
+
+            JobDeque() : mTop(0), mBottom(0) {}
+            /// Pushes a job by the owner, fails if the deque is full
+            bool push(Job* job);
+            /// Pops the last job pushed by the owner, null if empty
+            Job* pop();
+            /// Steals the oldest job from another thread, null if empty or lost to another thief
+            Job* steal();
+            /// Whether there is anything to take, from any thread
+            bool isEmpty() const { return mBottom.get() <= mTop.get(); }
+        };
+        typedef vector<JobDeque*>::type JobDequeList;
+        typedef deque<Job*>::type JobList;
+
+        /// Deques of the startup thread (first) and the workers
+        JobDequeList mDeques;
+        /// Jobs added from threads without a deque, guarded by mSharedJobsMutex
+        JobList mSharedJobs;
+        AtomicScalar<size_t> mSharedJobCount;
+        OGRE_MUTEX(mSharedJobsMutex);
+
+        /// Gives out the deques to the workers as they start
+        AtomicScalar<size_t> mNextWorkerIndex;
+        AtomicScalar<size_t> mStartedWorkers;
+        /// Rotates the first victim of steals, to spread them
+        AtomicScalar<size_t> mStealSeed;
+
+        /// Incremented whenever work is added, so idle workers can tell they missed some
+        AtomicScalar<size_t> mWorkSignal;
+        AtomicScalar<size_t> mSleepingWorkers;
+        OGRE_MUTEX(mSleepMutex);
+        OGRE_THREAD_SYNCHRONISER(mSleepCondition);
+
+        size_t mNumThreadsRegisteredWithRS;
+        OGRE_MUTEX(mInitMutex);
+        OGRE_THREAD_SYNCHRONISER(mInitSync);
+#if OGRE_THREAD_SUPPORT
+        typedef vector<OGRE_THREAD_TYPE*>::type WorkerThreadList;
+        WorkerThreadList mWorkers;
+#endif
+
+        /// Index of the deque of the calling thread, or mDeques.size() if it has none
+        size_t getThreadDequeIndex() const;
+        /// Makes a job available to the threads, or runs it if nobody else can
+        void pushJob(Job* job);
+        /// Takes a job for the thread with the given deque index
+        Job* findJob(size_t dequeIndex);
+        /// Runs a job and signals its counter
+        void runJob(Job* job);
+        /// Decrements a counter, releasing the jobs waiting for it
+        void signalCounter(JobCounter* counter);
+        /// Processes one request, returns whether there was one
+        bool processNextRequest();
+        /// Wakes a sleeping worker, if any, after adding work
+        void wakeWorker();
+
+        /// @copydoc DefaultWorkQueueBase::notifyWorkers
+        virtual void notifyWorkers();
+    };
+
+    /** @} */
+    /** @} */
+
+}
+
+#endif
@@ -778,6 +778,24 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForApply(void)
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        if (mInterpolationMode == IM_SPLINE)
+        {
+            for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                i->second->_buildInterpolationSplines();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_notifyContainer(AnimationContainer* c)
     {
         mContainer = c;
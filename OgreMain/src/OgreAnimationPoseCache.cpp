@@ -0,0 +1,198 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreAnimationPoseCache.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreSkeletonPoseEvaluator.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationState.h"
+
+namespace Ogre {
+
+    //---------------------------------------------------------------------
+    bool AnimationPoseCache::StateKey::operator<(const StateKey& rhs) const
+    {
+        if (animation != rhs.animation)
+            return animation < rhs.animation;
+        if (timePos != rhs.timePos)
+            return timePos < rhs.timePos;
+        if (weight != rhs.weight)
+            return weight < rhs.weight;
+        if (blendMaskHash != rhs.blendMaskHash)
+            return blendMaskHash < rhs.blendMaskHash;
+        return blendMask < rhs.blendMask;
+    }
+    //---------------------------------------------------------------------
+    bool AnimationPoseCache::PoseKey::operator<(const PoseKey& rhs) const
+    {
+        if (skeleton != rhs.skeleton)
+            return skeleton < rhs.skeleton;
+        if (blendMode != rhs.blendMode)
+            return blendMode < rhs.blendMode;
+        return std::lexicographical_compare(states.begin(), states.end(),
+            rhs.states.begin(), rhs.states.end());
+    }
+    //---------------------------------------------------------------------
+    AnimationPoseCache::AnimationPoseCache()
+        : mFrameNumber(std::numeric_limits<unsigned long>::max())
+        , mNumHits(0)
+        , mTimeQuantum(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    AnimationPoseCache::~AnimationPoseCache()
+    {
+    }
+    //---------------------------------------------------------------------
+    Real AnimationPoseCache::quantise(Real timePos) const
+    {
+        if (mTimeQuantum <= 0)
+            return timePos;
+        return Math::Floor(timePos / mTimeQuantum + 0.5f) * mTimeQuantum;
+    }
+    //---------------------------------------------------------------------
+    size_t AnimationPoseCache::getNumPoses(void) const
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        return mPoses.size();
+    }
+    //---------------------------------------------------------------------
+    size_t AnimationPoseCache::getNumHits(void) const
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        return mNumHits;
+    }
+    //---------------------------------------------------------------------
+    void AnimationPoseCache::clear(void)
+    {
+        OGRE_LOCK_MUTEX(mMutex);
+        mPoses.clear();
+        mNumHits = 0;
+        mFrameNumber = std::numeric_limits<unsigned long>::max();
+    }
+    //---------------------------------------------------------------------
+    bool AnimationPoseCache::getBoneMatrices(SkeletonInstance* skeleton,
+        const AnimationStateSet& animSet, unsigned long frameNumber, Matrix4* boneMatrices)
+    {
+        // The pose of manual bones isn't given by the animation states
+        if (skeleton->hasManualBones())
+            return false;
+
+        PoseKey key;
+        key.skeleton = skeleton->getHandle();
+        key.blendMode = skeleton->getBlendMode();
+        ConstEnabledAnimationStateIterator stateIt = animSet.getEnabledAnimationStateIterator();
+        while (stateIt.hasMoreElements())
+        {
+            const AnimationState* animState = stateIt.getNext();
+            StateKey state;
+            state.animation = skeleton->_getAnimationImpl(animState->getAnimationName());
+            // Ignored when posing as well
+            if (!state.animation)
+                continue;
+            state.timePos = quantise(animState->getTimePosition());
+            state.weight = animState->getWeight();
+            const AnimationState::BoneBlendMask* blendMask = animState->getBlendMask();
+            state.blendMaskHash = 0;
+            if (blendMask && !blendMask->empty())
+            {
+                state.blendMaskHash = FastHash((const char*)&(*blendMask)[0],
+                    int(blendMask->size() * sizeof(float)));
+                state.blendMask = *blendMask;
+            }
+            key.states.push_back(state);
+        }
+
+        size_t numBones = skeleton->getNumBones();
+        const MatrixList* pose = 0;
+        {
+            OGRE_LOCK_MUTEX(mMutex);
+            if (mFrameNumber != frameNumber)
+            {
+                mPoses.clear();
+                mNumHits = 0;
+                mFrameNumber = frameNumber;
+            }
+            PoseMap::const_iterator i = mPoses.find(key);
+            if (i != mPoses.end())
+            {
+                pose = &i->second;
+                ++mNumHits;
+            }
+        }
+
+        // Poses are not removed within a frame, so this one can be read unlocked
+        if (pose)
+        {
+            memcpy(boneMatrices, &(*pose)[0], sizeof(Matrix4) * numBones);
+            return true;
+        }
+
+        evaluate(skeleton, animSet, boneMatrices);
+
+        // Another thread may have evaluated the same pose meanwhile, either will do
+        OGRE_LOCK_MUTEX(mMutex);
+        MatrixList& matrices = mPoses[key];
+        if (matrices.empty())
+            matrices.assign(boneMatrices, boneMatrices + numBones);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void AnimationPoseCache::evaluate(SkeletonInstance* skeleton,
+        const AnimationStateSet& animSet, Matrix4* boneMatrices) const
+    {
+        const AnimationStateSet* poseSet = &animSet;
+
+        // Pose at the quantised time positions, so that the result doesn't
+        // depend on which entity gets here first
+        AnimationStateSet quantisedSet;
+        if (mTimeQuantum > 0)
+        {
+            ConstEnabledAnimationStateIterator stateIt = animSet.getEnabledAnimationStateIterator();
+            while (stateIt.hasMoreElements())
+            {
+                const AnimationState* animState = stateIt.getNext();
+                AnimationState* state = quantisedSet.createAnimationState(
+                    animState->getAnimationName(), 0, animState->getLength(),
+                    animState->getWeight(), true);
+                state->setLoop(animState->getLoop());
+                state->setTimePosition(quantise(animState->getTimePosition()));
+                if (animState->hasBlendMask())
+                    state->_setBlendMask(animState->getBlendMask());
+            }
+            poseSet = &quantisedSet;
+        }
+
+        if (!skeleton->_getPoseEvaluator()->evaluate(*poseSet, boneMatrices))
+        {
+            skeleton->setAnimationState(*poseSet);
+            skeleton->_getBoneMatrices(boneMatrices);
+        }
+    }
+
+}
@@ -29,9 +29,11 @@ THE SOFTWARE.
 #include "OgreAnimationTrack.h"
 #include "OgreAnimation.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedTransformTrack.h"
 #include "OgreNode.h"
 #include "OgreMesh.h"
 #include "OgreException.h"
+#include "OgreRoot.h"
 
 namespace Ogre {
 
@@ -354,10 +356,11 @@ namespace Ogre {
     //---------------------------------------------------------------------
     // Node specialisations
     //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
     NodeAnimationTrack::NodeAnimationTrack(Animation* parent, unsigned short handle)
         : AnimationTrack(parent, handle), mTargetNode(0)
         , mSplines(0), mSplineBuildNeeded(false)
-        , mUseShortestRotationPath(true)
+        , mUseShortestRotationPath(true), mCompressed(0), mCompressionTolerance(1e-4f)
     {
     }
     //---------------------------------------------------------------------
@@ -365,13 +368,15 @@ namespace Ogre {
         Node* targetNode)
         : AnimationTrack(parent, handle), mTargetNode(targetNode)
         , mSplines(0), mSplineBuildNeeded(false)
-        , mUseShortestRotationPath(true)
+        , mUseShortestRotationPath(true), mCompressed(0), mCompressionTolerance(1e-4f)
     {
     }
     //---------------------------------------------------------------------
     NodeAnimationTrack::~NodeAnimationTrack()
     {
         OGRE_DELETE_T(mSplines, Splines, MEMCATEGORY_ANIMATION);
+        OGRE_DELETE mCompressed;
+        destroyDecodedKeyFrames();
     }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::getInterpolatedKeyFrame(const TimeIndex& timeIndex, KeyFrame* kf) const
@@ -384,6 +389,12 @@ namespace Ogre {
 
         TransformKeyFrame* kret = static_cast<TransformKeyFrame*>(kf);
 
+        if (mCompressed)
+        {
+            getCompressedInterpolatedKeyFrame(timeIndex, kret);
+            return;
+        }
+
         // Keyframe pointers
         KeyFrame *kBase1, *kBase2;
         TransformKeyFrame *k1, *k2;
@@ -477,19 +488,33 @@ namespace Ogre {
     void NodeAnimationTrack::applyToNode(Node* node, const TimeIndex& timeIndex, Real weight,
         Real scl)
     {
-        // Nothing to do if no keyframes or zero weight or no node
-        if (mKeyFrames.empty() || !weight || !node)
+        if (!node)
             return;
 
+        Vector3 translate, scale;
+        Quaternion rotate;
+        if (_getTransformToApply(timeIndex, weight, scl, translate, rotate, scale))
+        {
+            node->translate(translate);
+            node->rotate(rotate);
+            node->scale(scale);
+        }
+    }
+    //---------------------------------------------------------------------
+    bool NodeAnimationTrack::_getTransformToApply(const TimeIndex& timeIndex, Real weight,
+        Real scl, Vector3& translate, Quaternion& rotate, Vector3& scale) const
+    {
+        // Nothing to do if no keyframes or zero weight
+        if ((mKeyFrames.empty() && !mCompressed) || !weight)
+            return false;
+
         TransformKeyFrame kf(0, timeIndex.getTimePos());
         getInterpolatedKeyFrame(timeIndex, &kf);
 
         // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
-        Vector3 translate = kf.getTranslate() * weight * scl;
-        node->translate(translate);
+        translate = kf.getTranslate() * weight * scl;
 
         // interpolate between no-rotation and full rotation, to point 'weight', so 0 = no rotate, 1 = full
-        Quaternion rotate;
         Animation::RotationInterpolationMode rim =
             mParent->getRotationInterpolationMode();
         if (rim == Animation::RIM_LINEAR)
@@ -500,9 +525,8 @@ namespace Ogre {
         {
             rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
         }
-        node->rotate(rotate);
 
-        Vector3 scale = kf.getScale();
+        scale = kf.getScale();
         // Not sure how to modify scale for cumulative anims... leave it alone
         //scale = ((Vector3::UNIT_SCALE - kf.getScale()) * weight) + Vector3::UNIT_SCALE;
         if (scale != Vector3::UNIT_SCALE)
@@ -512,8 +536,8 @@ namespace Ogre {
             else if (weight != 1.0f)
                 scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * weight;
         }
-        node->scale(scale);
 
+        return true;
     }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::buildInterpolationSplines(void) const
@@ -536,14 +560,26 @@ namespace Ogre {
         splines->rotationSpline.clear();
         splines->scaleSpline.clear();
 
-        KeyFrameList::const_iterator i, iend;
-        iend = mKeyFrames.end(); // precall to avoid overhead
-        for (i = mKeyFrames.begin(); i != iend; ++i)
+        if (mCompressed)
         {
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
-            splines->positionSpline.addPoint(kf->getTranslate());
-            splines->rotationSpline.addPoint(kf->getRotation());
-            splines->scaleSpline.addPoint(kf->getScale());
+            for (size_t k = 0; k < mCompressed->getNumKeyFrames(); ++k)
+            {
+                splines->positionSpline.addPoint(mCompressed->getTranslate(k));
+                splines->rotationSpline.addPoint(mCompressed->getRotation(k));
+                splines->scaleSpline.addPoint(mCompressed->getScale(k));
+            }
+        }
+        else
+        {
+            KeyFrameList::const_iterator i, iend;
+            iend = mKeyFrames.end(); // precall to avoid overhead
+            for (i = mKeyFrames.begin(); i != iend; ++i)
+            {
+                TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
+                splines->positionSpline.addPoint(kf->getTranslate());
+                splines->rotationSpline.addPoint(kf->getRotation());
+                splines->scaleSpline.addPoint(kf->getScale());
+            }
         }
 
         splines->positionSpline.recalcTangents();
@@ -571,20 +607,40 @@ namespace Ogre {
         mSplineBuildNeeded = true;
     }
     //---------------------------------------------------------------------
+    void NodeAnimationTrack::_buildInterpolationSplines(void) const
+    {
+        if (mSplineBuildNeeded)
+        {
+            buildInterpolationSplines();
+        }
+    }
+    //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
     {
-        KeyFrameList::const_iterator i = mKeyFrames.begin();
-        for (; i != mKeyFrames.end(); ++i)
+        unsigned short numKeyFrames = getNumKeyFrames();
+        for (unsigned short k = 0; k < numKeyFrames; ++k)
         {
             // look for keyframes which have any component which is non-zero
             // Since exporters can be a little inaccurate sometimes we use a
             // tolerance value rather than looking for nothing
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
-            Vector3 trans = kf->getTranslate();
-            Vector3 scale = kf->getScale();
+            Vector3 trans, scale;
+            Quaternion rotation;
+            if (mCompressed)
+            {
+                trans = mCompressed->getTranslate(k);
+                scale = mCompressed->getScale(k);
+                rotation = mCompressed->getRotation(k);
+            }
+            else
+            {
+                TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(mKeyFrames[k]);
+                trans = kf->getTranslate();
+                scale = kf->getScale();
+                rotation = kf->getRotation();
+            }
             Vector3 axis;
             Radian angle;
-            kf->getRotation().ToAngleAxis(angle, axis);
+            rotation.ToAngleAxis(angle, axis);
             Real tolerance = 1e-3f;
             if (!trans.positionEquals(Vector3::ZERO, tolerance) ||
                 !scale.positionEquals(Vector3::UNIT_SCALE, tolerance) ||
@@ -600,6 +656,11 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void NodeAnimationTrack::optimise(void)
     {
+        // Compressed tracks store unchanging channels once already, and
+        // their keyframes take little room
+        if (mCompressed)
+            return;
+
         // Eliminate duplicate keyframes from 2nd to penultimate keyframe
         // NB only eliminate middle keys from sequences of 5+ identical keyframes
         // since we need to preserve the boundary keys in place, and we need
@@ -665,7 +726,12 @@ namespace Ogre {
         return static_cast<TransformKeyFrame*>(createKeyFrame(timePos));
     }
     //--------------------------------------------------------------------------
-    TransformKeyFrame* NodeAnimationTrack::getNodeKeyFrame(unsigned short index) const
+    const TransformKeyFrame* NodeAnimationTrack::getNodeKeyFrame(unsigned short index) const
+    {
+        return static_cast<const TransformKeyFrame*>(getKeyFrame(index));
+    }
+    //--------------------------------------------------------------------------
+    TransformKeyFrame* NodeAnimationTrack::getNodeKeyFrame(unsigned short index)
     {
         return static_cast<TransformKeyFrame*>(getKeyFrame(index));
     }
@@ -676,13 +742,20 @@ namespace Ogre {
             newParent->createNodeTrack(mHandle, mTargetNode);
         newTrack->mUseShortestRotationPath = mUseShortestRotationPath;
         populateClone(newTrack);
+        newTrack->mCompressionTolerance = mCompressionTolerance;
+        if (mCompressed)
+            newTrack->_setCompressedKeyFrames(OGRE_NEW CompressedTransformTrack(*mCompressed));
         return newTrack;
     }
     //--------------------------------------------------------------------------
     void NodeAnimationTrack::_applyBaseKeyFrame(const KeyFrame* b)
     {
         const TransformKeyFrame* base = static_cast<const TransformKeyFrame*>(b);
-        
+
+        // Keyframes can't be changed in place once compressed
+        bool compressed = isCompressed();
+        decompress();
+
         for (KeyFrameList::iterator i = mKeyFrames.begin(); i != mKeyFrames.end(); ++i)
         {
             TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
@@ -690,7 +763,339 @@ namespace Ogre {
             kf->setRotation(base->getRotation().Inverse() * kf->getRotation());
             kf->setScale(kf->getScale() * (Vector3::UNIT_SCALE / base->getScale()));
         }
-            
+
+        if (compressed)
+            compress(mCompressionTolerance);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::compress(Real tolerance)
+    {
+        if (mCompressed || mKeyFrames.empty())
+            return;
+
+        size_t numKeyFrames = mKeyFrames.size();
+        vector<Real>::type times(numKeyFrames);
+        vector<Quaternion>::type rotations(numKeyFrames);
+        vector<Vector3>::type translates(numKeyFrames);
+        vector<Vector3>::type scales(numKeyFrames);
+        for (size_t k = 0; k < numKeyFrames; ++k)
+        {
+            const TransformKeyFrame* kf = static_cast<const TransformKeyFrame*>(mKeyFrames[k]);
+            times[k] = kf->getTime();
+            rotations[k] = kf->getRotation();
+            translates[k] = kf->getTranslate();
+            scales[k] = kf->getScale();
+        }
+
+        CompressedTransformTrack* keyFrames = OGRE_NEW CompressedTransformTrack();
+        keyFrames->compress(numKeyFrames, &times[0], &rotations[0], &translates[0], &scales[0],
+            tolerance);
+        mCompressionTolerance = tolerance;
+        _setCompressedKeyFrames(keyFrames);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::decompress(void)
+    {
+        if (!mCompressed)
+            return;
+
+        // Other threads may be sampling the compressed keyframes
+        assert((!Root::getSingletonPtr() || Root::getSingleton()._isMainThread()) &&
+            "Compressed animation tracks can't be changed from worker threads");
+
+        destroyDecodedKeyFrames();
+        CompressedTransformTrack* keyFrames = mCompressed;
+        mCompressed = 0;
+        const CompressedTransformTrack::TimeList& times = keyFrames->getTimes();
+        mKeyFrames.reserve(times.size());
+        for (size_t k = 0; k < times.size(); ++k)
+        {
+            TransformKeyFrame* kf = OGRE_NEW TransformKeyFrame(this, times[k]);
+            kf->setRotation(keyFrames->getRotation(k));
+            kf->setTranslate(keyFrames->getTranslate(k));
+            kf->setScale(keyFrames->getScale(k));
+            mKeyFrames.push_back(kf);
+        }
+        OGRE_DELETE keyFrames;
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_setCompressedKeyFrames(CompressedTransformTrack* keyFrames)
+    {
+        AnimationTrack::removeAllKeyFrames();
+        destroyDecodedKeyFrames();
+        OGRE_DELETE mCompressed;
+        mCompressed = keyFrames;
+
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //--------------------------------------------------------------------------
+    unsigned short NodeAnimationTrack::getNumKeyFrames(void) const
+    {
+        if (mCompressed)
+            return static_cast<unsigned short>(mCompressed->getNumKeyFrames());
+        return AnimationTrack::getNumKeyFrames();
+    }
+    //--------------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::getKeyFrame(unsigned short index) const
+    {
+        if (!mCompressed)
+            return AnimationTrack::getKeyFrame(index);
+
+        // Decoding leaves the compressed keyframes alone, so the track may
+        // still be applied on other threads meanwhile
+        assert (index < mCompressed->getNumKeyFrames() && "Index out of bounds!");
+        decodeKeyFrames();
+        return mDecodedKeyFrames[index];
+    }
+    //--------------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::getKeyFrame(unsigned short index)
+    {
+        // The keyframe may be changed, so it must be the track's own
+        decompress();
+        return AnimationTrack::getKeyFrame(index);
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1,
+        KeyFrame** keyFrame2, unsigned short* firstKeyIndex)
+    {
+        decompress();
+        return AnimationTrack::getKeyFramesAtTime(timeIndex, keyFrame1, keyFrame2, firstKeyIndex);
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::getKeyFramesAtTime(const TimeIndex& timeIndex, KeyFrame** keyFrame1,
+        KeyFrame** keyFrame2, unsigned short* firstKeyIndex) const
+    {
+        if (!mCompressed)
+            return AnimationTrack::getKeyFramesAtTime(timeIndex, keyFrame1, keyFrame2, firstKeyIndex);
+
+        size_t k1, k2;
+        Real t = getCompressedKeyFramesAtTime(timeIndex, k1, k2);
+        decodeKeyFrames();
+        *keyFrame1 = mDecodedKeyFrames[k1];
+        *keyFrame2 = mDecodedKeyFrames[k2];
+        if (firstKeyIndex)
+            *firstKeyIndex = static_cast<unsigned short>(k1);
+        return t;
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::decodeKeyFrames(void) const
+    {
+        OGRE_LOCK_MUTEX(mDecodeMutex);
+        if (!mDecodedKeyFrames.empty())
+            return;
+
+        const CompressedTransformTrack::TimeList& times = mCompressed->getTimes();
+        KeyFrameList keyFrames;
+        keyFrames.reserve(times.size());
+        for (size_t k = 0; k < times.size(); ++k)
+        {
+            // Detached from the track, which setting them would notify
+            TransformKeyFrame* kf = OGRE_NEW TransformKeyFrame(0, times[k]);
+            kf->setRotation(mCompressed->getRotation(k));
+            kf->setTranslate(mCompressed->getTranslate(k));
+            kf->setScale(mCompressed->getScale(k));
+            keyFrames.push_back(kf);
+        }
+        mDecodedKeyFrames.swap(keyFrames);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::destroyDecodedKeyFrames(void)
+    {
+        for (KeyFrameList::iterator i = mDecodedKeyFrames.begin(); i != mDecodedKeyFrames.end(); ++i)
+        {
+            OGRE_DELETE *i;
+        }
+        mDecodedKeyFrames.clear();
+    }
+    //--------------------------------------------------------------------------
+    KeyFrame* NodeAnimationTrack::createKeyFrame(Real timePos)
+    {
+        decompress();
+        return AnimationTrack::createKeyFrame(timePos);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::removeKeyFrame(unsigned short index)
+    {
+        decompress();
+        AnimationTrack::removeKeyFrame(index);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::removeAllKeyFrames(void)
+    {
+        destroyDecodedKeyFrames();
+        OGRE_DELETE mCompressed;
+        mCompressed = 0;
+        AnimationTrack::removeAllKeyFrames();
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_collectKeyFrameTimes(vector<Real>::type& keyFrameTimes)
+    {
+        if (!mCompressed)
+        {
+            AnimationTrack::_collectKeyFrameTimes(keyFrameTimes);
+            return;
+        }
+
+        const CompressedTransformTrack::TimeList& times = mCompressed->getTimes();
+        for (size_t k = 0; k < times.size(); ++k)
+        {
+            Real timePos = times[k];
+
+            vector<Real>::type::iterator it =
+                std::lower_bound(keyFrameTimes.begin(), keyFrameTimes.end(), timePos);
+            if (it == keyFrameTimes.end() || *it != timePos)
+            {
+                keyFrameTimes.insert(it, timePos);
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_buildKeyFrameIndexMap(const vector<Real>::type& keyFrameTimes)
+    {
+        if (!mCompressed)
+        {
+            AnimationTrack::_buildKeyFrameIndexMap(keyFrameTimes);
+            return;
+        }
+
+        const CompressedTransformTrack::TimeList& times = mCompressed->getTimes();
+        mKeyFrameIndexMap.resize(keyFrameTimes.size() + 1);
+
+        size_t i = 0, j = 0;
+        while (j <= keyFrameTimes.size())
+        {
+            mKeyFrameIndexMap[j] = static_cast<ushort>(i);
+            while (i < times.size() && times[i] <= keyFrameTimes[j])
+                ++i;
+            ++j;
+        }
+    }
+    //--------------------------------------------------------------------------
+    Real NodeAnimationTrack::getCompressedKeyFramesAtTime(const TimeIndex& timeIndex,
+        size_t& keyIndex1, size_t& keyIndex2) const
+    {
+        const CompressedTransformTrack::TimeList& times = mCompressed->getTimes();
+        Real timePos = timeIndex.getTimePos();
+
+        // Find first keyframe after or on current time, in the same way as
+        // getKeyFramesAtTime does
+        size_t i;
+        if (timeIndex.hasKeyIndex())
+        {
+            // Global keyframe index available, map to local keyframe index directly.
+            assert(timeIndex.getKeyIndex() < mKeyFrameIndexMap.size());
+            i = mKeyFrameIndexMap[timeIndex.getKeyIndex()];
+        }
+        else
+        {
+            // Wrap time
+            Real totalAnimationLength = mParent->getLength();
+            assert(totalAnimationLength > 0.0f && "Invalid animation length!");
+
+            if( timePos > totalAnimationLength && totalAnimationLength > 0.0f )
+                timePos = fmod( timePos, totalAnimationLength );
+
+            i = mCompressed->findKeyFrame(timePos);
+        }
+
+        Real t2;
+        if (i == times.size())
+        {
+            // There is no keyframe after this time, wrap back to first
+            keyIndex2 = 0;
+            t2 = mParent->getLength() + times[0];
+
+            // Use last keyframe as previous keyframe
+            --i;
+        }
+        else
+        {
+            keyIndex2 = i;
+            t2 = times[i];
+
+            // Find last keyframe before or on current time
+            if (i != 0 && timePos < times[i])
+            {
+                --i;
+            }
+        }
+
+        keyIndex1 = i;
+        Real t1 = times[i];
+
+        if (t1 == t2)
+        {
+            // Same KeyFrame (only one)
+            return 0.0;
+        }
+        else
+        {
+            return (timePos - t1) / (t2 - t1);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::getCompressedInterpolatedKeyFrame(const TimeIndex& timeIndex,
+        TransformKeyFrame* kf) const
+    {
+        size_t k1, k2;
+        Real t = getCompressedKeyFramesAtTime(timeIndex, k1, k2);
+        const CompressedTransformTrack* keyFrames = mCompressed;
+
+        if (t == 0.0)
+        {
+            // Just use k1
+            kf->setRotation(keyFrames->getRotation(k1));
+            kf->setTranslate(keyFrames->getTranslate(k1));
+            kf->setScale(keyFrames->getScale(k1));
+            return;
+        }
+
+        if (mParent->getInterpolationMode() == Animation::IM_SPLINE)
+        {
+            // Build splines if required
+            if (mSplineBuildNeeded)
+            {
+                buildInterpolationSplines();
+            }
+
+            kf->setRotation( mSplines->rotationSpline.interpolate(k1, t,
+                mUseShortestRotationPath) );
+            kf->setTranslate( mSplines->positionSpline.interpolate(k1, t) );
+            kf->setScale( mSplines->scaleSpline.interpolate(k1, t) );
+            return;
+        }
+
+        // Interpolate linearly, the constant channels need none
+        if (keyFrames->isRotationConstant())
+        {
+            kf->setRotation(keyFrames->getRotation(k1));
+        }
+        else if (mParent->getRotationInterpolationMode() == Animation::RIM_LINEAR)
+        {
+            kf->setRotation( Quaternion::nlerp(t, keyFrames->getRotation(k1),
+                keyFrames->getRotation(k2), mUseShortestRotationPath) );
+        }
+        else //if (rim == Animation::RIM_SPHERICAL)
+        {
+            kf->setRotation( Quaternion::Slerp(t, keyFrames->getRotation(k1),
+                keyFrames->getRotation(k2), mUseShortestRotationPath) );
+        }
+
+        Vector3 base = keyFrames->getTranslate(k1);
+        if (keyFrames->isTranslateConstant())
+            kf->setTranslate(base);
+        else
+            kf->setTranslate( base + ((keyFrames->getTranslate(k2) - base) * t) );
+
+        base = keyFrames->getScale(k1);
+        if (keyFrames->isScaleConstant())
+            kf->setScale(base);
+        else
+            kf->setScale( base + ((keyFrames->getScale(k2) - base) * t) );
     }
     //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
@@ -72,6 +72,8 @@ namespace Ogre {
     void Billboard::setPosition(const Vector3& position)
     {
         mPosition = position;
+        if (mParentSet)
+            mParentSet->_notifyBillboardMoved();
     }
     //-----------------------------------------------------------------------
     void Billboard::setPosition(Real x, Real y, Real z)
@@ -79,6 +81,8 @@ namespace Ogre {
         mPosition.x = x;
         mPosition.y = y;
         mPosition.z = z;
+        if (mParentSet)
+            mParentSet->_notifyBillboardMoved();
     }
     //-----------------------------------------------------------------------
     const Vector3& Billboard::getPosition(void) const
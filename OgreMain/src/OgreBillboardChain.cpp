@@ -75,9 +75,16 @@ namespace Ogre {
         mBoundsDirty(true),
         mIndexContentDirty(true),
         mVertexContentDirty(true),
+        mStreaming(false),
+        mShareBuffers(false),
+        mBatch(0),
+        mBatchGeneration(0),
+        mCurrentCamera(0),
         mRadius(0.0f),
         mTexCoordDir(TCD_U),
         mVertexCameraUsed(0),
+        mVertexEyePosUsed(Vector3::ZERO),
+        mVertexTransformUsed(Matrix4::IDENTITY),
         mFaceCamera(true),
         mNormalBase(Vector3::UNIT_X)
     {
@@ -98,6 +105,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     BillboardChain::~BillboardChain()
     {
+        leaveBatch();
         OGRE_DELETE mVertexData;
         OGRE_DELETE mIndexData;
     }
@@ -107,6 +115,9 @@ namespace Ogre {
         // Allocate enough space for everything
         mChainElementList.resize(mChainCount * mMaxElementsPerChain);
         mVertexData->vertexCount = mChainElementList.size() * 2;
+        mDirtyElements.assign(mChainElementList.size(), false);
+        mDirtyElementList.clear();
+        mElementSlots.assign(mChainElementList.size(), 0);
 
         // Configure chains
         mChainSegmentList.resize(mChainCount);
@@ -231,6 +242,46 @@ namespace Ogre {
         mBuffersNeedRecreating = mIndexContentDirty = mVertexContentDirty = true;
     }
     //-----------------------------------------------------------------------
+    void BillboardChain::setStreamingEnabled(bool streaming)
+    {
+        mStreaming = streaming;
+        if (!mStreaming)
+            leaveBatch();
+        mBuffersNeedRecreating = mIndexContentDirty = mVertexContentDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::setBufferSharingEnabled(bool share)
+    {
+        // The chain moves to another batch when next queued
+        mShareBuffers = share;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::markElementDirty(const ChainSegment& seg, size_t e)
+    {
+        if (!mStreaming)
+        {
+            mVertexContentDirty = true;
+            return;
+        }
+
+        // The neighbours use the element for their direction
+        size_t elements[3] =
+        {
+            (e == 0 ? mMaxElementsPerChain : e) - 1,
+            e,
+            (e + 1 == mMaxElementsPerChain) ? 0 : e + 1
+        };
+        for (size_t i = 0; i < 3; ++i)
+        {
+            size_t index = seg.start + elements[i];
+            if (!mDirtyElements[index])
+            {
+                mDirtyElements[index] = true;
+                mDirtyElementList.push_back(index);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void BillboardChain::addChainElement(size_t chainIndex,
         const BillboardChain::Element& dtls)
     {
@@ -269,13 +320,14 @@ namespace Ogre {
                     seg.tail = mMaxElementsPerChain - 1;
                 else
                     --seg.tail;
+                markElementDirty(seg, seg.tail);
             }
         }
 
         // Set the details
         mChainElementList[seg.start + seg.head] = dtls;
 
-        mVertexContentDirty = true;
+        markElementDirty(seg, seg.head);
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -311,8 +363,10 @@ namespace Ogre {
             --seg.tail;
         }
 
-        // we removed an entry so indexes need updating
-        mVertexContentDirty = true;
+        // we removed an entry so indexes need updating, and the new tail
+        // changes direction
+        if (seg.head != SEGMENT_EMPTY)
+            markElementDirty(seg, seg.tail);
         mIndexContentDirty = true;
         mBoundsDirty = true;
         // tell parent node to update bounds
@@ -383,7 +437,7 @@ namespace Ogre {
 
         mChainElementList[idx] = dtls;
 
-        mVertexContentDirty = true;
+        markElementDirty(seg, idx - seg.start);
         mBoundsDirty = true;
         // tell parent node to update bounds
         if (mParentNode)
@@ -484,7 +538,7 @@ namespace Ogre {
     void BillboardChain::updateVertexBuffer(Camera* cam)
     {
         setupBuffers();
-        
+
         // The contents of the vertex buffer are correct if they are not dirty
         // and the camera used to build the vertex buffer is still the current 
         // camera.
@@ -493,12 +547,12 @@ namespace Ogre {
 
         HardwareVertexBufferSharedPtr pBuffer =
             mVertexData->vertexBufferBinding->getBuffer(0);
+        size_t vertexSize = pBuffer->getVertexSize();
         void* pBufferStart = pBuffer->lock(HardwareBuffer::HBL_DISCARD);
 
         const Vector3& camPos = cam->getDerivedPosition();
         Vector3 eyePos = mParentNode->convertWorldToLocalPosition(camPos);
 
-        Vector3 chainTangent;
         for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
             segi != mChainSegmentList.end(); ++segi)
         {
@@ -507,136 +561,316 @@ namespace Ogre {
             // Skip 0 or 1 element segment counts
             if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
             {
-                size_t laste = seg.head;
                 for (size_t e = seg.head; ; ++e) // until break
                 {
                     // Wrap forwards
                     if (e == mMaxElementsPerChain)
                         e = 0;
 
-                    Element& elem = mChainElementList[e + seg.start];
                     assert (((e + seg.start) * 2) < 65536 && "Too many elements!");
                     uint16 baseIdx = static_cast<uint16>((e + seg.start) * 2);
 
                     // Determine base pointer to vertex #1
                     void* pBase = static_cast<void*>(
-                        static_cast<char*>(pBufferStart) +
-                            pBuffer->getVertexSize() * baseIdx);
+                        static_cast<char*>(pBufferStart) + vertexSize * baseIdx);
+                    writeElementVertices(seg, e, eyePos, pBase);
 
-                    // Get index of next item
-                    size_t nexte = e + 1;
-                    if (nexte == mMaxElementsPerChain)
-                        nexte = 0;
+                    if (e == seg.tail)
+                        break; // last one
 
-                    if (e == seg.head)
-                    {
-                        // No laste, use next item
-                        chainTangent = mChainElementList[nexte + seg.start].position - elem.position;
-                    }
-                    else if (e == seg.tail)
-                    {
-                        // No nexte, use only last item
-                        chainTangent = elem.position - mChainElementList[laste + seg.start].position;
-                    }
-                    else
-                    {
-                        // A mid position, use tangent across both prev and next
-                        chainTangent = mChainElementList[nexte + seg.start].position - mChainElementList[laste + seg.start].position;
+                } // element
+            } // segment valid?
 
-                    }
+        } // each segment
 
-                    Vector3 vP1ToEye;
 
-                    if( mFaceCamera )
-                        vP1ToEye = eyePos - elem.position;
-                    else
-                        vP1ToEye = elem.orientation * mNormalBase;
 
-                    Vector3 vPerpendicular = chainTangent.crossProduct(vP1ToEye);
-                    vPerpendicular.normalise();
-                    vPerpendicular *= (elem.width * 0.5f);
+        pBuffer->unlock();
+        mVertexCameraUsed = cam;
+        mVertexContentDirty = false;
 
-                    Vector3 pos0 = elem.position - vPerpendicular;
-                    Vector3 pos1 = elem.position + vPerpendicular;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::updateBatch(void)
+    {
+        if (mBatch && (mBatch->isShared() != mShareBuffers || !mBatch->isCompatible(this)))
+            leaveBatch();
 
-                    float* pFloat = static_cast<float*>(pBase);
-                    // pos1
-                    *pFloat++ = pos0.x;
-                    *pFloat++ = pos0.y;
-                    *pFloat++ = pos0.z;
+        if (!mBatch)
+        {
+            if (mShareBuffers)
+            {
+                BillboardChainFactory* factory = static_cast<BillboardChainFactory*>(
+                    Root::getSingleton().getMovableObjectFactory(BillboardChainFactory::FACTORY_TYPE_NAME));
+                mBatch = factory->_getSharedBatch(this);
+            }
+            else
+            {
+                mBatch = OGRE_NEW BillboardChainBatch(this, false);
+            }
+            mBatch->_addChain(this);
+            // Nothing written to the new batch yet
+            mVertexContentDirty = mIndexContentDirty = true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::leaveBatch(void)
+    {
+        if (!mBatch)
+            return;
 
-                    pBase = static_cast<void*>(pFloat);
+        if (!mBatch->isShared())
+        {
+            OGRE_DELETE mBatch;
+        }
+        else if (mBatch->_removeChain(this) == 0)
+        {
+            BillboardChainFactory* factory = static_cast<BillboardChainFactory*>(
+                Root::getSingleton().getMovableObjectFactory(BillboardChainFactory::FACTORY_TYPE_NAME));
+            factory->_releaseSharedBatch(mBatch);
+        }
+        mBatch = 0;
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardChain::hasQuads(void) const
+    {
+        for (ChainSegmentList::const_iterator segi = mChainSegmentList.begin();
+            segi != mChainSegmentList.end(); ++segi)
+        {
+            if (segi->head != SEGMENT_EMPTY && segi->head != segi->tail)
+                return true;
+        }
+        return false;
+    }
+    //-----------------------------------------------------------------------
+    size_t BillboardChain::prepareStreamedVertices(Camera* cam, bool worldSpace, size_t generation)
+    {
+        const Vector3& camPos = cam->getDerivedPosition();
+        Vector3 eyePos = mParentNode->convertWorldToLocalPosition(camPos);
+        const Matrix4& xform = _getParentNodeFullTransform();
 
-                    if (mUseVertexColour)
-                    {
-                        RGBA* pCol = static_cast<RGBA*>(pBase);
-                        Root::getSingleton().convertColourValue(elem.colour, pCol);
-                        pCol++;
-                        pBase = static_cast<void*>(pCol);
-                    }
+        // Everything must be written again if the buffers no longer hold the
+        // previous vertices, or if these all depend on something which moved
+        bool all = mVertexContentDirty || generation != mBatchGeneration ||
+            (mFaceCamera && (cam != mVertexCameraUsed || eyePos != mVertexEyePosUsed)) ||
+            (worldSpace && xform != mVertexTransformUsed);
+        mVertexCameraUsed = cam;
+        mVertexEyePosUsed = eyePos;
+        mVertexTransformUsed = xform;
+        mVertexContentDirty = false;
+        mBatchGeneration = generation;
 
-                    if (mUseTexCoords)
-                    {
-                        pFloat = static_cast<float*>(pBase);
-                        if (mTexCoordDir == TCD_U)
-                        {
-                            *pFloat++ = elem.texCoord;
-                            *pFloat++ = mOtherTexCoordRange[0];
-                        }
-                        else
-                        {
-                            *pFloat++ = mOtherTexCoordRange[0];
-                            *pFloat++ = elem.texCoord;
-                        }
-                        pBase = static_cast<void*>(pFloat);
-                    }
+        if (!all)
+        {
+            // Keep the marked elements which are drawn, the others are marked
+            // again if they come to be drawn
+            size_t kept = 0;
+            for (size_t i = 0; i < mDirtyElementList.size(); ++i)
+            {
+                size_t index = mDirtyElementList[i];
+                mDirtyElements[index] = false;
+
+                const ChainSegment& seg = mChainSegmentList[index / mMaxElementsPerChain];
+                if (seg.head == SEGMENT_EMPTY || seg.head == seg.tail)
+                    continue;
+                size_t fromHead = (index - seg.start + mMaxElementsPerChain - seg.head) % mMaxElementsPerChain;
+                size_t tailFromHead = (seg.tail + mMaxElementsPerChain - seg.head) % mMaxElementsPerChain;
+                if (fromHead <= tailFromHead)
+                    mDirtyElementList[kept++] = index;
+            }
+            mDirtyElementList.resize(kept);
+            return kept;
+        }
 
-                    // pos2
-                    pFloat = static_cast<float*>(pBase);
-                    *pFloat++ = pos1.x;
-                    *pFloat++ = pos1.y;
-                    *pFloat++ = pos1.z;
-                    pBase = static_cast<void*>(pFloat);
+        for (vector<size_t>::type::iterator i = mDirtyElementList.begin();
+            i != mDirtyElementList.end(); ++i)
+        {
+            mDirtyElements[*i] = false;
+        }
+        mDirtyElementList.clear();
+        for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
+            segi != mChainSegmentList.end(); ++segi)
+        {
+            ChainSegment& seg = *segi;
 
-                    if (mUseVertexColour)
-                    {
-                        RGBA* pCol = static_cast<RGBA*>(pBase);
-                        Root::getSingleton().convertColourValue(elem.colour, pCol);
-                        pCol++;
-                        pBase = static_cast<void*>(pCol);
-                    }
+            // Skip 0 or 1 element segment counts
+            if (seg.head == SEGMENT_EMPTY || seg.head == seg.tail)
+                continue;
 
-                    if (mUseTexCoords)
-                    {
-                        pFloat = static_cast<float*>(pBase);
-                        if (mTexCoordDir == TCD_U)
-                        {
-                            *pFloat++ = elem.texCoord;
-                            *pFloat++ = mOtherTexCoordRange[1];
-                        }
-                        else
-                        {
-                            *pFloat++ = mOtherTexCoordRange[1];
-                            *pFloat++ = elem.texCoord;
-                        }
-                    }
+            for (size_t e = seg.head; ; ++e) // until break
+            {
+                // Wrap forwards
+                if (e == mMaxElementsPerChain)
+                    e = 0;
 
-                    if (e == seg.tail)
-                        break; // last one
+                mDirtyElementList.push_back(seg.start + e);
 
-                    laste = e;
+                if (e == seg.tail)
+                    break; // last one
+            }
+        }
+        return mDirtyElementList.size();
+    }
+    //-----------------------------------------------------------------------
+    size_t BillboardChain::writeStreamedVertices(char* pDest, uint32 firstSlot, size_t vertexSize,
+        bool worldSpace)
+    {
+        uint32 slot = firstSlot;
+        for (vector<size_t>::type::iterator i = mDirtyElementList.begin();
+            i != mDirtyElementList.end(); ++i, ++slot, pDest += vertexSize * 2)
+        {
+            const ChainSegment& seg = mChainSegmentList[*i / mMaxElementsPerChain];
+            writeElementVertices(seg, *i - seg.start, mVertexEyePosUsed, pDest);
+            if (worldSpace)
+            {
+                // The positions come first in both vertices
+                for (size_t v = 0; v < 2; ++v)
+                {
+                    float* pFloat = reinterpret_cast<float*>(pDest + vertexSize * v);
+                    Vector3 pos = mVertexTransformUsed.transformAffine(
+                        Vector3(pFloat[0], pFloat[1], pFloat[2]));
+                    pFloat[0] = pos.x;
+                    pFloat[1] = pos.y;
+                    pFloat[2] = pos.z;
+                }
+            }
+            mElementSlots[*i] = slot;
+        }
 
-                } // element
-            } // segment valid?
+        size_t written = mDirtyElementList.size();
+        mDirtyElementList.clear();
+        return written;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::collectStreamedQuads(vector<uint32>::type& quads) const
+    {
+        for (ChainSegmentList::const_iterator segi = mChainSegmentList.begin();
+            segi != mChainSegmentList.end(); ++segi)
+        {
+            const ChainSegment& seg = *segi;
 
-        } // each segment
+            // Skip 0 or 1 element segment counts
+            if (seg.head == SEGMENT_EMPTY || seg.head == seg.tail)
+                continue;
 
+            // Each element is joined to the next one, up to the tail
+            for (size_t e = seg.head; e != seg.tail; )
+            {
+                size_t nexte = e + 1;
+                if (nexte == mMaxElementsPerChain)
+                    nexte = 0;
+                quads.push_back(mElementSlots[seg.start + e]);
+                quads.push_back(mElementSlots[seg.start + nexte]);
+                e = nexte;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChain::writeElementVertices(const ChainSegment& seg, size_t e,
+        const Vector3& eyePos, void* pDest)
+    {
+        const Element& elem = mChainElementList[e + seg.start];
 
+        // Get index of previous and next items
+        size_t laste = (e == 0 ? mMaxElementsPerChain : e) - 1;
+        size_t nexte = e + 1;
+        if (nexte == mMaxElementsPerChain)
+            nexte = 0;
 
-        pBuffer->unlock();
-        mVertexCameraUsed = cam;
-        mVertexContentDirty = false;
+        Vector3 chainTangent;
+        if (e == seg.head)
+        {
+            // No laste, use next item
+            chainTangent = mChainElementList[nexte + seg.start].position - elem.position;
+        }
+        else if (e == seg.tail)
+        {
+            // No nexte, use only last item
+            chainTangent = elem.position - mChainElementList[laste + seg.start].position;
+        }
+        else
+        {
+            // A mid position, use tangent across both prev and next
+            chainTangent = mChainElementList[nexte + seg.start].position - mChainElementList[laste + seg.start].position;
 
+        }
+
+        Vector3 vP1ToEye;
+
+        if( mFaceCamera )
+            vP1ToEye = eyePos - elem.position;
+        else
+            vP1ToEye = elem.orientation * mNormalBase;
+
+        Vector3 vPerpendicular = chainTangent.crossProduct(vP1ToEye);
+        vPerpendicular.normalise();
+        vPerpendicular *= (elem.width * 0.5f);
+
+        Vector3 pos0 = elem.position - vPerpendicular;
+        Vector3 pos1 = elem.position + vPerpendicular;
+
+        void* pBase = pDest;
+        float* pFloat = static_cast<float*>(pBase);
+        // pos1
+        *pFloat++ = pos0.x;
+        *pFloat++ = pos0.y;
+        *pFloat++ = pos0.z;
+
+        pBase = static_cast<void*>(pFloat);
+
+        if (mUseVertexColour)
+        {
+            RGBA* pCol = static_cast<RGBA*>(pBase);
+            Root::getSingleton().convertColourValue(elem.colour, pCol);
+            pCol++;
+            pBase = static_cast<void*>(pCol);
+        }
+
+        if (mUseTexCoords)
+        {
+            pFloat = static_cast<float*>(pBase);
+            if (mTexCoordDir == TCD_U)
+            {
+                *pFloat++ = elem.texCoord;
+                *pFloat++ = mOtherTexCoordRange[0];
+            }
+            else
+            {
+                *pFloat++ = mOtherTexCoordRange[0];
+                *pFloat++ = elem.texCoord;
+            }
+            pBase = static_cast<void*>(pFloat);
+        }
+
+        // pos2
+        pFloat = static_cast<float*>(pBase);
+        *pFloat++ = pos1.x;
+        *pFloat++ = pos1.y;
+        *pFloat++ = pos1.z;
+        pBase = static_cast<void*>(pFloat);
+
+        if (mUseVertexColour)
+        {
+            RGBA* pCol = static_cast<RGBA*>(pBase);
+            Root::getSingleton().convertColourValue(elem.colour, pCol);
+            pCol++;
+            pBase = static_cast<void*>(pCol);
+        }
+
+        if (mUseTexCoords)
+        {
+            pFloat = static_cast<float*>(pBase);
+            if (mTexCoordDir == TCD_U)
+            {
+                *pFloat++ = elem.texCoord;
+                *pFloat++ = mOtherTexCoordRange[1];
+            }
+            else
+            {
+                *pFloat++ = mOtherTexCoordRange[1];
+                *pFloat++ = elem.texCoord;
+            }
+        }
     }
     //-----------------------------------------------------------------------
     void BillboardChain::updateIndexBuffer(void)
@@ -753,8 +987,30 @@ namespace Ogre {
         return BillboardChainFactory::FACTORY_TYPE_NAME;
     }
     //-----------------------------------------------------------------------
+    void BillboardChain::_notifyCurrentCamera(Camera* cam)
+    {
+        MovableObject::_notifyCurrentCamera(cam);
+        mCurrentCamera = cam;
+    }
+    //-----------------------------------------------------------------------
     void BillboardChain::_updateRenderQueue(RenderQueue* queue)
     {
+        if (mStreaming)
+        {
+            // The batch is queued instead, once for all its visible chains
+            updateBatch();
+            if (hasQuads() && mBatch->_notifyChainVisible(this, mCurrentCamera))
+            {
+                if (mRenderQueuePrioritySet)
+                    queue->addRenderable(mBatch, mRenderQueueID, mRenderQueuePriority);
+                else if (mRenderQueueIDSet)
+                    queue->addRenderable(mBatch, mRenderQueueID);
+                else
+                    queue->addRenderable(mBatch);
+            }
+            return;
+        }
+
         updateIndexBuffer();
 
         if (mIndexData->indexCount > 0)
@@ -771,6 +1027,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardChain::getRenderOperation(RenderOperation& op)
     {
+        if (mStreaming && mBatch)
+        {
+            mBatch->getRenderOperation(op);
+            return;
+        }
         op.indexData = mIndexData;
         op.operationType = RenderOperation::OT_TRIANGLE_LIST;
         op.srcRenderable = this;
@@ -808,8 +1069,296 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    BillboardChainBatch::BillboardChainBatch(BillboardChain* chain, bool shared)
+        : mShared(shared),
+        mManager(chain->_getManager()),
+        mMaterial(chain->getMaterial()),
+        mRenderQueueID(chain->getRenderQueueGroup()),
+        mUseTexCoords(chain->getUseTextureCoords()),
+        mUseVertexColour(chain->getUseVertexColours()),
+        mVertexCapacity(0),
+        mVertexCursor(0),
+        mIndexCursor(0),
+        mGeneration(1),
+        mQueued(false),
+        mQueuedFrame(0),
+        mQueuedCamera(0)
+    {
+        mVertexData = OGRE_NEW VertexData();
+        mIndexData = OGRE_NEW IndexData();
+        mVertexData->vertexStart = 0;
+        mVertexData->vertexCount = 0;
+
+        // Same vertex format as the chain
+        chain->setupVertexDeclaration();
+        const VertexDeclaration::VertexElementList& elems =
+            chain->mVertexData->vertexDeclaration->getElements();
+        for (VertexDeclaration::VertexElementList::const_iterator i = elems.begin();
+            i != elems.end(); ++i)
+        {
+            mVertexData->vertexDeclaration->addElement(i->getSource(), i->getOffset(),
+                i->getType(), i->getSemantic(), i->getIndex());
+        }
+    }
+    //-----------------------------------------------------------------------
+    BillboardChainBatch::~BillboardChainBatch()
+    {
+        OGRE_DELETE mVertexData;
+        OGRE_DELETE mIndexData;
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardChainBatch::isCompatible(const BillboardChain* chain) const
+    {
+        return chain->_getManager() == mManager && chain->getMaterial() == mMaterial &&
+            chain->getRenderQueueGroup() == mRenderQueueID &&
+            chain->getUseTextureCoords() == mUseTexCoords &&
+            chain->getUseVertexColours() == mUseVertexColour;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatch::_addChain(BillboardChain* chain)
+    {
+        assert((mShared || mChains.empty()) && "Only shared batches hold several chains");
+        mChains.push_back(chain);
+    }
+    //-----------------------------------------------------------------------
+    size_t BillboardChainBatch::_removeChain(BillboardChain* chain)
+    {
+        mChains.erase(std::find(mChains.begin(), mChains.end(), chain));
+        ChainList::iterator i = std::find(mVisibleChains.begin(), mVisibleChains.end(), chain);
+        if (i != mVisibleChains.end())
+            mVisibleChains.erase(i);
+        // Index the remaining chains again
+        mIndexedChains.clear();
+        return mChains.size();
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardChainBatch::_notifyChainVisible(BillboardChain* chain, Camera* cam)
+    {
+        // A batch queued but never rendered starts again on the next frame,
+        // or for another camera
+        unsigned long frame = Root::getSingleton().getNextFrameNumber();
+        bool first = !mQueued || frame != mQueuedFrame || cam != mQueuedCamera;
+        if (first)
+        {
+            mVisibleChains.clear();
+            mVisibleBounds.setNull();
+            mQueued = true;
+            mQueuedFrame = frame;
+            mQueuedCamera = cam;
+        }
+
+        mVisibleChains.push_back(chain);
+        if (mShared)
+            mVisibleBounds.merge(chain->getWorldBoundingBox(true));
+        return first;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatch::setupBuffers(size_t numElements)
+    {
+        // Twice the elements, so that many updates can be appended before the
+        // buffers are discarded
+        mVertexCapacity = numElements * 2;
+        mVertexData->vertexCount = mVertexCapacity * 2;
+        HardwareVertexBufferSharedPtr pBuffer =
+            HardwareBufferManager::getSingleton().createVertexBuffer(
+            mVertexData->vertexDeclaration->getVertexSize(0),
+            mVertexData->vertexCount,
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+        mVertexData->vertexBufferBinding->setBinding(0, pBuffer);
+
+        mIndexData->indexBuffer =
+            HardwareBufferManager::getSingleton().createIndexBuffer(
+                mVertexData->vertexCount > 65536 ?
+                    HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+                mVertexCapacity * 6,
+                HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+        mIndexData->indexStart = 0;
+        mIndexData->indexCount = 0;
+
+        mVertexCursor = mIndexCursor = 0;
+        ++mGeneration;
+        mIndexedChains.clear();
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatch::_updateBuffers(Camera* cam)
+    {
+        mQueued = false;
+
+        size_t numElements = 0;
+        for (ChainList::iterator i = mChains.begin(); i != mChains.end(); ++i)
+            numElements += (*i)->mChainElementList.size();
+        if (numElements * 2 != mVertexCapacity)
+            setupBuffers(numElements);
+
+        // Append the changed vertices after the ones written before, which a
+        // previous frame may still be drawing
+        size_t needed = 0;
+        for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+            needed += (*i)->prepareStreamedVertices(cam, mShared, mGeneration);
+
+        if (needed)
+        {
+            HardwareVertexBufferSharedPtr pBuffer =
+                mVertexData->vertexBufferBinding->getBuffer(0);
+            size_t vertexSize = pBuffer->getVertexSize();
+            char* pDest;
+            if (mVertexCursor + needed > mVertexCapacity)
+            {
+                // Out of room: discard the buffer and write all the visible
+                // chains again from the start
+                ++mGeneration;
+                needed = 0;
+                for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+                    needed += (*i)->prepareStreamedVertices(cam, mShared, mGeneration);
+                mVertexCursor = 0;
+                pDest = static_cast<char*>(pBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            }
+            else
+            {
+                pDest = static_cast<char*>(pBuffer->lock(mVertexCursor * 2 * vertexSize,
+                    needed * 2 * vertexSize, HardwareBuffer::HBL_NO_OVERWRITE));
+            }
+
+            for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+            {
+                size_t written = (*i)->writeStreamedVertices(pDest,
+                    static_cast<uint32>(mVertexCursor), vertexSize, mShared);
+                pDest += written * 2 * vertexSize;
+                mVertexCursor += written;
+            }
+            pBuffer->unlock();
+        }
+
+        // The indices refer to the latest vertices of each element
+        bool indicesDirty = needed || mVisibleChains != mIndexedChains;
+        for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+        {
+            indicesDirty |= (*i)->mIndexContentDirty;
+            (*i)->mIndexContentDirty = false;
+        }
+        if (indicesDirty)
+        {
+            mQuads.clear();
+            for (ChainList::iterator i = mVisibleChains.begin(); i != mVisibleChains.end(); ++i)
+                (*i)->collectStreamedQuads(mQuads);
+            writeIndices();
+            mIndexedChains = mVisibleChains;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatch::writeIndices(void)
+    {
+        size_t count = mQuads.size() / 2 * 6;
+        mIndexData->indexCount = count;
+        if (!count)
+            return;
+
+        // Written after the indices used before too, which a previous frame
+        // may still be drawing
+        HardwareIndexBufferSharedPtr pBuffer = mIndexData->indexBuffer;
+        size_t indexSize = pBuffer->getIndexSize();
+        void* pDest;
+        if (mIndexCursor + count > pBuffer->getNumIndexes())
+        {
+            mIndexCursor = 0;
+            pDest = pBuffer->lock(HardwareBuffer::HBL_DISCARD);
+        }
+        else
+        {
+            pDest = pBuffer->lock(mIndexCursor * indexSize, count * indexSize,
+                HardwareBuffer::HBL_NO_OVERWRITE);
+        }
+
+        uint16* pShort = static_cast<uint16*>(pDest);
+        uint32* pInt = static_cast<uint32*>(pDest);
+        bool use32Bit = pBuffer->getType() == HardwareIndexBuffer::IT_32BIT;
+        for (size_t q = 0; q < mQuads.size(); q += 2)
+        {
+            uint32 baseIdx = mQuads[q] * 2;
+            uint32 nextBaseIdx = mQuads[q + 1] * 2;
+            uint32 quad[6] =
+            {
+                baseIdx, baseIdx + 1, nextBaseIdx,
+                baseIdx + 1, nextBaseIdx + 1, nextBaseIdx
+            };
+            if (use32Bit)
+            {
+                std::copy(quad, quad + 6, pInt);
+                pInt += 6;
+            }
+            else
+            {
+                for (size_t i = 0; i < 6; ++i)
+                    *pShort++ = static_cast<uint16>(quad[i]);
+            }
+        }
+        pBuffer->unlock();
+
+        mIndexData->indexStart = mIndexCursor;
+        mIndexCursor += count;
+    }
+    //-----------------------------------------------------------------------
+    const MaterialPtr& BillboardChainBatch::getMaterial(void) const
+    {
+        return mMaterial;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatch::getRenderOperation(RenderOperation& op)
+    {
+        op.indexData = mIndexData;
+        op.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        op.srcRenderable = this;
+        op.useIndexes = true;
+        op.vertexData = mVertexData;
+    }
+    //-----------------------------------------------------------------------
+    bool BillboardChainBatch::preRender(SceneManager* sm, RenderSystem* rsys)
+    {
+        // Retrieve the current viewport from the scene manager.
+        // The viewport is only valid during a viewport update.
+        Viewport *currentViewport = sm->getCurrentViewport();
+        if( !currentViewport )
+            return false;
+
+        // Only the first pass rendered updates the buffers
+        if (mQueued)
+            _updateBuffers(currentViewport->getCamera());
+        return mIndexData->indexCount > 0;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainBatch::getWorldTransforms(Matrix4* xform) const
+    {
+        if (mShared)
+            *xform = Matrix4::IDENTITY;
+        else
+            *xform = mChains.front()->_getParentNodeFullTransform();
+    }
+    //-----------------------------------------------------------------------
+    Real BillboardChainBatch::getSquaredViewDepth(const Camera* cam) const
+    {
+        if (!mShared)
+            return mChains.front()->getSquaredViewDepth(cam);
+        if (mVisibleBounds.isNull())
+            return 0;
+        return (cam->getDerivedPosition() - mVisibleBounds.getCenter()).squaredLength();
+    }
+    //-----------------------------------------------------------------------
+    const LightList& BillboardChainBatch::getLights(void) const
+    {
+        if (mVisibleChains.empty())
+            return mNoLights;
+        return mVisibleChains.front()->queryLights();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     String BillboardChainFactory::FACTORY_TYPE_NAME = "BillboardChain";
     //-----------------------------------------------------------------------
+    BillboardChainFactory::~BillboardChainFactory()
+    {
+        for (BatchList::iterator i = mSharedBatches.begin(); i != mSharedBatches.end(); ++i)
+            OGRE_DELETE *i;
+    }
+    //-----------------------------------------------------------------------
     const String& BillboardChainFactory::getType(void) const
     {
         return FACTORY_TYPE_NAME;
@@ -862,6 +1411,27 @@ namespace Ogre {
     {
         OGRE_DELETE  obj;
     }
+    //-----------------------------------------------------------------------
+    BillboardChainBatch* BillboardChainFactory::_getSharedBatch(BillboardChain* chain)
+    {
+        for (BatchList::iterator i = mSharedBatches.begin(); i != mSharedBatches.end(); ++i)
+        {
+            if ((*i)->isCompatible(chain))
+                return *i;
+        }
+        mSharedBatches.push_back(OGRE_NEW BillboardChainBatch(chain, true));
+        return mSharedBatches.back();
+    }
+    //-----------------------------------------------------------------------
+    void BillboardChainFactory::_releaseSharedBatch(BillboardChainBatch* batch)
+    {
+        BatchList::iterator i = std::find(mSharedBatches.begin(), mSharedBatches.end(), batch);
+        if (i != mSharedBatches.end())
+        {
+            mSharedBatches.erase(i);
+            OGRE_DELETE batch;
+        }
+    }
 
 }
 
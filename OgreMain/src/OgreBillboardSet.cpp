@@ -40,12 +40,31 @@ THE SOFTWARE.
 #include "OgreException.h"
 #include "OgreSceneNode.h"
 #include "OgreLogManager.h"
+#include "OgreOptimisedUtil.h"
 #include <algorithm>
 
 namespace Ogre {
     // Init statics
     RadixSort<BillboardSet::ActiveBillboardList, Billboard*, float> BillboardSet::mRadixSorter;
 
+    /// Number of billboards gathered before their vertices are generated
+    static const size_t BATCH_SIZE = 256;
+
+    namespace {
+        /// Gives the radix sort key of a billboard from its depth key
+        struct SortKeyFunctor
+        {
+            const Real* keys;
+
+            SortKeyFunctor(const Real* k) : keys(k) {}
+            uint64 operator()(uint32 index) const
+            {
+                return ParallelRadixSort<vector<uint32>::type>::floatToKey(
+                    static_cast<float>(keys[index]));
+            }
+        };
+    }
+
     //-----------------------------------------------------------------------
     BillboardSet::BillboardSet() :
         mBoundingRadius(0.0f), 
@@ -63,7 +82,13 @@ namespace Ogre {
         mBillboardType(BBT_POINT),
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
+        mSortingReuseDistance(0),
+        mSortOrderValid(false),
+        mLastSortMode(SM_DIRECTION),
+        mLastSortRadius(0),
         mPointRendering(false),
+        mBatchingBillboards(false),
+        mNumBatchedBillboards(0),
         mBuffersCreated(false),
         mPoolSize(0),
         mExternalData(false),
@@ -97,7 +122,13 @@ namespace Ogre {
         mBillboardType(BBT_POINT),
         mCommonDirection(Ogre::Vector3::UNIT_Z),
         mCommonUpVector(Vector3::UNIT_Y),
+        mSortingReuseDistance(0),
+        mSortOrderValid(false),
+        mLastSortMode(SM_DIRECTION),
+        mLastSortRadius(0),
         mPointRendering(false),
+        mBatchingBillboards(false),
+        mNumBatchedBillboards(0),
         mBuffersCreated(false),
         mPoolSize(poolSize),
         mExternalData(externalData),
@@ -151,6 +182,8 @@ namespace Ogre {
         newBill->setTexcoordIndex(0);
         newBill->resetDimensions();
         newBill->_notifyOwner(this);
+        // Appended whatever its depth
+        mSortOrderValid = false;
 
         // Merge into bounds
         Real adjust = std::max(mDefaultWidth, mDefaultHeight);
@@ -325,14 +358,67 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::_sortBillboards( Camera* cam)
     {
-        switch (_getSortMode())
+        SortMode sortMode = _getSortMode();
+        // Sort back to front
+        Vector3 sortDir = -mCamDir;
+
+        if (mSortOrderValid && sortMode == mLastSortMode && mSortingReuseDistance > 0)
         {
-        case SM_DIRECTION:
-            mRadixSorter.sort(mActiveBillboards, SortByDirectionFunctor(-mCamDir));
-            break;
-        case SM_DISTANCE:
-            mRadixSorter.sort(mActiveBillboards, SortByDistanceFunctor(mCamPos));
-            break;
+            // Bound the change of depth of the billboards since the last sort:
+            // moving the camera changes their distances by at most the distance
+            // moved, turning it changes their depths along the direction by at
+            // most the change of direction times their distance to the origin
+            Real depthChange = (sortMode == SM_DISTANCE) ?
+                mCamPos.distance(mLastSortCamPos) :
+                sortDir.distance(mLastSortDir) * mLastSortRadius;
+            if (depthChange < mSortingReuseDistance)
+                return;
+        }
+
+        size_t count = mActiveBillboards.size();
+        mSortBillboards.resize(count);
+        mSortPositions.resize(count * 3);
+        mSortKeys.resize(count);
+        mSortOrder.resize(count);
+
+        // Gather the positions into separate arrays, so that the keys are
+        // computed with SIMD in a single pass
+        Real* posX = count ? &mSortPositions[0] : 0;
+        Real* posY = posX + count;
+        Real* posZ = posY + count;
+        Real maxSqLen = 0;
+        ActiveBillboardList::iterator it = mActiveBillboards.begin();
+        for (size_t i = 0; i < count; ++i, ++it)
+        {
+            const Vector3& pos = (*it)->mPosition;
+            mSortBillboards[i] = *it;
+            posX[i] = pos.x;
+            posY[i] = pos.y;
+            posZ[i] = pos.z;
+            maxSqLen = std::max(maxSqLen, pos.squaredLength());
+            mSortOrder[i] = static_cast<uint32>(i);
+        }
+
+        mSortOrderValid = true;
+        mLastSortMode = sortMode;
+        mLastSortCamPos = mCamPos;
+        mLastSortDir = sortDir;
+        mLastSortRadius = Math::Sqrt(maxSqLen);
+        if (count < 2)
+            return;
+
+        OptimisedUtil::getImplementation()->calculateDepthKeys(posX, posY, posZ,
+            mCamPos, sortDir, sortMode == SM_DISTANCE, &mSortKeys[0], count);
+
+        // Large sets are split between the worker threads
+        Root* root = Root::getSingletonPtr();
+        mSortOrderSorter.sort(mSortOrder, SortKeyFunctor(&mSortKeys[0]),
+            (root && count > 2000) ? root->getWorkQueue() : 0);
+
+        it = mActiveBillboards.begin();
+        for (size_t i = 0; i < count; ++i, ++it)
+        {
+            *it = mSortBillboards[mSortOrder[i]];
         }
     }
     BillboardSet::SortByDirectionFunctor::SortByDirectionFunctor(const Vector3& dir)
@@ -415,6 +501,7 @@ namespace Ogre {
         // create vertex and index buffers if they haven't already been
         if(!mBuffersCreated)
             _createBuffers();
+        mBatchingBillboards = false;
 
         // Only calculate vertex offets et al if we're not point rendering
         if (!mPointRendering)
@@ -437,11 +524,23 @@ namespace Ogre {
                 genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
                     mDefaultWidth, mDefaultHeight, mCamX, mCamY, mVOffset);
 
+                // Billboards using these offsets can have their vertices
+                // generated in batches
+                for (size_t corner = 0; corner < 4; ++corner)
+                {
+                    mBatchOffsets[corner * 3 + 0] = static_cast<float>(mVOffset[corner].x);
+                    mBatchOffsets[corner * 3 + 1] = static_cast<float>(mVOffset[corner].y);
+                    mBatchOffsets[corner * 3 + 2] = static_cast<float>(mVOffset[corner].z);
+                }
+                mBatchingBillboards = true;
             }
         }
 
         // Init num visible
         mNumVisibleBillboards = 0;
+        mNumBatchedBillboards = 0;
+        if (mBatchingBillboards && mBatchedBillboards.empty())
+            mBatchedBillboards.resize(BATCH_SIZE * 4);
 
         // Lock the buffer
         if (numBillboards) // optimal lock
@@ -484,6 +583,18 @@ namespace Ogre {
         // Skip if not visible (NB always true if not bounds checking individual billboards)
         if (!billboardVisible(mCurrentCamera, bb)) return;
 
+        if (mBatchingBillboards &&
+            (mAllDefaultSize || !bb.mOwnDimensions) &&
+            (mAllDefaultRotation || bb.mRotation == Radian(0)))
+        {
+            // Vertices generated later, along with the billboards sharing the offsets
+            batchBillboard(bb);
+            mNumVisibleBillboards++;
+            return;
+        }
+        // Keep the vertices in the order of the billboards
+        flushBatchedBillboards();
+
         if (!mPointRendering &&
             (mBillboardType == BBT_ORIENTED_SELF ||
             mBillboardType == BBT_PERPENDICULAR_SELF ||
@@ -537,9 +648,54 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
     {
+        flushBatchedBillboards();
         mMainBuf->unlock();
     }
     //-----------------------------------------------------------------------
+    void BillboardSet::batchBillboard(const Billboard& bb)
+    {
+        assert( bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size() );
+        const Ogre::FloatRect & r =
+            bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+
+        // A batch shares the texture coordinates
+        if (mNumBatchedBillboards == BATCH_SIZE ||
+            (mNumBatchedBillboards &&
+            (r.left != mBatchTexcoordRect.left || r.top != mBatchTexcoordRect.top ||
+            r.right != mBatchTexcoordRect.right || r.bottom != mBatchTexcoordRect.bottom)))
+        {
+            flushBatchedBillboards();
+        }
+        mBatchTexcoordRect = r;
+
+        float* pBatch = &mBatchedBillboards[mNumBatchedBillboards * 4];
+        pBatch[0] = static_cast<float>(bb.mPosition.x);
+        pBatch[1] = static_cast<float>(bb.mPosition.y);
+        pBatch[2] = static_cast<float>(bb.mPosition.z);
+        RGBA colour;
+        Root::getSingleton().convertColourValue(bb.mColour, &colour);
+        memcpy(pBatch + 3, &colour, sizeof(RGBA));
+        ++mNumBatchedBillboards;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::flushBatchedBillboards(void)
+    {
+        if (!mNumBatchedBillboards)
+            return;
+
+        // Left-top, right-top, left-bottom, right-bottom as genVertices
+        const Ogre::FloatRect & r = mBatchTexcoordRect;
+        float texcoords[8] =
+        {
+            r.left, r.top, r.right, r.top, r.left, r.bottom, r.right, r.bottom
+        };
+        OptimisedUtil::getImplementation()->generateBillboardVertices(
+            &mBatchedBillboards[0], mBatchOffsets, texcoords, mLockPtr, mNumBatchedBillboards);
+        // Position, colour and texture coordinates for each corner
+        mLockPtr += mNumBatchedBillboards * 4 * 6;
+        mNumBatchedBillboards = 0;
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::setBounds(const AxisAlignedBox& box, Real radius)
     {
         mAABB = box;
@@ -727,6 +883,7 @@ namespace Ogre {
     void BillboardSet::setSortingEnabled( bool sortenable )
     {
         mSortingEnabled = sortenable;
+        mSortOrderValid = false;
     }
 
     //-----------------------------------------------------------------------
@@ -735,6 +892,18 @@ namespace Ogre {
         return mSortingEnabled;
     }
 
+    //-----------------------------------------------------------------------
+    void BillboardSet::setSortingReuseDistance(Real distance)
+    {
+        mSortingReuseDistance = distance;
+    }
+
+    //-----------------------------------------------------------------------
+    Real BillboardSet::getSortingReuseDistance(void) const
+    {
+        return mSortingReuseDistance;
+    }
+
     //-----------------------------------------------------------------------
     void BillboardSet::setPoolSize( size_t size )
     {
@@ -905,6 +1074,12 @@ namespace Ogre {
         mAllDefaultRotation = false;
     }
 
+    //-----------------------------------------------------------------------
+    void BillboardSet::_notifyBillboardMoved(void)
+    {
+        mSortOrderValid = false;
+    }
+
     //-----------------------------------------------------------------------
     void BillboardSet::getParametricOffsets(
         Real& left, Real& right, Real& top, Real& bottom )
@@ -901,6 +901,19 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::isVisible(const Vector3* centres, const Vector3* halfSizes, 
+        size_t count, uint32* visibilityMask) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(centres, halfSizes, count, visibilityMask);
+        }
+        else
+        {
+            Frustum::isVisible(centres, halfSizes, count, visibilityMask);
+        }
+    }
+    //-----------------------------------------------------------------------
     const Vector3* Camera::getWorldSpaceCorners(void) const
     {
         if (mCullFrustum)
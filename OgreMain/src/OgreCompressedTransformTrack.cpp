@@ -0,0 +1,215 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreCompressedTransformTrack.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Largest value of the rotation components after quantisation
+        const Real ROTATION_QUANTISE_MAX = 32767;
+        /// Largest value of the vector components after quantisation
+        const Real VECTOR_QUANTISE_MAX = 65535;
+        /// Rotation components other than the largest are within +/- this
+        const Real ROTATION_COMPONENT_RANGE = Real(0.70710678118654752440);
+
+        /// Difference between two quaternions, which are the same rotation when opposite
+        Real rotationDifference(const Quaternion& a, const Quaternion& b)
+        {
+            Real same = std::max(std::max(Math::Abs(a.w - b.w), Math::Abs(a.x - b.x)),
+                std::max(Math::Abs(a.y - b.y), Math::Abs(a.z - b.z)));
+            Real opposite = std::max(std::max(Math::Abs(a.w + b.w), Math::Abs(a.x + b.x)),
+                std::max(Math::Abs(a.y + b.y), Math::Abs(a.z + b.z)));
+            return std::min(same, opposite);
+        }
+    }
+    //---------------------------------------------------------------------
+    CompressedTransformTrack::CompressedTransformTrack()
+        : mConstantRotation(Quaternion::IDENTITY)
+        , mTranslateBase(Vector3::ZERO)
+        , mTranslateStep(Vector3::ZERO)
+        , mScaleBase(Vector3::UNIT_SCALE)
+        , mScaleStep(Vector3::ZERO)
+    {
+    }
+    //---------------------------------------------------------------------
+    void CompressedTransformTrack::compress(size_t numKeyFrames, const Real* times,
+        const Quaternion* rotations, const Vector3* translates, const Vector3* scales,
+        Real tolerance)
+    {
+        mTimes.assign(times, times + numKeyFrames);
+
+        // Rotations
+        mRotations.clear();
+        mConstantRotation = numKeyFrames ? rotations[0] : Quaternion::IDENTITY;
+        for (size_t i = 1; i < numKeyFrames; ++i)
+        {
+            if (rotationDifference(rotations[i], mConstantRotation) > tolerance)
+            {
+                mRotations.resize(numKeyFrames * 3);
+                for (size_t k = 0; k < numKeyFrames; ++k)
+                {
+                    encodeRotation(rotations[k], &mRotations[k * 3]);
+                }
+                break;
+            }
+        }
+
+        compressVectors(numKeyFrames, translates, tolerance,
+            mTranslates, mTranslateBase, mTranslateStep);
+        compressVectors(numKeyFrames, scales, tolerance,
+            mScales, mScaleBase, mScaleStep);
+        if (!numKeyFrames)
+        {
+            mScaleBase = Vector3::UNIT_SCALE;
+        }
+    }
+    //---------------------------------------------------------------------
+    void CompressedTransformTrack::compressVectors(size_t numKeyFrames, const Vector3* values,
+        Real tolerance, QuantisedList& dest, Vector3& base, Vector3& step)
+    {
+        dest.clear();
+        step = Vector3::ZERO;
+        if (!numKeyFrames)
+        {
+            base = Vector3::ZERO;
+            return;
+        }
+
+        Vector3 minimum = values[0], maximum = values[0];
+        for (size_t i = 1; i < numKeyFrames; ++i)
+        {
+            minimum.makeFloor(values[i]);
+            maximum.makeCeil(values[i]);
+        }
+
+        Vector3 range = maximum - minimum;
+        if (range.x <= tolerance && range.y <= tolerance && range.z <= tolerance)
+        {
+            // Constant, keep the value closest to all
+            base = minimum.midPoint(maximum);
+            return;
+        }
+
+        base = minimum;
+        step = range / VECTOR_QUANTISE_MAX;
+        Vector3 invStep(
+            step.x > 0 ? 1 / step.x : 0,
+            step.y > 0 ? 1 / step.y : 0,
+            step.z > 0 ? 1 / step.z : 0);
+
+        dest.resize(numKeyFrames * 3);
+        for (size_t i = 0; i < numKeyFrames; ++i)
+        {
+            Vector3 quantised = (values[i] - minimum) * invStep;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                Real value = std::min(quantised[c] + Real(0.5), VECTOR_QUANTISE_MAX);
+                dest[i * 3 + c] = static_cast<uint16>(value);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void CompressedTransformTrack::encodeRotation(const Quaternion& q, uint16* dest)
+    {
+        Real components[4] = { q.w, q.x, q.y, q.z };
+        Real length = Math::Sqrt(q.Norm());
+        if (length <= 0)
+        {
+            components[0] = 1;
+            length = 1;
+        }
+
+        // Drop the largest component, it is recomputed from the others
+        size_t largest = 0;
+        for (size_t i = 1; i < 4; ++i)
+        {
+            if (Math::Abs(components[i]) > Math::Abs(components[largest]))
+                largest = i;
+        }
+        // Make the dropped component positive, and keep the sign to give back
+        // the same quaternion rather than its opposite
+        uint16 negated = components[largest] < 0 ? 1 : 0;
+        Real scale = (negated ? -1 : 1) / length;
+
+        size_t j = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real value = (components[i] * scale / ROTATION_COMPONENT_RANGE + 1) *
+                Real(0.5) * ROTATION_QUANTISE_MAX + Real(0.5);
+            value = Math::Clamp(value, Real(0), ROTATION_QUANTISE_MAX);
+            dest[j++] = static_cast<uint16>(value);
+        }
+
+        dest[0] |= static_cast<uint16>((largest >> 1) << 15);
+        dest[1] |= static_cast<uint16>((largest & 1) << 15);
+        dest[2] |= static_cast<uint16>(negated << 15);
+    }
+    //---------------------------------------------------------------------
+    Quaternion CompressedTransformTrack::decodeRotation(const uint16* src)
+    {
+        size_t largest = ((src[0] >> 15) << 1) | (src[1] >> 15);
+
+        Real components[4];
+        Real sum = 0;
+        size_t j = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real value = ((src[j++] & 0x7fff) * (2 / ROTATION_QUANTISE_MAX) - 1) *
+                ROTATION_COMPONENT_RANGE;
+            components[i] = value;
+            sum += value * value;
+        }
+        components[largest] = Math::Sqrt(std::max(Real(0), 1 - sum));
+
+        if (src[2] >> 15)
+        {
+            return Quaternion(-components[0], -components[1], -components[2], -components[3]);
+        }
+        return Quaternion(components[0], components[1], components[2], components[3]);
+    }
+    //---------------------------------------------------------------------
+    size_t CompressedTransformTrack::findKeyFrame(Real timePos) const
+    {
+        return std::lower_bound(mTimes.begin(), mTimes.end(), timePos) - mTimes.begin();
+    }
+    //---------------------------------------------------------------------
+    size_t CompressedTransformTrack::getMemoryUsage(void) const
+    {
+        return sizeof(*this) +
+            mTimes.capacity() * sizeof(Real) +
+            (mRotations.capacity() + mTranslates.capacity() + mScales.capacity()) * sizeof(uint16);
+    }
+
+}
@@ -30,6 +30,19 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#   define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#elif OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -470,6 +483,90 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream(const String& name, const String& path)
+        : MemoryDataStream(name, static_cast<void*>(0), 0, false, true)
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        , mFileHandle(INVALID_HANDLE_VALUE), mMappingHandle(0)
+#endif
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        mFileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+        LARGE_INTEGER fileSize;
+        if (mFileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(mFileHandle, &fileSize))
+        {
+            close();
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + path,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        mSize = static_cast<size_t>(fileSize.QuadPart);
+        if (mSize > 0)
+        {
+            mMappingHandle = CreateFileMappingA(mFileHandle, 0, PAGE_READONLY, 0, 0, 0);
+            if (mMappingHandle)
+                mData = static_cast<uchar*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Mapping files is not supported on this platform: " + path,
+            "MappedFileDataStream::MappedFileDataStream");
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat fileStat;
+        if (fd == -1 || fstat(fd, &fileStat) != 0)
+        {
+            if (fd != -1)
+                ::close(fd);
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot open file: " + path,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        mSize = static_cast<size_t>(fileStat.st_size);
+        if (mSize > 0)
+        {
+            void* mapped = mmap(0, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+                mData = static_cast<uchar*>(mapped);
+        }
+        // The mapping keeps the file open
+        ::close(fd);
+#endif
+        if (mSize > 0 && !mData)
+        {
+            close();
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                "Cannot map file: " + path,
+                "MappedFileDataStream::MappedFileDataStream");
+        }
+        mPos = mData;
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close(void)
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMappingHandle)
+            CloseHandle(mMappingHandle);
+        if (mFileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(mFileHandle);
+        mMappingHandle = 0;
+        mFileHandle = INVALID_HANDLE_VALUE;
+#elif OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+        if (mData)
+            munmap(mData, mSize);
+#endif
+        mData = mPos = mEnd = 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(0), mFreeOnClose(freeOnClose)
     {
@@ -30,9 +30,23 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// Orders proxies by their minimum along an axis
+        template <class T>
+        struct ProxyMinimumLess
+        {
+            int axis;
+            ProxyMinimumLess(int a) : axis(a) {}
+            bool operator()(const T& a, const T& b) const
+            {
+                return a.minimum[axis] < b.minimum[axis];
+            }
+        };
+    }
     //---------------------------------------------------------------------
     DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
-    : IntersectionSceneQuery(creator)
+    : IntersectionSceneQuery(creator), mAxis(0)
     {
         // No world geometry results supported
         mSupportedWorldFragments.insert(SceneQuery::WFT_NONE);
@@ -42,19 +56,21 @@ namespace Ogre {
     {
     }
     //---------------------------------------------------------------------
-    void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    void DefaultIntersectionSceneQuery::gatherObjects(void)
     {
+        mCurrentObjects.clear();
+
         // Iterate over all movable types
         Root::MovableObjectFactoryIterator factIt = 
             Root::getSingleton().getMovableObjectFactoryIterator();
         while(factIt.hasMoreElements())
         {
-            SceneManager::MovableObjectIterator objItA = 
+            SceneManager::MovableObjectIterator objIt = 
                 mParentSceneMgr->getMovableObjectIterator(
                     factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
+            while (objIt.hasMoreElements())
             {
-                MovableObject* a = objItA.getNext();
+                MovableObject* a = objIt.getNext();
                 // skip entire section if type doesn't match
                 if (!(a->getTypeFlags() & mQueryTypeMask))
                     break;
@@ -64,60 +80,149 @@ namespace Ogre {
                     !a->isInScene())
                     continue;
 
-                // Check against later objects in the same group
-                SceneManager::MovableObjectIterator objItB = objItA;
-                while (objItB.hasMoreElements())
-                {
-                    MovableObject* b = objItB.getNext();
-
-                    // Apply mask to b (both must pass)
-                    if ((b->getQueryFlags() & mQueryMask) && 
-                        b->isInScene())
-                    {
-                        const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                        const AxisAlignedBox& box2 = b->getWorldBoundingBox();
+                mCurrentObjects.push_back(a);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultIntersectionSceneQuery::readBounds(MovableObject* movable, Proxy& proxy)
+    {
+        const AxisAlignedBox& box = movable->getWorldBoundingBox();
+        if (box.isNull())
+        {
+            // Empty range, which sorts last and overlaps nothing
+            for (int i = 0; i < 3; ++i)
+            {
+                proxy.minimum[i] = std::numeric_limits<float>::max();
+                proxy.maximum[i] = -std::numeric_limits<float>::max();
+            }
+        }
+        else if (box.isInfinite())
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                proxy.minimum[i] = -std::numeric_limits<float>::max();
+                proxy.maximum[i] = std::numeric_limits<float>::max();
+            }
+        }
+        else
+        {
+            const Vector3& minimum = box.getMinimum();
+            const Vector3& maximum = box.getMaximum();
+            for (int i = 0; i < 3; ++i)
+            {
+                proxy.minimum[i] = static_cast<float>(minimum[i]);
+                proxy.maximum[i] = static_cast<float>(maximum[i]);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultIntersectionSceneQuery::updateProxies(void)
+    {
+        // The proxies are in the order of the last execution if the objects
+        // are the same, otherwise start again from the scene order
+        bool sameObjects = (mCurrentObjects == mObjects);
+        mObjects.swap(mCurrentObjects);
+        if (!sameObjects)
+        {
+            mProxies.resize(mObjects.size());
+            for (size_t i = 0; i < mObjects.size(); ++i)
+                mProxies[i].movable = mObjects[i];
+        }
 
-                        if (box1.intersects(box2))
-                        {
-                            if (!listener->queryResult(a, b)) return;
-                        }
-                    }
-                }
-                // Check  against later groups
-                Root::MovableObjectFactoryIterator factItLater = factIt;
-                while (factItLater.hasMoreElements())
-                {
-                    SceneManager::MovableObjectIterator objItC = 
-                        mParentSceneMgr->getMovableObjectIterator(
-                            factItLater.getNext()->getType());
-                    while (objItC.hasMoreElements())
-                    {
-                        MovableObject* c = objItC.getNext();
-                        // skip entire section if type doesn't match
-                        if (!(c->getTypeFlags() & mQueryTypeMask))
-                            break;
+        // Refresh the boxes, and measure how spread out the objects are
+        double sum[3] = { 0, 0, 0 };
+        double sumSquares[3] = { 0, 0, 0 };
+        size_t numFinite = 0;
+        for (ProxyList::iterator i = mProxies.begin(); i != mProxies.end(); ++i)
+        {
+            readBounds(i->movable, *i);
+            if (i->minimum[0] > i->maximum[0] ||
+                i->maximum[0] == std::numeric_limits<float>::max())
+                continue;
 
-                        // Apply mask to c (both must pass)
-                        if ((c->getQueryFlags() & mQueryMask) &&
-                            c->isInScene())
-                        {
-                            const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                            const AxisAlignedBox& box2 = c->getWorldBoundingBox();
+            for (int a = 0; a < 3; ++a)
+            {
+                double centre = (double(i->minimum[a]) + double(i->maximum[a])) * 0.5;
+                sum[a] += centre;
+                sumSquares[a] += centre * centre;
+            }
+            ++numFinite;
+        }
 
-                            if (box1.intersects(box2))
-                            {
-                                if (!listener->queryResult(a, c)) return;
-                            }
-                        }
-                    }
+        // Switch to the axis with the largest variance, if it is clearly
+        // better, since switching means sorting from scratch
+        int axis = mAxis;
+        if (numFinite > 1)
+        {
+            double variance[3];
+            for (int a = 0; a < 3; ++a)
+                variance[a] = sumSquares[a] - sum[a] * sum[a] / numFinite;
+            int best = 0;
+            for (int a = 1; a < 3; ++a)
+            {
+                if (variance[a] > variance[best])
+                    best = a;
+            }
+            if (variance[best] > variance[axis] * 2)
+                axis = best;
+        }
 
-                }
+        if (!sameObjects || axis != mAxis)
+        {
+            mAxis = axis;
+            std::sort(mProxies.begin(), mProxies.end(), ProxyMinimumLess<Proxy>(mAxis));
+        }
+        else
+        {
+            // Insertion sort, close to linear since the objects only moved a little
+            for (size_t i = 1; i < mProxies.size(); ++i)
+            {
+                if (!(mProxies[i].minimum[mAxis] < mProxies[i - 1].minimum[mAxis]))
+                    continue;
 
+                Proxy proxy = mProxies[i];
+                size_t j = i;
+                do
+                {
+                    mProxies[j] = mProxies[j - 1];
+                    --j;
+                } while (j > 0 && proxy.minimum[mAxis] < mProxies[j - 1].minimum[mAxis]);
+                mProxies[j] = proxy;
             }
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    {
+        gatherObjects();
+        updateProxies();
 
+        const int axis = mAxis;
+        const int axis1 = (axis + 1) % 3;
+        const int axis2 = (axis + 2) % 3;
+        const size_t numProxies = mProxies.size();
+        for (size_t i = 0; i < numProxies; ++i)
+        {
+            const Proxy& a = mProxies[i];
+            // Null boxes are sorted last
+            if (a.minimum[axis] > a.maximum[axis])
+                break;
 
-        }
+            // Only the objects starting before a ends can overlap it
+            for (size_t j = i + 1; j < numProxies; ++j)
+            {
+                const Proxy& b = mProxies[j];
+                if (b.minimum[axis] > a.maximum[axis] || b.minimum[axis] > b.maximum[axis])
+                    break;
 
+                if (a.maximum[axis1] < b.minimum[axis1] || b.maximum[axis1] < a.minimum[axis1] ||
+                    a.maximum[axis2] < b.minimum[axis2] || b.maximum[axis2] < a.minimum[axis2])
+                    continue;
+
+                if (!listener->queryResult(a.movable, b.movable)) return;
+            }
+        }
     }
     //---------------------------------------------------------------------
     DefaultAxisAlignedBoxSceneQuery::
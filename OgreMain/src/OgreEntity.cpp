@@ -45,11 +45,15 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreTechnique.h"
 #include "OgrePass.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreSkeletonPoseEvaluator.h"
+#include "OgreAnimationPoseCache.h"
 #include "OgreOptimisedUtil.h"
 #include "OgreSceneNode.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
 #include "OgreMaterialManager.h"
+#include "OgreRay.h"
+#include "OgreEntityAnimationUpdater.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -77,6 +81,10 @@ namespace Ogre {
         mSkipAnimStateUpdates(false),
         mAlwaysUpdateMainSkeleton(false),
           mUpdateBoundingBoxFromSkeleton(false),
+          mUseSkeletonPoseEvaluator(false),
+          mSkelAnimBlendCount(0),
+          mPoseTriangleBVH(0),
+          mPoseTriangleBVHBlendCount(0),
         mMeshLodIndex(0),
         mMeshLodFactorTransformed(1.0f),
         mMinMeshLodIndex(99),
@@ -116,6 +124,10 @@ namespace Ogre {
         mSkipAnimStateUpdates(false),
         mAlwaysUpdateMainSkeleton(false),
         mUpdateBoundingBoxFromSkeleton(false),
+        mUseSkeletonPoseEvaluator(false),
+        mSkelAnimBlendCount(0),
+        mPoseTriangleBVH(0),
+        mPoseTriangleBVHBlendCount(0),
         mMeshLodIndex(0),
         mMeshLodFactorTransformed(1.0f),
         mMinMeshLodIndex(99),
@@ -243,6 +255,18 @@ namespace Ogre {
         if (!mInitialised)
             return;
 
+        // Don't leave this entity or its LOD entities queued for animation
+        EntityAnimationUpdater* animationUpdater =
+            mManager ? mManager->_getEntityAnimationUpdater() : 0;
+        if (animationUpdater)
+        {
+            animationUpdater->removeEntity(this);
+#if !OGRE_NO_MESHLOD
+            for (LODEntityList::iterator li = mLodEntityList.begin(); li != mLodEntityList.end(); ++li)
+                animationUpdater->removeEntity(*li);
+#endif
+        }
+
         // Delete submeshes
         SubEntityList::iterator i, iend;
         iend = mSubEntityList.end();
@@ -314,6 +338,7 @@ namespace Ogre {
         OGRE_DELETE mSkelAnimVertexData; mSkelAnimVertexData = 0;
         OGRE_DELETE mSoftwareVertexAnimVertexData; mSoftwareVertexAnimVertexData = 0;
         OGRE_DELETE mHardwareVertexAnimVertexData; mHardwareVertexAnimVertexData = 0;
+        OGRE_DELETE mPoseTriangleBVH; mPoseTriangleBVH = 0;
 
         mInitialised = false;
     }
@@ -520,6 +545,65 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    const MeshTriangleBVH* Entity::getPoseTriangleBVH(void)
+    {
+        const MeshTriangleBVH* meshBVH = mMesh->getTriangleBVH();
+
+        // Software skinned positions are only usable while the temporary
+        // buffers still hold the results of the last blend
+        if (!hasSkeleton() || mSkelAnimBlendCount == 0 || !tempSkelAnimBuffersBound(false))
+            return meshBVH;
+
+        if (!mPoseTriangleBVH)
+        {
+            mPoseTriangleBVH = OGRE_NEW MeshTriangleBVH(*meshBVH);
+            mPoseTriangleBVHBlendCount = 0;
+        }
+
+        if (mPoseTriangleBVHBlendCount != mSkelAnimBlendCount)
+        {
+            vector<const VertexData*>::type subVertexData(mSubEntityList.size(), 0);
+            for (size_t i = 0; i < mSubEntityList.size(); ++i)
+            {
+                SubEntity* sub = mSubEntityList[i];
+                if (sub->isVisible())
+                    subVertexData[i] = sub->mSkelAnimVertexData;
+            }
+            mPoseTriangleBVH->updatePositions(mSkelAnimVertexData,
+                subVertexData.empty() ? 0 : &subVertexData[0]);
+            mPoseTriangleBVHBlendCount = mSkelAnimBlendCount;
+        }
+
+        return mPoseTriangleBVH;
+    }
+    //-----------------------------------------------------------------------
+    bool Entity::intersectTriangles(const Ray& ray, MeshTriangleBVH::Hit& hit)
+    {
+        return intersectTriangles(&ray, 1, &hit) != 0;
+    }
+    //-----------------------------------------------------------------------
+    size_t Entity::intersectTriangles(const Ray* rays, size_t numRays, MeshTriangleBVH::Hit* hits)
+    {
+        if (!mMesh->isLoaded() || numRays == 0)
+        {
+            for (size_t i = 0; i < numRays; ++i)
+                hits[i].distance = Math::POS_INFINITY;
+            return 0;
+        }
+
+        // Bring the rays into mesh space; the transform is affine, so the ray
+        // parameter of a hit is the same in both spaces
+        Matrix4 worldToLocal = _getParentNodeFullTransform().inverseAffine();
+        vector<Ray>::type localRays(numRays);
+        for (size_t i = 0; i < numRays; ++i)
+        {
+            localRays[i].setOrigin(worldToLocal.transformAffine(rays[i].getOrigin()));
+            localRays[i].setDirection(worldToLocal.transformDirectionAffine(rays[i].getDirection()));
+        }
+
+        return getPoseTriangleBVH()->intersect(&localRays[0], numRays, hits, true, true);
+    }
+    //-----------------------------------------------------------------------
     const AxisAlignedBox& Entity::getBoundingBox(void) const
     {
         // Get from Mesh
@@ -750,7 +834,14 @@ namespace Ogre {
         // update the animation
         if (displayEntity->hasSkeleton() || displayEntity->hasVertexAnimation())
         {
-            displayEntity->updateAnimation();
+            // With parallel animation the update is left to the scene manager,
+            // unless objects attached to bones need it now
+            EntityAnimationUpdater* animationUpdater =
+                mManager ? mManager->_getEntityAnimationUpdater() : 0;
+            if (animationUpdater && mChildObjectList.empty())
+                animationUpdater->queueEntity(displayEntity);
+            else
+                displayEntity->updateAnimation();
 
             //--- pass this point,  we are sure that the transformation matrix of each bone and tagPoint have been updated
             ChildObjectList::iterator child_itr = mChildObjectList.begin();
@@ -999,6 +1090,7 @@ namespace Ogre {
 
                     }
 
+                    ++mSkelAnimBlendCount;
                 }
             }
 
@@ -1464,7 +1556,26 @@ namespace Ogre {
             (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
         {
             if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
+            {
+                // Pose straight into the bone matrices, unless something needs the bones
+                bool bonesUnused = !mDisplaySkeleton && !mAlwaysUpdateMainSkeleton &&
+                    !mUpdateBoundingBoxFromSkeleton && mChildObjectList.empty();
+                AnimationPoseCache* poseCache = mManager ? mManager->getAnimationPoseCache() : 0;
+                if (bonesUnused && poseCache &&
+                    poseCache->getBoneMatrices(mSkeletonInstance, *mAnimationState,
+                        currentFrameNumber, mBoneMatrices))
+                {
+                    *mFrameBonesLastUpdated = currentFrameNumber;
+                    return true;
+                }
+                if (bonesUnused && mUseSkeletonPoseEvaluator &&
+                    mSkeletonInstance->_getPoseEvaluator()->evaluate(*mAnimationState, mBoneMatrices))
+                {
+                    *mFrameBonesLastUpdated = currentFrameNumber;
+                    return true;
+                }
                 mSkeletonInstance->setAnimationState(*mAnimationState);
+            }
             mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
             *mFrameBonesLastUpdated  = currentFrameNumber;
 
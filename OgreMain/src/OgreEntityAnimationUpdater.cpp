@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreEntityAnimationUpdater.h"
+#include "OgreEntity.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationState.h"
+
+namespace Ogre {
+    namespace {
+        /// Orders entities by skeleton instance
+        struct SkeletonLess
+        {
+            bool operator()(const Entity* a, const Entity* b) const
+            {
+                return a->getSkeleton() < b->getSkeleton();
+            }
+        };
+        struct SkeletonEqual
+        {
+            bool operator()(const Entity* a, const Entity* b) const
+            {
+                return a->getSkeleton() == b->getSkeleton();
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    void EntityAnimationUpdater::PoseTask::execute(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            mUpdater->mPoseEntities[i]->cacheBoneMatrices();
+    }
+    //-----------------------------------------------------------------------
+    EntityAnimationUpdater::EntityAnimationUpdater()
+        : mBatchSize(4)
+    {
+    }
+    //-----------------------------------------------------------------------
+    EntityAnimationUpdater::~EntityAnimationUpdater()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void EntityAnimationUpdater::removeEntity(Entity* ent)
+    {
+        mEntities.erase(std::remove(mEntities.begin(), mEntities.end(), ent), mEntities.end());
+    }
+    //-----------------------------------------------------------------------
+    bool EntityAnimationUpdater::canPoseInParallel(Entity* ent)
+    {
+        if (!ent->mInitialised || !ent->hasSkeleton())
+            return false;
+
+        // Same test as Entity::updateAnimation, the pose is cached otherwise
+        bool animationDirty =
+            (ent->mFrameAnimationLastUpdated != ent->mAnimationState->getDirtyFrameNumber()) ||
+            ent->getSkeleton()->getManualBonesDirty();
+        if (!animationDirty)
+            return false;
+
+        // Tag points read the transform of their entity's scene node, which
+        // may be shared with the entities posed on other threads
+        if (!ent->mChildObjectList.empty())
+            return false;
+        if (ent->mSharedSkeletonEntities)
+        {
+            Entity::EntitySet::const_iterator i, iend = ent->mSharedSkeletonEntities->end();
+            for (i = ent->mSharedSkeletonEntities->begin(); i != iend; ++i)
+            {
+                if (!(*i)->mChildObjectList.empty())
+                    return false;
+            }
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void EntityAnimationUpdater::update(WorkQueue* workQueue)
+    {
+        if (mEntities.empty())
+            return;
+
+        // Pick one entity per skeleton instance, the first queued as that
+        // is the one which would have posed it
+        mPoseEntities.clear();
+        for (EntityList::iterator i = mEntities.begin(); i != mEntities.end(); ++i)
+        {
+            if (canPoseInParallel(*i))
+                mPoseEntities.push_back(*i);
+        }
+        std::stable_sort(mPoseEntities.begin(), mPoseEntities.end(), SkeletonLess());
+        mPoseEntities.erase(std::unique(mPoseEntities.begin(), mPoseEntities.end(), SkeletonEqual()),
+            mPoseEntities.end());
+
+        // Build on this thread what the animations would build on demand
+        for (EntityList::iterator i = mPoseEntities.begin(); i != mPoseEntities.end(); ++i)
+        {
+            Entity* ent = *i;
+            if (ent->mSkipAnimStateUpdates)
+                continue;
+
+            ConstEnabledAnimationStateIterator it =
+                ent->mAnimationState->getEnabledAnimationStateIterator();
+            while (it.hasMoreElements())
+            {
+                Animation* anim = ent->mSkeletonInstance->_getAnimationImpl(it.getNext()->getAnimationName());
+                if (anim)
+                    anim->_prepareForApply();
+            }
+        }
+
+        PoseTask task;
+        task.mUpdater = this;
+        if (workQueue)
+            workQueue->parallelFor(&task, mPoseEntities.size(), mBatchSize);
+        else
+            task.execute(0, mPoseEntities.size());
+
+        // The rest in queue order, with the bone matrices already cached
+        for (EntityList::iterator i = mEntities.begin(); i != mEntities.end(); ++i)
+        {
+            (*i)->updateAnimation();
+        }
+        mEntities.clear();
+    }
+}
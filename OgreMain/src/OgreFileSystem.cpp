@@ -55,6 +55,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    size_t FileSystemArchive::msMemoryMappingThreshold = 0;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -225,6 +226,19 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+        if (readOnly && msMemoryMappingThreshold > 0 &&
+            (size_t)tagStat.st_size >= msMemoryMappingThreshold)
+        {
+            try
+            {
+                return DataStreamPtr(OGRE_NEW MappedFileDataStream(filename, full_path));
+            }
+            catch (Exception&)
+            {
+                // Read it the usual way instead
+            }
+        }
+
         if (!readOnly)
         {
             mode |= std::ios::out;
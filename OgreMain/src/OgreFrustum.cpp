@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreRenderSystem.h"
 #include "OgreMovablePlane.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 
@@ -286,6 +287,39 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
+    void Frustum::isVisible(const Vector3* centres, const Vector3* halfSizes, 
+        size_t count, uint32* visibilityMask) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        Plane planes[6];
+        size_t numPlanes = 0;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                continue;
+
+            planes[numPlanes++] = mFrustumPlanes[plane];
+        }
+
+        OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(
+            planes, numPlanes, centres, halfSizes, visibilityMask, count);
+    }
+    //-----------------------------------------------------------------------
+    void Frustum::isVisibleOneByOne(const Vector3* centres, const Vector3* halfSizes, 
+        size_t count, uint32* visibilityMask) const
+    {
+        std::fill(visibilityMask, visibilityMask + (count + 31) / 32, 0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            AxisAlignedBox box(centres[i] - halfSizes[i], centres[i] + halfSizes[i]);
+            if (isVisible(box))
+                visibilityMask[i / 32] |= 1u << (i % 32);
+        }
+    }
+    //-----------------------------------------------------------------------
     bool Frustum::isVisible(const Sphere& sphere, FrustumPlane* culledBy) const
     {
         // Make any pending updates to the calculated frustum planes
@@ -549,10 +583,19 @@ namespace Ogre {
 #endif
 
         RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
-        // API specific
-        renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRS);
-        // API specific for Gpu Programs
-        renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRSDepth, true);
+        if (renderSystem)
+        {
+            // API specific
+            renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRS);
+            // API specific for Gpu Programs
+            renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRSDepth, true);
+        }
+        else
+        {
+            // No render system yet, e.g. culling without rendering
+            mProjMatrixRS = mProjMatrix;
+            mProjMatrixRSDepth = mProjMatrix;
+        }
 
 
         // Calculate bounding box (local)
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "OgreSphere.h"
 #include "OgreAxisAlignedBox.h"
 #include "OgrePlane.h"
+#include "OgreAtomicScalar.h"
 
 
 namespace Ogre
@@ -59,6 +60,45 @@ namespace Ogre
 
     Math::RandomValueProvider* Math::mRandProvider = NULL;
 
+    namespace {
+        /// Random value provider of a thread, see Math::SetThreadRandomValueProvider
+        struct ThreadRandomValueProvider : public GeneralAllocatedObject
+        {
+            Math::RandomValueProvider* provider;
+            ThreadRandomValueProvider() : provider(0) {}
+        };
+        /** Number of threads with a provider of their own, so that the thread
+            slot is only looked up while one is set, i.e. while particle systems
+            update in parallel. */
+        AtomicScalar<uint32> gThreadRandProviderCount(0);
+#if OGRE_THREAD_PROVIDER == 4
+        // ThreadLocalPtr may not be read on a thread before it was set there
+        thread_local ThreadRandomValueProvider gThreadRandProvider;
+
+        ThreadRandomValueProvider* peekThreadRandProvider() { return &gThreadRandProvider; }
+        ThreadRandomValueProvider* getThreadRandProvider() { return &gThreadRandProvider; }
+#else
+        OGRE_THREAD_POINTER_VAR(ThreadRandomValueProvider, gThreadRandProvider);
+
+        /// Returns the provider of this thread, 0 if none was ever set on it
+        ThreadRandomValueProvider* peekThreadRandProvider()
+        {
+            return OGRE_THREAD_POINTER_GET(gThreadRandProvider);
+        }
+        /// Returns the provider of this thread, allocated the first time only
+        ThreadRandomValueProvider* getThreadRandProvider()
+        {
+            ThreadRandomValueProvider* threadProvider = OGRE_THREAD_POINTER_GET(gThreadRandProvider);
+            if (!threadProvider)
+            {
+                threadProvider = OGRE_NEW ThreadRandomValueProvider();
+                OGRE_THREAD_POINTER_SET(gThreadRandProvider, threadProvider);
+            }
+            return threadProvider;
+        }
+#endif
+    }
+
     //-----------------------------------------------------------------------
     Math::Math( unsigned int trigTableSize )
     {
@@ -171,6 +211,12 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Real Math::UnitRandom ()
     {
+        if (gThreadRandProviderCount.get())
+        {
+            ThreadRandomValueProvider* threadProvider = peekThreadRandProvider();
+            if (threadProvider && threadProvider->provider)
+                return threadProvider->provider->getRandomUnit();
+        }
         if (mRandProvider)
             return mRandProvider->getRandomUnit();
         else return asm_rand() / asm_rand_max();
@@ -193,6 +239,19 @@ namespace Ogre
     {
         mRandProvider = provider;
     }
+    //-----------------------------------------------------------------------
+    void Math::SetThreadRandomValueProvider(RandomValueProvider* provider)
+    {
+        // Kept allocated when cleared, as this is done for every parallel update
+        ThreadRandomValueProvider* threadProvider = provider ? getThreadRandProvider() : peekThreadRandProvider();
+        if (!threadProvider)
+            return;
+        if (provider && !threadProvider->provider)
+            ++gThreadRandProviderCount;
+        else if (!provider && threadProvider->provider)
+            --gThreadRandProviderCount;
+        threadProvider->provider = provider;
+    }
 
 
    //-----------------------------------------------------------------------
@@ -33,10 +33,12 @@ THE SOFTWARE.
 #include "OgreMeshSerializer.h"
 #include "OgreSkeletonManager.h"
 #include "OgreHardwareBufferManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreException.h"
 #include "OgreMeshManager.h"
 #include "OgreEdgeListBuilder.h"
+#include "OgreMeshTriangleBVH.h"
 #include "OgreAnimation.h"
 #include "OgreAnimationState.h"
 #include "OgreAnimationTrack.h"
@@ -65,10 +67,12 @@ namespace Ogre {
         mPreparedForShadowVolumes(false),
         mEdgeListsBuilt(false),
         mAutoBuildEdgeLists(true), // will be set to false by serializers of 1.30 and above
+        mTriangleBVH(0),
         mSharedVertexDataAnimationType(VAT_NONE),
         mSharedVertexDataAnimationIncludesNormals(false),
         mAnimationTypesDirty(true),
         mPosesIncludeNormals(false),
+        mStagingBufferManager(0),
         sharedVertexData(0)
     {
         // Init first (manual) lod
@@ -85,6 +89,7 @@ namespace Ogre {
         // have to call this here reather than in Resource destructor
         // since calling virtual methods in base destructors causes crash
         unload();
+        freeTriangleBVH();
     }
     //-----------------------------------------------------------------------
     SubMesh* Mesh::createSubMesh()
@@ -229,31 +234,61 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, true, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless it is there already (e.g. mapped)
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+
+        // Parse into system memory buffers right away, so the file data can
+        // go and loadImpl only has to move the geometry to the hardware. Not
+        // worth it when loading straight away.
+        if (MeshManager::getSingleton().getDeferHardwareBufferCreation() &&
+            getLoadingState() == LOADSTATE_PREPARING)
+        {
+            DataStreamPtr data(mFreshFromDisk);
+            mFreshFromDisk.setNull();
+
+            mStagingBufferManager = OGRE_NEW DefaultHardwareBufferManagerBase();
+
+            MeshSerializer serializer;
+            serializer.setListener(MeshManager::getSingleton().getListener());
+            serializer.setBufferManager(mStagingBufferManager);
+            serializer.importMesh(data, this);
+        }
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
     {
         mFreshFromDisk.setNull();
+
+        // Drop the geometry parsed by prepareImpl as well
+        if (mStagingBufferManager)
+            unloadImpl();
     }
     void Mesh::loadImpl()
     {
-        MeshSerializer serializer;
-        serializer.setListener(MeshManager::getSingleton().getListener());
+        if (mStagingBufferManager)
+        {
+            // Already parsed by prepareImpl
+            uploadStagedGeometry();
+        }
+        else
+        {
+            MeshSerializer serializer;
+            serializer.setListener(MeshManager::getSingleton().getListener());
 
-        // If the only copy is local on the stack, it will be cleaned
-        // up reliably in case of exceptions, etc
-        DataStreamPtr data(mFreshFromDisk);
-        mFreshFromDisk.setNull();
+            // If the only copy is local on the stack, it will be cleaned
+            // up reliably in case of exceptions, etc
+            DataStreamPtr data(mFreshFromDisk);
+            mFreshFromDisk.setNull();
 
-        if (data.isNull()) {
-            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
-                        "Data doesn't appear to have been prepared in " + mName,
-                        "Mesh::loadImpl()");
-        }
+            if (data.isNull()) {
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                            "Data doesn't appear to have been prepared in " + mName,
+                            "Mesh::loadImpl()");
+            }
 
-        serializer.importMesh(data, this);
+            serializer.importMesh(data, this);
+        }
 
         /* check all submeshes to see if their materials should be
            updated.  If the submesh has texture aliases that match those
@@ -282,6 +317,7 @@ namespace Ogre {
         mSubMeshNameMap.clear();
 
         freeEdgeList();
+        freeTriangleBVH();
 #if !OGRE_NO_MESHLOD
         // Removes all LOD data
         removeLodLevels();
@@ -298,6 +334,87 @@ namespace Ogre {
 
         // Removes reference to skeleton
         setSkeletonName(BLANKSTRING);
+
+        // All the staged buffers are gone now, if there were any
+        if (mStagingBufferManager)
+        {
+            OGRE_DELETE mStagingBufferManager;
+            mStagingBufferManager = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    static void uploadStagedIndexData(IndexData* indexData, bool useShadowBuffer,
+        map<HardwareIndexBuffer*, HardwareIndexBufferSharedPtr>::type& uploaded)
+    {
+        if (!indexData || indexData->indexBuffer.isNull())
+            return;
+
+        // LOD levels may share a buffer, keep them sharing it
+        HardwareIndexBufferSharedPtr& dstbuf = uploaded[indexData->indexBuffer.get()];
+        if (dstbuf.isNull())
+        {
+            const HardwareIndexBufferSharedPtr& srcbuf = indexData->indexBuffer;
+            dstbuf = HardwareBufferManager::getSingleton().createIndexBuffer(
+                srcbuf->getType(), srcbuf->getNumIndexes(), srcbuf->getUsage(), useShadowBuffer);
+            dstbuf->copyData(*srcbuf.get());
+        }
+        indexData->indexBuffer = dstbuf;
+    }
+    //-----------------------------------------------------------------------
+    void Mesh::uploadStagedGeometry(void)
+    {
+        HardwareBufferManager* mgr = HardwareBufferManager::getSingletonPtr();
+
+        if (sharedVertexData)
+            sharedVertexData->transferBuffers(mgr, mVertexBufferShadowBuffer);
+
+        map<HardwareIndexBuffer*, HardwareIndexBufferSharedPtr>::type uploaded;
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+        {
+            SubMesh* sub = *i;
+            if (!sub->useSharedVertices)
+                sub->vertexData->transferBuffers(mgr, mVertexBufferShadowBuffer);
+
+            uploadStagedIndexData(sub->indexData, mIndexBufferShadowBuffer, uploaded);
+            for (SubMesh::LODFaceList::iterator l = sub->mLodFaceList.begin();
+                l != sub->mLodFaceList.end(); ++l)
+            {
+                uploadStagedIndexData(*l, mIndexBufferShadowBuffer, uploaded);
+            }
+        }
+
+        // Morph keyframes, created the way the serializer creates them
+        for (AnimationList::iterator a = mAnimationsList.begin(); a != mAnimationsList.end(); ++a)
+        {
+            Animation::VertexTrackIterator t = a->second->getVertexTrackIterator();
+            while (t.hasMoreElements())
+            {
+                VertexAnimationTrack* track = t.getNext();
+                if (track->getAnimationType() != VAT_MORPH)
+                    continue;
+
+                for (unsigned short k = 0; k < track->getNumKeyFrames(); ++k)
+                {
+                    VertexMorphKeyFrame* kf = track->getVertexMorphKeyFrame(k);
+                    HardwareVertexBufferSharedPtr srcbuf = kf->getVertexBuffer();
+                    HardwareVertexBufferSharedPtr dstbuf = mgr->createVertexBuffer(
+                        srcbuf->getVertexSize(), srcbuf->getNumVertices(), srcbuf->getUsage(), true);
+                    dstbuf->copyData(*srcbuf.get());
+                    kf->setVertexBuffer(dstbuf);
+                }
+            }
+        }
+
+        OGRE_DELETE mStagingBufferManager;
+        mStagingBufferManager = 0;
+
+        // The skeleton was only prepared along with the geometry
+        if (!mSkeleton.isNull())
+        {
+            String skelName = mSkeletonName;
+            mSkeletonName.clear();
+            setSkeletonName(skelName);
+        }
     }
     //-----------------------------------------------------------------------
     void Mesh::reload(LoadingFlags flags)
@@ -527,9 +644,13 @@ namespace Ogre {
             }
             else
             {
-                // Load skeleton
+                // Load skeleton, or only prepare it while the geometry is
+                // being staged; uploadStagedGeometry sets it again to load it
                 try {
-                    mSkeleton = SkeletonManager::getSingleton().load(skelName, mGroup).staticCast<Skeleton>();
+                    if (mStagingBufferManager)
+                        mSkeleton = SkeletonManager::getSingleton().prepare(skelName, mGroup).staticCast<Skeleton>();
+                    else
+                        mSkeleton = SkeletonManager::getSingleton().load(skelName, mGroup).staticCast<Skeleton>();
                 }
                 catch (...)
                 {
@@ -1800,6 +1921,22 @@ namespace Ogre {
         mEdgeListsBuilt = false;
     }
     //---------------------------------------------------------------------
+    const MeshTriangleBVH* Mesh::getTriangleBVH(void)
+    {
+        if (!mTriangleBVH)
+        {
+            mTriangleBVH = OGRE_NEW MeshTriangleBVH();
+            mTriangleBVH->build(this);
+        }
+        return mTriangleBVH;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::freeTriangleBVH(void)
+    {
+        OGRE_DELETE mTriangleBVH;
+        mTriangleBVH = 0;
+    }
+    //---------------------------------------------------------------------
     void Mesh::prepareForShadowVolume(void)
     {
         if (mPreparedForShadowVolumes)
@@ -55,6 +55,7 @@ namespace Ogre
     mBoundsPaddingFactor(0.01), mListener(0)
     {
         mPrepAllMeshesForShadowVolumes = false;
+        mDeferHardwareBufferCreation = false;
 
         mLoadOrder = 350.0f;
         mResourceType = "Mesh";
@@ -965,6 +966,16 @@ namespace Ogre
         return mPrepAllMeshesForShadowVolumes;
     }
     //-----------------------------------------------------------------------
+    void MeshManager::setDeferHardwareBufferCreation(bool defer)
+    {
+        mDeferHardwareBufferCreation = defer;
+    }
+    //-----------------------------------------------------------------------
+    bool MeshManager::getDeferHardwareBufferCreation(void) const
+    {
+        return mDeferHardwareBufferCreation;
+    }
+    //-----------------------------------------------------------------------
     Real MeshManager::getBoundsPaddingFactor(void)
     {
         return mBoundsPaddingFactor;
@@ -38,7 +38,7 @@ namespace Ogre {
     const unsigned short HEADER_CHUNK_ID = 0x1000;
     //---------------------------------------------------------------------
     MeshSerializer::MeshSerializer()
-        :mListener(0)
+        :mListener(0), mBufferManager(0)
     {
         // Init implementations
         // String identifiers have not always been 100% unified with OGRE version
@@ -186,6 +186,7 @@ namespace Ogre {
                         "mesh version " + ver, "MeshSerializer::importMesh");
         
         // Call implementation
+        impl->setBufferManager(mBufferManager);
         impl->importMesh(stream, pDest, mListener);
         // Warn on old version of mesh
         if (ver != mVersionData[0]->versionString)
@@ -208,5 +209,15 @@ namespace Ogre {
     {
         return mListener;
     }
+    //-------------------------------------------------------------------------
+    void MeshSerializer::setBufferManager(HardwareBufferManagerBase* mgr)
+    {
+        mBufferManager = mgr;
+    }
+    //-------------------------------------------------------------------------
+    HardwareBufferManagerBase* MeshSerializer::getBufferManager(void) const
+    {
+        return mBufferManager;
+    }
 }
 
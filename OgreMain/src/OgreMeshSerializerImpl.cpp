@@ -54,6 +54,7 @@ namespace Ogre {
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl()
+        : mBufferManager(0)
     {
         // Version number
         mVersion = "[MeshSerializer_v1.100]";
@@ -63,6 +64,16 @@ namespace Ogre {
     {
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::setBufferManager(HardwareBufferManagerBase* mgr)
+    {
+        mBufferManager = mgr;
+    }
+    //---------------------------------------------------------------------
+    HardwareBufferManagerBase* MeshSerializerImpl::getBufferManager(void) const
+    {
+        return mBufferManager ? mBufferManager : HardwareBufferManager::getSingletonPtr();
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::exportMesh(const Mesh* pMesh, 
         DataStreamPtr stream, Endian endianMode)
     {
@@ -817,7 +828,7 @@ namespace Ogre {
 
         // Create / populate vertex buffer
         HardwareVertexBufferSharedPtr vbuf;
-        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        vbuf = getBufferManager()->createVertexBuffer(
             vertexSize,
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
@@ -924,7 +935,7 @@ namespace Ogre {
                 switch(streamID)
                 {
                 case M_GEOMETRY:
-                    pMesh->sharedVertexData = OGRE_NEW VertexData();
+                    pMesh->sharedVertexData = OGRE_NEW VertexData(getBufferManager());
                     try {
                         readGeometry(stream, pMesh, pMesh->sharedVertexData);
                     }
@@ -1020,7 +1031,7 @@ namespace Ogre {
         {
             if (idx32bit)
             {
-                ibuf = HardwareBufferManager::getSingleton().
+                ibuf = getBufferManager()->
                     createIndexBuffer(
                         HardwareIndexBuffer::IT_32BIT,
                         sm->indexData->indexCount,
@@ -1036,7 +1047,7 @@ namespace Ogre {
             }
             else // 16-bit
             {
-                ibuf = HardwareBufferManager::getSingleton().
+                ibuf = getBufferManager()->
                     createIndexBuffer(
                         HardwareIndexBuffer::IT_16BIT,
                         sm->indexData->indexCount,
@@ -1063,7 +1074,7 @@ namespace Ogre {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Missing geometry data in mesh file",
                     "MeshSerializerImpl::readSubMesh");
             }
-            sm->vertexData = OGRE_NEW VertexData();
+            sm->vertexData = OGRE_NEW VertexData(getBufferManager());
             readGeometry(stream, pMesh, sm->vertexData);
         }
 
@@ -1603,7 +1614,7 @@ namespace Ogre {
                 unsigned int buffIndexCount;
                 readInts(stream, &buffIndexCount, 1);
 
-                indexData->indexBuffer = HardwareBufferManager::getSingleton().
+                indexData->indexBuffer = getBufferManager()->
                     createIndexBuffer(idx32Bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
                     buffIndexCount, pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
                 void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
@@ -2676,7 +2687,7 @@ namespace Ogre {
         size_t vertexCount = track->getAssociatedVertexData()->vertexCount;
         size_t vertexSize = sizeof(float) * (includesNormals ? 6 : 3);
         HardwareVertexBufferSharedPtr vbuf =
-            HardwareBufferManager::getSingleton().createVertexBuffer(
+            getBufferManager()->createVertexBuffer(
                 vertexSize, vertexCount,
                 HardwareBuffer::HBU_STATIC, true);
         // float x,y,z          // repeat by number of vertices in original geometry
@@ -3035,7 +3046,7 @@ namespace Ogre {
                 // unsigned short*/int* faceIndexes;  ((v1, v2, v3) * numFaces)
                 if (idx32Bit)
                 {
-                    indexData->indexBuffer = HardwareBufferManager::getSingleton().
+                    indexData->indexBuffer = getBufferManager()->
                         createIndexBuffer(HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
                     unsigned int* pIdx = static_cast<unsigned int*>(
@@ -3050,7 +3061,7 @@ namespace Ogre {
                 }
                 else
                 {
-                    indexData->indexBuffer = HardwareBufferManager::getSingleton().
+                    indexData->indexBuffer = getBufferManager()->
                         createIndexBuffer(HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
                     unsigned short* pIdx = static_cast<unsigned short*>(
@@ -3265,7 +3276,7 @@ namespace Ogre {
         // Create buffer, allow read and use shadow buffer
         size_t vertexCount = track->getAssociatedVertexData()->vertexCount;
         HardwareVertexBufferSharedPtr vbuf =
-            HardwareBufferManager::getSingleton().createVertexBuffer(
+            getBufferManager()->createVertexBuffer(
                 VertexElement::getTypeSize(VET_FLOAT3), vertexCount,
                 HardwareBuffer::HBU_STATIC, true);
         // float x,y,z          // repeat by number of vertices in original geometry
@@ -4131,7 +4142,7 @@ namespace Ogre {
         HardwareVertexBufferSharedPtr vbuf;
         // float* pVertices (x, y, z order x numVertices)
         dest->vertexDeclaration->addElement(bindIdx, 0, VET_FLOAT3, VES_POSITION);
-        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        vbuf = getBufferManager()->createVertexBuffer(
             dest->vertexDeclaration->getVertexSize(bindIdx),
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
@@ -4150,7 +4161,7 @@ namespace Ogre {
         HardwareVertexBufferSharedPtr vbuf;
         // float* pNormals (x, y, z order x numVertices)
         dest->vertexDeclaration->addElement(bindIdx, 0, VET_FLOAT3, VES_NORMAL);
-        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        vbuf = getBufferManager()->createVertexBuffer(
             dest->vertexDeclaration->getVertexSize(bindIdx),
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
@@ -4169,7 +4180,7 @@ namespace Ogre {
         HardwareVertexBufferSharedPtr vbuf;
         // unsigned long* pColours (RGBA 8888 format x numVertices)
         dest->vertexDeclaration->addElement(bindIdx, 0, VET_COLOUR, VES_DIFFUSE);
-        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        vbuf = getBufferManager()->createVertexBuffer(
             dest->vertexDeclaration->getVertexSize(bindIdx),
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
@@ -4196,7 +4207,7 @@ namespace Ogre {
             VertexElement::multiplyTypeCount(VET_FLOAT1, dim),
             VES_TEXTURE_COORDINATES,
             texCoordSet);
-        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        vbuf = getBufferManager()->createVertexBuffer(
             dest->vertexDeclaration->getVertexSize(bindIdx),
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
@@ -4235,7 +4246,7 @@ namespace Ogre {
             VertexElement::multiplyTypeCount(VET_FLOAT1, dim),
             VES_TEXTURE_COORDINATES,
             texCoordSet);
-        vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        vbuf = getBufferManager()->createVertexBuffer(
             dest->vertexDeclaration->getVertexSize(bindIdx),
             dest->vertexCount,
             pMesh->getVertexBufferUsage(),
@@ -0,0 +1,667 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMeshTriangleBVH.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreRay.h"
+
+namespace Ogre {
+
+    namespace {
+        /// Number of bins of the surface area heuristic
+        const size_t NUM_BINS = 12;
+
+        /// Bounds of a set of points, kept as two vectors for speed
+        struct Bounds
+        {
+            Vector3 minimum;
+            Vector3 maximum;
+
+            Bounds()
+                : minimum(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY)
+                , maximum(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY)
+            {
+            }
+
+            void merge(const Vector3& point)
+            {
+                minimum.makeFloor(point);
+                maximum.makeCeil(point);
+            }
+
+            void merge(const Bounds& bounds)
+            {
+                minimum.makeFloor(bounds.minimum);
+                maximum.makeCeil(bounds.maximum);
+            }
+
+            Real halfArea() const
+            {
+                if (minimum.x > maximum.x)
+                    return 0;
+                Vector3 size = maximum - minimum;
+                return size.x * size.y + size.y * size.z + size.z * size.x;
+            }
+        };
+
+        /// Whether a triangle's centroid falls in the bins left of the split
+        struct CentroidLeftOfSplit
+        {
+            const vector<Vector3>::type* centroids;
+            int axis;
+            Real minimum;
+            Real scale;
+            size_t split;
+
+            bool operator()(uint32 tri) const
+            {
+                size_t bin = std::min(NUM_BINS - 1,
+                    static_cast<size_t>(((*centroids)[tri][axis] - minimum) * scale));
+                return bin <= split;
+            }
+        };
+
+        /// Orders triangles by centroid along an axis
+        struct CentroidLess
+        {
+            const vector<Vector3>::type* centroids;
+            int axis;
+
+            bool operator()(uint32 a, uint32 b) const
+            {
+                return (*centroids)[a][axis] < (*centroids)[b][axis];
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    MeshTriangleBVH::MeshTriangleBVH()
+    {
+    }
+    //-----------------------------------------------------------------------
+    MeshTriangleBVH::~MeshTriangleBVH()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::build(const Mesh* mesh)
+    {
+        mNodes.clear();
+        mTriangles.clear();
+        mPositions.clear();
+
+        // Find out how many vertices each vertex data has
+        unsigned short numSubMeshes = mesh->getNumSubMeshes();
+        VertexRange empty = { 0, 0 };
+        mVertexRanges.assign(numSubMeshes + 1, empty);
+        uint32 numVertices = 0;
+        for (unsigned short i = 0; i <= numSubMeshes; ++i)
+        {
+            const VertexData* vertexData = i == 0 ? mesh->sharedVertexData :
+                (mesh->getSubMesh(i - 1)->useSharedVertices ? 0 : mesh->getSubMesh(i - 1)->vertexData);
+            if (!vertexData)
+                continue;
+
+            const VertexElement* posElem = 
+                vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            if (!posElem)
+                continue;
+
+            mVertexRanges[i].start = numVertices;
+            mVertexRanges[i].count = static_cast<uint32>(
+                vertexData->vertexBufferBinding->getBuffer(posElem->getSource())->getNumVertices());
+            numVertices += mVertexRanges[i].count;
+        }
+
+        mPositions.resize(numVertices);
+        for (unsigned short i = 0; i <= numSubMeshes; ++i)
+        {
+            if (!mVertexRanges[i].count)
+                continue;
+
+            readPositions(i == 0 ? mesh->sharedVertexData : mesh->getSubMesh(i - 1)->vertexData,
+                mVertexRanges[i]);
+        }
+
+        for (unsigned short i = 0; i < numSubMeshes; ++i)
+        {
+            const SubMesh* subMesh = mesh->getSubMesh(i);
+            const VertexRange& range = mVertexRanges[subMesh->useSharedVertices ? 0 : i + 1];
+            if (range.count)
+                addTriangles(subMesh, i, range);
+        }
+
+        buildNodes();
+        refit();
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::updatePositions(const VertexData* sharedVertexData,
+        const VertexData* const* subMeshVertexData)
+    {
+        if (sharedVertexData && mVertexRanges[0].count)
+            readPositions(sharedVertexData, mVertexRanges[0]);
+
+        for (size_t i = 1; i < mVertexRanges.size(); ++i)
+        {
+            if (subMeshVertexData && subMeshVertexData[i - 1] && mVertexRanges[i].count)
+                readPositions(subMeshVertexData[i - 1], mVertexRanges[i]);
+        }
+
+        refit();
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::readPositions(const VertexData* vertexData, const VertexRange& range)
+    {
+        const VertexElement* posElem = 
+            vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        if (!posElem)
+            return;
+
+        HardwareVertexBufferSharedPtr vbuf = 
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        size_t count = std::min(static_cast<size_t>(range.count), vbuf->getNumVertices());
+        size_t vertexSize = vbuf->getVertexSize();
+
+        unsigned char* pVertex = static_cast<unsigned char*>(
+            vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        Vector3* pDest = &mPositions[range.start];
+        for (size_t v = 0; v < count; ++v, pVertex += vertexSize)
+        {
+            float* pFloat;
+            posElem->baseVertexPointerToElement(pVertex, &pFloat);
+            pDest[v].x = pFloat[0];
+            pDest[v].y = pFloat[1];
+            pDest[v].z = pFloat[2];
+        }
+        vbuf->unlock();
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::addTriangles(const SubMesh* subMesh, unsigned short subMeshIndex,
+        const VertexRange& range)
+    {
+        RenderOperation::OperationType opType = subMesh->operationType;
+        if (opType != RenderOperation::OT_TRIANGLE_LIST &&
+            opType != RenderOperation::OT_TRIANGLE_STRIP &&
+            opType != RenderOperation::OT_TRIANGLE_FAN)
+            return;
+
+        // Gather the vertex indices, the vertices are used in order if there
+        // is no index data
+        vector<uint32>::type indices;
+        const IndexData* indexData = subMesh->indexData;
+        if (indexData && indexData->indexCount && !indexData->indexBuffer.isNull())
+        {
+            indices.resize(indexData->indexCount);
+            bool idx32bit = (indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
+            const void* pIndex = indexData->indexBuffer->lock(
+                indexData->indexStart * indexData->indexBuffer->getIndexSize(),
+                indexData->indexCount * indexData->indexBuffer->getIndexSize(),
+                HardwareBuffer::HBL_READ_ONLY);
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                indices[i] = idx32bit ? static_cast<const uint32*>(pIndex)[i] :
+                    static_cast<const uint16*>(pIndex)[i];
+            }
+            indexData->indexBuffer->unlock();
+        }
+        else
+        {
+            const VertexData* vertexData = subMesh->useSharedVertices ?
+                subMesh->parent->sharedVertexData : subMesh->vertexData;
+            indices.resize(vertexData->vertexCount);
+            for (size_t i = 0; i < indices.size(); ++i)
+                indices[i] = static_cast<uint32>(vertexData->vertexStart + i);
+        }
+
+        size_t numTriangles;
+        if (opType == RenderOperation::OT_TRIANGLE_LIST)
+            numTriangles = indices.size() / 3;
+        else
+            numTriangles = indices.size() < 3 ? 0 : indices.size() - 2;
+
+        mTriangles.reserve(mTriangles.size() + numTriangles);
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            uint32 index[3];
+            if (opType == RenderOperation::OT_TRIANGLE_LIST)
+            {
+                index[0] = indices[t * 3];
+                index[1] = indices[t * 3 + 1];
+                index[2] = indices[t * 3 + 2];
+            }
+            else if (opType == RenderOperation::OT_TRIANGLE_STRIP)
+            {
+                // Every other triangle of a strip is reversed, swap them back
+                // to keep the counter-clockwise winding
+                index[0] = indices[t + (t & 1)];
+                index[1] = indices[t + 1 - (t & 1)];
+                index[2] = indices[t + 2];
+            }
+            else
+            {
+                index[0] = indices[0];
+                index[1] = indices[t + 1];
+                index[2] = indices[t + 2];
+            }
+
+            // Skip degenerate and out of range triangles
+            if (index[0] == index[1] || index[1] == index[2] || index[2] == index[0] ||
+                index[0] >= range.count || index[1] >= range.count || index[2] >= range.count)
+                continue;
+
+            Triangle tri;
+            tri.vertex[0] = range.start + index[0];
+            tri.vertex[1] = range.start + index[1];
+            tri.vertex[2] = range.start + index[2];
+            tri.triangleIndex = static_cast<uint32>(t);
+            tri.subMeshIndex = subMeshIndex;
+            mTriangles.push_back(tri);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::buildNodes(void)
+    {
+        size_t numTriangles = mTriangles.size();
+        if (!numTriangles)
+            return;
+
+        vector<Vector3>::type centroids(numTriangles);
+        vector<uint32>::type order(numTriangles);
+        for (size_t i = 0; i < numTriangles; ++i)
+        {
+            const Triangle& tri = mTriangles[i];
+            centroids[i] = (mPositions[tri.vertex[0]] + mPositions[tri.vertex[1]] +
+                mPositions[tri.vertex[2]]) / 3;
+            order[i] = static_cast<uint32>(i);
+        }
+
+        mNodes.reserve(numTriangles * 2 / MAX_LEAF_SIZE + 1);
+        Node root;
+        root.start = 0;
+        root.count = static_cast<uint32>(numTriangles);
+        mNodes.push_back(root);
+
+        // Nodes waiting to be split, with their depth
+        typedef std::pair<uint32, size_t> PendingNode;
+        vector<PendingNode>::type pending;
+        pending.push_back(PendingNode(0, 0));
+        while (!pending.empty())
+        {
+            uint32 nodeIndex = pending.back().first;
+            size_t depth = pending.back().second;
+            pending.pop_back();
+
+            uint32 start = mNodes[nodeIndex].start;
+            uint32 count = mNodes[nodeIndex].count;
+            if (count <= MAX_LEAF_SIZE || depth >= MAX_DEPTH)
+                continue;
+
+            // Split along the axis where the centroids spread the most
+            Bounds centroidBounds;
+            for (uint32 i = start; i < start + count; ++i)
+                centroidBounds.merge(centroids[order[i]]);
+            Vector3 extent = centroidBounds.maximum - centroidBounds.minimum;
+            int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+            if (extent[axis] <= 0)
+                continue;
+
+            // Put the triangles in bins along the axis
+            CentroidLeftOfSplit left;
+            left.centroids = &centroids;
+            left.axis = axis;
+            left.minimum = centroidBounds.minimum[axis];
+            left.scale = NUM_BINS / extent[axis];
+
+            Bounds binBounds[NUM_BINS];
+            size_t binCounts[NUM_BINS] = { 0 };
+            for (uint32 i = start; i < start + count; ++i)
+            {
+                uint32 tri = order[i];
+                size_t bin = std::min(NUM_BINS - 1,
+                    static_cast<size_t>((centroids[tri][axis] - left.minimum) * left.scale));
+                ++binCounts[bin];
+                for (int v = 0; v < 3; ++v)
+                    binBounds[bin].merge(mPositions[mTriangles[tri].vertex[v]]);
+            }
+
+            // Sweep from the right to get the cost of everything right of each split
+            Real rightCost[NUM_BINS];
+            Bounds rightBounds;
+            size_t rightCount = 0;
+            for (size_t b = NUM_BINS - 1; b > 0; --b)
+            {
+                rightBounds.merge(binBounds[b]);
+                rightCount += binCounts[b];
+                rightCost[b - 1] = rightBounds.halfArea() * rightCount;
+            }
+
+            // Then from the left to find the cheapest split
+            Bounds leftBounds;
+            size_t leftCount = 0;
+            Real bestCost = Math::POS_INFINITY;
+            left.split = 0;
+            for (size_t b = 0; b < NUM_BINS - 1; ++b)
+            {
+                leftBounds.merge(binBounds[b]);
+                leftCount += binCounts[b];
+                Real cost = leftBounds.halfArea() * leftCount + rightCost[b];
+                if (leftCount && leftCount < count && cost < bestCost)
+                {
+                    bestCost = cost;
+                    left.split = b;
+                }
+            }
+
+            uint32 middle = static_cast<uint32>(
+                std::partition(order.begin() + start, order.begin() + start + count, left) -
+                order.begin());
+            if (middle == start || middle == start + count)
+            {
+                // All the centroids fell in the same bin, split at the median
+                CentroidLess less;
+                less.centroids = &centroids;
+                less.axis = axis;
+                middle = start + count / 2;
+                std::nth_element(order.begin() + start, order.begin() + middle,
+                    order.begin() + start + count, less);
+            }
+
+            Node child;
+            child.start = start;
+            child.count = middle - start;
+            uint32 leftIndex = static_cast<uint32>(mNodes.size());
+            mNodes.push_back(child);
+            child.start = middle;
+            child.count = start + count - middle;
+            mNodes.push_back(child);
+
+            mNodes[nodeIndex].start = leftIndex;
+            mNodes[nodeIndex].count = 0;
+            pending.push_back(PendingNode(leftIndex, depth + 1));
+            pending.push_back(PendingNode(leftIndex + 1, depth + 1));
+        }
+
+        // Put the triangles in leaf order
+        TriangleList sorted(numTriangles);
+        for (size_t i = 0; i < numTriangles; ++i)
+            sorted[i] = mTriangles[order[i]];
+        mTriangles.swap(sorted);
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::refit(void)
+    {
+        // Children always come after their parent
+        for (size_t n = mNodes.size(); n-- > 0; )
+        {
+            Node& node = mNodes[n];
+            Bounds bounds;
+            if (node.count)
+            {
+                for (uint32 t = node.start; t < node.start + node.count; ++t)
+                {
+                    const Triangle& tri = mTriangles[t];
+                    bounds.merge(mPositions[tri.vertex[0]]);
+                    bounds.merge(mPositions[tri.vertex[1]]);
+                    bounds.merge(mPositions[tri.vertex[2]]);
+                }
+            }
+            else
+            {
+                for (uint32 c = node.start; c < node.start + 2; ++c)
+                {
+                    const Node& child = mNodes[c];
+                    bounds.merge(Vector3(child.minimum[0], child.minimum[1], child.minimum[2]));
+                    bounds.merge(Vector3(child.maximum[0], child.maximum[1], child.maximum[2]));
+                }
+            }
+
+            for (int a = 0; a < 3; ++a)
+            {
+                node.minimum[a] = static_cast<float>(bounds.minimum[a]);
+                node.maximum[a] = static_cast<float>(bounds.maximum[a]);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBox MeshTriangleBVH::getBounds(void) const
+    {
+        if (mNodes.empty())
+            return AxisAlignedBox::BOX_NULL;
+
+        const Node& root = mNodes[0];
+        return AxisAlignedBox(root.minimum[0], root.minimum[1], root.minimum[2],
+            root.maximum[0], root.maximum[1], root.maximum[2]);
+    }
+    //-----------------------------------------------------------------------
+    bool MeshTriangleBVH::intersectNode(const Node& node, const PreparedRay& ray,
+        Real maxDistance, Real& entryDistance)
+    {
+        Real tmin = 0, tmax = maxDistance;
+        for (int a = 0; a < 3; ++a)
+        {
+            Real t1 = (node.minimum[a] - ray.origin[a]) * ray.invDirection[a];
+            Real t2 = (node.maximum[a] - ray.origin[a]) * ray.invDirection[a];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+        }
+        entryDistance = tmin;
+        return tmin <= tmax;
+    }
+    //-----------------------------------------------------------------------
+    bool MeshTriangleBVH::intersectTriangle(const Triangle& tri, const PreparedRay& ray,
+        bool positiveSide, bool negativeSide, Hit& hit) const
+    {
+        // Moller-Trumbore, det is positive when the ray hits the front face
+        const Vector3& a = mPositions[tri.vertex[0]];
+        Vector3 e1 = mPositions[tri.vertex[1]] - a;
+        Vector3 e2 = mPositions[tri.vertex[2]] - a;
+        Vector3 p = ray.direction.crossProduct(e2);
+        Real det = e1.dotProduct(p);
+        if (det == 0 || (det > 0 ? !positiveSide : !negativeSide))
+            return false;
+
+        Real invDet = 1 / det;
+        Vector3 s = ray.origin - a;
+        Real u = s.dotProduct(p) * invDet;
+        if (u < 0 || u > 1)
+            return false;
+
+        Vector3 q = s.crossProduct(e1);
+        Real v = ray.direction.dotProduct(q) * invDet;
+        if (v < 0 || u + v > 1)
+            return false;
+
+        Real t = e2.dotProduct(q) * invDet;
+        if (t < 0 || t >= hit.distance)
+            return false;
+
+        hit.distance = t;
+        hit.subMeshIndex = tri.subMeshIndex;
+        hit.triangleIndex = tri.triangleIndex;
+        hit.u = u;
+        hit.v = v;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool MeshTriangleBVH::intersect(const Ray& ray, Hit& hit,
+        bool positiveSide, bool negativeSide) const
+    {
+        hit.distance = Math::POS_INFINITY;
+        hit.subMeshIndex = 0;
+        hit.triangleIndex = 0;
+        hit.u = hit.v = 0;
+
+        PreparedRay r;
+        r.origin = ray.getOrigin();
+        r.direction = ray.getDirection();
+        r.invDirection = Vector3(1 / r.direction.x, 1 / r.direction.y, 1 / r.direction.z);
+
+        Real entry;
+        if (mNodes.empty() || !intersectNode(mNodes[0], r, hit.distance, entry))
+            return false;
+
+        // Each level pushes at most two nodes and pops one
+        std::pair<uint32, Real> stack[MAX_DEPTH + 2];
+        size_t top = 0;
+        stack[top++] = std::make_pair(0u, entry);
+        while (top)
+        {
+            --top;
+            if (stack[top].second > hit.distance)
+                continue;
+
+            const Node& node = mNodes[stack[top].first];
+            if (node.count)
+            {
+                for (uint32 t = node.start; t < node.start + node.count; ++t)
+                    intersectTriangle(mTriangles[t], r, positiveSide, negativeSide, hit);
+                continue;
+            }
+
+            // Visit the nearer child first
+            Real entry1, entry2;
+            bool hit1 = intersectNode(mNodes[node.start], r, hit.distance, entry1);
+            bool hit2 = intersectNode(mNodes[node.start + 1], r, hit.distance, entry2);
+            if (hit1 && hit2)
+            {
+                if (entry1 <= entry2)
+                {
+                    stack[top++] = std::make_pair(node.start + 1, entry2);
+                    stack[top++] = std::make_pair(node.start, entry1);
+                }
+                else
+                {
+                    stack[top++] = std::make_pair(node.start, entry1);
+                    stack[top++] = std::make_pair(node.start + 1, entry2);
+                }
+            }
+            else if (hit1)
+            {
+                stack[top++] = std::make_pair(node.start, entry1);
+            }
+            else if (hit2)
+            {
+                stack[top++] = std::make_pair(node.start + 1, entry2);
+            }
+        }
+
+        return hit.distance < Math::POS_INFINITY;
+    }
+    //-----------------------------------------------------------------------
+    size_t MeshTriangleBVH::intersect(const Ray* rays, size_t numRays, Hit* hits,
+        bool positiveSide, bool negativeSide) const
+    {
+        size_t numHits = 0;
+        for (size_t first = 0; first < numRays; first += PACKET_SIZE)
+        {
+            size_t count = numRays - first;
+            if (count > PACKET_SIZE)
+                count = PACKET_SIZE;
+            PreparedRay packet[PACKET_SIZE];
+            for (size_t i = 0; i < count; ++i)
+            {
+                PreparedRay& r = packet[i];
+                r.origin = rays[first + i].getOrigin();
+                r.direction = rays[first + i].getDirection();
+                r.invDirection = Vector3(1 / r.direction.x, 1 / r.direction.y, 1 / r.direction.z);
+
+                Hit& hit = hits[first + i];
+                hit.distance = Math::POS_INFINITY;
+                hit.subMeshIndex = 0;
+                hit.triangleIndex = 0;
+                hit.u = hit.v = 0;
+            }
+
+            if (!mNodes.empty())
+                intersectPacket(packet, count, hits + first, positiveSide, negativeSide);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (hits[first + i].distance < Math::POS_INFINITY)
+                    ++numHits;
+            }
+        }
+        return numHits;
+    }
+    //-----------------------------------------------------------------------
+    void MeshTriangleBVH::intersectPacket(const PreparedRay* rays, size_t numRays, Hit* hits,
+        bool positiveSide, bool negativeSide) const
+    {
+        uint32 stack[MAX_DEPTH + 2];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top)
+        {
+            const Node& node = mNodes[stack[--top]];
+
+            // Rays of the packet which still need this node
+            uint32 active = 0;
+            size_t firstActive = numRays;
+            for (size_t r = 0; r < numRays; ++r)
+            {
+                Real entry;
+                if (intersectNode(node, rays[r], hits[r].distance, entry))
+                {
+                    active |= 1 << r;
+                    firstActive = std::min(firstActive, r);
+                }
+            }
+            if (!active)
+                continue;
+
+            if (node.count)
+            {
+                for (uint32 t = node.start; t < node.start + node.count; ++t)
+                {
+                    for (size_t r = firstActive; r < numRays; ++r)
+                    {
+                        if (active & (1 << r))
+                            intersectTriangle(mTriangles[t], rays[r], positiveSide, negativeSide, hits[r]);
+                    }
+                }
+                continue;
+            }
+
+            // Visit first the child nearer to the first active ray
+            Real entry1 = Math::POS_INFINITY, entry2 = Math::POS_INFINITY;
+            intersectNode(mNodes[node.start], rays[firstActive], Math::POS_INFINITY, entry1);
+            intersectNode(mNodes[node.start + 1], rays[firstActive], Math::POS_INFINITY, entry2);
+            if (entry1 <= entry2)
+            {
+                stack[top++] = node.start + 1;
+                stack[top++] = node.start;
+            }
+            else
+            {
+                stack[top++] = node.start;
+                stack[top++] = node.start + 1;
+            }
+        }
+    }
+}
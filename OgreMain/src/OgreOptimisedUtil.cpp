@@ -43,8 +43,19 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
-//#elif __OGRE_HAVE_NEON
-//    extern OptimisedUtil* _getOptimisedUtilNEON(void);
+#if __OGRE_HAVE_AVX2
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+
+    //---------------------------------------------------------------------
+    // Whether the CPU can run the AVX2 implementation, which also uses FMA
+    static bool _hasAvx2AndFma(void)
+    {
+        const uint features = PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA;
+        return (PlatformInformation::getCpuFeatures() & features) == features;
+    }
+#endif
+#elif __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
+    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 //#elif __OGRE_HAVE_VFP
 //    extern OptimisedUtil* _getOptimisedUtilVFP(void);
 #endif
@@ -86,8 +97,11 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
-//#elif __OGRE_HAVE_NEON
-//            IMPL_NEON,
+#if __OGRE_HAVE_AVX2
+            IMPL_AVX2,
+#endif
+#elif __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
+            IMPL_NEON,
 //#elif __OGRE_HAVE_VFP
 //            IMPL_VFP,
 #endif
@@ -137,16 +151,22 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+#if __OGRE_HAVE_AVX2
+            if (_hasAvx2AndFma())
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
+#endif
 //#elif __OGRE_HAVE_VFP
 //            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_VFP)
 //            {
 //                mOptimisedUtils.push_back(_getOptimisedUtilVFP());
 //            }
-//#elif __OGRE_HAVE_NEON
-//            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
-//            {
-//                mOptimisedUtils.push_back(_getOptimisedUtilNEON());
-//            }
+#elif __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilNEON());
+            }
 #endif
         }
 
@@ -348,6 +368,182 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullAxisAlignedBoxes(
+                planes,
+                numPlanes,
+                centres,
+                halfSizes,
+                visibilityMask,
+                numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->concatenateBoneTransforms(
+                localTransforms,
+                bindInverseTransforms,
+                parents,
+                boneHandles,
+                derivedTransforms,
+                boneMatrices,
+                stride,
+                numSlots);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->addScaledArray(
+                dst,
+                src,
+                scale,
+                count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->multiplyAddClampArray(
+                data,
+                scale,
+                offset,
+                minValue,
+                maxValue,
+                count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->generateBillboardVertices(
+                billboards,
+                offsets,
+                texcoords,
+                dest,
+                numBillboards);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->calculateDepthKeys(
+                posX,
+                posY,
+                posZ,
+                origin,
+                direction,
+                byDistance,
+                keys,
+                count);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -402,6 +598,13 @@ namespace Ogre {
 #else   // !__DO_PROFILE__
 
 #if __OGRE_HAVE_SSE
+#if __OGRE_HAVE_AVX2
+        if (_hasAvx2AndFma())
+        {
+            return _getOptimisedUtilAVX2();
+        }
+        else
+#endif
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
             return _getOptimisedUtilSSE();
@@ -413,12 +616,12 @@ namespace Ogre {
 //            return _getOptimisedUtilVFP();
 //        }
 //        else
-//#elif __OGRE_HAVE_NEON
-//        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
-//        {
-//            return _getOptimisedUtilNEON();
-//        }
-//        else
+#elif __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+        {
+            return _getOptimisedUtilNEON();
+        }
+        else
 #endif  // __OGRE_HAVE_SSE
         {
 #if __OGRE_HAVE_DIRECTXMATH
@@ -430,5 +633,26 @@ namespace Ogre {
 
 #endif  // __DO_PROFILE__
     }
+    //---------------------------------------------------------------------
+    OptimisedUtil::ImplementationMap OptimisedUtil::getAvailableImplementations(void)
+    {
+        ImplementationMap implementations;
+        implementations["General"] = _getOptimisedUtilGeneral();
+#if __OGRE_HAVE_SSE
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+            implementations["SSE"] = _getOptimisedUtilSSE();
+#if __OGRE_HAVE_AVX2
+        if (_hasAvx2AndFma())
+            implementations["AVX2"] = _getOptimisedUtilAVX2();
+#endif
+#elif __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_NEON)
+            implementations["NEON"] = _getOptimisedUtilNEON();
+#endif
+#if __OGRE_HAVE_DIRECTXMATH
+        implementations["DirectXMath"] = _getOptimisedUtilDirectXMath();
+#endif
+        return implementations;
+    }
 
 }
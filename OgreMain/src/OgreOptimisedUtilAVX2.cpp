@@ -0,0 +1,837 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include "OgreMatrix4.h"
+#include "OgreSIMDHelper.h"
+
+#include <immintrin.h>
+
+//-------------------------------------------------------------------------
+//
+// Unlike the SSE routines, which are only compiled when the compiler
+// targets SSE anyway, the AVX2 routines are compiled for AVX2 and FMA
+// function by function, so the rest of the library keeps running on the
+// CPUs without them. Every function using the 256-bit intrinsics must be
+// marked with __OGRE_AVX2_TARGET, including the inline helpers.
+//
+// The loads and stores of the x, y, z triplets go through the masked
+// instructions, which never touch the w element, so they are safe at the
+// end of a buffer and with interleaved vertex elements.
+//
+//-------------------------------------------------------------------------
+
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+#   define __OGRE_AVX2_TARGET
+#else
+#   define __OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+
+//-------------------------------------------------------------------------
+// Local helpers
+//-------------------------------------------------------------------------
+
+    /// Loads x, y and z into a vector, with w set to zero
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE __m128 __mm_load_xyz_ps(const float* p)
+    {
+        return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)p)), _mm_load_ss(p + 2));
+    }
+    /// Stores x, y and z of a vector, leaving the memory after them untouched
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE void __mm_store_xyz_ps(float* p, __m128 v)
+    {
+        _mm_store_sd((double*)p, _mm_castps_pd(v));
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+    /// Puts the same four elements in both halves
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE __m256 __mm256_dup_ps(__m128 v)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+    }
+    /** Reciprocal square roots, refined by a Newton-Raphson step to nearly
+        full precision. Zero where the input is zero, so that zero length
+        vectors stay zero as with Vector3::normalise.
+    */
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE __m256 __mm256_rsqrt_refined_ps(__m256 x)
+    {
+        __m256 estimate = _mm256_rsqrt_ps(x);
+        __m256 halfX = _mm256_mul_ps(x, _mm256_set1_ps(0.5f));
+        // estimate * (1.5 - x / 2 * estimate^2)
+        __m256 refined = _mm256_mul_ps(estimate,
+            _mm256_fnmadd_ps(_mm256_mul_ps(halfX, estimate), estimate, _mm256_set1_ps(1.5f)));
+        return _mm256_and_ps(refined, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ));
+    }
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE __m128 __mm_rsqrt_refined_ps(__m128 x)
+    {
+        __m128 estimate = _mm_rsqrt_ps(x);
+        __m128 halfX = _mm_mul_ps(x, _mm_set1_ps(0.5f));
+        __m128 refined = _mm_mul_ps(estimate,
+            _mm_fnmadd_ps(_mm_mul_ps(halfX, estimate), estimate, _mm_set1_ps(1.5f)));
+        return _mm_and_ps(refined, _mm_cmpgt_ps(x, _mm_setzero_ps()));
+    }
+    /// Normalises the x, y, z part of a vector whose w is to be ignored
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE __m128 __mm_normalise_xyz_ps(__m128 v)
+    {
+        __m128 squares = _mm_mul_ps(v, v);
+        __m128 lengthSquared = _mm_add_ss(_mm_add_ss(squares, _mm_movehdup_ps(squares)), _mm_movehl_ps(squares, squares));
+        return _mm_mul_ps(v, _mm_broadcastss_ps(__mm_rsqrt_refined_ps(lengthSquared)));
+    }
+    /** Separates 8 packed x, y, z triplets into a vector of each component.
+    @remarks
+        The triplets are spread over the three inputs in a fixed pattern, so
+        the elements of a component are first blended together then put in
+        order with a single permutation.
+    */
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE void __mm256_deinterleave_xyz_ps(
+        __m256 in0, __m256 in1, __m256 in2, __m256& x, __m256& y, __m256& z)
+    {
+        x = _mm256_blend_ps(_mm256_blend_ps(in0, in1, 0x92), in2, 0x24);
+        y = _mm256_blend_ps(_mm256_blend_ps(in0, in1, 0x24), in2, 0x49);
+        z = _mm256_blend_ps(_mm256_blend_ps(in0, in1, 0x49), in2, 0x92);
+        x = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+        y = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+        z = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+    }
+    /// Packs 8 x, y, z triplets back, the reverse of __mm256_deinterleave_xyz_ps
+    static __OGRE_AVX2_TARGET OGRE_FORCE_INLINE void __mm256_interleave_xyz_ps(
+        __m256 x, __m256 y, __m256 z, __m256& out0, __m256& out1, __m256& out2)
+    {
+        x = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+        y = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+        z = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+        out0 = _mm256_blend_ps(_mm256_blend_ps(x, y, 0x92), z, 0x24);
+        out1 = _mm256_blend_ps(_mm256_blend_ps(x, y, 0x24), z, 0x49);
+        out2 = _mm256_blend_ps(_mm256_blend_ps(x, y, 0x49), z, 0x92);
+    }
+
+    /// Light facing flags of four faces, from the bits of a mask
+    static const uint32 msLightFacingsFromBits[16] =
+    {
+        0x00000000, 0x00000001, 0x00000100, 0x00000101,
+        0x00010000, 0x00010001, 0x00010100, 0x00010101,
+        0x01000000, 0x01000001, 0x01000100, 0x01000101,
+        0x01010000, 0x01010001, 0x01010100, 0x01010101,
+    };
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil, which also uses FMA.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    public:
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /** @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        @note
+            Forwarded to the SSE implementation, which already tests four
+            boxes at a time.
+        */
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes);
+        /** @copydoc OptimisedUtil::concatenateBoneTransforms
+        @note
+            Forwarded to the SSE implementation, which already concatenates four
+            bones at a time.
+        */
+        virtual void concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots);
+
+        /// @copydoc OptimisedUtil::addScaledArray
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::multiplyAddClampArray
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count);
+
+        /** @copydoc OptimisedUtil::generateBillboardVertices
+        @remarks
+            Vertices of six values don't map to eight lanes, this is the SSE
+            version.
+        */
+        virtual void generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards);
+
+        /// @copydoc OptimisedUtil::calculateDepthKeys
+        virtual void __OGRE_AVX2_TARGET __OGRE_SIMD_ALIGN_ATTRIBUTE calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count);
+    };
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // The blend matrices are weighted together first, as their rows 0
+        // and 1 in a 256-bit register and row 2 in a 128-bit one, then the
+        // position and normal are transformed once by the result. This
+        // takes one FMA per matrix half instead of a matrix transform per
+        // weight. Two vertices are transformed together, one in each half
+        // of the registers, which halves the horizontal adds.
+        const __m128 unitW = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t vertIdx = 0; vertIdx < numVertices; vertIdx += 2)
+        {
+            // The last vertex of an odd count is paired with itself
+            const bool pair = vertIdx + 1 < numVertices;
+            const float* pSrcPosB = pair ? rawOffsetPointer(pSrcPos, srcPosStride) : pSrcPos;
+            const float* pSrcNormB = pair && pSrcNorm ? rawOffsetPointer(pSrcNorm, srcNormStride) : pSrcNorm;
+            const float* pBlendWeightB = pair ? rawOffsetPointer(pBlendWeight, blendWeightStride) : pBlendWeight;
+            const unsigned char* pBlendIndexB = pair ? rawOffsetPointer(pBlendIndex, blendIndexStride) : pBlendIndex;
+
+            __m256 rowsA01 = _mm256_setzero_ps(), rowsB01 = _mm256_setzero_ps();
+            __m128 rowA2 = _mm_setzero_ps(), rowB2 = _mm_setzero_ps();
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                const float* mA = (*blendMatrices[pBlendIndex[blendIdx]])[0];
+                const float* mB = (*blendMatrices[pBlendIndexB[blendIdx]])[0];
+                __m256 weightA = _mm256_broadcast_ss(pBlendWeight + blendIdx);
+                __m256 weightB = _mm256_broadcast_ss(pBlendWeightB + blendIdx);
+                rowsA01 = _mm256_fmadd_ps(weightA, _mm256_loadu_ps(mA), rowsA01);
+                rowsB01 = _mm256_fmadd_ps(weightB, _mm256_loadu_ps(mB), rowsB01);
+                rowA2 = _mm_fmadd_ps(_mm256_castps256_ps128(weightA), _mm_loadu_ps(mA + 8), rowA2);
+                rowB2 = _mm_fmadd_ps(_mm256_castps256_ps128(weightB), _mm_loadu_ps(mB + 8), rowB2);
+            }
+
+            // Each row of vertex A in the low half and of vertex B in the high half
+            __m256 row0 = _mm256_permute2f128_ps(rowsA01, rowsB01, 0x20);
+            __m256 row1 = _mm256_permute2f128_ps(rowsA01, rowsB01, 0x31);
+            __m256 row2 = _mm256_insertf128_ps(_mm256_castps128_ps256(rowA2), rowB2, 1);
+
+            __m256 pos = _mm256_insertf128_ps(_mm256_castps128_ps256(
+                _mm_or_ps(__mm_load_xyz_ps(pSrcPos), unitW)),
+                _mm_or_ps(__mm_load_xyz_ps(pSrcPosB), unitW), 1);
+            __m256 p0 = _mm256_mul_ps(row0, pos);
+            __m256 p1 = _mm256_mul_ps(row1, pos);
+            __m256 p2 = _mm256_mul_ps(row2, pos);
+
+            if (pSrcNorm)
+            {
+                __m256 norm = _mm256_insertf128_ps(_mm256_castps128_ps256(
+                    __mm_load_xyz_ps(pSrcNorm)), __mm_load_xyz_ps(pSrcNormB), 1);
+                __m256 n0 = _mm256_mul_ps(row0, norm);
+                __m256 n1 = _mm256_mul_ps(row1, norm);
+                __m256 n2 = _mm256_mul_ps(row2, norm);
+
+                // The sums of row 2 are shared: p2 p2 n2 n2 in each half
+                __m256 sums2 = _mm256_hadd_ps(p2, n2);
+                // r0.pos r1.pos r2.pos - and r0.norm r1.norm - r2.norm
+                __m256 blendedPos = _mm256_hadd_ps(_mm256_hadd_ps(p0, p1), sums2);
+                __m256 blendedNorm = _mm256_hadd_ps(_mm256_hadd_ps(n0, n1), sums2);
+                blendedNorm = _mm256_blend_ps(blendedNorm, _mm256_permute_ps(blendedNorm, _MM_SHUFFLE(3, 3, 3, 3)), 0x44);
+
+                // Normalise both
+                __m256 squares = _mm256_mul_ps(blendedNorm, blendedNorm);
+                __m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(squares,
+                    _mm256_permute_ps(squares, _MM_SHUFFLE(0, 0, 0, 1))),
+                    _mm256_permute_ps(squares, _MM_SHUFFLE(0, 0, 0, 2)));
+                blendedNorm = _mm256_mul_ps(blendedNorm,
+                    _mm256_permute_ps(__mm256_rsqrt_refined_ps(lengthSquared), _MM_SHUFFLE(0, 0, 0, 0)));
+
+                __mm_store_xyz_ps(pDestNorm, _mm256_castps256_ps128(blendedNorm));
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+                if (pair)
+                {
+                    __mm_store_xyz_ps(pDestNorm, _mm256_extractf128_ps(blendedNorm, 1));
+                    advanceRawPointer(pSrcNorm, srcNormStride);
+                    advanceRawPointer(pDestNorm, destNormStride);
+                }
+
+                __mm_store_xyz_ps(pDestPos, _mm256_castps256_ps128(blendedPos));
+                if (pair)
+                    __mm_store_xyz_ps(rawOffsetPointer(pDestPos, destPosStride), _mm256_extractf128_ps(blendedPos, 1));
+            }
+            else
+            {
+                __m256 blendedPos = _mm256_hadd_ps(_mm256_hadd_ps(p0, p1), _mm256_hadd_ps(p2, p2));
+                __mm_store_xyz_ps(pDestPos, _mm256_castps256_ps128(blendedPos));
+                if (pair)
+                    __mm_store_xyz_ps(rawOffsetPointer(pDestPos, destPosStride), _mm256_extractf128_ps(blendedPos, 1));
+            }
+
+            advanceRawPointer(pSrcPos, 2 * srcPosStride);
+            advanceRawPointer(pDestPos, 2 * destPosStride);
+            advanceRawPointer(pBlendWeight, 2 * blendWeightStride);
+            advanceRawPointer(pBlendIndex, 2 * blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        const size_t packedVSize = (morphNormals ? 6 : 3) * sizeof(float);
+        if (pos1VSize == packedVSize && pos2VSize == packedVSize && dstVSize == packedVSize)
+        {
+            // Packed vertices, lerp them as a flat array, positions and
+            // normals alike
+            const __m256 t8 = _mm256_set1_ps(t);
+            const size_t numFloats = numVertices * packedVSize / sizeof(float);
+            size_t i = 0;
+            for ( ; i + 8 <= numFloats; i += 8)
+            {
+                __m256 src1 = _mm256_loadu_ps(pSrc1 + i);
+                __m256 src2 = _mm256_loadu_ps(pSrc2 + i);
+                _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(t8, _mm256_sub_ps(src2, src1), src1));
+            }
+            for ( ; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+
+            if (morphNormals)
+            {
+                // Then normalise the normals, two at a time, one in each half
+                float* pNorm = pDst + 3;
+                for ( ; numVertices >= 2; numVertices -= 2, pNorm += 12)
+                {
+                    __m256 norm = _mm256_insertf128_ps(_mm256_castps128_ps256(
+                        __mm_load_xyz_ps(pNorm)), __mm_load_xyz_ps(pNorm + 6), 1);
+                    __m256 squares = _mm256_mul_ps(norm, norm);
+                    __m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(squares,
+                        _mm256_permute_ps(squares, _MM_SHUFFLE(0, 0, 0, 1))),
+                        _mm256_permute_ps(squares, _MM_SHUFFLE(0, 0, 0, 2)));
+                    norm = _mm256_mul_ps(norm,
+                        _mm256_permute_ps(__mm256_rsqrt_refined_ps(lengthSquared), _MM_SHUFFLE(0, 0, 0, 0)));
+                    __mm_store_xyz_ps(pNorm, _mm256_castps256_ps128(norm));
+                    __mm_store_xyz_ps(pNorm + 6, _mm256_extractf128_ps(norm, 1));
+                }
+                if (numVertices)
+                {
+                    __mm_store_xyz_ps(pNorm, __mm_normalise_xyz_ps(__mm_load_xyz_ps(pNorm)));
+                }
+            }
+            return;
+        }
+
+        const __m128 t4 = _mm_set1_ps(t);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            __m128 src1 = __mm_load_xyz_ps(pSrc1);
+            __m128 src2 = __mm_load_xyz_ps(pSrc2);
+            __mm_store_xyz_ps(pDst, _mm_fmadd_ps(t4, _mm_sub_ps(src2, src1), src1));
+
+            if (morphNormals)
+            {
+                // Normals must be in the same buffer as positions, nlerp them
+                src1 = __mm_load_xyz_ps(pSrc1 + 3);
+                src2 = __mm_load_xyz_ps(pSrc2 + 3);
+                __m128 norm = _mm_fmadd_ps(t4, _mm_sub_ps(src2, src1), src1);
+                __mm_store_xyz_ps(pDst + 3, __mm_normalise_xyz_ps(norm));
+            }
+
+            advanceRawPointer(pSrc1, pos1VSize);
+            advanceRawPointer(pSrc2, pos2VSize);
+            advanceRawPointer(pDst, dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        // Rows 0 and 1 of the results are computed together, each element
+        // of the base matrix being broadcast within its half
+        const __m128 unitW = _mm_setr_ps(0, 0, 0, 1);
+        const __m256 base01 = _mm256_loadu_ps(baseMatrix[0]);
+        const __m128 base2 = _mm_loadu_ps(baseMatrix[2]);
+
+        const __m256 m01x = _mm256_permute_ps(base01, 0x00);
+        const __m256 m01y = _mm256_permute_ps(base01, 0x55);
+        const __m256 m01z = _mm256_permute_ps(base01, 0xAA);
+        const __m256 m01w = _mm256_mul_ps(_mm256_permute_ps(base01, 0xFF), __mm256_dup_ps(unitW));
+        const __m128 m2x = _mm_permute_ps(base2, 0x00);
+        const __m128 m2y = _mm_permute_ps(base2, 0x55);
+        const __m128 m2z = _mm_permute_ps(base2, 0xAA);
+        const __m128 m2w = _mm_mul_ps(_mm_permute_ps(base2, 0xFF), unitW);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* s = (*pSrcMat)[0];
+            float* d = (*pDstMat)[0];
+
+            __m256 s0 = _mm256_broadcast_ps((const __m128*)(s + 0));
+            __m256 s1 = _mm256_broadcast_ps((const __m128*)(s + 4));
+            __m256 s2 = _mm256_broadcast_ps((const __m128*)(s + 8));
+
+            __m256 d01 = _mm256_fmadd_ps(m01x, s0, _mm256_fmadd_ps(m01y, s1, _mm256_fmadd_ps(m01z, s2, m01w)));
+            __m128 d2 = _mm_fmadd_ps(m2x, _mm256_castps256_ps128(s0),
+                _mm_fmadd_ps(m2y, _mm256_castps256_ps128(s1),
+                _mm_fmadd_ps(m2z, _mm256_castps256_ps128(s2), m2w)));
+
+            _mm256_storeu_ps(d, d01);
+            _mm256_storeu_ps(d + 8, _mm256_insertf128_ps(_mm256_castps128_ps256(d2), unitW, 1));
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        // Eight triangles at a time, gathering the corners into a vector
+        // per component
+        for ( ; numTriangles >= 8; numTriangles -= 8, triangles += 8, faceNormals += 8)
+        {
+            __m256 x[3], y[3], z[3];
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                // Triangles 0 to 3 in the low half and 4 to 7 in the high half,
+                // transposed within each half. Gathers are slower than this on
+                // most CPUs.
+                __m256 p[4];
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    p[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(
+                        __mm_load_xyz_ps(positions + triangles[i].vertIndex[corner] * 3)),
+                        __mm_load_xyz_ps(positions + triangles[i + 4].vertIndex[corner] * 3), 1);
+                }
+                __m256 xy01 = _mm256_unpacklo_ps(p[0], p[1]);
+                __m256 xy23 = _mm256_unpacklo_ps(p[2], p[3]);
+                __m256 zw01 = _mm256_unpackhi_ps(p[0], p[1]);
+                __m256 zw23 = _mm256_unpackhi_ps(p[2], p[3]);
+                x[corner] = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0));
+                y[corner] = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+                z[corner] = _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+            }
+
+            // (v2 - v1) x (v3 - v1), and the distance from the origin
+            __m256 ax = _mm256_sub_ps(x[1], x[0]), ay = _mm256_sub_ps(y[1], y[0]), az = _mm256_sub_ps(z[1], z[0]);
+            __m256 bx = _mm256_sub_ps(x[2], x[0]), by = _mm256_sub_ps(y[2], y[0]), bz = _mm256_sub_ps(z[2], z[0]);
+            __m256 nx = _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by));
+            __m256 ny = _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz));
+            __m256 nz = _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx));
+            __m256 nw = _mm256_fnmsub_ps(nx, x[0], _mm256_fmadd_ps(ny, y[0], _mm256_mul_ps(nz, z[0])));
+
+            // Transpose to 8 Vector4
+            __m256 xy0 = _mm256_unpacklo_ps(nx, ny);
+            __m256 xy1 = _mm256_unpackhi_ps(nx, ny);
+            __m256 zw0 = _mm256_unpacklo_ps(nz, nw);
+            __m256 zw1 = _mm256_unpackhi_ps(nz, nw);
+            __m256 n04 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 n15 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 n26 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 n37 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+
+            float* dst = faceNormals[0].ptr();
+            _mm256_storeu_ps(dst + 0, _mm256_permute2f128_ps(n04, n15, 0x20));
+            _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(n26, n37, 0x20));
+            _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(n04, n15, 0x31));
+            _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(n26, n37, 0x31));
+        }
+
+        for ( ; numTriangles; --numTriangles)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            const float* v1 = positions + t.vertIndex[0] * 3;
+            const float* v2 = positions + t.vertIndex[1] * 3;
+            const float* v3 = positions + t.vertIndex[2] * 3;
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(
+                Vector3(v1[0], v1[1], v1[2]), Vector3(v2[0], v2[1], v2[2]), Vector3(v3[0], v3[1], v3[2]));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const __m256 light = __mm256_dup_ps(_mm_loadu_ps(lightPos.ptr()));
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        for ( ; numFaces >= 8; numFaces -= 8, faceNormals += 8, lightFacings += 8)
+        {
+            const float* n = faceNormals[0].ptr();
+            __m256 p01 = _mm256_mul_ps(_mm256_loadu_ps(n + 0), light);
+            __m256 p23 = _mm256_mul_ps(_mm256_loadu_ps(n + 8), light);
+            __m256 p45 = _mm256_mul_ps(_mm256_loadu_ps(n + 16), light);
+            __m256 p67 = _mm256_mul_ps(_mm256_loadu_ps(n + 24), light);
+
+            // Dot products of faces 0 2 4 6 in the low half and 1 3 5 7 in
+            // the high half, put back in order
+            __m256 dots = _mm256_hadd_ps(_mm256_hadd_ps(p01, p23), _mm256_hadd_ps(p45, p67));
+            dots = _mm256_permutevar8x32_ps(dots, order);
+
+            int bits = _mm256_movemask_ps(_mm256_cmp_ps(dots, _mm256_setzero_ps(), _CMP_GT_OQ));
+            memcpy(lightFacings + 0, &msLightFacingsFromBits[bits & 15], sizeof(uint32));
+            memcpy(lightFacings + 4, &msLightFacingsFromBits[bits >> 4], sizeof(uint32));
+        }
+
+        for ( ; numFaces; --numFaces)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        // Eight vertices at a time, which are three 256-bit vectors
+        size_t numBlocks = numVertices / 8;
+        numVertices -= numBlocks * 8;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 dir(-lightPos.x, -lightPos.y, -lightPos.z);
+            dir.normalise();
+            dir *= extrudeDist;
+
+            const __m256 dir0 = _mm256_setr_ps(dir.x, dir.y, dir.z, dir.x, dir.y, dir.z, dir.x, dir.y);
+            const __m256 dir1 = _mm256_setr_ps(dir.z, dir.x, dir.y, dir.z, dir.x, dir.y, dir.z, dir.x);
+            const __m256 dir2 = _mm256_setr_ps(dir.y, dir.z, dir.x, dir.y, dir.z, dir.x, dir.y, dir.z);
+
+            for ( ; numBlocks; --numBlocks, pSrcPos += 24, pDestPos += 24)
+            {
+                _mm256_storeu_ps(pDestPos + 0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 0), dir0));
+                _mm256_storeu_ps(pDestPos + 8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 8), dir1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), dir2));
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                *pDestPos++ = *pSrcPos++ + dir.x;
+                *pDestPos++ = *pSrcPos++ + dir.y;
+                *pDestPos++ = *pSrcPos++ + dir.z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m256 lightX = _mm256_set1_ps(lightPos.x);
+            const __m256 lightY = _mm256_set1_ps(lightPos.y);
+            const __m256 lightZ = _mm256_set1_ps(lightPos.z);
+            const __m256 dist = _mm256_set1_ps(extrudeDist);
+
+            for ( ; numBlocks; --numBlocks, pSrcPos += 24, pDestPos += 24)
+            {
+                __m256 x, y, z;
+                __mm256_deinterleave_xyz_ps(
+                    _mm256_loadu_ps(pSrcPos + 0), _mm256_loadu_ps(pSrcPos + 8), _mm256_loadu_ps(pSrcPos + 16),
+                    x, y, z);
+
+                __m256 dx = _mm256_sub_ps(x, lightX);
+                __m256 dy = _mm256_sub_ps(y, lightY);
+                __m256 dz = _mm256_sub_ps(z, lightZ);
+                __m256 scale = _mm256_mul_ps(dist, __mm256_rsqrt_refined_ps(
+                    _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)))));
+
+                __m256 out0, out1, out2;
+                __mm256_interleave_xyz_ps(
+                    _mm256_fmadd_ps(dx, scale, x), _mm256_fmadd_ps(dy, scale, y), _mm256_fmadd_ps(dz, scale, z),
+                    out0, out1, out2);
+                _mm256_storeu_ps(pDestPos + 0, out0);
+                _mm256_storeu_ps(pDestPos + 8, out1);
+                _mm256_storeu_ps(pDestPos + 16, out2);
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                Vector3 extrusionDir(
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Vector3* centres,
+        const Vector3* halfSizes,
+        uint32* visibilityMask,
+        size_t numBoxes)
+    {
+        _getOptimisedUtilSSE()->cullAxisAlignedBoxes(
+            planes, numPlanes, centres, halfSizes, visibilityMask, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateBoneTransforms(
+        const Real* localTransforms,
+        const Real* bindInverseTransforms,
+        const unsigned short* parents,
+        const unsigned short* boneHandles,
+        Real* derivedTransforms,
+        Matrix4* boneMatrices,
+        size_t stride,
+        size_t numSlots)
+    {
+        _getOptimisedUtilSSE()->concatenateBoneTransforms(
+            localTransforms, bindInverseTransforms, parents, boneHandles,
+            derivedTransforms, boneMatrices, stride, numSlots);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::addScaledArray(
+        Real* dst,
+        const Real* src,
+        Real scale,
+        size_t count)
+    {
+        const __m256 s = _mm256_set1_ps(scale);
+
+        // Eight elements at a time, the arrays can have any alignment
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(dst + i,
+                _mm256_fmadd_ps(_mm256_loadu_ps(src + i), s, _mm256_loadu_ps(dst + i)));
+        }
+
+        for (; i < count; ++i)
+        {
+            dst[i] += src[i] * scale;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::multiplyAddClampArray(
+        Real* data,
+        Real scale,
+        Real offset,
+        Real minValue,
+        Real maxValue,
+        size_t count)
+    {
+        const __m256 s = _mm256_set1_ps(scale);
+        const __m256 o = _mm256_set1_ps(offset);
+        const __m256 lo = _mm256_set1_ps(minValue);
+        const __m256 hi = _mm256_set1_ps(maxValue);
+
+        // Eight elements at a time, the array can have any alignment
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 d = _mm256_fmadd_ps(_mm256_loadu_ps(data + i), s, o);
+            _mm256_storeu_ps(data + i, _mm256_min_ps(_mm256_max_ps(d, lo), hi));
+        }
+
+        for (; i < count; ++i)
+        {
+            data[i] = std::min(std::max(data[i] * scale + offset, minValue), maxValue);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::generateBillboardVertices(
+        const float* billboards,
+        const float* offsets,
+        const float* texcoords,
+        float* dest,
+        size_t numBillboards)
+    {
+        _getOptimisedUtilSSE()->generateBillboardVertices(
+            billboards, offsets, texcoords, dest, numBillboards);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::calculateDepthKeys(
+        const Real* posX,
+        const Real* posY,
+        const Real* posZ,
+        const Vector3& origin,
+        const Vector3& direction,
+        bool byDistance,
+        Real* keys,
+        size_t count)
+    {
+        const __m256 ox = _mm256_set1_ps(origin.x);
+        const __m256 oy = _mm256_set1_ps(origin.y);
+        const __m256 oz = _mm256_set1_ps(origin.z);
+
+        // Eight points at a time, the arrays can have any alignment
+        size_t i = 0;
+        if (byDistance)
+        {
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(posX + i), ox);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(posY + i), oy);
+                __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(posZ + i), oz);
+                __m256 sqLen = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+                _mm256_storeu_ps(keys + i, _mm256_sub_ps(_mm256_setzero_ps(), sqLen));
+            }
+        }
+        else
+        {
+            const __m256 dirX = _mm256_set1_ps(direction.x);
+            const __m256 dirY = _mm256_set1_ps(direction.y);
+            const __m256 dirZ = _mm256_set1_ps(direction.z);
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(posX + i), ox);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(posY + i), oy);
+                __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(posZ + i), oz);
+                _mm256_storeu_ps(keys + i,
+                    _mm256_fmadd_ps(dz, dirZ, _mm256_fmadd_ps(dy, dirY, _mm256_mul_ps(dx, dirX))));
+            }
+        }
+
+        // Remaining points
+        for (; i < count; ++i)
+        {
+            Real dx = posX[i] - origin.x;
+            Real dy = posY[i] - origin.y;
+            Real dz = posZ[i] - origin.z;
+            keys[i] = byDistance ? -(dx * dx + dy * dy + dz * dz) :
+                dx * direction.x + dy * direction.y + dz * direction.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
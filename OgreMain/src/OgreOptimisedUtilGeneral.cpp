@@ -31,6 +31,8 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgrePlane.h"
+#include "OgreQuaternion.h"
 
 namespace Ogre {
 
@@ -94,6 +96,60 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::concatenateBoneTransforms
+        virtual void concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots);
+
+        /// @copydoc OptimisedUtil::addScaledArray
+        virtual void addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::multiplyAddClampArray
+        virtual void multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::generateBillboardVertices
+        virtual void generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards);
+        /// @copydoc OptimisedUtil::calculateDepthKeys
+        virtual void calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +448,195 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Vector3* centres,
+        const Vector3* halfSizes,
+        uint32* visibilityMask,
+        size_t numBoxes)
+    {
+        uint32 mask = 0;
+        uint32 bit = 1;
+        for (size_t box = 0; box < numBoxes; ++box)
+        {
+            bool visible = true;
+            for (size_t plane = 0; plane < numPlanes; ++plane)
+            {
+                if (planes[plane].getSide(centres[box], halfSizes[box]) == Plane::NEGATIVE_SIDE)
+                {
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible)
+                mask |= bit;
+
+            bit <<= 1;
+            if (!bit)
+            {
+                *visibilityMask++ = mask;
+                mask = 0;
+                bit = 1;
+            }
+        }
+
+        if (bit != 1)
+            *visibilityMask = mask;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::concatenateBoneTransforms(
+        const Real* localTransforms,
+        const Real* bindInverseTransforms,
+        const unsigned short* parents,
+        const unsigned short* boneHandles,
+        Real* derivedTransforms,
+        Matrix4* boneMatrices,
+        size_t stride,
+        size_t numSlots)
+    {
+        // Component arrays
+        const Real* lpx = localTransforms;
+        const Real* lpy = lpx + stride;
+        const Real* lpz = lpy + stride;
+        const Real* lqw = lpz + stride;
+        const Real* lqx = lqw + stride;
+        const Real* lqy = lqx + stride;
+        const Real* lqz = lqy + stride;
+        const Real* lsx = lqz + stride;
+        const Real* lsy = lsx + stride;
+        const Real* lsz = lsy + stride;
+
+        const Real* bpx = bindInverseTransforms;
+        const Real* bpy = bpx + stride;
+        const Real* bpz = bpy + stride;
+        const Real* bqw = bpz + stride;
+        const Real* bqx = bqw + stride;
+        const Real* bqy = bqx + stride;
+        const Real* bqz = bqy + stride;
+        const Real* bsx = bqz + stride;
+        const Real* bsy = bsx + stride;
+        const Real* bsz = bsy + stride;
+
+        Real* dpx = derivedTransforms;
+        Real* dpy = dpx + stride;
+        Real* dpz = dpy + stride;
+        Real* dqw = dpz + stride;
+        Real* dqx = dqw + stride;
+        Real* dqy = dqx + stride;
+        Real* dqz = dqy + stride;
+        Real* dsx = dqz + stride;
+        Real* dsy = dsx + stride;
+        Real* dsz = dsy + stride;
+
+        for (size_t i = 1; i < numSlots; ++i)
+        {
+            size_t p = parents[i];
+            Vector3 parentPosition(dpx[p], dpy[p], dpz[p]);
+            Quaternion parentOrientation(dqw[p], dqx[p], dqy[p], dqz[p]);
+            Vector3 parentScale(dsx[p], dsy[p], dsz[p]);
+
+            // Same operations as Node::updateFromParentImpl
+            Quaternion orientation = parentOrientation *
+                Quaternion(lqw[i], lqx[i], lqy[i], lqz[i]);
+            Vector3 scale = parentScale * Vector3(lsx[i], lsy[i], lsz[i]);
+            Vector3 position = parentOrientation *
+                (parentScale * Vector3(lpx[i], lpy[i], lpz[i])) + parentPosition;
+
+            dpx[i] = position.x; dpy[i] = position.y; dpz[i] = position.z;
+            dqw[i] = orientation.w; dqx[i] = orientation.x; dqy[i] = orientation.y; dqz[i] = orientation.z;
+            dsx[i] = scale.x; dsy[i] = scale.y; dsz[i] = scale.z;
+
+            // Same operations as Bone::_getOffsetTransform
+            Vector3 locScale = scale * Vector3(bsx[i], bsy[i], bsz[i]);
+            Quaternion locRotate = orientation * Quaternion(bqw[i], bqx[i], bqy[i], bqz[i]);
+            Vector3 locTranslate = position +
+                locRotate * (locScale * Vector3(bpx[i], bpy[i], bpz[i]));
+
+            boneMatrices[boneHandles[i]].makeTransform(locTranslate, locScale, locRotate);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::addScaledArray(
+        Real* dst,
+        const Real* src,
+        Real scale,
+        size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[i] += src[i] * scale;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::multiplyAddClampArray(
+        Real* data,
+        Real scale,
+        Real offset,
+        Real minValue,
+        Real maxValue,
+        size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            data[i] = std::min(std::max(data[i] * scale + offset, minValue), maxValue);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::generateBillboardVertices(
+        const float* billboards,
+        const float* offsets,
+        const float* texcoords,
+        float* dest,
+        size_t numBillboards)
+    {
+        for (size_t i = 0; i < numBillboards; ++i, billboards += 4)
+        {
+            for (size_t corner = 0; corner < 4; ++corner, dest += 6)
+            {
+                dest[0] = offsets[corner * 3 + 0] + billboards[0];
+                dest[1] = offsets[corner * 3 + 1] + billboards[1];
+                dest[2] = offsets[corner * 3 + 2] + billboards[2];
+                // Colour, copied as bits
+                memcpy(dest + 3, billboards + 3, sizeof(uint32));
+                dest[4] = texcoords[corner * 2 + 0];
+                dest[5] = texcoords[corner * 2 + 1];
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::calculateDepthKeys(
+        const Real* posX,
+        const Real* posY,
+        const Real* posZ,
+        const Vector3& origin,
+        const Vector3& direction,
+        bool byDistance,
+        Real* keys,
+        size_t count)
+    {
+        if (byDistance)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                Real dx = posX[i] - origin.x;
+                Real dy = posY[i] - origin.y;
+                Real dz = posZ[i] - origin.z;
+                keys[i] = -(dx * dx + dy * dy + dz * dz);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                keys[i] = (posX[i] - origin.x) * direction.x +
+                    (posY[i] - origin.y) * direction.y +
+                    (posZ[i] - origin.z) * direction.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -0,0 +1,673 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
+
+#include "OgreMatrix4.h"
+
+#include <arm_neon.h>
+
+//-------------------------------------------------------------------------
+//
+// The routines implemented in this file only use the intrinsics common to
+// ARMv7 and AArch64, so the multiply-adds are not fused and the square
+// roots go through the reciprocal estimates, refined by Newton-Raphson
+// steps to single precision.
+//
+// The interleaved loads and stores (vld3q/vst3q, vld4q/vst4q) do the
+// transposes between the packed x, y, z (w) vectors of the buffers and
+// a register per component.
+//
+// None of this has been built or run on an ARM device yet, so it is only
+// compiled and selected when OGRE_OPTIMISEDUTIL_NEON is defined to 1, to
+// be done once OptimisedUtilTests pass there.
+//
+//-------------------------------------------------------------------------
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
+//-------------------------------------------------------------------------
+// Local helpers
+//-------------------------------------------------------------------------
+
+    /// Loads x, y and z into a vector, with w set to zero
+    static OGRE_FORCE_INLINE float32x4_t __neon_load_xyz(const float* p)
+    {
+        return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0), 0));
+    }
+    /// Stores x, y and z of a vector, leaving the memory after them untouched
+    static OGRE_FORCE_INLINE void __neon_store_xyz(float* p, float32x4_t v)
+    {
+        vst1_f32(p, vget_low_f32(v));
+        vst1q_lane_f32(p + 2, v, 2);
+    }
+    /// Sums the four elements of a vector, into both elements of the result
+    static OGRE_FORCE_INLINE float32x2_t __neon_sum(float32x4_t v)
+    {
+        float32x2_t pairs = vpadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vpadd_f32(pairs, pairs);
+    }
+    /** Reciprocal square roots, zero where the input is zero so zero length
+        vectors stay zero as with Vector3::normalise.
+    */
+    static OGRE_FORCE_INLINE float32x4_t __neon_rsqrt(float32x4_t x)
+    {
+        float32x4_t estimate = vrsqrteq_f32(x);
+        estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(x, estimate), estimate));
+        estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(x, estimate), estimate));
+        uint32x4_t nonZero = vcgtq_f32(x, vdupq_n_f32(0));
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(estimate), nonZero));
+    }
+    /// Normalises the x, y, z part of a vector whose w is zero
+    static OGRE_FORCE_INLINE float32x4_t __neon_normalise_xyz(float32x4_t v)
+    {
+        float32x2_t lengthSquared = __neon_sum(vmulq_f32(v, v));
+        return vmulq_f32(v, __neon_rsqrt(vcombine_f32(lengthSquared, lengthSquared)));
+    }
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** NEON implementation of OptimisedUtil.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilNEON : public OptimisedUtil
+    {
+    public:
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /** @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        @note
+            Forwarded to the general implementation.
+        */
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes);
+        /** @copydoc OptimisedUtil::concatenateBoneTransforms
+        @note
+            Forwarded to the general implementation.
+        */
+        virtual void concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots);
+
+        /// @copydoc OptimisedUtil::addScaledArray
+        virtual void addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::multiplyAddClampArray
+        virtual void multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count);
+
+        /// @copydoc OptimisedUtil::generateBillboardVertices
+        virtual void generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards);
+
+        /// @copydoc OptimisedUtil::calculateDepthKeys
+        virtual void calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count);
+    };
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // The blend matrices are weighted together first, then the position
+        // and normal are transformed once by the result
+        for (size_t vertIdx = 0; vertIdx < numVertices; ++vertIdx)
+        {
+            float32x4_t row0 = vdupq_n_f32(0);
+            float32x4_t row1 = vdupq_n_f32(0);
+            float32x4_t row2 = vdupq_n_f32(0);
+            for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+            {
+                const float* m = (*blendMatrices[pBlendIndex[blendIdx]])[0];
+                float weight = pBlendWeight[blendIdx];
+                row0 = vmlaq_n_f32(row0, vld1q_f32(m + 0), weight);
+                row1 = vmlaq_n_f32(row1, vld1q_f32(m + 4), weight);
+                row2 = vmlaq_n_f32(row2, vld1q_f32(m + 8), weight);
+            }
+
+            float32x4_t pos = vsetq_lane_f32(1.0f, __neon_load_xyz(pSrcPos), 3);
+            float32x2_t xy = vpadd_f32(
+                vpadd_f32(vget_low_f32(vmulq_f32(row0, pos)), vget_high_f32(vmulq_f32(row0, pos))),
+                vpadd_f32(vget_low_f32(vmulq_f32(row1, pos)), vget_high_f32(vmulq_f32(row1, pos))));
+            float32x2_t z = __neon_sum(vmulq_f32(row2, pos));
+            vst1_f32(pDestPos, xy);
+            vst1_lane_f32(pDestPos + 2, z, 0);
+
+            if (pSrcNorm)
+            {
+                float32x4_t norm = __neon_load_xyz(pSrcNorm);
+                float32x2_t nxy = vpadd_f32(
+                    vpadd_f32(vget_low_f32(vmulq_f32(row0, norm)), vget_high_f32(vmulq_f32(row0, norm))),
+                    vpadd_f32(vget_low_f32(vmulq_f32(row1, norm)), vget_high_f32(vmulq_f32(row1, norm))));
+                float32x2_t nz = __neon_sum(vmulq_f32(row2, norm));
+                norm = vcombine_f32(nxy, vset_lane_f32(0.0f, nz, 1));
+                __neon_store_xyz(pDestNorm, __neon_normalise_xyz(norm));
+
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        if (!morphNormals &&
+            pos1VSize == 3 * sizeof(float) && pos2VSize == 3 * sizeof(float) && dstVSize == 3 * sizeof(float))
+        {
+            // Packed positions, morph them as a flat array
+            const size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for ( ; i + 4 <= numFloats; i += 4)
+            {
+                float32x4_t src1 = vld1q_f32(pSrc1 + i);
+                float32x4_t src2 = vld1q_f32(pSrc2 + i);
+                vst1q_f32(pDst + i, vmlaq_n_f32(src1, vsubq_f32(src2, src1), t));
+            }
+            for ( ; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            float32x4_t src1 = __neon_load_xyz(pSrc1);
+            float32x4_t src2 = __neon_load_xyz(pSrc2);
+            __neon_store_xyz(pDst, vmlaq_n_f32(src1, vsubq_f32(src2, src1), t));
+
+            if (morphNormals)
+            {
+                // Normals must be in the same buffer as positions, nlerp them
+                src1 = __neon_load_xyz(pSrc1 + 3);
+                src2 = __neon_load_xyz(pSrc2 + 3);
+                float32x4_t norm = vmlaq_n_f32(src1, vsubq_f32(src2, src1), t);
+                __neon_store_xyz(pDst + 3, __neon_normalise_xyz(norm));
+            }
+
+            advanceRawPointer(pSrc1, pos1VSize);
+            advanceRawPointer(pSrc2, pos2VSize);
+            advanceRawPointer(pDst, dstVSize);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+        const float unitWData[4] = { 0, 0, 0, 1 };
+        const float32x4_t unitW = vld1q_f32(unitWData);
+        const float32x4_t m0w = vmulq_n_f32(unitW, m[0][3]);
+        const float32x4_t m1w = vmulq_n_f32(unitW, m[1][3]);
+        const float32x4_t m2w = vmulq_n_f32(unitW, m[2][3]);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const float* s = (*pSrcMat)[0];
+            float* d = (*pDstMat)[0];
+
+            float32x4_t s0 = vld1q_f32(s + 0);
+            float32x4_t s1 = vld1q_f32(s + 4);
+            float32x4_t s2 = vld1q_f32(s + 8);
+
+            vst1q_f32(d + 0, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(m0w, s0, m[0][0]), s1, m[0][1]), s2, m[0][2]));
+            vst1q_f32(d + 4, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(m1w, s0, m[1][0]), s1, m[1][1]), s2, m[1][2]));
+            vst1q_f32(d + 8, vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(m2w, s0, m[2][0]), s1, m[2][1]), s2, m[2][2]));
+            vst1q_f32(d + 12, unitW);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        // Four triangles at a time, a register per component of each corner
+        for ( ; numTriangles >= 4; numTriangles -= 4, triangles += 4, faceNormals += 4)
+        {
+            float32x4_t x[3], y[3], z[3];
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const float* v0 = positions + triangles[0].vertIndex[corner] * 3;
+                const float* v1 = positions + triangles[1].vertIndex[corner] * 3;
+                const float* v2 = positions + triangles[2].vertIndex[corner] * 3;
+                const float* v3 = positions + triangles[3].vertIndex[corner] * 3;
+                float32x4x3_t v;
+                v.val[0] = v.val[1] = v.val[2] = vdupq_n_f32(0);
+                v = vld3q_lane_f32(v0, v, 0);
+                v = vld3q_lane_f32(v1, v, 1);
+                v = vld3q_lane_f32(v2, v, 2);
+                v = vld3q_lane_f32(v3, v, 3);
+                x[corner] = v.val[0];
+                y[corner] = v.val[1];
+                z[corner] = v.val[2];
+            }
+
+            // (v2 - v1) x (v3 - v1), and the distance from the origin
+            float32x4_t ax = vsubq_f32(x[1], x[0]), ay = vsubq_f32(y[1], y[0]), az = vsubq_f32(z[1], z[0]);
+            float32x4_t bx = vsubq_f32(x[2], x[0]), by = vsubq_f32(y[2], y[0]), bz = vsubq_f32(z[2], z[0]);
+            float32x4x4_t n;
+            n.val[0] = vmlsq_f32(vmulq_f32(ay, bz), az, by);
+            n.val[1] = vmlsq_f32(vmulq_f32(az, bx), ax, bz);
+            n.val[2] = vmlsq_f32(vmulq_f32(ax, by), ay, bx);
+            n.val[3] = vnegq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(n.val[0], x[0]), n.val[1], y[0]), n.val[2], z[0]));
+
+            vst4q_f32(faceNormals[0].ptr(), n);
+        }
+
+        for ( ; numTriangles; --numTriangles)
+        {
+            const EdgeData::Triangle& t = *triangles++;
+            const float* v1 = positions + t.vertIndex[0] * 3;
+            const float* v2 = positions + t.vertIndex[1] * 3;
+            const float* v3 = positions + t.vertIndex[2] * 3;
+            *faceNormals++ = Math::calculateFaceNormalWithoutNormalize(
+                Vector3(v1[0], v1[1], v1[2]), Vector3(v2[0], v2[1], v2[2]), Vector3(v3[0], v3[1], v3[2]));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const float32x4_t zero = vdupq_n_f32(0);
+        const uint8x8_t one = vdup_n_u8(1);
+
+        for ( ; numFaces >= 8; numFaces -= 8, faceNormals += 8, lightFacings += 8)
+        {
+            // The interleaved loads give a register per component
+            float32x4x4_t n0 = vld4q_f32(faceNormals[0].ptr());
+            float32x4x4_t n1 = vld4q_f32(faceNormals[4].ptr());
+
+            float32x4_t dots0 = vmulq_n_f32(n0.val[0], lightPos.x);
+            dots0 = vmlaq_n_f32(dots0, n0.val[1], lightPos.y);
+            dots0 = vmlaq_n_f32(dots0, n0.val[2], lightPos.z);
+            dots0 = vmlaq_n_f32(dots0, n0.val[3], lightPos.w);
+            float32x4_t dots1 = vmulq_n_f32(n1.val[0], lightPos.x);
+            dots1 = vmlaq_n_f32(dots1, n1.val[1], lightPos.y);
+            dots1 = vmlaq_n_f32(dots1, n1.val[2], lightPos.z);
+            dots1 = vmlaq_n_f32(dots1, n1.val[3], lightPos.w);
+
+            uint16x8_t facing = vcombine_u16(vmovn_u32(vcgtq_f32(dots0, zero)), vmovn_u32(vcgtq_f32(dots1, zero)));
+            vst1_u8((uint8_t*)lightFacings, vand_u8(vmovn_u16(facing), one));
+        }
+
+        for ( ; numFaces; --numFaces)
+        {
+            *lightFacings++ = (lightPos.dotProduct(*faceNormals++) > 0);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        // Four vertices at a time, the interleaved loads and stores giving
+        // a register per component
+        size_t numBlocks = numVertices / 4;
+        numVertices -= numBlocks * 4;
+
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, extrusion is along light direction
+            Vector3 dir(-lightPos.x, -lightPos.y, -lightPos.z);
+            dir.normalise();
+            dir *= extrudeDist;
+
+            for ( ; numBlocks; --numBlocks, pSrcPos += 12, pDestPos += 12)
+            {
+                float32x4x3_t v = vld3q_f32(pSrcPos);
+                v.val[0] = vaddq_f32(v.val[0], vdupq_n_f32(dir.x));
+                v.val[1] = vaddq_f32(v.val[1], vdupq_n_f32(dir.y));
+                v.val[2] = vaddq_f32(v.val[2], vdupq_n_f32(dir.z));
+                vst3q_f32(pDestPos, v);
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                *pDestPos++ = *pSrcPos++ + dir.x;
+                *pDestPos++ = *pSrcPos++ + dir.y;
+                *pDestPos++ = *pSrcPos++ + dir.z;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            for ( ; numBlocks; --numBlocks, pSrcPos += 12, pDestPos += 12)
+            {
+                float32x4x3_t v = vld3q_f32(pSrcPos);
+                float32x4_t dx = vsubq_f32(v.val[0], vdupq_n_f32(lightPos.x));
+                float32x4_t dy = vsubq_f32(v.val[1], vdupq_n_f32(lightPos.y));
+                float32x4_t dz = vsubq_f32(v.val[2], vdupq_n_f32(lightPos.z));
+                float32x4_t lengthSquared = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+                float32x4_t scale = vmulq_n_f32(__neon_rsqrt(lengthSquared), extrudeDist);
+
+                v.val[0] = vmlaq_f32(v.val[0], dx, scale);
+                v.val[1] = vmlaq_f32(v.val[1], dy, scale);
+                v.val[2] = vmlaq_f32(v.val[2], dz, scale);
+                vst3q_f32(pDestPos, v);
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                Vector3 extrusionDir(
+                    pSrcPos[0] - lightPos.x,
+                    pSrcPos[1] - lightPos.y,
+                    pSrcPos[2] - lightPos.z);
+                extrusionDir.normalise();
+                extrusionDir *= extrudeDist;
+
+                *pDestPos++ = *pSrcPos++ + extrusionDir.x;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.y;
+                *pDestPos++ = *pSrcPos++ + extrusionDir.z;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Vector3* centres,
+        const Vector3* halfSizes,
+        uint32* visibilityMask,
+        size_t numBoxes)
+    {
+        _getOptimisedUtilGeneral()->cullAxisAlignedBoxes(
+            planes, numPlanes, centres, halfSizes, visibilityMask, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::concatenateBoneTransforms(
+        const Real* localTransforms,
+        const Real* bindInverseTransforms,
+        const unsigned short* parents,
+        const unsigned short* boneHandles,
+        Real* derivedTransforms,
+        Matrix4* boneMatrices,
+        size_t stride,
+        size_t numSlots)
+    {
+        _getOptimisedUtilGeneral()->concatenateBoneTransforms(
+            localTransforms, bindInverseTransforms, parents, boneHandles,
+            derivedTransforms, boneMatrices, stride, numSlots);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::addScaledArray(
+        Real* dst,
+        const Real* src,
+        Real scale,
+        size_t count)
+    {
+        // Four elements at a time, the arrays can have any alignment
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), scale));
+        }
+
+        for (; i < count; ++i)
+        {
+            dst[i] += src[i] * scale;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::multiplyAddClampArray(
+        Real* data,
+        Real scale,
+        Real offset,
+        Real minValue,
+        Real maxValue,
+        size_t count)
+    {
+        const float32x4_t o = vdupq_n_f32(offset);
+        const float32x4_t lo = vdupq_n_f32(minValue);
+        const float32x4_t hi = vdupq_n_f32(maxValue);
+
+        // Four elements at a time, the array can have any alignment
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t d = vmlaq_n_f32(o, vld1q_f32(data + i), scale);
+            vst1q_f32(data + i, vminq_f32(vmaxq_f32(d, lo), hi));
+        }
+
+        for (; i < count; ++i)
+        {
+            data[i] = std::min(std::max(data[i] * scale + offset, minValue), maxValue);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::generateBillboardVertices(
+        const float* billboards,
+        const float* offsets,
+        const float* texcoords,
+        float* dest,
+        size_t numBillboards)
+    {
+        // Selects the position of a billboard, the rest being its colour
+        static const uint32_t positionMaskValues[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0 };
+        const uint32x4_t positionMask = vld1q_u32(positionMaskValues);
+
+        float32x4_t offset[4];
+        float32x2_t texcoord[4];
+        for (size_t corner = 0; corner < 4; ++corner)
+        {
+            const float o[4] = { offsets[corner * 3 + 0], offsets[corner * 3 + 1], offsets[corner * 3 + 2], 0 };
+            offset[corner] = vld1q_f32(o);
+            texcoord[corner] = vld1_f32(texcoords + corner * 2);
+        }
+
+        for (size_t i = 0; i < numBillboards; ++i, billboards += 4)
+        {
+            float32x4_t billboard = vld1q_f32(billboards);
+            for (size_t corner = 0; corner < 4; ++corner, dest += 6)
+            {
+                // Position from the sum, colour bits from the billboard
+                vst1q_f32(dest, vbslq_f32(positionMask, vaddq_f32(billboard, offset[corner]), billboard));
+                vst1_f32(dest + 4, texcoord[corner]);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilNEON::calculateDepthKeys(
+        const Real* posX,
+        const Real* posY,
+        const Real* posZ,
+        const Vector3& origin,
+        const Vector3& direction,
+        bool byDistance,
+        Real* keys,
+        size_t count)
+    {
+        const float32x4_t ox = vdupq_n_f32(origin.x);
+        const float32x4_t oy = vdupq_n_f32(origin.y);
+        const float32x4_t oz = vdupq_n_f32(origin.z);
+
+        // Four points at a time, the arrays can have any alignment
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t dx = vsubq_f32(vld1q_f32(posX + i), ox);
+            float32x4_t dy = vsubq_f32(vld1q_f32(posY + i), oy);
+            float32x4_t dz = vsubq_f32(vld1q_f32(posZ + i), oz);
+            if (byDistance)
+            {
+                float32x4_t sqLen = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+                vst1q_f32(keys + i, vnegq_f32(sqLen));
+            }
+            else
+            {
+                float32x4_t dot = vmlaq_n_f32(vmlaq_n_f32(
+                    vmulq_n_f32(dx, direction.x), dy, direction.y), dz, direction.z);
+                vst1q_f32(keys + i, dot);
+            }
+        }
+
+        // Remaining points
+        for (; i < count; ++i)
+        {
+            Real dx = posX[i] - origin.x;
+            Real dy = posY[i] - origin.y;
+            Real dz = posZ[i] - origin.z;
+            keys[i] = byDistance ? -(dx * dx + dy * dy + dz * dz) :
+                dx * direction.x + dy * direction.y + dz * direction.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilNEON(void)
+    {
+        static OptimisedUtilNEON msOptimisedUtilNEON;
+        return &msOptimisedUtilNEON;
+    }
+
+}
+
+#endif // __OGRE_HAVE_NEON && OGRE_OPTIMISEDUTIL_NEON
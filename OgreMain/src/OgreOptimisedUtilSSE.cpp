@@ -33,6 +33,8 @@ THE SOFTWARE.
 #if __OGRE_HAVE_SSE
 
 #include "OgreMatrix4.h"
+#include "OgrePlane.h"
+#include "OgreQuaternion.h"
 
 // Should keep this includes at latest to avoid potential "xmmintrin.h" included by
 // other header file on some platform for some reason.
@@ -132,6 +134,57 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes);
+        /// @copydoc OptimisedUtil::concatenateBoneTransforms
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots);
+        /// @copydoc OptimisedUtil::addScaledArray
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count);
+        /// @copydoc OptimisedUtil::multiplyAddClampArray
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count);
+        /// @copydoc OptimisedUtil::generateBillboardVertices
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards);
+
+        /// @copydoc OptimisedUtil::calculateDepthKeys
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +324,128 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullAxisAlignedBoxes(
+                planes,
+                numPlanes,
+                centres,
+                halfSizes,
+                visibilityMask,
+                numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::concatenateBoneTransforms
+        virtual void concatenateBoneTransforms(
+            const Real* localTransforms,
+            const Real* bindInverseTransforms,
+            const unsigned short* parents,
+            const unsigned short* boneHandles,
+            Real* derivedTransforms,
+            Matrix4* boneMatrices,
+            size_t stride,
+            size_t numSlots)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->concatenateBoneTransforms(
+                localTransforms,
+                bindInverseTransforms,
+                parents,
+                boneHandles,
+                derivedTransforms,
+                boneMatrices,
+                stride,
+                numSlots);
+        }
+
+        /// @copydoc OptimisedUtil::addScaledArray
+        virtual void addScaledArray(
+            Real* dst,
+            const Real* src,
+            Real scale,
+            size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->addScaledArray(
+                dst,
+                src,
+                scale,
+                count);
+        }
+
+        /// @copydoc OptimisedUtil::multiplyAddClampArray
+        virtual void multiplyAddClampArray(
+            Real* data,
+            Real scale,
+            Real offset,
+            Real minValue,
+            Real maxValue,
+            size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->multiplyAddClampArray(
+                data,
+                scale,
+                offset,
+                minValue,
+                maxValue,
+                count);
+        }
+
+        /// @copydoc OptimisedUtil::generateBillboardVertices
+        virtual void generateBillboardVertices(
+            const float* billboards,
+            const float* offsets,
+            const float* texcoords,
+            float* dest,
+            size_t numBillboards)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->generateBillboardVertices(
+                billboards,
+                offsets,
+                texcoords,
+                dest,
+                numBillboards);
+        }
+
+        /// @copydoc OptimisedUtil::calculateDepthKeys
+        virtual void calculateDepthKeys(
+            const Real* posX,
+            const Real* posY,
+            const Real* posZ,
+            const Vector3& origin,
+            const Vector3& direction,
+            bool byDistance,
+            Real* keys,
+            size_t count)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->calculateDepthKeys(
+                posX,
+                posY,
+                posZ,
+                origin,
+                direction,
+                byDistance,
+                keys,
+                count);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -1496,18 +1671,12 @@ namespace Ogre {
                 norm = _mm_loadh_pi(norm, (__m64*)(pNorm + 0));
                 
                 // Fill a 4-vec with vector length
-                // square
+                // square, elements are z | unused | x | y
                 __m128 tmp = _mm_mul_ps(norm, norm);
-                // Add - for this we want this effect:
-                // orig   3 | 2 | 1 | 0
-                // add1   0 | 0 | 0 | 2
-                // add2   2 | 3 | 0 | 3
-                // This way elements 0, 2 and 3 have the sum of all entries (except 1 which is unused)
-                
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,0,0,2)));
-                // Add final combination & sqrt 
-                // bottom 3 elements of l will have length, we don't care about 4
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(2,3,0,3)));
+                // Add x and y to z in element 0, then broadcast it
+                tmp = _mm_add_ps(tmp, _mm_movehl_ps(tmp, tmp));
+                tmp = _mm_add_ss(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(1,1,1,1)));
+                tmp = _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,0,0,0));
                 // Then divide to normalise
                 norm = _mm_div_ps(norm, _mm_sqrt_ps(tmp));
                 
@@ -2136,6 +2305,509 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    /** Tests four boxes, given as separated x, y and z components, against
+        the planes and returns a four bit mask of the visible ones.
+    @note
+        The operations are done in the same order as Plane::getSide, so the
+        results are exactly the same as the general version.
+    */
+    static OGRE_FORCE_INLINE uint32 _cullAxisAlignedBoxes4_SSE(
+        const Plane* planes, size_t numPlanes,
+        __m128 cx, __m128 cy, __m128 cz,
+        __m128 hx, __m128 hy, __m128 hz)
+    {
+        const __m128 signMask = _mm_set_ps1(-0.0f);
+
+        __m128 outside = _mm_setzero_ps();
+        for (size_t i = 0; i < numPlanes; ++i)
+        {
+            const Plane& plane = planes[i];
+            __m128 nx = _mm_load_ps1(&plane.normal.x);
+            __m128 ny = _mm_load_ps1(&plane.normal.y);
+            __m128 nz = _mm_load_ps1(&plane.normal.z);
+            __m128 d = _mm_load_ps1(&plane.d);
+
+            // Distance between box centre and plane
+            __m128 dist = _mm_add_ps(__MM_DOT3x3_PS(nx, ny, nz, cx, cy, cz), d);
+
+            // Maximise allowed absolute distance, the half sizes are not negative
+            __m128 maxAbsDist = __MM_DOT3x3_PS(
+                _mm_andnot_ps(signMask, nx),
+                _mm_andnot_ps(signMask, ny),
+                _mm_andnot_ps(signMask, nz),
+                hx, hy, hz);
+
+            // Box on the negative side of the plane?
+            outside = _mm_or_ps(outside,
+                _mm_cmplt_ps(dist, _mm_xor_ps(maxAbsDist, signMask)));
+        }
+
+        return ~_mm_movemask_ps(outside) & 0xF;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Vector3* centres,
+        const Vector3* halfSizes,
+        uint32* visibilityMask,
+        size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        // Vector3 is packed xyz floats when __OGRE_HAVE_SSE is set
+        const float* pCentre = reinterpret_cast<const float*>(centres);
+        const float* pHalfSize = reinterpret_cast<const float*>(halfSizes);
+
+        uint32 mask = 0;
+        uint32 shift = 0;
+
+        // Four boxes per-iteration
+        size_t numIterations = numBoxes / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            __m128 cx = _mm_loadu_ps(pCentre + 0);
+            __m128 cy = _mm_loadu_ps(pCentre + 4);
+            __m128 cz = _mm_loadu_ps(pCentre + 8);
+            __MM_TRANSPOSE4x3_PS(cx, cy, cz);
+
+            __m128 hx = _mm_loadu_ps(pHalfSize + 0);
+            __m128 hy = _mm_loadu_ps(pHalfSize + 4);
+            __m128 hz = _mm_loadu_ps(pHalfSize + 8);
+            __MM_TRANSPOSE4x3_PS(hx, hy, hz);
+
+            mask |= _cullAxisAlignedBoxes4_SSE(planes, numPlanes,
+                cx, cy, cz, hx, hy, hz) << shift;
+
+            shift += 4;
+            if (shift == 32)
+            {
+                *visibilityMask++ = mask;
+                mask = 0;
+                shift = 0;
+            }
+
+            pCentre += 12;
+            pHalfSize += 12;
+        }
+
+        // Pad the remaining boxes to four, the padding results are masked off
+        size_t numRemaining = numBoxes & 3;
+        if (numRemaining)
+        {
+            float centre[12] = { 0 };
+            float halfSize[12] = { 0 };
+            memcpy(centre, pCentre, numRemaining * 3 * sizeof(float));
+            memcpy(halfSize, pHalfSize, numRemaining * 3 * sizeof(float));
+
+            __m128 cx = _mm_loadu_ps(centre + 0);
+            __m128 cy = _mm_loadu_ps(centre + 4);
+            __m128 cz = _mm_loadu_ps(centre + 8);
+            __MM_TRANSPOSE4x3_PS(cx, cy, cz);
+
+            __m128 hx = _mm_loadu_ps(halfSize + 0);
+            __m128 hy = _mm_loadu_ps(halfSize + 4);
+            __m128 hz = _mm_loadu_ps(halfSize + 8);
+            __MM_TRANSPOSE4x3_PS(hx, hy, hz);
+
+            uint32 remaining = _cullAxisAlignedBoxes4_SSE(planes, numPlanes,
+                cx, cy, cz, hx, hy, hz) & ((1u << numRemaining) - 1);
+            mask |= remaining << shift;
+            shift += 4;
+        }
+
+        if (shift)
+            *visibilityMask = mask;
+    }
+    //---------------------------------------------------------------------
+    /// Multiplies four pairs of quaternions, as Quaternion::operator*
+    static OGRE_FORCE_INLINE void _multiplyQuaternions4_SSE(
+        __m128 aw, __m128 ax, __m128 ay, __m128 az,
+        __m128 bw, __m128 bx, __m128 by, __m128 bz,
+        __m128& rw, __m128& rx, __m128& ry, __m128& rz)
+    {
+        rw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(aw, bw), _mm_mul_ps(ax, bx)),
+            _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        rx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bx), _mm_mul_ps(ax, bw)),
+            _mm_mul_ps(ay, bz)), _mm_mul_ps(az, by));
+        ry = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, by), _mm_mul_ps(ay, bw)),
+            _mm_mul_ps(az, bx)), _mm_mul_ps(ax, bz));
+        rz = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bz), _mm_mul_ps(az, bw)),
+            _mm_mul_ps(ax, by)), _mm_mul_ps(ay, bx));
+    }
+    //---------------------------------------------------------------------
+    /// Rotates four vectors by four quaternions, as Quaternion::operator*
+    static OGRE_FORCE_INLINE void _rotateVectors4_SSE(
+        __m128 qw, __m128 qx, __m128 qy, __m128 qz,
+        __m128& vx, __m128& vy, __m128& vz)
+    {
+        __m128 uvx = _mm_sub_ps(_mm_mul_ps(qy, vz), _mm_mul_ps(qz, vy));
+        __m128 uvy = _mm_sub_ps(_mm_mul_ps(qz, vx), _mm_mul_ps(qx, vz));
+        __m128 uvz = _mm_sub_ps(_mm_mul_ps(qx, vy), _mm_mul_ps(qy, vx));
+        __m128 uuvx = _mm_sub_ps(_mm_mul_ps(qy, uvz), _mm_mul_ps(qz, uvy));
+        __m128 uuvy = _mm_sub_ps(_mm_mul_ps(qz, uvx), _mm_mul_ps(qx, uvz));
+        __m128 uuvz = _mm_sub_ps(_mm_mul_ps(qx, uvy), _mm_mul_ps(qy, uvx));
+        __m128 w2 = _mm_add_ps(qw, qw);
+
+        vx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(uvx, w2)), _mm_add_ps(uuvx, uuvx));
+        vy = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(uvy, w2)), _mm_add_ps(uuvy, uuvy));
+        vz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(uvz, w2)), _mm_add_ps(uuvz, uuvz));
+    }
+    //---------------------------------------------------------------------
+    /// Concatenates the transform of a single slot, as the general implementation
+    static void _concatenateBoneTransform(
+        const float* local, const float* bindInverse, float* derived,
+        size_t stride, size_t i, size_t p, Matrix4& boneMatrix)
+    {
+        Vector3 parentPosition(derived[p], derived[stride + p], derived[2 * stride + p]);
+        Quaternion parentOrientation(derived[3 * stride + p], derived[4 * stride + p],
+            derived[5 * stride + p], derived[6 * stride + p]);
+        Vector3 parentScale(derived[7 * stride + p], derived[8 * stride + p], derived[9 * stride + p]);
+
+        Quaternion orientation = parentOrientation * Quaternion(local[3 * stride + i],
+            local[4 * stride + i], local[5 * stride + i], local[6 * stride + i]);
+        Vector3 scale = parentScale * Vector3(local[7 * stride + i],
+            local[8 * stride + i], local[9 * stride + i]);
+        Vector3 position = parentOrientation * (parentScale * Vector3(local[i],
+            local[stride + i], local[2 * stride + i])) + parentPosition;
+
+        derived[i] = position.x;
+        derived[stride + i] = position.y;
+        derived[2 * stride + i] = position.z;
+        derived[3 * stride + i] = orientation.w;
+        derived[4 * stride + i] = orientation.x;
+        derived[5 * stride + i] = orientation.y;
+        derived[6 * stride + i] = orientation.z;
+        derived[7 * stride + i] = scale.x;
+        derived[8 * stride + i] = scale.y;
+        derived[9 * stride + i] = scale.z;
+
+        Vector3 locScale = scale * Vector3(bindInverse[7 * stride + i],
+            bindInverse[8 * stride + i], bindInverse[9 * stride + i]);
+        Quaternion locRotate = orientation * Quaternion(bindInverse[3 * stride + i],
+            bindInverse[4 * stride + i], bindInverse[5 * stride + i], bindInverse[6 * stride + i]);
+        Vector3 locTranslate = position + locRotate * (locScale * Vector3(bindInverse[i],
+            bindInverse[stride + i], bindInverse[2 * stride + i]));
+
+        boneMatrix.makeTransform(locTranslate, locScale, locRotate);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::concatenateBoneTransforms(
+        const Real* localTransforms,
+        const Real* bindInverseTransforms,
+        const unsigned short* parents,
+        const unsigned short* boneHandles,
+        Real* derivedTransforms,
+        Matrix4* boneMatrices,
+        size_t stride,
+        size_t numSlots)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const __m128 one = _mm_set_ps1(1.0f);
+
+        // Slot 0 is the root, so the first group is never concatenated at once
+        size_t group = 0;
+        for (size_t i = 1; i < numSlots; )
+        {
+            if (i != group || group + 4 > numSlots ||
+                parents[group] >= group || parents[group + 1] >= group ||
+                parents[group + 2] >= group || parents[group + 3] >= group)
+            {
+                // Some parent is in the group, one slot at a time
+                _concatenateBoneTransform(localTransforms, bindInverseTransforms,
+                    derivedTransforms, stride, i, parents[i], boneMatrices[boneHandles[i]]);
+                ++i;
+                if (i == group + 4)
+                    group = i;
+                continue;
+            }
+
+            // Gather the derived transforms of the parents
+            const float* d = derivedTransforms;
+            size_t p0 = parents[group + 0];
+            size_t p1 = parents[group + 1];
+            size_t p2 = parents[group + 2];
+            size_t p3 = parents[group + 3];
+            __m128 ppx = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 ppy = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 ppz = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 pqw = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 pqx = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 pqy = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 pqz = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 psx = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 psy = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+            d += stride;
+            __m128 psz = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+
+            // The component arrays are aligned, and so are the groups
+            const float* l = localTransforms + group;
+            __m128 lpx = _mm_load_ps(l + 0 * stride);
+            __m128 lpy = _mm_load_ps(l + 1 * stride);
+            __m128 lpz = _mm_load_ps(l + 2 * stride);
+            __m128 lqw = _mm_load_ps(l + 3 * stride);
+            __m128 lqx = _mm_load_ps(l + 4 * stride);
+            __m128 lqy = _mm_load_ps(l + 5 * stride);
+            __m128 lqz = _mm_load_ps(l + 6 * stride);
+            __m128 lsx = _mm_load_ps(l + 7 * stride);
+            __m128 lsy = _mm_load_ps(l + 8 * stride);
+            __m128 lsz = _mm_load_ps(l + 9 * stride);
+
+            // Derived transforms, as Node::updateFromParentImpl
+            __m128 dqw, dqx, dqy, dqz;
+            _multiplyQuaternions4_SSE(pqw, pqx, pqy, pqz, lqw, lqx, lqy, lqz,
+                dqw, dqx, dqy, dqz);
+            __m128 dsx = _mm_mul_ps(psx, lsx);
+            __m128 dsy = _mm_mul_ps(psy, lsy);
+            __m128 dsz = _mm_mul_ps(psz, lsz);
+            __m128 dpx = _mm_mul_ps(psx, lpx);
+            __m128 dpy = _mm_mul_ps(psy, lpy);
+            __m128 dpz = _mm_mul_ps(psz, lpz);
+            _rotateVectors4_SSE(pqw, pqx, pqy, pqz, dpx, dpy, dpz);
+            dpx = _mm_add_ps(dpx, ppx);
+            dpy = _mm_add_ps(dpy, ppy);
+            dpz = _mm_add_ps(dpz, ppz);
+
+            float* o = derivedTransforms + group;
+            _mm_store_ps(o + 0 * stride, dpx);
+            _mm_store_ps(o + 1 * stride, dpy);
+            _mm_store_ps(o + 2 * stride, dpz);
+            _mm_store_ps(o + 3 * stride, dqw);
+            _mm_store_ps(o + 4 * stride, dqx);
+            _mm_store_ps(o + 5 * stride, dqy);
+            _mm_store_ps(o + 6 * stride, dqz);
+            _mm_store_ps(o + 7 * stride, dsx);
+            _mm_store_ps(o + 8 * stride, dsy);
+            _mm_store_ps(o + 9 * stride, dsz);
+
+            // Offset transforms, as Bone::_getOffsetTransform
+            const float* b = bindInverseTransforms + group;
+            __m128 sx = _mm_mul_ps(dsx, _mm_load_ps(b + 7 * stride));
+            __m128 sy = _mm_mul_ps(dsy, _mm_load_ps(b + 8 * stride));
+            __m128 sz = _mm_mul_ps(dsz, _mm_load_ps(b + 9 * stride));
+            __m128 qw, qx, qy, qz;
+            _multiplyQuaternions4_SSE(dqw, dqx, dqy, dqz,
+                _mm_load_ps(b + 3 * stride), _mm_load_ps(b + 4 * stride),
+                _mm_load_ps(b + 5 * stride), _mm_load_ps(b + 6 * stride),
+                qw, qx, qy, qz);
+            __m128 tx = _mm_mul_ps(sx, _mm_load_ps(b + 0 * stride));
+            __m128 ty = _mm_mul_ps(sy, _mm_load_ps(b + 1 * stride));
+            __m128 tz = _mm_mul_ps(sz, _mm_load_ps(b + 2 * stride));
+            _rotateVectors4_SSE(qw, qx, qy, qz, tx, ty, tz);
+            tx = _mm_add_ps(dpx, tx);
+            ty = _mm_add_ps(dpy, ty);
+            tz = _mm_add_ps(dpz, tz);
+
+            // Matrices, as Matrix4::makeTransform
+            __m128 fTx = _mm_add_ps(qx, qx);
+            __m128 fTy = _mm_add_ps(qy, qy);
+            __m128 fTz = _mm_add_ps(qz, qz);
+            __m128 fTwx = _mm_mul_ps(fTx, qw);
+            __m128 fTwy = _mm_mul_ps(fTy, qw);
+            __m128 fTwz = _mm_mul_ps(fTz, qw);
+            __m128 fTxx = _mm_mul_ps(fTx, qx);
+            __m128 fTxy = _mm_mul_ps(fTy, qx);
+            __m128 fTxz = _mm_mul_ps(fTz, qx);
+            __m128 fTyy = _mm_mul_ps(fTy, qy);
+            __m128 fTyz = _mm_mul_ps(fTz, qy);
+            __m128 fTzz = _mm_mul_ps(fTz, qz);
+
+            __m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_add_ps(fTyy, fTzz)));
+            __m128 m01 = _mm_mul_ps(sy, _mm_sub_ps(fTxy, fTwz));
+            __m128 m02 = _mm_mul_ps(sz, _mm_add_ps(fTxz, fTwy));
+            __m128 m10 = _mm_mul_ps(sx, _mm_add_ps(fTxy, fTwz));
+            __m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_add_ps(fTxx, fTzz)));
+            __m128 m12 = _mm_mul_ps(sz, _mm_sub_ps(fTyz, fTwx));
+            __m128 m20 = _mm_mul_ps(sx, _mm_sub_ps(fTxz, fTwy));
+            __m128 m21 = _mm_mul_ps(sy, _mm_add_ps(fTyz, fTwx));
+            __m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_add_ps(fTxx, fTyy)));
+
+            // From four values of each element to four matrices
+            _MM_TRANSPOSE4_PS(m00, m01, m02, tx);
+            _MM_TRANSPOSE4_PS(m10, m11, m12, ty);
+            _MM_TRANSPOSE4_PS(m20, m21, m22, tz);
+            const __m128 lastRow = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+            Matrix4* m = boneMatrices + boneHandles[group + 0];
+            _mm_storeu_ps((*m)[0], m00);
+            _mm_storeu_ps((*m)[1], m10);
+            _mm_storeu_ps((*m)[2], m20);
+            _mm_storeu_ps((*m)[3], lastRow);
+            m = boneMatrices + boneHandles[group + 1];
+            _mm_storeu_ps((*m)[0], m01);
+            _mm_storeu_ps((*m)[1], m11);
+            _mm_storeu_ps((*m)[2], m21);
+            _mm_storeu_ps((*m)[3], lastRow);
+            m = boneMatrices + boneHandles[group + 2];
+            _mm_storeu_ps((*m)[0], m02);
+            _mm_storeu_ps((*m)[1], m12);
+            _mm_storeu_ps((*m)[2], m22);
+            _mm_storeu_ps((*m)[3], lastRow);
+            m = boneMatrices + boneHandles[group + 3];
+            _mm_storeu_ps((*m)[0], tx);
+            _mm_storeu_ps((*m)[1], ty);
+            _mm_storeu_ps((*m)[2], tz);
+            _mm_storeu_ps((*m)[3], lastRow);
+
+            group += 4;
+            i = group;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::addScaledArray(
+        Real* dst,
+        const Real* src,
+        Real scale,
+        size_t count)
+    {
+        __m128 s = _mm_set_ps1(scale);
+
+        // Four elements at a time, the arrays can have any alignment
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 d = _mm_loadu_ps(dst + i);
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(src + i), s));
+            _mm_storeu_ps(dst + i, d);
+        }
+
+        // Remaining elements
+        for (; i < count; ++i)
+        {
+            dst[i] += src[i] * scale;
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::multiplyAddClampArray(
+        Real* data,
+        Real scale,
+        Real offset,
+        Real minValue,
+        Real maxValue,
+        size_t count)
+    {
+        __m128 s = _mm_set_ps1(scale);
+        __m128 o = _mm_set_ps1(offset);
+        __m128 lo = _mm_set_ps1(minValue);
+        __m128 hi = _mm_set_ps1(maxValue);
+
+        // Four elements at a time, the array can have any alignment
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(data + i), s), o);
+            _mm_storeu_ps(data + i, _mm_min_ps(_mm_max_ps(d, lo), hi));
+        }
+
+        // Remaining elements, same min/max semantics as above
+        for (; i < count; ++i)
+        {
+            __m128 d = _mm_add_ss(_mm_mul_ss(_mm_load_ss(data + i), s), o);
+            _mm_store_ss(data + i, _mm_min_ss(_mm_max_ss(d, lo), hi));
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::generateBillboardVertices(
+        const float* billboards,
+        const float* offsets,
+        const float* texcoords,
+        float* dest,
+        size_t numBillboards)
+    {
+        // Selects the position of a billboard, the rest being its colour
+        OGRE_SIMD_ALIGNED_DECL(static const uint32, msPositionMask[4]) =
+        {
+            0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0,
+        };
+        const __m128 positionMask = *(const __m128 *)&msPositionMask;
+
+        // Corner offsets with a null fourth component, and texture coordinates
+        __m128 offset[4], texcoord[4];
+        for (size_t corner = 0; corner < 4; ++corner)
+        {
+            offset[corner] = _mm_setr_ps(
+                offsets[corner * 3 + 0], offsets[corner * 3 + 1], offsets[corner * 3 + 2], 0);
+            texcoord[corner] = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(texcoords + corner * 2));
+        }
+
+        for (size_t i = 0; i < numBillboards; ++i, billboards += 4)
+        {
+            __m128 billboard = _mm_loadu_ps(billboards);
+            __m128 position = _mm_and_ps(billboard, positionMask);
+            __m128 colour = _mm_andnot_ps(positionMask, billboard);
+
+            // The colour lane of the sum is null, put the colour bits there
+            for (size_t corner = 0; corner < 4; ++corner, dest += 6)
+            {
+                _mm_storeu_ps(dest, _mm_or_ps(_mm_add_ps(position, offset[corner]), colour));
+                _mm_storel_pi((__m64*)(dest + 4), texcoord[corner]);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::calculateDepthKeys(
+        const Real* posX,
+        const Real* posY,
+        const Real* posZ,
+        const Vector3& origin,
+        const Vector3& direction,
+        bool byDistance,
+        Real* keys,
+        size_t count)
+    {
+        const __m128 ox = _mm_set_ps1(origin.x);
+        const __m128 oy = _mm_set_ps1(origin.y);
+        const __m128 oz = _mm_set_ps1(origin.z);
+
+        // Four points at a time, the arrays can have any alignment
+        size_t i = 0;
+        if (byDistance)
+        {
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(posX + i), ox);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(posY + i), oy);
+                __m128 dz = _mm_sub_ps(_mm_loadu_ps(posZ + i), oz);
+                __m128 sqLen = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                _mm_storeu_ps(keys + i, _mm_sub_ps(_mm_setzero_ps(), sqLen));
+            }
+        }
+        else
+        {
+            const __m128 dirX = _mm_set_ps1(direction.x);
+            const __m128 dirY = _mm_set_ps1(direction.y);
+            const __m128 dirZ = _mm_set_ps1(direction.z);
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(posX + i), ox);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(posY + i), oy);
+                __m128 dz = _mm_sub_ps(_mm_loadu_ps(posZ + i), oz);
+                _mm_storeu_ps(keys + i, _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(dx, dirX), _mm_mul_ps(dy, dirY)), _mm_mul_ps(dz, dirZ)));
+            }
+        }
+
+        // Remaining points
+        for (; i < count; ++i)
+        {
+            Real dx = posX[i] - origin.x;
+            Real dy = posY[i] - origin.y;
+            Real dz = posZ[i] - origin.z;
+            keys[i] = byDistance ? -(dx * dx + dy * dy + dz * dz) :
+                dx * direction.x + dy * direction.y + dz * direction.z;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
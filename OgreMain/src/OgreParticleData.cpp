@@ -0,0 +1,237 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreParticleData.h"
+#include "OgreParticle.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    /// Reallocates an array, keeping the given number of elements
+    template <typename T>
+    static void reallocateArray(T*& array, size_t used, size_t capacity)
+    {
+        T* newArray = static_cast<T*>(OGRE_MALLOC_SIMD(sizeof(T) * capacity, MEMCATEGORY_GENERAL));
+        if (array)
+        {
+            memcpy(newArray, array, sizeof(T) * used);
+            OGRE_FREE_SIMD(array, MEMCATEGORY_GENERAL);
+        }
+        array = newArray;
+    }
+    //-----------------------------------------------------------------------
+    ParticleData::ParticleData()
+        : mParticles(0)
+        , mPositionX(0), mPositionY(0), mPositionZ(0)
+        , mDirectionX(0), mDirectionY(0), mDirectionZ(0)
+        , mColourR(0), mColourG(0), mColourB(0), mColourA(0)
+        , mOwnDimensions(0), mWidth(0), mHeight(0)
+        , mRotation(0), mRotationSpeed(0)
+        , mTimeToLive(0), mTotalTimeToLive(0)
+        , mCount(0)
+        , mNumFree(0)
+        , mCapacity(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    ParticleData::~ParticleData()
+    {
+        if (mParticles)
+        {
+            OGRE_FREE_SIMD(mParticles, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mPositionX, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mPositionY, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mPositionZ, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mDirectionX, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mDirectionY, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mDirectionZ, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mColourR, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mColourG, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mColourB, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mColourA, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mOwnDimensions, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mWidth, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mHeight, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mRotation, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mRotationSpeed, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mTimeToLive, MEMCATEGORY_GENERAL);
+            OGRE_FREE_SIMD(mTotalTimeToLive, MEMCATEGORY_GENERAL);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::reserve(size_t capacity)
+    {
+        if (capacity <= mCapacity)
+            return;
+
+        // Grow geometrically, the emitted emitters are added one by one
+        capacity = std::max(capacity, mCapacity * 2);
+
+        // Only the particles of the free slots matter
+        size_t used = mCount + mNumFree;
+        reallocateArray(mParticles, used, capacity);
+        reallocateArray(mPositionX, mCount, capacity);
+        reallocateArray(mPositionY, mCount, capacity);
+        reallocateArray(mPositionZ, mCount, capacity);
+        reallocateArray(mDirectionX, mCount, capacity);
+        reallocateArray(mDirectionY, mCount, capacity);
+        reallocateArray(mDirectionZ, mCount, capacity);
+        reallocateArray(mColourR, mCount, capacity);
+        reallocateArray(mColourG, mCount, capacity);
+        reallocateArray(mColourB, mCount, capacity);
+        reallocateArray(mColourA, mCount, capacity);
+        reallocateArray(mOwnDimensions, mCount, capacity);
+        reallocateArray(mWidth, mCount, capacity);
+        reallocateArray(mHeight, mCount, capacity);
+        reallocateArray(mRotation, mCount, capacity);
+        reallocateArray(mRotationSpeed, mCount, capacity);
+        reallocateArray(mTimeToLive, mCount, capacity);
+        reallocateArray(mTotalTimeToLive, mCount, capacity);
+        mCapacity = capacity;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::copySlot(size_t dst, size_t src)
+    {
+        mPositionX[dst] = mPositionX[src];
+        mPositionY[dst] = mPositionY[src];
+        mPositionZ[dst] = mPositionZ[src];
+        mDirectionX[dst] = mDirectionX[src];
+        mDirectionY[dst] = mDirectionY[src];
+        mDirectionZ[dst] = mDirectionZ[src];
+        mColourR[dst] = mColourR[src];
+        mColourG[dst] = mColourG[src];
+        mColourB[dst] = mColourB[src];
+        mColourA[dst] = mColourA[src];
+        mOwnDimensions[dst] = mOwnDimensions[src];
+        mWidth[dst] = mWidth[src];
+        mHeight[dst] = mHeight[src];
+        mRotation[dst] = mRotation[src];
+        mRotationSpeed[dst] = mRotationSpeed[src];
+        mTimeToLive[dst] = mTimeToLive[src];
+        mTotalTimeToLive[dst] = mTotalTimeToLive[src];
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::addFree(Particle* p)
+    {
+        reserve(mCount + mNumFree + 1);
+        mParticles[mCount + mNumFree] = p;
+        ++mNumFree;
+    }
+    //-----------------------------------------------------------------------
+    Particle* ParticleData::activateFree(void)
+    {
+        if (!mNumFree)
+            return 0;
+
+        --mNumFree;
+        return mParticles[mCount++];
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::addActive(Particle* p)
+    {
+        reserve(mCount + mNumFree + 1);
+
+        // The first free particle moves to the end of the free slots
+        if (mNumFree)
+            mParticles[mCount + mNumFree] = mParticles[mCount];
+        mParticles[mCount] = p;
+        read(mCount++);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::deactivate(size_t index)
+    {
+        assert(index < mCount && "Index out of bounds!");
+        size_t last = mCount - 1;
+        if (index != last)
+        {
+            copySlot(index, last);
+            std::swap(mParticles[index], mParticles[last]);
+        }
+        --mCount;
+        ++mNumFree;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::remove(size_t index)
+    {
+        assert(index < mCount && "Index out of bounds!");
+        size_t last = mCount - 1;
+        if (index != last)
+        {
+            copySlot(index, last);
+            mParticles[index] = mParticles[last];
+        }
+
+        // The last free particle fills the gap
+        if (mNumFree)
+            mParticles[last] = mParticles[last + mNumFree];
+        --mCount;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::read(size_t index)
+    {
+        const Particle* p = mParticles[index];
+        mPositionX[index] = p->mPosition.x;
+        mPositionY[index] = p->mPosition.y;
+        mPositionZ[index] = p->mPosition.z;
+        mDirectionX[index] = p->mDirection.x;
+        mDirectionY[index] = p->mDirection.y;
+        mDirectionZ[index] = p->mDirection.z;
+        mColourR[index] = p->mColour.r;
+        mColourG[index] = p->mColour.g;
+        mColourB[index] = p->mColour.b;
+        mColourA[index] = p->mColour.a;
+        mOwnDimensions[index] = p->mOwnDimensions;
+        mWidth[index] = p->mWidth;
+        mHeight[index] = p->mHeight;
+        mRotation[index] = p->mRotation.valueRadians();
+        mRotationSpeed[index] = p->mRotationSpeed.valueRadians();
+        mTimeToLive[index] = p->mTimeToLive;
+        mTotalTimeToLive[index] = p->mTotalTimeToLive;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleData::write(size_t index) const
+    {
+        Particle* p = mParticles[index];
+        p->mPosition.x = mPositionX[index];
+        p->mPosition.y = mPositionY[index];
+        p->mPosition.z = mPositionZ[index];
+        p->mDirection.x = mDirectionX[index];
+        p->mDirection.y = mDirectionY[index];
+        p->mDirection.z = mDirectionZ[index];
+        p->mColour.r = mColourR[index];
+        p->mColour.g = mColourG[index];
+        p->mColour.b = mColourB[index];
+        p->mColour.a = mColourA[index];
+        p->mOwnDimensions = mOwnDimensions[index];
+        p->mWidth = mWidth[index];
+        p->mHeight = mHeight[index];
+        p->mRotation = Radian(mRotation[index]);
+        p->mRotationSpeed = Radian(mRotationSpeed[index]);
+        p->mTimeToLive = mTimeToLive[index];
+        p->mTotalTimeToLive = mTotalTimeToLive[index];
+    }
+}
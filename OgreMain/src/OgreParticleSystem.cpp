@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreParticleEmitter.h"
 #include "OgreParticleAffector.h"
 #include "OgreParticle.h"
+#include "OgreParticleData.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreCamera.h"
 #include "OgreStringConverter.h"
@@ -41,6 +42,7 @@ THE SOFTWARE.
 #include "OgreSceneManager.h"
 #include "OgreControllerManager.h"
 #include "OgreRoot.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
     // Init statics
@@ -55,6 +57,7 @@ namespace Ogre {
     ParticleSystem::CmdLocalSpace ParticleSystem::msLocalSpaceCmd;
     ParticleSystem::CmdIterationInterval ParticleSystem::msIterationIntervalCmd;
     ParticleSystem::CmdNonvisibleTimeout ParticleSystem::msNonvisibleTimeoutCmd;
+    ParticleSystem::CmdStorageMode ParticleSystem::msStorageModeCmd;
 
     RadixSort<ParticleSystem::ActiveParticleList, Particle*, float> ParticleSystem::mRadixSorter;
 
@@ -72,7 +75,14 @@ namespace Ogre {
 
         Real getValue(void) const { return 0; } // N/A
 
-        void setValue(Real value) { mTarget->_update(value); }
+        void setValue(Real value)
+        {
+            ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+            if (mgr.getParallelUpdate())
+                mgr._queueUpdate(mTarget, value);
+            else
+                mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
@@ -96,11 +106,20 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mParticleData(0),
+        mParticleObjectsInSync(true),
+        mParticleObjectsExposed(false),
+        mParticlesMoved(false),
+        mRandomSeed(0),
+        mPendingUpdateTime(0),
+        mUpdatePending(false),
+        mParentNodeUpdatePending(false),
         mRenderer(0),
         mCullIndividual(false),
         mPoolSize(0),
         mEmittedEmitterPoolSize(0)
     {
+        mRandomSequence.reset(mRandomSeed);
         initParameters();
 
         // Default to billboard renderer
@@ -129,11 +148,20 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mParticleData(0),
+        mParticleObjectsInSync(true),
+        mParticleObjectsExposed(false),
+        mParticlesMoved(false),
+        mRandomSeed(FastHash(name.c_str(), static_cast<int>(name.size()))),
+        mPendingUpdateTime(0),
+        mUpdatePending(false),
+        mParentNodeUpdatePending(false),
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
         mEmittedEmitterPoolSize(0)
     {
+        mRandomSequence.reset(mRandomSeed);
         setDefaultDimensions( 100, 100 );
         setMaterialName( "BaseWhite" );
         // Default to 10 particles, expect app to specify (will only be increased, not decreased)
@@ -153,12 +181,20 @@ namespace Ogre {
             ControllerManager::getSingleton().destroyController(mTimeController);
             mTimeController = 0;
         }
+        if (ParticleSystemManager::getSingletonPtr())
+        {
+            // Drop any update queued by the controller
+            ParticleSystemManager::getSingleton()._dequeueUpdate(this);
+        }
 
         // Arrange for the deletion of emitters & affectors
         removeAllEmitters();
         removeAllEmittedEmitters();
         removeAllAffectors();
 
+        OGRE_DELETE mParticleData;
+        mParticleData = 0;
+
         // Deallocate all particles
         destroyVisualParticles(0, mParticlePool.size());
         // Free pool items
@@ -295,6 +331,7 @@ namespace Ogre {
         mIterationIntervalSet = rhs.mIterationIntervalSet;
         mNonvisibleTimeout = rhs.mNonvisibleTimeout;
         mNonvisibleTimeoutSet = rhs.mNonvisibleTimeoutSet;
+        setStorageMode(rhs.getStorageMode());
         // last frame visible and time since last visible should be left default
 
         setRenderer(rhs.getRendererName());
@@ -310,6 +347,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     size_t ParticleSystem::getNumParticles(void) const
     {
+        if (mParticleData)
+            return mParticleData->getCount();
         return mActiveParticles.size();
     }
     //-----------------------------------------------------------------------
@@ -366,10 +405,19 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
+    {
+        if (_prepareUpdate(timeElapsed))
+        {
+            _updateParticles(false);
+            _finishUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_prepareUpdate(Real timeElapsed)
     {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
         Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
             mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -385,13 +433,16 @@ namespace Ogre {
                 if (mTimeSinceLastVisible >= nonvisibleTimeout)
                 {
                     // No update
-                    return;
+                    return false;
                 }
             }
         }
 
         // Scale incoming speed for the rest of the calculation
-        timeElapsed *= mSpeedFactor;
+        mPendingUpdateTime += timeElapsed * mSpeedFactor;
+        if (mUpdatePending)
+            return false;
+        mUpdatePending = true;
 
         // Init renderer if not done already
         configureRenderer();
@@ -399,6 +450,34 @@ namespace Ogre {
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        if (mParticleData)
+        {
+            // Pick up any change made to the particles since the last update
+            if (mParticleObjectsExposed)
+            {
+                readParticleObjects();
+                mParticleObjectsExposed = false;
+            }
+            mParticleObjectsInSync = false;
+        }
+
+        // The node caches its derived transform on demand, do it now rather
+        // than during _updateParticles
+        mParentNode->_getFullTransform();
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_updateParticles(bool ownRandomSequence)
+    {
+        if (!mUpdatePending)
+            return;
+        Real timeElapsed = mPendingUpdateTime;
+        mPendingUpdateTime = 0;
+        mUpdatePending = false;
+
+        if (ownRandomSequence)
+            Math::SetThreadRandomValueProvider(&mRandomSequence);
+
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -437,8 +516,40 @@ namespace Ogre {
 
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
-        _updateBounds();
+        mParentNodeUpdatePending = calculateBounds() || mParentNodeUpdatePending;
 
+        if (ownRandomSequence)
+            Math::SetThreadRandomValueProvider(0);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_finishUpdate(void)
+    {
+        if (mParentNodeUpdatePending && mParentNode)
+            mParentNode->needUpdate();
+        mParentNodeUpdatePending = false;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::setRandomSeed(uint32 seed)
+    {
+        mRandomSeed = seed;
+        mRandomSequence.reset(seed);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::RandomSequence::reset(uint32 seed)
+    {
+        // Xorshift needs a non-zero state
+        mState = seed ^ 0x9E3779B9;
+        if (!mState)
+            mState = 1;
+    }
+    //-----------------------------------------------------------------------
+    Real ParticleSystem::RandomSequence::getRandomUnit()
+    {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        // 24 bits, which a float represents exactly
+        return Real(mState >> 8) / Real(0xFFFFFF);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
@@ -447,6 +558,47 @@ namespace Ogre {
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
+        if (mParticleData)
+        {
+            ParticleData& data = *mParticleData;
+
+            // Each expired particle is replaced by the last one, which is tested next
+            size_t index = 0;
+            while (index < data.getCount())
+            {
+                if (data.mTimeToLive[index] < timeElapsed)
+                {
+                    pParticle = data.mParticles[index];
+                    data.write(index);
+
+                    // Notify renderer
+                    mRenderer->_notifyParticleExpired(pParticle);
+
+                    if (pParticle->mParticleType == Particle::Visual)
+                    {
+                        data.deactivate(index);
+                    }
+                    else
+                    {
+                        pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
+                        list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
+                        fee->push_back(pParticleEmitter);
+                        removeFromActiveEmittedEmitters(pParticleEmitter);
+                        data.remove(index);
+                    }
+                }
+                else
+                {
+                    ++index;
+                }
+            }
+
+            // Decrement TTL of the others
+            OptimisedUtil::getImplementation()->multiplyAddClampArray(data.mTimeToLive,
+                1, -timeElapsed, Math::NEG_INFINITY, Math::POS_INFINITY, data.getCount());
+            return;
+        }
+
         itEnd = mActiveParticles.end();
 
         for (i = mActiveParticles.begin(); i != itEnd; )
@@ -490,8 +642,8 @@ namespace Ogre {
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static vector<unsigned>::type requested;
-        static vector<unsigned>::type emittedRequested;
+        vector<unsigned>::type& requested = mRequestedEmissions;
+        vector<unsigned>::type& emittedRequested = mEmittedRequestedEmissions;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -506,7 +658,7 @@ namespace Ogre {
         emitterCount = mEmitters.size();
         emittedEmitterCount=mActiveEmittedEmitters.size();
         itActiveEnd=mActiveEmittedEmitters.end();
-        emissionAllowed = mFreeParticles.size();
+        emissionAllowed = mParticleData ? mParticleData->getNumFree() : mFreeParticles.size();
         totalRequested = 0;
 
         // Count up total requested emissions for regular emitters (and exclude the ones that are used as
@@ -579,7 +731,7 @@ namespace Ogre {
             Particle* p = 0;
             String  emitterName = emitter->getEmittedEmitter();
             if (emitterName == BLANKSTRING)
-                p = createParticle();
+                p = activateParticle();
             else
                 p = createEmitterParticle(emitterName);
 
@@ -616,6 +768,10 @@ namespace Ogre {
                 pParticleEmitter->setPosition(p->mPosition);
             }
 
+            // The new particle always takes the last slot
+            if (mParticleData)
+                mParticleData->read(mParticleData->getCount() - 1);
+
             // Notify renderer
             mRenderer->_notifyParticleEmitted(p);
         }
@@ -627,6 +783,34 @@ namespace Ogre {
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
+        if (mParticleData)
+        {
+            ParticleData& data = *mParticleData;
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            util->addScaledArray(data.mPositionX, data.mDirectionX, timeElapsed, data.getCount());
+            util->addScaledArray(data.mPositionY, data.mDirectionY, timeElapsed, data.getCount());
+            util->addScaledArray(data.mPositionZ, data.mDirectionZ, timeElapsed, data.getCount());
+
+            if (!mActiveEmittedEmitters.empty())
+            {
+                // The emitter positions must also be updated
+                for (size_t index = 0; index < data.getCount(); ++index)
+                {
+                    pParticle = data.mParticles[index];
+                    if (pParticle->mParticleType == Particle::Emitter)
+                    {
+                        data.write(index);
+                        pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
+                        pParticleEmitter->setPosition(pParticle->mPosition);
+                    }
+                }
+            }
+
+            // The renderer is notified once the Particle instances are brought up to date
+            mParticlesMoved = true;
+            return;
+        }
+
         itEnd = mActiveParticles.end();
         for (i = mActiveParticles.begin(); i != itEnd; ++i)
         {
@@ -654,7 +838,22 @@ namespace Ogre {
         itEnd = mAffectors.end();
         for (i = mAffectors.begin(); i != itEnd; ++i)
         {
-            (*i)->_affectParticles(this, timeElapsed);
+            if (!mParticleData)
+            {
+                (*i)->_affectParticles(this, timeElapsed);
+            }
+            else if (!(*i)->_affectParticleData(this, *mParticleData, timeElapsed))
+            {
+                // Let the affector work on the Particle instances, then pick up its changes
+                syncParticleObjects();
+                (*i)->_affectParticles(this, timeElapsed);
+                readParticleObjects();
+                mParticleObjectsExposed = false;
+            }
+            else
+            {
+                mParticleObjectsInSync = false;
+            }
         }
 
     }
@@ -683,11 +882,24 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ParticleIterator ParticleSystem::_getIterator(void)
     {
+        if (mParticleData)
+        {
+            syncParticleObjects();
+            mParticleObjectsExposed = true;
+        }
         return ParticleIterator(mActiveParticles.begin(), mActiveParticles.end());
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::getParticle(size_t index) 
     {
+        if (mParticleData)
+        {
+            assert (index < mParticleData->getCount() && "Index out of bounds!");
+            syncParticleObjects();
+            mParticleObjectsExposed = true;
+            return mParticleData->mParticles[index];
+        }
+
         assert (index < mActiveParticles.size() && "Index out of bounds!");
         ActiveParticleList::iterator i = mActiveParticles.begin();
         std::advance(i, index);
@@ -695,9 +907,33 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::createParticle(void)
+    {
+        // The other particles are read back along with the created one, so
+        // bring their instances up to date with the arrays first
+        syncParticleObjects();
+
+        Particle* p = activateParticle();
+
+        // The caller initialises the particle
+        if (p && mParticleData)
+            mParticleObjectsExposed = true;
+
+        return p;
+    }
+    //-----------------------------------------------------------------------
+    Particle* ParticleSystem::activateParticle(void)
     {
         Particle* p = 0;
-        if (!mFreeParticles.empty())
+        if (mParticleData)
+        {
+            p = mParticleData->activateFree();
+            if (p)
+            {
+                p->_notifyOwner(this);
+                mParticleObjectsInSync = false;
+            }
+        }
+        else if (!mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
             p = mFreeParticles.front();
@@ -720,7 +956,15 @@ namespace Ogre {
             p = fee->front();
             p->mParticleType = Particle::Emitter;
             fee->pop_front();
-            mActiveParticles.push_back(p);
+            if (mParticleData)
+            {
+                mParticleData->addActive(p);
+                mParticleObjectsInSync = false;
+            }
+            else
+            {
+                mActiveParticles.push_back(p);
+            }
 
             // Also add to mActiveEmittedEmitters. This is needed to traverse through all active emitters
             // that are emitted. Don't use mActiveParticles for that (although they are added to
@@ -737,6 +981,7 @@ namespace Ogre {
     {
         if (mRenderer)
         {
+            syncParticleObjects();
             mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
         }
     }
@@ -813,15 +1058,27 @@ namespace Ogre {
                 PT_REAL),
                 &msNonvisibleTimeoutCmd);
 
+            dict->addParameter(ParameterDef("storage_mode", 
+                "Sets how the particles are stored, 'list' (default) or 'arrays' of each "
+                "component for faster updates of large numbers of particles.",
+                PT_STRING),
+                &msStorageModeCmd);
+
         }
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_updateBounds()
+    {
+        if (calculateBounds())
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::calculateBounds(void)
     {
 
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
-            if (mActiveParticles.empty())
+            if (getNumParticles() == 0)
             {
                 // No particles, reset to null if auto update bounds
                 if (mBoundsAutoUpdate)
@@ -849,19 +1106,42 @@ namespace Ogre {
                 Vector3 halfScale = Vector3::UNIT_SCALE * 0.5;
                 Vector3 defaultPadding = 
                     halfScale * std::max(mDefaultHeight, mDefaultWidth);
-                for (p = mActiveParticles.begin(); p != mActiveParticles.end(); ++p)
+                if (mParticleData)
                 {
-                    if ((*p)->mOwnDimensions)
+                    const ParticleData& data = *mParticleData;
+                    for (size_t index = 0; index < data.getCount(); ++index)
                     {
-                        Vector3 padding = 
-                            halfScale * std::max((*p)->mWidth, (*p)->mHeight);
-                        min.makeFloor((*p)->mPosition - padding);
-                        max.makeCeil((*p)->mPosition + padding);
+                        Vector3 position(data.mPositionX[index], data.mPositionY[index], data.mPositionZ[index]);
+                        if (data.mOwnDimensions[index])
+                        {
+                            Vector3 padding = 
+                                halfScale * std::max(data.mWidth[index], data.mHeight[index]);
+                            min.makeFloor(position - padding);
+                            max.makeCeil(position + padding);
+                        }
+                        else
+                        {
+                            min.makeFloor(position - defaultPadding);
+                            max.makeCeil(position + defaultPadding);
+                        }
                     }
-                    else
+                }
+                else
+                {
+                    for (p = mActiveParticles.begin(); p != mActiveParticles.end(); ++p)
                     {
-                        min.makeFloor((*p)->mPosition - defaultPadding);
-                        max.makeCeil((*p)->mPosition + defaultPadding);
+                        if ((*p)->mOwnDimensions)
+                        {
+                            Vector3 padding = 
+                                halfScale * std::max((*p)->mWidth, (*p)->mHeight);
+                            min.makeFloor((*p)->mPosition - padding);
+                            max.makeCeil((*p)->mPosition + padding);
+                        }
+                        else
+                        {
+                            min.makeFloor((*p)->mPosition - defaultPadding);
+                            max.makeCeil((*p)->mPosition + defaultPadding);
+                        }
                     }
                 }
                 mWorldAABB.setExtents(min, max);
@@ -885,8 +1165,9 @@ namespace Ogre {
                 mAABB.merge(newAABB);
             }
 
-            mParentNode->needUpdate();
+            return true;
         }
+        return false;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::fastForward(Real time, Real interval)
@@ -1044,11 +1325,30 @@ namespace Ogre {
         // Notify renderer if exists
         if (mRenderer)
         {
+            syncParticleObjects();
             mRenderer->_notifyParticleCleared(mActiveParticles);
         }
 
-        // Move actives to free list
-        mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        if (mParticleData)
+        {
+            // Free the visual particles, from the last one so that none moves
+            for (size_t index = mParticleData->getCount(); index > 0; --index)
+            {
+                if (mParticleData->mParticles[index - 1]->mParticleType == Particle::Visual)
+                    mParticleData->deactivate(index - 1);
+                else
+                    mParticleData->remove(index - 1);
+            }
+            mActiveParticles.clear();
+            mParticleObjectsInSync = true;
+            mParticleObjectsExposed = false;
+            mParticlesMoved = false;
+        }
+        else
+        {
+            // Move actives to free list
+            mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        }
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1089,7 +1389,10 @@ namespace Ogre {
             for( size_t i = currSize; i < size; ++i )
             {
                 // Add new items to the queue
-                mFreeParticles.push_back( mParticlePool[i] );
+                if (mParticleData)
+                    mParticleData->addFree( mParticlePool[i] );
+                else
+                    mFreeParticles.push_back( mParticlePool[i] );
             }
 
             // Tell the renderer, if already configured
@@ -1212,6 +1515,9 @@ namespace Ogre {
     {
         if (mRenderer)
         {
+            // Only the list is sorted, the order of the arrays does not matter
+            syncParticleObjects();
+
             SortMode sortMode = mRenderer->_getSortMode();
             if (sortMode == SM_DIRECTION)
             {
@@ -1258,6 +1564,80 @@ namespace Ogre {
         return SceneManager::FX_TYPE_MASK;
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::setStorageMode(ParticleStorageMode mode)
+    {
+        if (mode == getStorageMode())
+            return;
+
+        if (mode == PSM_ARRAYS)
+        {
+            mParticleData = OGRE_NEW ParticleData();
+
+            ActiveParticleList::iterator i;
+            for (i = mActiveParticles.begin(); i != mActiveParticles.end(); ++i)
+            {
+                mParticleData->addActive(*i);
+            }
+            FreeParticleList::iterator f;
+            for (f = mFreeParticles.begin(); f != mFreeParticles.end(); ++f)
+            {
+                mParticleData->addFree(*f);
+            }
+            mFreeParticles.clear();
+
+            // mActiveParticles still lists the particles, in their order
+            mParticleObjectsInSync = true;
+            mParticleObjectsExposed = false;
+            mParticlesMoved = false;
+        }
+        else
+        {
+            syncParticleObjects();
+
+            Particle** freeParticles = mParticleData->mParticles + mParticleData->getCount();
+            mFreeParticles.assign(freeParticles, freeParticles + mParticleData->getNumFree());
+
+            OGRE_DELETE mParticleData;
+            mParticleData = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::syncParticleObjects(void)
+    {
+        if (!mParticleData || mParticleObjectsInSync)
+            return;
+
+        // Changes made through the exposed instances, such as initialising
+        // a created particle, are newer than the arrays
+        if (mParticleObjectsExposed)
+            readParticleObjects();
+
+        const ParticleData& data = *mParticleData;
+        for (size_t index = 0; index < data.getCount(); ++index)
+        {
+            data.write(index);
+        }
+
+        // Reuses the nodes of the list
+        mActiveParticles.assign(data.mParticles, data.mParticles + data.getCount());
+        mParticleObjectsInSync = true;
+
+        if (mParticlesMoved && mRenderer)
+        {
+            mRenderer->_notifyParticleMoved(mActiveParticles);
+        }
+        mParticlesMoved = false;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::readParticleObjects(void)
+    {
+        ParticleData& data = *mParticleData;
+        for (size_t index = 0; index < data.getCount(); ++index)
+        {
+            data.read(index);
+        }
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::initialiseEmittedEmitters(void)
     {
         // Initialise the pool if needed
@@ -1608,6 +1988,31 @@ namespace Ogre {
         static_cast<ParticleSystem*>(target)->setNonVisibleUpdateTimeout(
             StringConverter::parseReal(val));
     }
+    //-----------------------------------------------------------------------
+    String ParticleSystem::CmdStorageMode::doGet(const void* target) const
+    {
+        ParticleStorageMode mode = static_cast<const ParticleSystem*>(target)->getStorageMode();
+        return mode == PSM_ARRAYS ? "arrays" : "list";
+    }
+    void ParticleSystem::CmdStorageMode::doSet(void* target, const String& val)
+    {
+        ParticleStorageMode mode;
+        if (val == "list")
+        {
+            mode = PSM_LIST;
+        }
+        else if (val == "arrays")
+        {
+            mode = PSM_ARRAYS;
+        }
+        else
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, 
+                "Invalid storage_mode '" + val + "'", 
+                "ParticleSystem::CmdStorageMode::doSet");
+        }
+        static_cast<ParticleSystem*>(target)->setStorageMode(mode);
+    }
    //-----------------------------------------------------------------------
     ParticleAffector::~ParticleAffector() 
     {
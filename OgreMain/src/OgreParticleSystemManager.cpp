@@ -37,8 +37,26 @@ THE SOFTWARE.
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreScriptCompiler.h"
 #include "OgreParticleSystem.h"
+#include "OgreWorkQueue.h"
+#include "OgreProfiler.h"
 
 namespace Ogre {
+    namespace {
+        /// Updates the particles of systems, see ParticleSystemManager::setParallelUpdate
+        class ParticleUpdateTask : public WorkQueue::ParallelTask
+        {
+        public:
+            explicit ParticleUpdateTask(const vector<ParticleSystem*>::type& systems)
+                : mSystems(systems) {}
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    mSystems[i]->_updateParticles(true);
+            }
+        protected:
+            const vector<ParticleSystem*>::type& mSystems;
+        };
+    }
     //-----------------------------------------------------------------------
     // Shortcut to set up billboard particle renderer
     BillboardParticleRendererFactory* mBillboardRendererFactory = 0;
@@ -54,6 +72,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleSystemManager()
+        : mParallelUpdate(false)
     {
         OGRE_LOCK_AUTO_MUTEX;
         mFactory = OGRE_NEW ParticleSystemFactory();
@@ -89,6 +108,63 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::setParallelUpdate(bool enabled)
+    {
+        if (!enabled)
+        {
+            // Don't leave updates behind
+            _updateQueuedSystems();
+        }
+        mParallelUpdate = enabled;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* system, Real timeElapsed)
+    {
+        mQueuedUpdates.push_back(std::make_pair(system, timeElapsed));
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_dequeueUpdate(ParticleSystem* system)
+    {
+        QueuedUpdateList::iterator i = mQueuedUpdates.begin();
+        while (i != mQueuedUpdates.end())
+        {
+            if (i->first == system)
+                i = mQueuedUpdates.erase(i);
+            else
+                ++i;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateQueuedSystems(void)
+    {
+        if (mQueuedUpdates.empty())
+            return;
+        OgreProfileGroup("_updateQueuedSystems", OGREPROF_GENERAL);
+
+        // A system queued more than once is only prepared once, with the sum of the times
+        mUpdatingSystems.clear();
+        for (QueuedUpdateList::iterator i = mQueuedUpdates.begin(); i != mQueuedUpdates.end(); ++i)
+        {
+            if (i->first->_prepareUpdate(i->second))
+                mUpdatingSystems.push_back(i->first);
+        }
+        mQueuedUpdates.clear();
+
+        ParticleUpdateTask task(mUpdatingSystems);
+        WorkQueue* workQueue = Root::getSingleton().getWorkQueue();
+        if (workQueue)
+            workQueue->parallelFor(&task, mUpdatingSystems.size());
+        else
+            task.execute(0, mUpdatingSystems.size());
+
+        // Back in queue order
+        for (ParticleSystemList::iterator i = mUpdatingSystems.begin(); i != mUpdatingSystems.end(); ++i)
+        {
+            (*i)->_finishUpdate();
+        }
+        mUpdatingSystems.clear();
+    }
+    //-----------------------------------------------------------------------
     const StringVector& ParticleSystemManager::getScriptPatterns(void) const
     {
         return mScriptPatterns;
@@ -151,10 +151,19 @@ namespace Ogre {
 
     //---------------------------------------------------------------------
     // Performs CPUID instruction with 'query', fill the results, and return value of eax.
+    // The sub-function in ecx is set to zero, for the functions which take one.
     static uint _performCpuid(int query, CpuidResult& result)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
-    #if _MSC_VER >= 1400 
+    #if _MSC_VER >= 1600
+        int CPUInfo[4];
+        __cpuidex(CPUInfo, query, 0);
+        result._eax = CPUInfo[0];
+        result._ebx = CPUInfo[1];
+        result._ecx = CPUInfo[2];
+        result._edx = CPUInfo[3];
+        return result._eax;
+    #elif _MSC_VER >= 1400
         int CPUInfo[4];
         __cpuid(CPUInfo, query);
         result._eax = CPUInfo[0];
@@ -167,6 +176,7 @@ namespace Ogre {
         {
             mov     edi, result
             mov     eax, query
+            xor     ecx, ecx
             cpuid
             mov     [edi]._eax, eax
             mov     [edi]._ebx, ebx
@@ -179,7 +189,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (0)
         );
         #else
         __asm__
@@ -189,11 +199,36 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (0)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
 
+#else
+        // TODO: Supports other compiler
+        return 0;
+#endif
+    }
+
+    //---------------------------------------------------------------------
+    // Reads the extended control register 0, which tells the register states
+    // the operating system saves. Only valid when CPUID reports OSXSAVE.
+    static uint _readExtendedControlRegister(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+    #if _MSC_VER >= 1600
+        return (uint)_xgetbv(0);
+    #else
+        return 0;
+    #endif
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_NACL && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint eax, edx;
+        // xgetbv, spelt out for the assemblers which don't know it
+        __asm__ __volatile__
+        (
+            ".byte 0x0f, 0x01, 0xd0": "=a" (eax), "=d" (edx) : "c" (0)
+        );
+        return eax;
 #else
         // TODO: Supports other compiler
         return 0;
@@ -280,11 +315,9 @@ namespace Ogre {
     // Compiler-independent routines
     //---------------------------------------------------------------------
 
-    static uint queryCpuFeatures(void)
-    {
-
 #define CPUID_FUNC_VENDOR_ID                 0x0
 #define CPUID_FUNC_STANDARD_FEATURES         0x1
+#define CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES 0x7
 #define CPUID_FUNC_EXTENSION_QUERY           0x80000000
 #define CPUID_FUNC_EXTENDED_FEATURES         0x80000001
 #define CPUID_FUNC_ADVANCED_POWER_MANAGEMENT 0x80000007
@@ -300,6 +333,13 @@ namespace Ogre {
 #define CPUID_STD_SSE3              (1<<0)      // ECX[0]  - Bit 0 of standard function 1 indicate SSE3 supported
 #define CPUID_STD_SSE41             (1<<19)     // ECX[19] - Bit 0 of standard function 1 indicate SSE41 supported
 #define CPUID_STD_SSE42             (1<<20)     // ECX[20] - Bit 0 of standard function 1 indicate SSE42 supported
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate the OS uses XSAVE
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+
+#define CPUID_SEXT_AVX2             (1<<5)      // EBX[5]  - Bit 5 of function 7 indicate AVX2 supported
+
+#define XCR0_SSE_AVX_STATE          0x6         // Bits 1 and 2 of XCR0 set when the OS saves the XMM and YMM registers
 
 #define CPUID_FAMILY_ID_MASK        0x0F00      // EAX[11:8] - Bit 11 thru 8 contains family  processor id
 #define CPUID_EXT_FAMILY_ID_MASK    0x0F00000   // EAX[23:20] - Bit 23 thru 20 contains extended family processor id
@@ -312,6 +352,39 @@ namespace Ogre {
 
 #define CPUID_APM_INVARIANT_TSC     (1<<8)      // EDX[8] - Bit 8 of function 0x80000007 indicates support for invariant TSC.
 
+    // Queries the AVX family features, common to all vendors. They are only
+    // reported when the operating system saves the YMM registers.
+    static uint queryAvxFeatures(uint maxStandardFunction)
+    {
+        uint features = 0;
+        CpuidResult result;
+
+        _performCpuid(CPUID_FUNC_STANDARD_FEATURES, result);
+        if (!(result._ecx & CPUID_STD_OSXSAVE) ||
+            (_readExtendedControlRegister() & XCR0_SSE_AVX_STATE) != XCR0_SSE_AVX_STATE)
+        {
+            return 0;
+        }
+
+        if (result._ecx & CPUID_STD_AVX)
+        {
+            features |= PlatformInformation::CPU_FEATURE_AVX;
+            if (result._ecx & CPUID_STD_FMA)
+                features |= PlatformInformation::CPU_FEATURE_FMA;
+
+            if (maxStandardFunction >= CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES)
+            {
+                _performCpuid(CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES, result);
+                if (result._ebx & CPUID_SEXT_AVX2)
+                    features |= PlatformInformation::CPU_FEATURE_AVX2;
+            }
+        }
+
+        return features;
+    }
+
+    static uint queryCpuFeatures(void)
+    {
         uint features = 0;
 
         // Supports CPUID instruction ?
@@ -320,7 +393,8 @@ namespace Ogre {
             CpuidResult result;
 
             // Has standard feature ?
-            if (_performCpuid(CPUID_FUNC_VENDOR_ID, result))
+            const uint maxStandardFunction = _performCpuid(CPUID_FUNC_VENDOR_ID, result);
+            if (maxStandardFunction)
             {
                 // Check vendor strings
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
@@ -416,6 +490,9 @@ namespace Ogre {
                             features |= PlatformInformation::CPU_FEATURE_INVARIANT_TSC;
                     }
                 }
+
+                if (features & PlatformInformation::CPU_FEATURE_SSE)
+                    features |= queryAvxFeatures(maxStandardFunction);
             }
         }
 
@@ -431,7 +508,10 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE2
             | PlatformInformation::CPU_FEATURE_SSE3
             | PlatformInformation::CPU_FEATURE_SSE41
-            | PlatformInformation::CPU_FEATURE_SSE42;
+            | PlatformInformation::CPU_FEATURE_SSE42
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA;
 
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
@@ -569,7 +649,7 @@ namespace Ogre {
     {
         // Use preprocessor definitions to determine architecture and CPU features
         uint features = 0;
-#if defined(__ARM_NEON__)
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
         int hasNEON;
         size_t len = sizeof(size_t);
@@ -719,6 +799,12 @@ namespace Ogre {
                 " *          PRO: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_PRO), true));
             pLog->logMessage(
                 " *           HT: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_HTT), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
         }
 #elif OGRE_CPU == OGRE_CPU_ARM || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
         pLog->logMessage(
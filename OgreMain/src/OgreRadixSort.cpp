@@ -0,0 +1,211 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreRadixSort.h"
+#include "OgreWorkQueue.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        const size_t NUM_PASSES = 8;
+
+        inline uint32 getDigit(uint64 key, size_t pass)
+        {
+            return static_cast<uint32>(key >> (pass * 8)) & 0xFF;
+        }
+
+        /// Shared state of the chunk tasks
+        struct ChunkTaskBase : public WorkQueue::ParallelTask
+        {
+            size_t mCount;
+            size_t mBatchSize;
+            uint32* mCounters;
+
+            size_t chunkBegin(size_t chunk) const { return chunk * mBatchSize; }
+            size_t chunkEnd(size_t chunk) const { return std::min((chunk + 1) * mBatchSize, mCount); }
+        };
+
+        /// Counts the digits of a chunk of keys, for all passes at once
+        template <typename TEntry>
+        struct CountAllTask : public ChunkTaskBase
+        {
+            const TEntry* mSrc;
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t chunk = begin; chunk < end; ++chunk)
+                {
+                    uint32* counters = mCounters + chunk * NUM_PASSES * 256;
+                    memset(counters, 0, sizeof(uint32) * NUM_PASSES * 256);
+                    for (size_t i = chunkBegin(chunk); i < chunkEnd(chunk); ++i)
+                    {
+                        uint64 key = mSrc[i].key;
+                        for (size_t p = 0; p < NUM_PASSES; ++p)
+                            ++counters[p * 256 + getDigit(key, p)];
+                    }
+                }
+            }
+        };
+
+        /// Counts the digits of a chunk of keys for a single pass
+        template <typename TEntry>
+        struct CountTask : public ChunkTaskBase
+        {
+            const TEntry* mSrc;
+            size_t mPass;
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t chunk = begin; chunk < end; ++chunk)
+                {
+                    uint32* counters = mCounters + (chunk * NUM_PASSES + mPass) * 256;
+                    memset(counters, 0, sizeof(uint32) * 256);
+                    for (size_t i = chunkBegin(chunk); i < chunkEnd(chunk); ++i)
+                        ++counters[getDigit(mSrc[i].key, mPass)];
+                }
+            }
+        };
+
+        /// Moves a chunk of keys to their place for a single pass
+        template <typename TEntry>
+        struct ScatterTask : public ChunkTaskBase
+        {
+            const TEntry* mSrc;
+            TEntry* mDest;
+            size_t mPass;
+
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t chunk = begin; chunk < end; ++chunk)
+                {
+                    uint32* offsets = mCounters + (chunk * NUM_PASSES + mPass) * 256;
+                    for (size_t i = chunkBegin(chunk); i < chunkEnd(chunk); ++i)
+                        mDest[offsets[getDigit(mSrc[i].key, mPass)]++] = mSrc[i];
+                }
+            }
+        };
+
+        void runTask(WorkQueue::ParallelTask& task, size_t numChunks, WorkQueue* workQueue)
+        {
+            if (workQueue)
+                workQueue->parallelFor(&task, numChunks);
+            else
+                task.execute(0, numChunks);
+        }
+    }
+    //-----------------------------------------------------------------------
+    ParallelRadixSortBase::ParallelRadixSortBase()
+        : mBatchSize(16384)
+    {
+    }
+    //-----------------------------------------------------------------------
+    ParallelRadixSortBase::~ParallelRadixSortBase()
+    {
+    }
+    //-----------------------------------------------------------------------
+    const ParallelRadixSortBase::SortVector& ParallelRadixSortBase::sortEntries(
+        size_t count, WorkQueue* workQueue)
+    {
+        size_t batchSize = std::max(mBatchSize, (size_t)1);
+        size_t numChunks = (count + batchSize - 1) / batchSize;
+        mSortArea2.resize(count);
+        mCounters.resize(numChunks * NUM_PASSES * 256);
+
+        SortVector* src = &mSortArea1;
+        SortVector* dest = &mSortArea2;
+
+        // Count the digits of all passes, which tells which passes can be skipped
+        CountAllTask<SortEntry> countAll;
+        countAll.mCount = count;
+        countAll.mBatchSize = batchSize;
+        countAll.mCounters = &mCounters[0];
+        countAll.mSrc = &(*src)[0];
+        runTask(countAll, numChunks, workQueue);
+
+        bool moved = false;
+        for (size_t pass = 0; pass < NUM_PASSES; ++pass)
+        {
+            // Skip the pass if all keys have the same digit, the totals don't
+            // depend on the order so the first counts can be used for that
+            bool skip = false;
+            for (uint32 digit = 0; digit < 256 && !skip; ++digit)
+            {
+                size_t total = 0;
+                for (size_t chunk = 0; chunk < numChunks; ++chunk)
+                    total += mCounters[(chunk * NUM_PASSES + pass) * 256 + digit];
+                if (total == count)
+                    skip = true;
+                else if (total)
+                    break;
+            }
+            if (skip)
+                continue;
+
+            // The chunks hold different keys once they have been moved
+            if (moved)
+            {
+                CountTask<SortEntry> countTask;
+                countTask.mCount = count;
+                countTask.mBatchSize = batchSize;
+                countTask.mCounters = &mCounters[0];
+                countTask.mSrc = &(*src)[0];
+                countTask.mPass = pass;
+                runTask(countTask, numChunks, workQueue);
+            }
+
+            // Turn the counts into offsets, the keys of earlier chunks come
+            // first for every digit so the sort is stable
+            uint32 offset = 0;
+            for (uint32 digit = 0; digit < 256; ++digit)
+            {
+                for (size_t chunk = 0; chunk < numChunks; ++chunk)
+                {
+                    uint32& counter = mCounters[(chunk * NUM_PASSES + pass) * 256 + digit];
+                    uint32 num = counter;
+                    counter = offset;
+                    offset += num;
+                }
+            }
+
+            ScatterTask<SortEntry> scatter;
+            scatter.mCount = count;
+            scatter.mBatchSize = batchSize;
+            scatter.mCounters = &mCounters[0];
+            scatter.mSrc = &(*src)[0];
+            scatter.mDest = &(*dest)[0];
+            scatter.mPass = pass;
+            runTask(scatter, numChunks, workQueue);
+
+            std::swap(src, dest);
+            moved = true;
+        }
+
+        return *src;
+    }
+}
@@ -46,6 +46,7 @@ namespace Ogre {
         : mSplitPassesByLightingType(false)
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
+        , mRetainSortOrder(false)
         , mRenderableListener(0)
     {
         // Create the 'main' queue up-front since we'll always need that
@@ -211,6 +212,8 @@ namespace Ogre {
                 mSplitPassesByLightingType,
                 mSplitNoShadowPasses,
                 mShadowCastersCannotBeReceivers);
+            if (mRetainSortOrder)
+                pGroup->setRetainSortOrder(true);
             mGroups.insert(RenderQueueGroupMap::value_type(groupID, pGroup));
         }
         else
@@ -276,6 +279,24 @@ namespace Ogre {
         return mShadowCastersCannotBeReceivers;
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::setRetainSortOrder(bool retain)
+    {
+        mRetainSortOrder = retain;
+
+        RenderQueueGroupMap::iterator i, iend;
+        i = mGroups.begin();
+        iend = mGroups.end();
+        for (; i != iend; ++i)
+        {
+            i->second->setRetainSortOrder(retain);
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool RenderQueue::getRetainSortOrder(void) const
+    {
+        return mRetainSortOrder;
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::merge( const RenderQueue* rhs )
     {
         ConstQueueGroupIterator it = rhs->_getQueueGroupIterator( );
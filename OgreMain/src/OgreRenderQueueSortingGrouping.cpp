@@ -29,13 +29,10 @@ THE SOFTWARE.
 #include "OgreRenderQueueSortingGrouping.h"
 #include "OgreException.h"
 #include "OgreTechnique.h"
+#include "OgreRoot.h"
 
 namespace Ogre {
     // Init statics
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
 
 
     //-----------------------------------------------------------------------
@@ -280,6 +277,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
         :mOrganisationMode(0)
+        , mRetainSortOrder(false)
+        , mRetainedCount(0)
     {
     }
     //-----------------------------------------------------------------------
@@ -329,15 +328,19 @@ namespace Ogre {
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
-        if (mOrganisationMode & OM_SORT_DESCENDING)
+        if ((mOrganisationMode & OM_SORT_DESCENDING) && mRetainSortOrder)
+        {
+            sortRetained(cam);
+        }
+        else if (mOrganisationMode & OM_SORT_DESCENDING)
         {
             
             // We can either use a stable_sort and the 'less' implementation,
-            // or a 2-pass radix sort (once by pass, then by distance, since
-            // radix sorting is inherently stable this will work)
+            // or a radix sort on a 64 bit key made of distance and pass hash
+            // (this gives the same order as sorting by pass, then by distance,
+            // since radix sorting is inherently stable)
             // We use stable_sort if the number of items is 512 or less, since
-            // the complexity of the radix sort is approximately O(10N), since 
-            // each sort is O(5N) (1 pass histograms, 4 passes sort)
+            // the complexity of the radix sort is approximately O(10N)
             // Since stable_sort has a worst-case performance of O(N(logN)^2)
             // the performance tipping point is from about 1500 items, but in
             // stable_sorts best-case scenario O(NlogN) it would be much higher.
@@ -345,10 +348,10 @@ namespace Ogre {
             
             if (mSortedDescending.size() > 2000)
             {
-                // sort by pass
-                msRadixSorter1.sort(mSortedDescending, RadixSortFunctorPass());
-                // sort by depth
-                msRadixSorter2.sort(mSortedDescending, RadixSortFunctorDistance(cam));
+                // Large lists are split between the worker threads
+                Root* root = Root::getSingletonPtr();
+                mRadixSorter.sort(mSortedDescending, RadixSortFunctorDistancePass(cam),
+                    root ? root->getWorkQueue() : 0);
             }
             else
             {
@@ -362,6 +365,124 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::setRetainSortOrder(bool retain)
+    {
+        mRetainSortOrder = retain;
+        if (!retain)
+        {
+            // free memory
+            RetainedEntryList().swap(mRetainedKept);
+            RetainedEntryList().swap(mRetainedAdded);
+            RetainedSlotList().swap(mRetainedTable);
+            mRetainedCount = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    static inline size_t hashRenderablePass(Renderable* rend, Pass* pass)
+    {
+        size_t h = reinterpret_cast<size_t>(rend) ^ (reinterpret_cast<size_t>(pass) << 5);
+        return h ^ (h >> 7) ^ (h >> 17);
+    }
+    //-----------------------------------------------------------------------
+    size_t QueuedRenderableCollection::findRetainedPosition(Renderable* rend, Pass* pass) const
+    {
+        if (mRetainedTable.empty())
+            return mRetainedCount;
+
+        size_t mask = mRetainedTable.size() - 1;
+        for (size_t i = hashRenderablePass(rend, pass) & mask; ; i = (i + 1) & mask)
+        {
+            const RetainedSlot& slot = mRetainedTable[i];
+            if (!slot.renderable)
+                return mRetainedCount;
+            if (slot.renderable == rend && slot.pass == pass)
+                return slot.position;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::sortRetained(const Camera* cam)
+    {
+        RadixSortFunctorDistancePass keyFunc(cam);
+        size_t count = mSortedDescending.size();
+
+        // Put the items queued last time back at their previous position, 
+        // the others are new. The previous items are only known by their 
+        // pointer values, which may not be valid any more.
+        RetainedEntry empty = { 0, 0, 0 };
+        mRetainedKept.assign(mRetainedCount, empty);
+        mRetainedAdded.clear();
+        RenderablePassList::iterator i, iend = mSortedDescending.end();
+        for (i = mSortedDescending.begin(); i != iend; ++i)
+        {
+            RetainedEntry entry = { keyFunc(*i), i->renderable, i->pass };
+            size_t pos = findRetainedPosition(i->renderable, i->pass);
+            if (pos < mRetainedCount && !mRetainedKept[pos].renderable)
+                mRetainedKept[pos] = entry;
+            else
+                mRetainedAdded.push_back(entry);
+        }
+
+        size_t numKept = 0;
+        for (size_t pos = 0; pos < mRetainedCount; ++pos)
+        {
+            if (mRetainedKept[pos].renderable)
+                mRetainedKept[numKept++] = mRetainedKept[pos];
+        }
+        mRetainedKept.resize(numKept);
+
+        // The kept items are mostly in order, fix them with an insertion sort, 
+        // but give up if it has to move too much
+        size_t movesLeft = numKept * 8 + 256;
+        for (size_t n = 1; n < numKept && movesLeft; ++n)
+        {
+            RetainedEntry entry = mRetainedKept[n];
+            size_t pos = n;
+            while (pos > 0 && entry.key < mRetainedKept[pos - 1].key && movesLeft)
+            {
+                mRetainedKept[pos] = mRetainedKept[pos - 1];
+                --pos;
+                --movesLeft;
+            }
+            mRetainedKept[pos] = entry;
+        }
+        if (!movesLeft)
+            std::stable_sort(mRetainedKept.begin(), mRetainedKept.end(), RetainedEntryLess());
+
+        // Sort the new items on their own and merge them in
+        std::stable_sort(mRetainedAdded.begin(), mRetainedAdded.end(), RetainedEntryLess());
+
+        RetainedEntryList::iterator kept = mRetainedKept.begin(), keptEnd = mRetainedKept.end();
+        RetainedEntryList::iterator added = mRetainedAdded.begin(), addedEnd = mRetainedAdded.end();
+        for (i = mSortedDescending.begin(); i != iend; ++i)
+        {
+            // Kept items first if keys are equal
+            const RetainedEntry& entry = 
+                (added == addedEnd || (kept != keptEnd && !(added->key < kept->key))) ?
+                *kept++ : *added++;
+            i->renderable = entry.renderable;
+            i->pass = entry.pass;
+        }
+
+        // Remember this order for the next sort, in a table at most half full
+        size_t tableSize = 16;
+        while (tableSize < count * 2)
+            tableSize <<= 1;
+        RetainedSlot emptySlot = { 0, 0, 0 };
+        mRetainedTable.assign(tableSize, emptySlot);
+        size_t mask = tableSize - 1;
+        for (size_t pos = 0; pos < count; ++pos)
+        {
+            const RenderablePass& rp = mSortedDescending[pos];
+            size_t slot = hashRenderablePass(rp.renderable, rp.pass) & mask;
+            while (mRetainedTable[slot].renderable)
+                slot = (slot + 1) & mask;
+            mRetainedTable[slot].renderable = rp.renderable;
+            mRetainedTable[slot].pass = rp.pass;
+            mRetainedTable[slot].position = static_cast<uint32>(pos);
+        }
+        mRetainedCount = count;
+    }
+    //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
     {
         // ascending and descending sort both set bit 1
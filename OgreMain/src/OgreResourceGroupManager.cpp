@@ -34,9 +34,82 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 
+    namespace {
+        /// Prepares resources of a group, see ResourceGroupManager::setParallelGroupLoading
+        class ResourcePrepareTask : public WorkQueue::ParallelTask
+        {
+        public:
+            ResourcePrepareTask(const vector<ResourcePtr>::type& resources,
+                vector<uchar>::type& prepared)
+                : mResources(resources), mPrepared(prepared) {}
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    Resource* res = mResources[i].get();
+                    // Manual loaders are left to the calling thread
+                    if (res->isManuallyLoaded() ||
+                        res->getLoadingState() != Resource::LOADSTATE_UNLOADED)
+                        continue;
+                    try
+                    {
+                        res->prepare(true);
+                        mPrepared[i] = res->isPrepared();
+                    }
+                    catch (...)
+                    {
+                        // The resource is left unloaded, the calling thread will
+                        // try again and report the error
+                    }
+                }
+            }
+        protected:
+            const vector<ResourcePtr>::type& mResources;
+            vector<uchar>::type& mPrepared;
+        };
+
+        /// A script read for ScriptPrepareTask
+        struct PreparedScript
+        {
+            ScriptLoader* loader;
+            DataStreamPtr stream;
+            Any prepared;
+        };
+
+        /// Prepares the scripts of a group, see ResourceGroupManager::setParallelScriptParsing
+        class ScriptPrepareTask : public WorkQueue::ParallelTask
+        {
+        public:
+            ScriptPrepareTask(vector<PreparedScript>::type& scripts) : mScripts(scripts) {}
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    PreparedScript& script = mScripts[i];
+                    if (script.stream.isNull())
+                        continue;
+                    try
+                    {
+                        script.prepared = script.loader->prepareScript(script.stream);
+                    }
+                    catch (...)
+                    {
+                        // Left empty, the script is parsed again on the calling
+                        // thread which reports the error
+                    }
+                    script.stream->seek(0);
+                }
+            }
+        protected:
+            vector<PreparedScript>::type& mScripts;
+        };
+    }
+
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::msSingleton = 0;
     ResourceGroupManager* ResourceGroupManager::getSingletonPtr(void)
@@ -56,7 +129,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mParallelGroupLoading(false),
+        mParallelScriptParsing(false)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME);
@@ -160,6 +234,13 @@ namespace Ogre {
     void ResourceGroupManager::prepareResourceGroup(const String& name, 
         bool prepareMainResources, bool prepareWorldGeom)
     {
+        if (prepareMainResources && mParallelGroupLoading && Root::getSingletonPtr() &&
+            Root::getSingleton().getWorkQueue())
+        {
+            processResourceGroupInParallel(name, false, prepareWorldGeom);
+            return;
+        }
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -205,39 +286,7 @@ namespace Ogre {
             for (oi = grp->loadResourceOrderMap.begin(); 
                 oi != grp->loadResourceOrderMap.end(); ++oi)
             {
-                size_t n = 0;
-                LoadUnloadResourceList::iterator l = oi->second.begin();
-                while (l != oi->second.end())
-                {
-                    ResourcePtr res = *l;
-
-                    // Fire resource events no matter whether resource needs preparing
-                    // or not. This ensures that the number of callbacks
-                    // matches the number originally estimated, which is important
-                    // for progress bars.
-                    fireResourcePrepareStarted(res);
-
-                    // If preparing one of these resources cascade-prepares another resource, 
-                    // the list will get longer! But these should be prepared immediately
-                    // Call prepare regardless, already prepared or loaded resources will be skipped
-                    res->prepare();
-
-                    fireResourcePrepareEnded();
-
-                    ++n;
-
-                    // Did the resource change group? if so, our iterator will have
-                    // been invalidated
-                    if (res->getGroup() != name)
-                    {
-                        l = oi->second.begin();
-                        std::advance(l, n);
-                    }
-                    else
-                    {
-                        ++l;
-                    }
-                }
+                processResourceList(oi->second, name, false);
             }
         }
         // Load World Geometry
@@ -257,6 +306,13 @@ namespace Ogre {
     void ResourceGroupManager::loadResourceGroup(const String& name, 
         bool loadMainResources, bool loadWorldGeom)
     {
+        if (loadMainResources && mParallelGroupLoading && Root::getSingletonPtr() &&
+            Root::getSingleton().getWorkQueue())
+        {
+            processResourceGroupInParallel(name, true, loadWorldGeom);
+            return;
+        }
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -302,39 +358,7 @@ namespace Ogre {
             for (oi = grp->loadResourceOrderMap.begin(); 
                 oi != grp->loadResourceOrderMap.end(); ++oi)
             {
-                size_t n = 0;
-                LoadUnloadResourceList::iterator l = oi->second.begin();
-                while (l != oi->second.end())
-                {
-                    ResourcePtr res = *l;
-
-                    // Fire resource events no matter whether resource is already
-                    // loaded or not. This ensures that the number of callbacks
-                    // matches the number originally estimated, which is important
-                    // for progress bars.
-                    fireResourceLoadStarted(res);
-
-                    // If loading one of these resources cascade-loads another resource, 
-                    // the list will get longer! But these should be loaded immediately
-                    // Call load regardless, already loaded resources will be skipped
-                    res->load();
-
-                    fireResourceLoadEnded();
-
-                    ++n;
-
-                    // Did the resource change group? if so, our iterator will have
-                    // been invalidated
-                    if (res->getGroup() != name)
-                    {
-                        l = oi->second.begin();
-                        std::advance(l, n);
-                    }
-                    else
-                    {
-                        ++l;
-                    }
-                }
+                processResourceList(oi->second, name, true);
             }
         }
         // Load World Geometry
@@ -354,6 +378,184 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished loading resource group " + name);
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::processResourceList(LoadUnloadResourceList& resources,
+        const String& groupName, bool load)
+    {
+        size_t n = 0;
+        LoadUnloadResourceList::iterator l = resources.begin();
+        while (l != resources.end())
+        {
+            ResourcePtr res = *l;
+
+            // Fire resource events no matter whether resource needs preparing / loading
+            // or not. This ensures that the number of callbacks
+            // matches the number originally estimated, which is important
+            // for progress bars.
+            if (load)
+                fireResourceLoadStarted(res);
+            else
+                fireResourcePrepareStarted(res);
+
+            // If loading one of these resources cascade-loads another resource, 
+            // the list will get longer! But these should be loaded immediately
+            // Call regardless, already prepared or loaded resources will be skipped
+            if (load)
+            {
+                res->load();
+                fireResourceLoadEnded();
+            }
+            else
+            {
+                res->prepare();
+                fireResourcePrepareEnded();
+            }
+
+            ++n;
+
+            // Did the resource change group? if so, our iterator will have
+            // been invalidated
+            if (res->getGroup() != groupName)
+            {
+                l = resources.begin();
+                std::advance(l, n);
+            }
+            else
+            {
+                ++l;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::processResourceGroupInParallel(const String& name,
+        bool load, bool worldGeom)
+    {
+        ResourceGroup* grp = 0;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+
+            LogManager::getSingleton().stream()
+                << (load ? "Loading" : "Preparing") << " resource group '" << name
+                << "' in parallel - World Geometry: " << worldGeom;
+            grp = getResourceGroup(name);
+            if (!grp)
+            {
+                OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
+                    "Cannot find a group named " + name, 
+                    "ResourceGroupManager::processResourceGroupInParallel");
+            }
+
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
+            // Set current group, kept while the workers run so that resources
+            // they create are added to it as usual
+            mCurrentGroup = grp;
+
+            // Count up resources for starting event
+            size_t resourceCount = 0;
+            for (ResourceGroup::LoadResourceOrderMap::iterator oi = grp->loadResourceOrderMap.begin();
+                oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                resourceCount += oi->second.size();
+            }
+            // Estimate world geometry size
+            if (grp->worldGeometrySceneManager && worldGeom)
+            {
+                resourceCount += 
+                    grp->worldGeometrySceneManager->estimateWorldGeometry(
+                        grp->worldGeometry);
+            }
+
+            if (load)
+                fireResourceGroupLoadStarted(name, resourceCount);
+            else
+                fireResourceGroupPrepareStarted(name, resourceCount);
+        }
+
+        // One loading order at a time, as resources may depend on those of
+        // lower loading orders but not on the ones sharing theirs
+        WorkQueue* workQueue = Root::getSingleton().getWorkQueue();
+        try
+        {
+            Real order = 0;
+            bool first = true;
+            for (;;)
+            {
+                vector<ResourcePtr>::type resources;
+                {
+                    OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+                    ResourceGroup::LoadResourceOrderMap::iterator oi = first ?
+                        grp->loadResourceOrderMap.begin() : grp->loadResourceOrderMap.upper_bound(order);
+                    if (oi == grp->loadResourceOrderMap.end())
+                        break;
+                    order = oi->first;
+                    first = false;
+                    resources.assign(oi->second.begin(), oi->second.end());
+                }
+
+                // No lock is held here, the resources open their files through this class
+                vector<uchar>::type prepared(resources.size(), 0);
+                ResourcePrepareTask task(resources, prepared);
+                workQueue->parallelFor(&task, resources.size());
+
+                // Loading may need the render system, it is done on this thread
+                OGRE_LOCK_AUTO_MUTEX;
+                OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
+                if (!load)
+                {
+                    // The workers prepared them in the background
+                    for (size_t i = 0; i < resources.size(); ++i)
+                    {
+                        if (prepared[i])
+                            resources[i]->_firePreparingComplete(false);
+                    }
+                }
+                ResourceGroup::LoadResourceOrderMap::iterator oi = grp->loadResourceOrderMap.find(order);
+                if (oi != grp->loadResourceOrderMap.end())
+                    processResourceList(oi->second, name, load);
+            }
+        }
+        catch (...)
+        {
+            // Don't leave the group set, the locks have been released
+            OGRE_LOCK_AUTO_MUTEX;
+            mCurrentGroup = 0;
+            throw;
+        }
+
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME); // lock group mutex 
+            if (load)
+            {
+                // Load World Geometry
+                if (grp->worldGeometrySceneManager && worldGeom)
+                {
+                    grp->worldGeometrySceneManager->setWorldGeometry(
+                        grp->worldGeometry);
+                }
+                fireResourceGroupLoadEnded(name);
+
+                // group is loaded
+                grp->groupStatus = ResourceGroup::LOADED;
+            }
+            else
+            {
+                // Prepare World Geometry
+                if (grp->worldGeometrySceneManager && worldGeom)
+                {
+                    grp->worldGeometrySceneManager->prepareWorldGeometry(
+                        grp->worldGeometry);
+                }
+                fireResourceGroupPrepareEnded(name);
+            }
+
+            // reset current group
+            mCurrentGroup = 0;
+        }
+
+        LogManager::getSingleton().logMessage(String("Finished ") +
+            (load ? "loading" : "preparing") + " resource group " + name);
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::unloadResourceGroup(const String& name, bool reloadableOnly)
     {
         // Can only bulk-unload one group at a time (reasonable limitation I think)
@@ -1053,6 +1255,44 @@ namespace Ogre {
         // Fire scripting event
         fireResourceGroupScriptingStarted(grp->name, scriptCount);
 
+        // When parsing in parallel, read all the scripts into memory and prepare them
+        // on the WorkQueue. Some archives can't be read from several threads.
+        WorkQueue* workQueue = mParallelScriptParsing && Root::getSingletonPtr() ?
+            Root::getSingleton().getWorkQueue() : 0;
+        vector<PreparedScript>::type preparedScripts;
+        if (workQueue)
+        {
+            preparedScripts.reserve(scriptCount);
+            for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
+                slfli != scriptLoaderFileList.end(); ++slfli)
+            {
+                for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
+                {
+                    for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                    {
+                        PreparedScript script;
+                        script.loader = slfli->first;
+                        script.stream = fii->archive->open(fii->filename);
+                        if (!script.stream.isNull())
+                        {
+                            if (mLoadingListener)
+                                mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, script.stream);
+                            if (!dynamic_cast<MemoryDataStream*>(script.stream.get()))
+                            {
+                                DataStreamPtr copy(OGRE_NEW MemoryDataStream(script.stream->getName(), script.stream));
+                                script.stream = copy;
+                            }
+                        }
+                        preparedScripts.push_back(script);
+                    }
+                }
+            }
+
+            ScriptPrepareTask task(preparedScripts);
+            workQueue->parallelFor(&task, preparedScripts.size());
+        }
+        size_t scriptIndex = 0;
+
         // Iterate over scripts and parse
         // Note we respect original ordering
         for (ScriptLoaderFileList::iterator slfli = scriptLoaderFileList.begin();
@@ -1063,7 +1303,7 @@ namespace Ogre {
             for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
             {
                 // Iterate over each item in the list
-                for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii, ++scriptIndex)
                 {
                     bool skipScript = false;
                     fireScriptStarted(fii->filename, skipScript);
@@ -1072,6 +1312,14 @@ namespace Ogre {
                         LogManager::getSingleton().logMessage(
                             "Skipping script " + fii->filename);
                     }
+                    else if (workQueue)
+                    {
+                        LogManager::getSingleton().logMessage(
+                            "Parsing script " + fii->filename);
+                        PreparedScript& script = preparedScripts[scriptIndex];
+                        if (!script.stream.isNull())
+                            su->parsePreparedScript(script.stream, grp->name, script.prepared);
+                    }
                     else
                     {
                         LogManager::getSingleton().logMessage(
@@ -1082,7 +1330,8 @@ namespace Ogre {
                             if (mLoadingListener)
                                 mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
 
-                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024 &&
+                                !dynamic_cast<MemoryDataStream*>(stream.get()))
                             {
                                 DataStreamPtr cachedCopy;
                                 cachedCopy.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
@@ -401,6 +401,7 @@ namespace Ogre
                 // Extend existing head
                 headElem.position = newPos;
                 done = true;
+                markElementDirty(seg, seg.head);
             }
 
             // Is this segment full?
@@ -423,6 +424,7 @@ namespace Ogre
                     Real tailsize = mElemLength - diff.length();
                     taildiff *= tailsize / taillen;
                     tailElem.position = preTailElem.position + taildiff;
+                    markElementDirty(seg, seg.tail);
                 }
 
             }
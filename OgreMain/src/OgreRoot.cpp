@@ -184,6 +184,9 @@ namespace Ogre {
         defaultQ->setWorkersCanAccessRenderSystem(false);
 #endif
         mWorkQueue = defaultQ;
+#if OGRE_THREAD_SUPPORT
+        mMainThread = OGRE_THREAD_CURRENT_ID;
+#endif
 
         // ResourceBackgroundQueue
         mResourceBackgroundQueue = OGRE_NEW ResourceBackgroundQueue();
@@ -1650,6 +1653,15 @@ namespace Ogre {
 
         }
     }
+    //---------------------------------------------------------------------
+    bool Root::_isMainThread(void) const
+    {
+#if OGRE_THREAD_SUPPORT
+        return OGRE_THREAD_CURRENT_ID == mMainThread;
+#else
+        return true;
+#endif
+    }
 
 
 
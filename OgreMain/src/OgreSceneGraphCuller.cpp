@@ -0,0 +1,189 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneGraphCuller.h"
+#include "OgreSceneNode.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    void SceneGraphCuller::CullTask::execute(size_t begin, size_t end)
+    {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+            mCuller->cullChunk(chunk, mCamera);
+    }
+    //-----------------------------------------------------------------------
+    SceneGraphCuller::SceneGraphCuller()
+        : mBatchSize(512)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SceneGraphCuller::~SceneGraphCuller()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphCuller::findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes, 
+        bool onlyShadowCasters, WorkQueue* workQueue)
+    {
+        mNodes.clear();
+        mSubtreeEnds.clear();
+        addNodes(root);
+
+        size_t numChunks = (mNodes.size() + mBatchSize - 1) / mBatchSize;
+        if (mLocalQueues.size() < numChunks)
+            mLocalQueues.resize(numChunks);
+
+        // Bring the frustum planes up to date here, the camera is only read
+        // from the worker threads
+        Frustum* cullFrustum = cam->getCullingFrustum();
+        (cullFrustum ? cullFrustum : cam)->getFrustumPlanes();
+
+        CullTask task;
+        task.mCuller = this;
+        task.mCamera = cam;
+        if (workQueue)
+            workQueue->parallelFor(&task, numChunks);
+        else
+            task.execute(0, numChunks);
+
+        // Merge in chunk order, leaving out the subtrees culled by earlier chunks
+        SceneManager* creator = root->getCreator();
+        bool showBoundingBoxes = creator && creator->getShowBoundingBoxes();
+        size_t culledEnd = 0;
+        for (size_t c = 0; c < numChunks; ++c)
+        {
+            LocalQueue& local = mLocalQueues[c];
+            size_t objectBegin = 0;
+            for (size_t n = 0; n < local.nodes.size(); ++n)
+            {
+                size_t objectEnd = local.objectEnds[n];
+                if (local.nodeIndices[n] < culledEnd)
+                {
+                    objectBegin = objectEnd;
+                    continue;
+                }
+
+                for (size_t o = objectBegin; o < objectEnd; ++o)
+                {
+                    queue->processVisibleObject(local.objects[o], cam, onlyShadowCasters, visibleBounds);
+                }
+                objectBegin = objectEnd;
+
+                SceneNode* node = local.nodes[n];
+                if (displayNodes)
+                    queue->addRenderable(node->getDebugRenderable());
+
+                if (!node->mHideBoundingBox && (node->mShowBoundingBox || showBoundingBoxes))
+                    node->_addBoundingBoxToQueue(queue);
+            }
+            culledEnd = std::max(culledEnd, local.culledEnd);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphCuller::addNodes(SceneNode* node)
+    {
+        size_t index = mNodes.size();
+        mNodes.push_back(node);
+        mSubtreeEnds.push_back(0);
+
+        Node::ChildNodeIterator it = node->getChildIterator();
+        while (it.hasMoreElements())
+        {
+            addNodes(static_cast<SceneNode*>(it.getNext()));
+        }
+        mSubtreeEnds[index] = mNodes.size();
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphCuller::cullChunk(size_t chunk, const Camera* cam)
+    {
+        LocalQueue& local = mLocalQueues[chunk];
+        local.nodes.clear();
+        local.nodeIndices.clear();
+        local.objectEnds.clear();
+        local.objects.clear();
+        local.culledEnd = 0;
+
+        size_t begin = chunk * mBatchSize;
+        size_t end = std::min(begin + mBatchSize, mNodes.size());
+        size_t count = end - begin;
+
+        // Test the whole chunk at once, null and infinite boxes are 
+        // resolved below
+        local.centres.resize(count);
+        local.halfSizes.resize(count);
+        local.visibilityMask.resize((count + 31) / 32);
+        for (size_t n = 0; n < count; ++n)
+        {
+            const AxisAlignedBox& box = mNodes[begin + n]->_getWorldAABB();
+            if (box.isFinite())
+            {
+                local.centres[n] = box.getCenter();
+                local.halfSizes[n] = box.getHalfSize();
+            }
+            else
+            {
+                local.centres[n] = Vector3::ZERO;
+                local.halfSizes[n] = Vector3::ZERO;
+            }
+        }
+        if (count)
+            cam->isVisible(&local.centres[0], &local.halfSizes[0], count, &local.visibilityMask[0]);
+
+        size_t n = 0;
+        while (n < count)
+        {
+            SceneNode* node = mNodes[begin + n];
+            const AxisAlignedBox& box = node->_getWorldAABB();
+            bool visible = box.isInfinite() || 
+                (!box.isNull() && (local.visibilityMask[n / 32] & (1u << (n % 32))));
+            if (!visible)
+            {
+                // Skip the descendants as the recursive walk does, the merge
+                // skips those past the end of this chunk
+                size_t subtreeEnd = mSubtreeEnds[begin + n];
+                if (subtreeEnd > end)
+                    local.culledEnd = subtreeEnd;
+                n = subtreeEnd - begin;
+                continue;
+            }
+
+            local.nodes.push_back(node);
+            local.nodeIndices.push_back(begin + n);
+            SceneNode::ObjectIterator it = node->getAttachedObjectIterator();
+            while (it.hasMoreElements())
+            {
+                local.objects.push_back(it.getNext());
+            }
+            local.objectEnds.push_back(local.objects.size());
+            ++n;
+        }
+    }
+}
@@ -0,0 +1,287 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneGraphUpdater.h"
+#include "OgreSceneNode.h"
+#include "OgreMovableObject.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::TransformArrays::resize(size_t n)
+    {
+        posX.resize(n); posY.resize(n); posZ.resize(n);
+        rotW.resize(n); rotX.resize(n); rotY.resize(n); rotZ.resize(n);
+        sclX.resize(n); sclY.resize(n); sclZ.resize(n);
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::LevelTask::execute(size_t begin, size_t end)
+    {
+        gatherTransforms(*mLevel, begin, end);
+        combineTransforms(*mLevel, begin, end);
+        scatterTransforms(*mLevel, begin, end);
+    }
+    //-----------------------------------------------------------------------
+    SceneGraphUpdater::SceneGraphUpdater()
+        : mNumLevels(0)
+        , mBatchSize(256)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SceneGraphUpdater::~SceneGraphUpdater()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::update(SceneNode* root, WorkQueue* queue)
+    {
+        gatherLevels(root);
+
+        // Derived transforms, top down. Each level only reads the one above,
+        // which is complete by the time it is processed.
+        LevelTask task;
+        for (size_t l = 0; l < mNumLevels; ++l)
+        {
+            DepthLevel& level = mLevels[l];
+            size_t count = level.dirty.size();
+            if (!count)
+                continue;
+
+            level.local.resize(count);
+            level.parent.resize(count);
+            level.derived.resize(count);
+            level.inheritOrientation.resize(count);
+            level.inheritScale.resize(count);
+
+            task.mLevel = &level;
+            if (queue && count > mBatchSize)
+                queue->parallelFor(&task, count, mBatchSize);
+            else
+                task.execute(0, count);
+        }
+
+        // Object notifications and world bounds, bottom up since each node
+        // merges the bounds of its children
+        for (size_t l = mNumLevels; l-- > 0; )
+        {
+            DepthLevel& level = mLevels[l];
+            for (NodeList::iterator i = level.dirty.begin(); i != level.dirty.end(); ++i)
+            {
+                SceneNode::ObjectMap& objects = (*i)->mObjectsByName;
+                for (SceneNode::ObjectMap::iterator o = objects.begin(); o != objects.end(); ++o)
+                {
+                    o->second->_notifyMoved();
+                }
+            }
+            for (NodeList::iterator i = level.visited.begin(); i != level.visited.end(); ++i)
+            {
+                (*i)->_updateBounds();
+            }
+        }
+
+        // Deferred listener callbacks, now that the whole graph is consistent
+        for (size_t l = 0; l < mNumLevels; ++l)
+        {
+            DepthLevel& level = mLevels[l];
+            for (NodeList::iterator i = level.dirty.begin(); i != level.dirty.end(); ++i)
+            {
+                if ((*i)->mListener)
+                    (*i)->mListener->nodeUpdated(*i);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::gatherLevels(SceneNode* root)
+    {
+        if (mLevels.empty())
+            mLevels.resize(1);
+
+        mLevels[0].visited.clear();
+        mLevels[0].parentChanged.clear();
+        mLevels[0].visited.push_back(root);
+        mLevels[0].parentChanged.push_back(false);
+        mNumLevels = 0;
+
+        // Breadth first, applying the same rules as Node::_update
+        while (mNumLevels < mLevels.size() && !mLevels[mNumLevels].visited.empty())
+        {
+            size_t l = mNumLevels++;
+            if (mLevels.size() == mNumLevels)
+                mLevels.resize(mNumLevels + 1);
+
+            DepthLevel& next = mLevels[mNumLevels];
+            next.visited.clear();
+            next.parentChanged.clear();
+
+            DepthLevel& level = mLevels[l];
+            level.dirty.clear();
+
+            for (size_t n = 0; n < level.visited.size(); ++n)
+            {
+                SceneNode* node = level.visited[n];
+                bool parentHasChanged = level.parentChanged[n] != 0;
+
+                node->mParentNotified = false;
+                if (node->mNeedParentUpdate || parentHasChanged)
+                    level.dirty.push_back(node);
+
+                if (node->mNeedChildUpdate || parentHasChanged)
+                {
+                    Node::ChildNodeMap::iterator it, itend = node->mChildren.end();
+                    for (it = node->mChildren.begin(); it != itend; ++it)
+                    {
+                        next.visited.push_back(static_cast<SceneNode*>(it->second));
+                        next.parentChanged.push_back(true);
+                    }
+                }
+                else
+                {
+                    Node::ChildUpdateSet::iterator it, itend = node->mChildrenToUpdate.end();
+                    for (it = node->mChildrenToUpdate.begin(); it != itend; ++it)
+                    {
+                        next.visited.push_back(static_cast<SceneNode*>(*it));
+                        next.parentChanged.push_back(false);
+                    }
+                }
+
+                node->mChildrenToUpdate.clear();
+                node->mNeedChildUpdate = false;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::gatherTransforms(DepthLevel& level, size_t begin, size_t end)
+    {
+        TransformArrays& local = level.local;
+        TransformArrays& parent = level.parent;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const SceneNode* node = level.dirty[i];
+
+            local.posX[i] = node->mPosition.x;
+            local.posY[i] = node->mPosition.y;
+            local.posZ[i] = node->mPosition.z;
+            local.rotW[i] = node->mOrientation.w;
+            local.rotX[i] = node->mOrientation.x;
+            local.rotY[i] = node->mOrientation.y;
+            local.rotZ[i] = node->mOrientation.z;
+            local.sclX[i] = node->mScale.x;
+            local.sclY[i] = node->mScale.y;
+            local.sclZ[i] = node->mScale.z;
+
+            const Node* p = node->mParent;
+            if (p)
+            {
+                // Parent is on the level above, so it's already up to date
+                parent.posX[i] = p->mDerivedPosition.x;
+                parent.posY[i] = p->mDerivedPosition.y;
+                parent.posZ[i] = p->mDerivedPosition.z;
+                parent.rotW[i] = p->mDerivedOrientation.w;
+                parent.rotX[i] = p->mDerivedOrientation.x;
+                parent.rotY[i] = p->mDerivedOrientation.y;
+                parent.rotZ[i] = p->mDerivedOrientation.z;
+                parent.sclX[i] = p->mDerivedScale.x;
+                parent.sclY[i] = p->mDerivedScale.y;
+                parent.sclZ[i] = p->mDerivedScale.z;
+                level.inheritOrientation[i] = node->mInheritOrientation;
+                level.inheritScale[i] = node->mInheritScale;
+            }
+            else
+            {
+                // Root node, an identity parent leaves the local transform as is
+                parent.posX[i] = parent.posY[i] = parent.posZ[i] = 0;
+                parent.rotW[i] = 1;
+                parent.rotX[i] = parent.rotY[i] = parent.rotZ[i] = 0;
+                parent.sclX[i] = parent.sclY[i] = parent.sclZ[i] = 1;
+                level.inheritOrientation[i] = false;
+                level.inheritScale[i] = false;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::combineTransforms(DepthLevel& level, size_t begin, size_t end)
+    {
+        // Same arithmetic as Node::updateFromParentImpl, in the same order, so 
+        // that results are identical. Written branch-free over plain arrays so
+        // that the compiler can vectorise it.
+        const TransformArrays& l = level.local;
+        const TransformArrays& p = level.parent;
+        TransformArrays& d = level.derived;
+        const uint8* inheritOrientation = &level.inheritOrientation[0];
+        const uint8* inheritScale = &level.inheritScale[0];
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            // Orientation, parentOrientation * mOrientation
+            Real qw = p.rotW[i] * l.rotW[i] - p.rotX[i] * l.rotX[i] - p.rotY[i] * l.rotY[i] - p.rotZ[i] * l.rotZ[i];
+            Real qx = p.rotW[i] * l.rotX[i] + p.rotX[i] * l.rotW[i] + p.rotY[i] * l.rotZ[i] - p.rotZ[i] * l.rotY[i];
+            Real qy = p.rotW[i] * l.rotY[i] + p.rotY[i] * l.rotW[i] + p.rotZ[i] * l.rotX[i] - p.rotX[i] * l.rotZ[i];
+            Real qz = p.rotW[i] * l.rotZ[i] + p.rotZ[i] * l.rotW[i] + p.rotX[i] * l.rotY[i] - p.rotY[i] * l.rotX[i];
+            d.rotW[i] = inheritOrientation[i] ? qw : l.rotW[i];
+            d.rotX[i] = inheritOrientation[i] ? qx : l.rotX[i];
+            d.rotY[i] = inheritOrientation[i] ? qy : l.rotY[i];
+            d.rotZ[i] = inheritOrientation[i] ? qz : l.rotZ[i];
+
+            // Scale, parentScale * mScale
+            d.sclX[i] = inheritScale[i] ? p.sclX[i] * l.sclX[i] : l.sclX[i];
+            d.sclY[i] = inheritScale[i] ? p.sclY[i] * l.sclY[i] : l.sclY[i];
+            d.sclZ[i] = inheritScale[i] ? p.sclZ[i] * l.sclZ[i] : l.sclZ[i];
+
+            // Position, parentOrientation * (parentScale * mPosition) + parentPosition
+            Real vx = p.sclX[i] * l.posX[i];
+            Real vy = p.sclY[i] * l.posY[i];
+            Real vz = p.sclZ[i] * l.posZ[i];
+            Real uvx = p.rotY[i] * vz - p.rotZ[i] * vy;
+            Real uvy = p.rotZ[i] * vx - p.rotX[i] * vz;
+            Real uvz = p.rotX[i] * vy - p.rotY[i] * vx;
+            Real uuvx = p.rotY[i] * uvz - p.rotZ[i] * uvy;
+            Real uuvy = p.rotZ[i] * uvx - p.rotX[i] * uvz;
+            Real uuvz = p.rotX[i] * uvy - p.rotY[i] * uvx;
+            Real w2 = 2.0f * p.rotW[i];
+            uvx *= w2; uvy *= w2; uvz *= w2;
+            uuvx *= 2.0f; uuvy *= 2.0f; uuvz *= 2.0f;
+            d.posX[i] = vx + uvx + uuvx + p.posX[i];
+            d.posY[i] = vy + uvy + uuvy + p.posY[i];
+            d.posZ[i] = vz + uvz + uuvz + p.posZ[i];
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphUpdater::scatterTransforms(DepthLevel& level, size_t begin, size_t end)
+    {
+        const TransformArrays& d = level.derived;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            SceneNode* node = level.dirty[i];
+            node->mDerivedPosition = Vector3(d.posX[i], d.posY[i], d.posZ[i]);
+            node->mDerivedOrientation = Quaternion(d.rotW[i], d.rotX[i], d.rotY[i], d.rotZ[i]);
+            node->mDerivedScale = Vector3(d.sclX[i], d.sclY[i], d.sclZ[i]);
+            node->mCachedTransformOutOfDate = true;
+            node->mNeedParentUpdate = false;
+        }
+    }
+}
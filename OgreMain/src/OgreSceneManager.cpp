@@ -60,6 +60,10 @@ THE SOFTWARE.
 #include "OgreRenderTexture.h"
 #include "OgreTextureManager.h"
 #include "OgreSceneNode.h"
+#include "OgreSceneGraphUpdater.h"
+#include "OgreSceneGraphCuller.h"
+#include "OgreEntityAnimationUpdater.h"
+#include "OgreAnimationPoseCache.h"
 #include "OgreRectangle2D.h"
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
@@ -145,6 +149,10 @@ mShadowTextureCustomCasterPass(0),
 mShadowTextureCustomReceiverPass(0),
 mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
+mSceneGraphUpdater(0),
+mSceneGraphCuller(0),
+mEntityAnimationUpdater(0),
+mAnimationPoseCache(0),
 mSuppressRenderStateChanges(false),
 mSuppressShadows(false),
 mCameraRelativeRendering(false),
@@ -212,6 +220,10 @@ SceneManager::~SceneManager()
     OGRE_DELETE mShadowCasterAABBQuery;
     OGRE_DELETE mRenderQueue;
     OGRE_DELETE mAutoParamDataSource;
+    OGRE_DELETE mSceneGraphUpdater;
+    OGRE_DELETE mSceneGraphCuller;
+    OGRE_DELETE mEntityAnimationUpdater;
+    OGRE_DELETE mAnimationPoseCache;
 }
 //-----------------------------------------------------------------------
 RenderQueue* SceneManager::getRenderQueue(void)
@@ -343,7 +355,8 @@ void SceneManager::destroyCamera(const String& name)
             mShadowCamLightMapping.erase( camLightIt );
 
         // Notify render system
-        mDestRenderSystem->_notifyCameraRemoved(i->second);
+        if (mDestRenderSystem)
+            mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
         mCameras.erase(i);
     }
@@ -1403,6 +1416,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Update controllers 
     ControllerManager::getSingleton().updateAllControllers();
+    // Run the particle system updates queued by the controllers
+    ParticleSystemManager::getSingleton()._updateQueuedSystems();
 
     // Update the scene, only do this once per frame
     unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
@@ -1528,6 +1543,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             firePreFindVisibleObjects(vp);
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            _updateEntityAnimations();
             firePostFindVisibleObjects(vp);
 
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
@@ -2290,14 +2306,89 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+#if !OGRE_NODE_INHERIT_TRANSFORM
+    if (mSceneGraphUpdater)
+        mSceneGraphUpdater->update(getRootSceneNode(), Root::getSingleton().getWorkQueue());
+    else
+#endif
+        getRootSceneNode()->_update(true, false);
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::setParallelSceneGraphUpdate(bool enabled)
+{
+    if (enabled && !mSceneGraphUpdater)
+    {
+        mSceneGraphUpdater = OGRE_NEW SceneGraphUpdater();
+    }
+    else if (!enabled && mSceneGraphUpdater)
+    {
+        OGRE_DELETE mSceneGraphUpdater;
+        mSceneGraphUpdater = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelCulling(bool enabled)
+{
+    if (enabled && !mSceneGraphCuller)
+    {
+        mSceneGraphCuller = OGRE_NEW SceneGraphCuller();
+    }
+    else if (!enabled && mSceneGraphCuller)
+    {
+        OGRE_DELETE mSceneGraphCuller;
+        mSceneGraphCuller = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelAnimation(bool enabled)
+{
+    if (enabled && !mEntityAnimationUpdater)
+    {
+        mEntityAnimationUpdater = OGRE_NEW EntityAnimationUpdater();
+    }
+    else if (!enabled && mEntityAnimationUpdater)
+    {
+        // Don't drop the entities queued already
+        _updateEntityAnimations();
+        OGRE_DELETE mEntityAnimationUpdater;
+        mEntityAnimationUpdater = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::setAnimationPoseCaching(bool enabled)
+{
+    if (enabled && !mAnimationPoseCache)
+    {
+        mAnimationPoseCache = OGRE_NEW AnimationPoseCache();
+    }
+    else if (!enabled && mAnimationPoseCache)
+    {
+        OGRE_DELETE mAnimationPoseCache;
+        mAnimationPoseCache = 0;
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_updateEntityAnimations(void)
+{
+    if (mEntityAnimationUpdater)
+    {
+        OgreProfileGroup("_updateEntityAnimations", OGREPROF_GENERAL);
+        mEntityAnimationUpdater->update(Root::getSingleton().getWorkQueue());
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mSceneGraphCuller)
+    {
+        mSceneGraphCuller->findVisibleObjects(getRootSceneNode(), cam, getRenderQueue(),
+            visibleBounds, mDisplayNodes, onlyShadowCasters, Root::getSingleton().getWorkQueue());
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreSceneQuery.h"
 #include "OgreException.h"
 #include "OgreSceneManager.h"
+#include "OgreEntity.h"
 
 namespace Ogre {
 
@@ -196,6 +197,7 @@ namespace Ogre {
     {
         mSortByDistance = false;
         mMaxResults = 0;
+        mTriangleIntersection = false;
     }
     //-----------------------------------------------------------------------
     RaySceneQuery::~RaySceneQuery()
@@ -228,6 +230,16 @@ namespace Ogre {
         return mMaxResults;
     }
     //-----------------------------------------------------------------------
+    void RaySceneQuery::setTriangleIntersection(bool enabled)
+    {
+        mTriangleIntersection = enabled;
+    }
+    //-----------------------------------------------------------------------
+    bool RaySceneQuery::getTriangleIntersection(void) const
+    {
+        return mTriangleIntersection;
+    }
+    //-----------------------------------------------------------------------
     RaySceneQueryResult& RaySceneQuery::execute(void)
     {
         // Clear without freeing the vector buffer
@@ -272,6 +284,15 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = obj;
         dets.worldFragment = NULL;
+        dets.hasTriangle = false;
+        if (mTriangleIntersection && obj->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+        {
+            // Refine the bounding volume hit, or drop the entity if it was missed
+            if (!static_cast<Entity*>(obj)->intersectTriangles(mRay, dets.triangle))
+                return true;
+            dets.distance = dets.triangle.distance;
+            dets.hasTriangle = true;
+        }
         mResult.push_back(dets);
         // Continue
         return true;
@@ -284,6 +305,7 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = NULL;
         dets.worldFragment = fragment;
+        dets.hasTriangle = false;
         mResult.push_back(dets);
         // Continue
         return true;
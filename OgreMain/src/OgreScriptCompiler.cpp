@@ -32,9 +32,100 @@ THE SOFTWARE.
 #include "OgreScriptTranslator.h"
 #include "OgreLogManager.h"
 #include "OgreResourceGroupManager.h"
+#include "Hash/MurmurHash3.h"
 
 namespace Ogre
 {
+    namespace {
+        /// Identifies a script cache, and the version of the format of the nodes it holds
+        const uint32 SCRIPT_CACHE_ID = 0x43534F47; // "GOSC"
+        const uint32 SCRIPT_CACHE_VERSION = 1;
+
+        template<typename T> void appendValue(String& blob, T value)
+        {
+            blob.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        /// Writes concrete nodes, except for their file which is the script they come from
+        void writeConcreteNodes(String& blob, const ConcreteNodeList& nodes)
+        {
+            appendValue(blob, static_cast<uint32>(nodes.size()));
+            for(ConcreteNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+            {
+                const ConcreteNode* node = (*i).get();
+                appendValue(blob, static_cast<uint8>(node->type));
+                appendValue(blob, static_cast<uint32>(node->line));
+                appendValue(blob, static_cast<uint32>(node->token.size()));
+                blob.append(node->token);
+                writeConcreteNodes(blob, node->children);
+            }
+        }
+
+        /// Reads nodes written by writeConcreteNodes, returning false if the blob is truncated
+        class ConcreteNodeReader
+        {
+        public:
+            ConcreteNodeReader(const String& blob, const String& file)
+                : mPos(blob.data()), mEnd(blob.data() + blob.size()), mFile(file) {}
+
+            bool read(ConcreteNodeList& nodes, ConcreteNode* parent)
+            {
+                uint32 count;
+                if(!readValue(count))
+                    return false;
+                for(uint32 i = 0; i < count; ++i)
+                {
+                    ConcreteNodePtr node(OGRE_NEW ConcreteNode());
+                    uint8 type;
+                    uint32 line, length;
+                    if(!readValue(type) || !readValue(line) || !readValue(length) ||
+                        length > static_cast<size_t>(mEnd - mPos))
+                        return false;
+                    node->type = static_cast<ConcreteNodeType>(type);
+                    node->line = line;
+                    node->token.assign(mPos, length);
+                    mPos += length;
+                    node->file = mFile;
+                    node->parent = parent;
+                    if(!read(node->children, node.get()))
+                        return false;
+                    nodes.push_back(node);
+                }
+                return true;
+            }
+        private:
+            template<typename T> bool readValue(T& value)
+            {
+                if(sizeof(T) > static_cast<size_t>(mEnd - mPos))
+                    return false;
+                memcpy(&value, mPos, sizeof(T));
+                mPos += sizeof(T);
+                return true;
+            }
+
+            const char* mPos;
+            const char* mEnd;
+            const String& mFile;
+        };
+
+        void writeString(const DataStreamPtr& stream, const String& str)
+        {
+            uint32 length = static_cast<uint32>(str.size());
+            stream->write(&length, sizeof(uint32));
+            stream->write(str.data(), length);
+        }
+
+        bool readString(const DataStreamPtr& stream, String& str)
+        {
+            uint32 length = 0;
+            if(stream->read(&length, sizeof(uint32)) != sizeof(uint32) ||
+                length > stream->size() - stream->tell())
+                return false;
+            str.resize(length);
+            return length == 0 || stream->read(&str[0], length) == length;
+        }
+    }
+
     // AbstractNode
     AbstractNode::AbstractNode(AbstractNode *ptr)
         :line(0), type(ANT_UNKNOWN), parent(ptr)
@@ -593,12 +684,7 @@ namespace Ogre
         {
             DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(name, mGroup);
             if(!stream.isNull())
-            {
-                ScriptLexer lexer;
-                ScriptTokenListPtr tokens = lexer.tokenize(stream->getAsString(), name);
-                ScriptParser parser;
-                nodes = parser.parse(tokens);
-            }
+                nodes = ScriptCompilerManager::getSingleton()._parseConcreteNodes(stream, name);
         }
 
         if(!nodes.isNull())
@@ -1586,7 +1672,8 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
-        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler),
+        mScriptCacheEnabled(false), mScriptCacheDirty(false)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1682,7 +1769,7 @@ namespace Ogre
         return 90.0f;
     }
     //-----------------------------------------------------------------------
-    void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
+    ScriptCompiler* ScriptCompilerManager::getThreadCompiler()
     {
 #if OGRE_THREAD_SUPPORT
         // check we have an instance for this thread (should always have one for main thread)
@@ -1698,7 +1785,149 @@ namespace Ogre
                     OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+        return OGRE_THREAD_POINTER_GET(mScriptCompiler);
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
+    {
+        ConcreteNodeListPtr nodes = _parseConcreteNodes(stream, stream->getName());
+        getThreadCompiler()->compile(nodes, groupName);
+    }
+    //-----------------------------------------------------------------------
+    Any ScriptCompilerManager::prepareScript(DataStreamPtr& stream)
+    {
+        return Any(_parseConcreteNodes(stream, stream->getName()));
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::parsePreparedScript(DataStreamPtr& stream, const String& groupName,
+        const Any& prepared)
+    {
+        if(prepared.isEmpty())
+            parseScript(stream, groupName);
+        else
+            getThreadCompiler()->compile(any_cast<ConcreteNodeListPtr>(prepared), groupName);
+    }
+    //-----------------------------------------------------------------------
+    ConcreteNodeListPtr ScriptCompilerManager::_parseConcreteNodes(const DataStreamPtr& stream,
+        const String& source)
+    {
+        ScriptLexer lexer;
+        ScriptParser parser;
+        if(!mScriptCacheEnabled)
+            return parser.parse(lexer.tokenize(stream, source));
+
+        // The contents are needed in memory for the hash
+        MemoryDataStreamPtr memStream = stream.dynamicCast<MemoryDataStream>();
+        if(memStream.isNull())
+            memStream.bind(OGRE_NEW MemoryDataStream(*stream));
+        const char* contents = reinterpret_cast<const char*>(memStream->getPtr());
+        size_t size = memStream->size();
+
+        uint32 hash[4];
+        MurmurHash3_x86_128(contents, static_cast<int>(size), SCRIPT_CACHE_VERSION, hash);
+        String key(reinterpret_cast<const char*>(hash), sizeof(hash));
+        appendValue(key, static_cast<uint32>(size));
+
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            ScriptCacheMap::iterator i = mScriptCache.find(key);
+            if(i != mScriptCache.end())
+            {
+                ConcreteNodeListPtr nodes(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+                ConcreteNodeReader reader(i->second.blob, source);
+                if(reader.read(*nodes, 0))
+                {
+                    i->second.used = true;
+                    return nodes;
+                }
+                // Damaged, parse it again below
+                mScriptCache.erase(key);
+            }
+        }
+
+        ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(contents, size, source));
+        String blob;
+        writeConcreteNodes(blob, *nodes);
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            ScriptCacheEntry& entry = mScriptCache[key];
+            entry.blob.swap(blob);
+            entry.used = true;
+            mScriptCacheDirty = true;
+        }
+        return nodes;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::setScriptCacheEnabled(bool enabled)
+    {
+        mScriptCacheEnabled = enabled;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::clearScriptCache(void)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache.clear();
+        mScriptCacheDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveScriptCache(DataStreamPtr stream) const
+    {
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "ScriptCompilerManager::saveScriptCache");
+        }
+
+        OGRE_LOCK_AUTO_MUTEX;
+        stream->write(&SCRIPT_CACHE_ID, sizeof(uint32));
+        stream->write(&SCRIPT_CACHE_VERSION, sizeof(uint32));
+        // Scripts which were not used since the cache was loaded are left out
+        uint32 count = 0;
+        ScriptCacheMap::const_iterator i;
+        for(i = mScriptCache.begin(); i != mScriptCache.end(); ++i)
+        {
+            if(i->second.used)
+                ++count;
+        }
+        stream->write(&count, sizeof(uint32));
+        for(i = mScriptCache.begin(); i != mScriptCache.end(); ++i)
+        {
+            if(!i->second.used)
+                continue;
+            writeString(stream, i->first);
+            writeString(stream, i->second.blob);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadScriptCache(DataStreamPtr stream)
+    {
+        OGRE_LOCK_AUTO_MUTEX;
+        mScriptCache.clear();
+        mScriptCacheDirty = false;
+
+        uint32 id = 0, version = 0, count = 0;
+        stream->read(&id, sizeof(uint32));
+        stream->read(&version, sizeof(uint32));
+        if(id != SCRIPT_CACHE_ID || version != SCRIPT_CACHE_VERSION)
+        {
+            LogManager::getSingleton().logMessage("Ignoring script cache " + stream->getName() +
+                " which was saved by a different version");
+            return;
+        }
+
+        stream->read(&count, sizeof(uint32));
+        for(uint32 i = 0; i < count; ++i)
+        {
+            String key, blob;
+            if(!readString(stream, key) || !readString(stream, blob))
+            {
+                LogManager::getSingleton().logMessage("Script cache " + stream->getName() +
+                    " is truncated, the remaining scripts will be parsed");
+                break;
+            }
+            mScriptCache[key].blob.swap(blob);
+        }
     }
 
     //-------------------------------------------------------------------------
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreException.h"
 #include "OgreScriptLexer.h"
+#include "OgreDataStream.h"
 
 namespace Ogre{
 
@@ -36,6 +37,19 @@ namespace Ogre{
     }
 
     ScriptTokenListPtr ScriptLexer::tokenize(const String &str, const String &source)
+    {
+        return tokenize(str.data(), str.size(), source);
+    }
+
+    ScriptTokenListPtr ScriptLexer::tokenize(const DataStreamPtr &stream, const String &source)
+    {
+        MemoryDataStream *memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if(memStream)
+            return tokenize(reinterpret_cast<const char*>(memStream->getPtr()), memStream->size(), source);
+        return tokenize(stream->getAsString(), source);
+    }
+
+    ScriptTokenListPtr ScriptLexer::tokenize(const char *str, size_t length, const String &source)
     {
         // State enums
         enum{ READY = 0, COMMENT, MULTICOMMENT, WORD, QUOTE, VAR, POSSIBLECOMMENT };
@@ -49,7 +63,7 @@ namespace Ogre{
         ScriptTokenListPtr tokens(OGRE_NEW_T(ScriptTokenList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
 
         // Iterate over the input
-        String::const_iterator i = str.begin(), end = str.end();
+        const char *i = str, *end = str + length;
         while(i != end)
         {
             lastc = c;
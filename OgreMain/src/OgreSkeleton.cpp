@@ -592,14 +592,14 @@ namespace Ogre {
 
             for (unsigned short ti = 0; ti < anim->getNumNodeTracks(); ++ti)
             {
-                NodeAnimationTrack* track = anim->getNodeTrack(ti);
+                const NodeAnimationTrack* track = anim->getNodeTrack(ti);
                 of << "  -- AnimationTrack " << ti << " --" << std::endl;
                 of << "  Affects bone: " << static_cast<Bone*>(track->getAssociatedNode())->getHandle() << std::endl;
                 of << "  Number of keyframes: " << track->getNumKeyFrames() << std::endl;
 
                 for (unsigned short ki = 0; ki < track->getNumKeyFrames(); ++ki)
                 {
-                    TransformKeyFrame* key = track->getNodeKeyFrame(ki);
+                    const TransformKeyFrame* key = track->getNodeKeyFrame(ki);
                     of << "    -- KeyFrame " << ki << " --" << std::endl;
                     of << "    Time index: " << key->getTime(); 
                     of << "    Translation: " << key->getTranslate() << std::endl;
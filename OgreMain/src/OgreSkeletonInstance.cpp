@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreSkeletonInstance.h"
 #include "OgreBone.h"
 #include "OgreTagPoint.h"
+#include "OgreSkeletonPoseEvaluator.h"
 
 
 namespace Ogre {
@@ -37,6 +38,7 @@ namespace Ogre {
         : Skeleton()
         , mSkeleton(masterCopy)
         , mNextTagPointAutoHandle(0)
+        , mPoseEvaluator(0)
     {
     }
     //-------------------------------------------------------------------------
@@ -47,6 +49,7 @@ namespace Ogre {
         // ...and calling it in Skeleton destructor does not unload
         // SkeletonInstance since it has seized to be by then.
         unload();
+        OGRE_DELETE mPoseEvaluator;
     }
     //-------------------------------------------------------------------------
     unsigned short SkeletonInstance::getNumAnimations(void) const
@@ -160,6 +163,9 @@ namespace Ogre {
     {
         Skeleton::unloadImpl();
 
+        if (mPoseEvaluator)
+            mPoseEvaluator->_notifyBonesChanged();
+
         // destroy TagPoints
         for (TagPointList::const_iterator it = mActiveTagPoints.begin(); it != mActiveTagPoints.end(); ++it)
         {
@@ -179,6 +185,13 @@ namespace Ogre {
         mFreeTagPoints.clear();
     }
 
+    //-------------------------------------------------------------------------
+    SkeletonPoseEvaluator* SkeletonInstance::_getPoseEvaluator(void)
+    {
+        if (!mPoseEvaluator)
+            mPoseEvaluator = OGRE_NEW SkeletonPoseEvaluator(this);
+        return mPoseEvaluator;
+    }
     //-------------------------------------------------------------------------
     TagPoint* SkeletonInstance::createTagPointOnBone(Bone* bone,
         const Quaternion &offsetOrientation, 
@@ -0,0 +1,287 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSkeletonPoseEvaluator.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationState.h"
+#include "OgreAnimationTrack.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+
+    //---------------------------------------------------------------------
+    SkeletonPoseEvaluator::SkeletonPoseEvaluator(Skeleton* skeleton)
+        : mSkeleton(skeleton)
+        , mStride(0)
+        , mLocalTransforms(0)
+        , mDerivedTransforms(0)
+        , mBindInverseTransforms(0)
+        , mLayoutDirty(true)
+    {
+    }
+    //---------------------------------------------------------------------
+    SkeletonPoseEvaluator::~SkeletonPoseEvaluator()
+    {
+        freeTransforms();
+    }
+    //---------------------------------------------------------------------
+    void SkeletonPoseEvaluator::_notifyBonesChanged(void)
+    {
+        mLayoutDirty = true;
+    }
+    //---------------------------------------------------------------------
+    void SkeletonPoseEvaluator::freeTransforms(void)
+    {
+        OGRE_FREE_SIMD(mLocalTransforms, MEMCATEGORY_ANIMATION);
+        OGRE_FREE_SIMD(mDerivedTransforms, MEMCATEGORY_ANIMATION);
+        OGRE_FREE_SIMD(mBindInverseTransforms, MEMCATEGORY_ANIMATION);
+        mLocalTransforms = 0;
+        mDerivedTransforms = 0;
+        mBindInverseTransforms = 0;
+        mStride = 0;
+    }
+    //---------------------------------------------------------------------
+    void SkeletonPoseEvaluator::buildLayout(void)
+    {
+        unsigned short numBones = mSkeleton->getNumBones();
+
+        // Depth of each bone, parents are always shallower than their children
+        IndexList depths(numBones);
+        size_t maxDepth = 0;
+        for (unsigned short handle = 0; handle < numBones; ++handle)
+        {
+            unsigned short depth = 0;
+            for (Node* parent = mSkeleton->getBone(handle)->getParent(); parent;
+                parent = parent->getParent())
+            {
+                ++depth;
+            }
+            depths[handle] = depth;
+            maxDepth = std::max(maxDepth, (size_t)depth);
+        }
+
+        // Order the bones by depth, slot 0 being the root
+        mBones.assign(1, (Bone*)0);
+        mBoneHandles.assign(1, 0);
+        mParents.assign(1, 0);
+        mSlots.resize(numBones);
+        for (size_t depth = 0; depth <= maxDepth; ++depth)
+        {
+            for (unsigned short handle = 0; handle < numBones; ++handle)
+            {
+                if (depths[handle] != depth)
+                    continue;
+
+                Bone* bone = mSkeleton->getBone(handle);
+                Bone* parent = static_cast<Bone*>(bone->getParent());
+                mSlots[handle] = static_cast<unsigned short>(mBones.size());
+                mBones.push_back(bone);
+                mBoneHandles.push_back(handle);
+                mParents.push_back(parent ? mSlots[parent->getHandle()] : 0);
+            }
+        }
+
+        // Component arrays padded to four elements
+        freeTransforms();
+        mStride = (mBones.size() + 3) & ~size_t(3);
+        size_t bytes = NUM_COMPONENTS * mStride * sizeof(Real);
+        mLocalTransforms = static_cast<Real*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_ANIMATION));
+        mDerivedTransforms = static_cast<Real*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_ANIMATION));
+        mBindInverseTransforms = static_cast<Real*>(OGRE_MALLOC_SIMD(bytes, MEMCATEGORY_ANIMATION));
+        memset(mLocalTransforms, 0, bytes);
+        memset(mDerivedTransforms, 0, bytes);
+        memset(mBindInverseTransforms, 0, bytes);
+
+        // The root has the identity transform
+        mDerivedTransforms[ORIENTATION_W * mStride] = 1;
+        mDerivedTransforms[SCALE_X * mStride] = 1;
+        mDerivedTransforms[SCALE_Y * mStride] = 1;
+        mDerivedTransforms[SCALE_Z * mStride] = 1;
+
+        mLayoutDirty = false;
+    }
+    //---------------------------------------------------------------------
+    bool SkeletonPoseEvaluator::resetTransforms(void)
+    {
+        Real* local = mLocalTransforms;
+        Real* bindInverse = mBindInverseTransforms;
+        size_t stride = mStride;
+
+        for (size_t i = 1; i < mBones.size(); ++i)
+        {
+            const Bone* bone = mBones[i];
+            if (bone->isManuallyControlled() ||
+                !bone->getInheritOrientation() || !bone->getInheritScale())
+            {
+                return false;
+            }
+
+            const Vector3& position = bone->getInitialPosition();
+            const Quaternion& orientation = bone->getInitialOrientation();
+            const Vector3& scale = bone->getInitialScale();
+            local[POSITION_X * stride + i] = position.x;
+            local[POSITION_Y * stride + i] = position.y;
+            local[POSITION_Z * stride + i] = position.z;
+            local[ORIENTATION_W * stride + i] = orientation.w;
+            local[ORIENTATION_X * stride + i] = orientation.x;
+            local[ORIENTATION_Y * stride + i] = orientation.y;
+            local[ORIENTATION_Z * stride + i] = orientation.z;
+            local[SCALE_X * stride + i] = scale.x;
+            local[SCALE_Y * stride + i] = scale.y;
+            local[SCALE_Z * stride + i] = scale.z;
+
+            const Vector3& bindPosition = bone->_getBindingPoseInversePosition();
+            const Quaternion& bindOrientation = bone->_getBindingPoseInverseOrientation();
+            const Vector3& bindScale = bone->_getBindingPoseInverseScale();
+            bindInverse[POSITION_X * stride + i] = bindPosition.x;
+            bindInverse[POSITION_Y * stride + i] = bindPosition.y;
+            bindInverse[POSITION_Z * stride + i] = bindPosition.z;
+            bindInverse[ORIENTATION_W * stride + i] = bindOrientation.w;
+            bindInverse[ORIENTATION_X * stride + i] = bindOrientation.x;
+            bindInverse[ORIENTATION_Y * stride + i] = bindOrientation.y;
+            bindInverse[ORIENTATION_Z * stride + i] = bindOrientation.z;
+            bindInverse[SCALE_X * stride + i] = bindScale.x;
+            bindInverse[SCALE_Y * stride + i] = bindScale.y;
+            bindInverse[SCALE_Z * stride + i] = bindScale.z;
+        }
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void SkeletonPoseEvaluator::applyAnimation(Animation* anim, Real timePos, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale)
+    {
+        anim->_applyBaseKeyFrame();
+
+        // Calculate time index for fast keyframe search
+        TimeIndex timeIndex = anim->_getTimeIndex(timePos);
+
+        Real* local = mLocalTransforms;
+        size_t stride = mStride;
+
+        const Animation::NodeTrackList& tracks = anim->_getNodeTrackList();
+        Animation::NodeTrackList::const_iterator t, tend = tracks.end();
+        for (t = tracks.begin(); t != tend; ++t)
+        {
+            unsigned short handle = t->first;
+            if (handle >= mSlots.size())
+                continue;
+
+            Real trackWeight = blendMask ? (*blendMask)[handle] * weight : weight;
+            Vector3 translate, scaling;
+            Quaternion rotate;
+            if (!t->second->_getTransformToApply(timeIndex, trackWeight, scale,
+                translate, rotate, scaling))
+            {
+                continue;
+            }
+
+            // Same operations as Node::translate, Node::rotate and Node::scale
+            size_t i = mSlots[handle];
+            local[POSITION_X * stride + i] += translate.x;
+            local[POSITION_Y * stride + i] += translate.y;
+            local[POSITION_Z * stride + i] += translate.z;
+
+            Quaternion orientation(local[ORIENTATION_W * stride + i],
+                local[ORIENTATION_X * stride + i], local[ORIENTATION_Y * stride + i],
+                local[ORIENTATION_Z * stride + i]);
+            orientation = orientation * rotate;
+            orientation.normalise();
+            local[ORIENTATION_W * stride + i] = orientation.w;
+            local[ORIENTATION_X * stride + i] = orientation.x;
+            local[ORIENTATION_Y * stride + i] = orientation.y;
+            local[ORIENTATION_Z * stride + i] = orientation.z;
+
+            local[SCALE_X * stride + i] *= scaling.x;
+            local[SCALE_Y * stride + i] *= scaling.y;
+            local[SCALE_Z * stride + i] *= scaling.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    bool SkeletonPoseEvaluator::evaluate(const AnimationStateSet& animSet, Matrix4* boneMatrices)
+    {
+#if OGRE_NODE_INHERIT_TRANSFORM
+        // Full transforms are inherited, which this doesn't do
+        return false;
+#else
+        if (mLayoutDirty || mBones.size() != (size_t)mSkeleton->getNumBones() + 1)
+            buildLayout();
+
+        // Reset bones
+        if (!resetTransforms())
+            return false;
+
+        // Same weighting as Skeleton::setAnimationState
+        Real weightFactor = 1.0f;
+        if (mSkeleton->getBlendMode() == ANIMBLEND_AVERAGE)
+        {
+            // Derive total weights so we can rebalance if > 1.0f
+            Real totalWeights = 0.0f;
+            ConstEnabledAnimationStateIterator stateIt = 
+                animSet.getEnabledAnimationStateIterator();
+            while (stateIt.hasMoreElements())
+            {
+                const AnimationState* animState = stateIt.getNext();
+                if (mSkeleton->_getAnimationImpl(animState->getAnimationName()))
+                    totalWeights += animState->getWeight();
+            }
+
+            // Allow < 1.0f, allows fade out of all anims if required 
+            if (totalWeights > 1.0f)
+                weightFactor = 1.0f / totalWeights;
+        }
+
+        // Per enabled animation state
+        ConstEnabledAnimationStateIterator stateIt = 
+            animSet.getEnabledAnimationStateIterator();
+        while (stateIt.hasMoreElements())
+        {
+            const AnimationState* animState = stateIt.getNext();
+            const LinkedSkeletonAnimationSource* linked = 0;
+            Animation* anim = mSkeleton->_getAnimationImpl(animState->getAnimationName(), &linked);
+            // tolerate state entries for animations we're not aware of
+            if (anim)
+            {
+                applyAnimation(anim, animState->getTimePosition(),
+                    animState->getWeight() * weightFactor, animState->getBlendMask(),
+                    linked ? linked->scale : 1.0f);
+            }
+        }
+
+        // Concatenate the hierarchy and build the matrices
+        OptimisedUtil::getImplementation()->concatenateBoneTransforms(
+            mLocalTransforms, mBindInverseTransforms, &mParents[0], &mBoneHandles[0],
+            mDerivedTransforms, boneMatrices, mStride, mBones.size());
+
+        return true;
+#endif
+    }
+
+}
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreAnimation.h"
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedTransformTrack.h"
 #include "OgreBone.h"
 #include "OgreLogManager.h"
 
@@ -68,6 +69,9 @@ namespace Ogre {
     void SkeletonSerializer::exportSkeleton(const Skeleton* pSkeleton, 
         DataStreamPtr stream, SkeletonVersion ver, Endian endianMode)
     {
+        // Files without compressed tracks stay readable by earlier versions
+        if (ver == SKELETON_VERSION_LATEST && !hasCompressedTracks(pSkeleton))
+            ver = SKELETON_VERSION_1_8;
         setWorkingVersion(ver);
         // Decide on endian mode
         determineEndianness(endianMode);
@@ -160,12 +164,28 @@ namespace Ogre {
 
     }
     
+    //---------------------------------------------------------------------
+    bool SkeletonSerializer::hasCompressedTracks(const Skeleton* pSkel) const
+    {
+        for (unsigned short i = 0; i < pSkel->getNumAnimations(); ++i)
+        {
+            Animation::NodeTrackIterator trackIt = pSkel->getAnimation(i)->getNodeTrackIterator();
+            while (trackIt.hasMoreElements())
+            {
+                if (trackIt.getNext()->isCompressed())
+                    return true;
+            }
+        }
+        return false;
+    }
     //---------------------------------------------------------------------
     void SkeletonSerializer::setWorkingVersion(SkeletonVersion ver)
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.100]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -273,7 +293,7 @@ namespace Ogre {
         Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
         {
-            writeAnimationTrack(pSkel, trackIt.getNext());
+            writeAnimationTrack(pSkel, trackIt.getNext(), ver);
         }
         }
         popInnerChunk(mStream);
@@ -281,19 +301,40 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeAnimationTrack(const Skeleton* pSkel, 
-        const NodeAnimationTrack* track)
+        const NodeAnimationTrack* track, SkeletonVersion ver)
     {
-        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track));
+        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track, ver));
 
         // unsigned short boneIndex     : Index of bone to apply to
         Bone* bone = static_cast<Bone*>(track->getAssociatedNode());
         unsigned short boneid = bone->getHandle();
         writeShorts(&boneid, 1);
         pushInnerChunk(mStream);
-        // Write all keyframes
-        for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+        const CompressedTransformTrack* compressed = track->getCompressedKeyFrames();
+        if (compressed && (int)ver > (int)SKELETON_VERSION_1_8)
         {
-            writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            writeCompressedKeyFrames(pSkel, compressed);
+        }
+        else if (compressed)
+        {
+            // Write the compressed keyframes as plain ones, without
+            // decompressing the track
+            for (size_t i = 0; i < compressed->getNumKeyFrames(); ++i)
+            {
+                TransformKeyFrame key(track, compressed->getTimes()[i]);
+                key.setRotation(compressed->getRotation(i));
+                key.setTranslate(compressed->getTranslate(i));
+                key.setScale(compressed->getScale(i));
+                writeKeyFrame(pSkel, &key);
+            }
+        }
+        else
+        {
+            // Write all keyframes
+            for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+            {
+                writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            }
         }
         popInnerChunk(mStream);
     }
@@ -318,6 +359,48 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedKeyFrames(const Skeleton* pSkel,
+        const CompressedTransformTrack* keyFrames)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_TRACK_COMPRESSED,
+            calcCompressedKeyFramesSize(pSkel, keyFrames));
+
+        // unsigned short numKeyFrames  : Number of keyframes
+        uint16 numKeyFrames = static_cast<uint16>(keyFrames->getNumKeyFrames());
+        writeShorts(&numKeyFrames, 1);
+        // float times[numKeyFrames]    : The time positions (seconds)
+        writeFloats(&keyFrames->mTimes[0], numKeyFrames);
+        // unsigned short channels      : Which channels vary
+        uint16 channels = 0;
+        if (!keyFrames->isRotationConstant())
+            channels |= 1;
+        if (!keyFrames->isTranslateConstant())
+            channels |= 2;
+        if (!keyFrames->isScaleConstant())
+            channels |= 4;
+        writeShorts(&channels, 1);
+
+        // Rotations
+        if (keyFrames->isRotationConstant())
+            writeObject(keyFrames->mConstantRotation);
+        else
+            writeShorts(&keyFrames->mRotations[0], keyFrames->mRotations.size());
+        // Translations
+        writeObject(keyFrames->mTranslateBase);
+        if (!keyFrames->isTranslateConstant())
+        {
+            writeObject(keyFrames->mTranslateStep);
+            writeShorts(&keyFrames->mTranslates[0], keyFrames->mTranslates.size());
+        }
+        // Scales
+        writeObject(keyFrames->mScaleBase);
+        if (!keyFrames->isScaleConstant())
+        {
+            writeObject(keyFrames->mScaleStep);
+            writeShorts(&keyFrames->mScales[0], keyFrames->mScales.size());
+        }
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone)
     {
@@ -391,29 +474,76 @@ namespace Ogre {
         Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
         {
-            size += calcAnimationTrackSize(pSkel, trackIt.getNext());
+            size += calcAnimationTrackSize(pSkel, trackIt.getNext(), ver);
         }
 
         return size;
     }
     //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcAnimationTrackSize(const Skeleton* pSkel, 
-        const NodeAnimationTrack* pTrack)
+        const NodeAnimationTrack* pTrack, SkeletonVersion ver)
     {
         size_t size = SSTREAM_OVERHEAD_SIZE;
 
         // unsigned short boneIndex     : Index of bone to apply to
         size += sizeof(unsigned short);
 
-        // Nested keyframes
-        for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
+        const CompressedTransformTrack* compressed = pTrack->getCompressedKeyFrames();
+        if (compressed && (int)ver > (int)SKELETON_VERSION_1_8)
         {
-            size += calcKeyFrameSize(pSkel, pTrack->getNodeKeyFrame(i));
+            size += calcCompressedKeyFramesSize(pSkel, compressed);
+        }
+        else if (compressed)
+        {
+            // Nested keyframes, with scale only where it isn't unit
+            for (size_t i = 0; i < compressed->getNumKeyFrames(); ++i)
+            {
+                TransformKeyFrame key(pTrack, compressed->getTimes()[i]);
+                key.setScale(compressed->getScale(i));
+                size += calcKeyFrameSize(pSkel, &key);
+            }
+        }
+        else
+        {
+            // Nested keyframes
+            for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
+            {
+                size += calcKeyFrameSize(pSkel, pTrack->getNodeKeyFrame(i));
+            }
         }
 
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedKeyFramesSize(const Skeleton* pSkel,
+        const CompressedTransformTrack* keyFrames)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+        size_t numKeyFrames = keyFrames->getNumKeyFrames();
+
+        // unsigned short numKeyFrames
+        size += sizeof(uint16);
+        // float times[numKeyFrames]
+        size += sizeof(float) * numKeyFrames;
+        // unsigned short channels
+        size += sizeof(uint16);
+        // Quaternion rotate, or unsigned short rotates[numKeyFrames * 3]
+        if (keyFrames->isRotationConstant())
+            size += sizeof(float) * 4;
+        else
+            size += sizeof(uint16) * 3 * numKeyFrames;
+        // Vector3 translateBase, and translateStep and translates if they vary
+        size += sizeof(float) * 3;
+        if (!keyFrames->isTranslateConstant())
+            size += sizeof(float) * 3 + sizeof(uint16) * 3 * numKeyFrames;
+        // Same for the scales
+        size += sizeof(float) * 3;
+        if (!keyFrames->isScaleConstant())
+            size += sizeof(float) * 3 + sizeof(uint16) * 3 * numKeyFrames;
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcKeyFrameSize(const Skeleton* pSkel, 
         const TransformKeyFrame* pKey)
     {
@@ -455,7 +585,8 @@ namespace Ogre {
             // Read version
             String ver = readString(stream);
             if ((ver != "[Serializer_v1.10]") &&
-                (ver != "[Serializer_v1.80]"))
+                (ver != "[Serializer_v1.80]") &&
+                (ver != "[Serializer_v1.100]"))
             {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
                     "Invalid file: version incompatible, file reports " + String(ver),
@@ -596,9 +727,13 @@ namespace Ogre {
         {
             pushInnerChunk(stream);
             unsigned short streamID = readChunk(stream);
-            while(streamID == SKELETON_ANIMATION_TRACK_KEYFRAME && !stream->eof())
+            while((streamID == SKELETON_ANIMATION_TRACK_KEYFRAME ||
+                streamID == SKELETON_ANIMATION_TRACK_COMPRESSED) && !stream->eof())
             {
-                readKeyFrame(stream, pTrack, pSkel);
+                if (streamID == SKELETON_ANIMATION_TRACK_COMPRESSED)
+                    readCompressedKeyFrames(stream, pTrack, pSkel);
+                else
+                    readKeyFrame(stream, pTrack, pSkel);
 
                 if (!stream->eof())
                 {
@@ -643,6 +778,58 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedKeyFrames(DataStreamPtr& stream, NodeAnimationTrack* track,
+        Skeleton* pSkel)
+    {
+        // Only handed to the track once completely read
+        CompressedTransformTrack keyFrames;
+
+        // unsigned short numKeyFrames  : Number of keyframes
+        uint16 numKeyFrames;
+        readShorts(stream, &numKeyFrames, 1);
+        if (!numKeyFrames)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid compressed keyframes in " + stream->getName(),
+                "SkeletonSerializer::readCompressedKeyFrames");
+        }
+        // float times[numKeyFrames]    : The time positions (seconds)
+        keyFrames.mTimes.resize(numKeyFrames);
+        readFloats(stream, &keyFrames.mTimes[0], numKeyFrames);
+        // unsigned short channels      : Which channels vary
+        uint16 channels;
+        readShorts(stream, &channels, 1);
+
+        // Rotations
+        if (channels & 1)
+        {
+            keyFrames.mRotations.resize(numKeyFrames * 3);
+            readShorts(stream, &keyFrames.mRotations[0], keyFrames.mRotations.size());
+        }
+        else
+        {
+            readObject(stream, keyFrames.mConstantRotation);
+        }
+        // Translations
+        readObject(stream, keyFrames.mTranslateBase);
+        if (channels & 2)
+        {
+            readObject(stream, keyFrames.mTranslateStep);
+            keyFrames.mTranslates.resize(numKeyFrames * 3);
+            readShorts(stream, &keyFrames.mTranslates[0], keyFrames.mTranslates.size());
+        }
+        // Scales
+        readObject(stream, keyFrames.mScaleBase);
+        if (channels & 4)
+        {
+            readObject(stream, keyFrames.mScaleStep);
+            keyFrames.mScales.resize(numKeyFrames * 3);
+            readShorts(stream, &keyFrames.mScales[0], keyFrames.mScales.size());
+        }
+
+        track->_setCompressedKeyFrames(OGRE_NEW CompressedTransformTrack(keyFrames));
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
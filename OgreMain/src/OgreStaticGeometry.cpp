@@ -43,9 +43,30 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgreLodStrategy.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreWorkQueue.h"
 
 namespace Ogre {
 
+    namespace {
+        /// Prepares the geometry of buckets, see StaticGeometry::buildRegions
+        class GeometryBuildTask : public WorkQueue::ParallelTask
+        {
+        public:
+            GeometryBuildTask(const vector<StaticGeometry::GeometryBucket*>::type& buckets,
+                const StaticGeometry::SourceDataMap& sources, bool stencilShadows)
+                : mBuckets(buckets), mSources(sources), mStencilShadows(stencilShadows) {}
+            void execute(size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    mBuckets[i]->_prepareBuild(mStencilShadows, &mSources);
+            }
+        protected:
+            const vector<StaticGeometry::GeometryBucket*>::type& mBuckets;
+            const StaticGeometry::SourceDataMap& mSources;
+            bool mStencilShadows;
+        };
+    }
+
     #define REGION_RANGE 1024
     #define REGION_HALF_RANGE 512
     #define REGION_MAX_INDEX 511
@@ -65,7 +86,8 @@ namespace Ogre {
         mVisible(true),
         mRenderQueueID(RENDER_QUEUE_MAIN),
         mRenderQueueIDSet(false),
-        mVisibilityFlags(Ogre::MovableObject::getDefaultVisibilityFlags())
+        mVisibilityFlags(Ogre::MovableObject::getDefaultVisibilityFlags()),
+        mNextAdditionId(1)
     {
     }
     //--------------------------------------------------------------------------
@@ -283,8 +305,16 @@ namespace Ogre {
         return AxisAlignedBox(min, max);
     }
     //--------------------------------------------------------------------------
-    void StaticGeometry::addEntity(Entity* ent, const Vector3& position,
-        const Quaternion& orientation, const Vector3& scale)
+    StaticGeometry::AdditionId StaticGeometry::addEntity(Entity* ent, 
+        const Vector3& position, const Quaternion& orientation, const Vector3& scale)
+    {
+        AdditionId id = mNextAdditionId++;
+        queueEntity(ent, position, orientation, scale, id);
+        return id;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::queueEntity(Entity* ent, const Vector3& position,
+        const Quaternion& orientation, const Vector3& scale, AdditionId id)
     {
         const MeshPtr& msh = ent->getMesh();
         // Validate
@@ -305,6 +335,8 @@ namespace Ogre {
 
             // Get the geometry for this SubMesh
             q->submesh = se->getSubMesh();
+            q->additionId = id;
+            q->region = 0;
             q->geometryLodList = determineGeometry(q->submesh);
             q->materialName = se->getMaterialName();
             q->orientation = orientation;
@@ -319,6 +351,27 @@ namespace Ogre {
         }
     }
     //--------------------------------------------------------------------------
+    void StaticGeometry::removeAddition(AdditionId id)
+    {
+        QueuedSubMeshList::iterator i = mQueuedSubMeshes.begin();
+        while (i != mQueuedSubMeshes.end())
+        {
+            QueuedSubMesh* q = *i;
+            if (q->additionId == id)
+            {
+                // The region it was built into needs rebuilding without it
+                if (q->region)
+                    mDirtyRegions.insert(q->region->getID());
+                OGRE_DELETE q;
+                i = mQueuedSubMeshes.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
     StaticGeometry::SubMeshLodGeometryLinkList*
     StaticGeometry::determineGeometry(SubMesh* sm)
     {
@@ -521,7 +574,14 @@ namespace Ogre {
         mOptimisedSubMeshGeometryList.push_back(optGeom);
     }
     //--------------------------------------------------------------------------
-    void StaticGeometry::addSceneNode(const SceneNode* node)
+    StaticGeometry::AdditionId StaticGeometry::addSceneNode(const SceneNode* node)
+    {
+        AdditionId id = mNextAdditionId++;
+        queueSceneNode(node, id);
+        return id;
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::queueSceneNode(const SceneNode* node, AdditionId id)
     {
         SceneNode::ConstObjectIterator obji = node->getAttachedObjectIterator();
         while (obji.hasMoreElements())
@@ -529,10 +589,10 @@ namespace Ogre {
             MovableObject* mobj = obji.getNext();
             if (mobj->getMovableType() == "Entity")
             {
-                addEntity(static_cast<Entity*>(mobj),
+                queueEntity(static_cast<Entity*>(mobj),
                     node->_getDerivedPosition(),
                     node->_getDerivedOrientation(),
-                    node->_getDerivedScale());
+                    node->_getDerivedScale(), id);
             }
         }
         // Iterate through all the child-nodes
@@ -542,22 +602,63 @@ namespace Ogre {
         {
             const SceneNode* subNode = static_cast<const SceneNode*>(nodei.getNext());
             // Add this subnode and its children...
-            addSceneNode( subNode );
+            queueSceneNode( subNode, id );
         }
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::build(void)
     {
-        // Make sure there's nothing from previous builds
-        destroy();
+        if (!mBuilt)
+        {
+            // Make sure there's nothing from previous builds
+            destroy();
+        }
+        else
+        {
+            // Find the regions new submeshes fall in
+            for (QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
+                qi != mQueuedSubMeshes.end(); ++qi)
+            {
+                if (!(*qi)->region)
+                    mDirtyRegions.insert(getRegion((*qi)->worldBounds, true)->getID());
+            }
+
+            // Throw away the regions which changed, their submeshes are
+            // assigned again below along with the new ones
+            for (QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
+                qi != mQueuedSubMeshes.end(); ++qi)
+            {
+                QueuedSubMesh* qsm = *qi;
+                if (qsm->region && mDirtyRegions.find(qsm->region->getID()) != mDirtyRegions.end())
+                    qsm->region = 0;
+            }
+            for (RegionIndexSet::iterator di = mDirtyRegions.begin();
+                di != mDirtyRegions.end(); ++di)
+            {
+                RegionMap::iterator ri = mRegionMap.find(*di);
+                if (ri != mRegionMap.end())
+                {
+                    mOwner->extractMovableObject(ri->second);
+                    OGRE_DELETE ri->second;
+                    mRegionMap.erase(ri);
+                }
+            }
+        }
+        mDirtyRegions.clear();
 
-        // Firstly allocate meshes to regions
+        // Allocate the meshes not in a region to regions
+        RegionList regions;
         for (QueuedSubMeshList::iterator qi = mQueuedSubMeshes.begin();
             qi != mQueuedSubMeshes.end(); ++qi)
         {
             QueuedSubMesh* qsm = *qi;
+            if (qsm->region)
+                continue;
             Region* region = getRegion(qsm->worldBounds, true);
             region->assign(qsm);
+            qsm->region = region;
+            if (std::find(regions.begin(), regions.end(), region) == regions.end())
+                regions.push_back(region);
         }
         bool stencilShadows = false;
         if (mCastShadows && mOwner->isShadowTechniqueStencilBased())
@@ -565,16 +666,71 @@ namespace Ogre {
             stencilShadows = true;
         }
 
-        // Now tell each region to build itself
-        for (RegionMap::iterator ri = mRegionMap.begin();
-            ri != mRegionMap.end(); ++ri)
+        // Now build the regions
+        buildRegions(regions, stencilShadows);
+        for (RegionList::iterator ri = regions.begin(); ri != regions.end(); ++ri)
         {
-            ri->second->build(stencilShadows);
-            
             // Set the visibility flags on these regions
-            ri->second->setVisibilityFlags(mVisibilityFlags);
+            (*ri)->setVisibilityFlags(mVisibilityFlags);
+        }
+        mBuilt = true;
+
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::buildRegions(const RegionList& regions, bool stencilShadows)
+    {
+        // Set up the buckets and load the materials on this thread
+        vector<GeometryBucket*>::type buckets;
+        for (RegionList::const_iterator ri = regions.begin(); ri != regions.end(); ++ri)
+        {
+            Region* region = *ri;
+            region->_createBuckets();
+            Region::LODIterator lodIt = region->getLODIterator();
+            while (lodIt.hasMoreElements())
+            {
+                LODBucket::MaterialIterator matIt = lodIt.getNext()->getMaterialIterator();
+                while (matIt.hasMoreElements())
+                {
+                    MaterialBucket* mat = matIt.getNext();
+                    mat->_loadMaterial();
+                    MaterialBucket::GeometryIterator geomIt = mat->getGeometryIterator();
+                    while (geomIt.hasMoreElements())
+                    {
+                        buckets.push_back(geomIt.getNext());
+                    }
+                }
+            }
         }
 
+        // Hardware buffers can't be read from other threads, so take copies
+        // of the sources. Each source mesh is read once however many times
+        // it is placed.
+        SourceDataMap sources;
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            buckets[i]->_readSources(sources);
+        }
+
+        GeometryBuildTask task(buckets, sources, stencilShadows);
+        WorkQueue* workQueue = Root::getSingleton().getWorkQueue();
+        if (workQueue)
+            workQueue->parallelFor(&task, buckets.size());
+        else
+            task.execute(0, buckets.size());
+
+        // Back on this thread for the hardware buffers
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            buckets[i]->_createBuffers(stencilShadows);
+        }
+        for (RegionList::const_iterator ri = regions.begin(); ri != regions.end(); ++ri)
+        {
+            Region::LODIterator lodIt = (*ri)->getLODIterator();
+            while (lodIt.hasMoreElements())
+            {
+                lodIt.getNext()->_buildEdgeList(stencilShadows);
+            }
+        }
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::destroy(void)
@@ -587,6 +743,13 @@ namespace Ogre {
             OGRE_DELETE i->second;
         }
         mRegionMap.clear();
+        for (QueuedSubMeshList::iterator i = mQueuedSubMeshes.begin();
+            i != mQueuedSubMeshes.end(); ++i)
+        {
+            (*i)->region = 0;
+        }
+        mDirtyRegions.clear();
+        mBuilt = false;
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::reset(void)
@@ -806,6 +969,16 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::Region::build(bool stencilShadows)
+    {
+        _createBuckets();
+        for (LODBucketList::iterator i = mLodBucketList.begin();
+            i != mLodBucketList.end(); ++i)
+        {
+            (*i)->build(stencilShadows);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::Region::_createBuckets(void)
     {
         // Create a node
         mNode = mSceneMgr->getRootSceneNode()->createChildSceneNode(mName,
@@ -826,12 +999,7 @@ namespace Ogre {
             {
                 lodBucket->assign(*qi, lod);
             }
-            // now build
-            lodBucket->build(stencilShadows);
         }
-
-
-
     }
     //--------------------------------------------------------------------------
     const String& StaticGeometry::Region::getMovableType(void) const
@@ -1104,58 +1272,62 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     void StaticGeometry::LODBucket::build(bool stencilShadows)
     {
+        // Just pass this on to child buckets
+        for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
+            i != mMaterialBucketMap.end(); ++i)
+        {
+            i->second->build(stencilShadows);
+        }
+
+        _buildEdgeList(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::LODBucket::_buildEdgeList(bool stencilShadows)
+    {
+        if (!stencilShadows)
+            return;
 
         EdgeListBuilder eb;
         size_t vertexSet = 0;
 
-        // Just pass this on to child buckets
         for (MaterialBucketMap::iterator i = mMaterialBucketMap.begin();
             i != mMaterialBucketMap.end(); ++i)
         {
             MaterialBucket* mat = i->second;
 
-            mat->build(stencilShadows);
-
-            if (stencilShadows)
+            MaterialBucket::GeometryIterator geomIt =
+                mat->getGeometryIterator();
+            // Check if we have vertex programs here
+            Technique* t = mat->getMaterial()->getBestTechnique();
+            if (t)
             {
-                MaterialBucket::GeometryIterator geomIt =
-                    mat->getGeometryIterator();
-                // Check if we have vertex programs here
-                Technique* t = mat->getMaterial()->getBestTechnique();
-                if (t)
+                Pass* p = t->getPass(0);
+                if (p)
                 {
-                    Pass* p = t->getPass(0);
-                    if (p)
+                    if (p->hasVertexProgram())
                     {
-                        if (p->hasVertexProgram())
-                        {
-                            mVertexProgramInUse = true;
-                        }
+                        mVertexProgramInUse = true;
                     }
                 }
+            }
 
-                while (geomIt.hasMoreElements())
-                {
-                    GeometryBucket* geom = geomIt.getNext();
-
-                    // Check we're dealing with 16-bit indexes here
-                    // Since stencil shadows can only deal with 16-bit
-                    // More than that and stencil is probably too CPU-heavy
-                    // in any case
-                    assert(geom->getIndexData()->indexBuffer->getType()
-                        == HardwareIndexBuffer::IT_16BIT &&
-                        "Only 16-bit indexes allowed when using stencil shadows");
-                    eb.addVertexData(geom->getVertexData());
-                    eb.addIndexData(geom->getIndexData(), vertexSet++);
-                }
-
+            while (geomIt.hasMoreElements())
+            {
+                GeometryBucket* geom = geomIt.getNext();
+
+                // Check we're dealing with 16-bit indexes here
+                // Since stencil shadows can only deal with 16-bit
+                // More than that and stencil is probably too CPU-heavy
+                // in any case
+                assert(geom->getIndexData()->indexBuffer->getType()
+                    == HardwareIndexBuffer::IT_16BIT &&
+                    "Only 16-bit indexes allowed when using stencil shadows");
+                eb.addVertexData(geom->getVertexData());
+                eb.addIndexData(geom->getIndexData(), vertexSet++);
             }
         }
 
-        if (stencilShadows)
-        {
-            mEdgeList = eb.build();
-        }
+        mEdgeList = eb.build();
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::LODBucket::addRenderables(RenderQueue* queue,
@@ -1315,6 +1487,17 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::MaterialBucket::build(bool stencilShadows)
+    {
+        _loadMaterial();
+        // tell the geometry buckets to build
+        for (GeometryBucketList::iterator i = mGeometryBucketList.begin();
+            i != mGeometryBucketList.end(); ++i)
+        {
+            (*i)->build(stencilShadows);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::MaterialBucket::_loadMaterial(void)
     {
         mTechnique = 0;
         mMaterial = MaterialManager::getSingleton().getByName(mMaterialName);
@@ -1322,15 +1505,9 @@ namespace Ogre {
         {
             OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
                 "Material '" + mMaterialName + "' not found.",
-                "StaticGeometry::MaterialBucket::build");
+                "StaticGeometry::MaterialBucket::_loadMaterial");
         }
         mMaterial->load();
-        // tell the geometry buckets to build
-        for (GeometryBucketList::iterator i = mGeometryBucketList.begin();
-            i != mGeometryBucketList.end(); ++i)
-        {
-            (*i)->build(stencilShadows);
-        }
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::MaterialBucket::addRenderables(RenderQueue* queue,
@@ -1542,35 +1719,88 @@ namespace Ogre {
     }
     //--------------------------------------------------------------------------
     void StaticGeometry::GeometryBucket::build(bool stencilShadows)
+    {
+        _prepareBuild(stencilShadows, 0);
+        _createBuffers(stencilShadows);
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_readSources(SourceDataMap& sources) const
+    {
+        for (QueuedGeometryList::const_iterator gi = mQueuedGeometry.begin();
+            gi != mQueuedGeometry.end(); ++gi)
+        {
+            const SubMeshLodGeometryLink* geom = (*gi)->geometry;
+            HardwareIndexBuffer* ibuf = geom->indexData->indexBuffer.get();
+            if (sources.find(ibuf) == sources.end())
+            {
+                vector<uchar>::type& data = sources[ibuf];
+                data.resize(ibuf->getSizeInBytes());
+                ibuf->readData(0, data.size(), &data[0]);
+            }
+            const VertexBufferBinding::VertexBufferBindingMap& bindings =
+                geom->vertexData->vertexBufferBinding->getBindings();
+            for (VertexBufferBinding::VertexBufferBindingMap::const_iterator bi = bindings.begin();
+                bi != bindings.end(); ++bi)
+            {
+                HardwareVertexBuffer* vbuf = bi->second.get();
+                if (sources.find(vbuf) == sources.end())
+                {
+                    vector<uchar>::type& data = sources[vbuf];
+                    data.resize(vbuf->getSizeInBytes());
+                    vbuf->readData(0, data.size(), &data[0]);
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    const uchar* StaticGeometry::GeometryBucket::lockSource(HardwareBuffer* buf,
+        const SourceDataMap* sources)
+    {
+        if (!sources)
+            return static_cast<const uchar*>(buf->lock(HardwareBuffer::HBL_READ_ONLY));
+
+        SourceDataMap::const_iterator i = sources->find(buf);
+        assert(i != sources->end() && "Source buffer has not been read");
+        return &i->second[0];
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::unlockSource(HardwareBuffer* buf,
+        const SourceDataMap* sources)
+    {
+        if (!sources)
+            buf->unlock();
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_prepareBuild(bool stencilShadows,
+        const SourceDataMap* sources)
     {
         // Ok, here's where we transfer the vertices and indexes to the shared
-        // buffers
+        // buffers, in memory for now
         // Shortcuts
         VertexDeclaration* dcl = mVertexData->vertexDeclaration;
         VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
 
-        // create index buffer, and lock
-        mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
-            .createIndexBuffer(mIndexType, mIndexData->indexCount,
-                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        // allocate the indexes
+        size_t indexSize = mIndexType == HardwareIndexBuffer::IT_32BIT ?
+            sizeof(uint32) : sizeof(uint16);
+        mPendingIndexes.resize(mIndexData->indexCount * indexSize);
         uint32* p32Dest = 0;
         uint16* p16Dest = 0;
         if (mIndexType == HardwareIndexBuffer::IT_32BIT)
         {
-            p32Dest = static_cast<uint32*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            p32Dest = reinterpret_cast<uint32*>(&mPendingIndexes[0]);
         }
         else
         {
-            p16Dest = static_cast<uint16*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            p16Dest = reinterpret_cast<uint16*>(&mPendingIndexes[0]);
         }
-        // create all vertex buffers, and lock
+        // allocate all vertex buffers
         ushort b;
         ushort posBufferIdx = dcl->findElementBySemantic(VES_POSITION)->getSource();
 
         vector<uchar*>::type destBufferLocks;
         vector<VertexDeclaration::VertexElementList>::type bufferElements;
+        mPendingVertexBuffers.resize(binds->getBufferCount());
         for (b = 0; b < binds->getBufferCount(); ++b)
         {
             size_t vertexCount = mVertexData->vertexCount;
@@ -1583,15 +1813,8 @@ namespace Ogre {
                     "Index range exceeded when using stencil shadows, consider "
                     "reducing your region size or reducing poly count");
             }
-            HardwareVertexBufferSharedPtr vbuf =
-                HardwareBufferManager::getSingleton().createVertexBuffer(
-                    dcl->getVertexSize(b),
-                    vertexCount,
-                    HardwareBuffer::HBU_STATIC_WRITE_ONLY);
-            binds->setBinding(b, vbuf);
-            uchar* pLock = static_cast<uchar*>(
-                vbuf->lock(HardwareBuffer::HBL_DISCARD));
-            destBufferLocks.push_back(pLock);
+            mPendingVertexBuffers[b].resize(dcl->getVertexSize(b) * vertexCount);
+            destBufferLocks.push_back(&mPendingVertexBuffers[b][0]);
             // Pre-cache vertex elements per buffer
             bufferElements.push_back(dcl->findElementsBySource(b));
         }
@@ -1607,32 +1830,22 @@ namespace Ogre {
             QueuedGeometry* geom = *gi;
             // Copy indexes across with offset
             IndexData* srcIdxData = geom->geometry->indexData;
+            HardwareIndexBuffer* srcIdxBuf = srcIdxData->indexBuffer.get();
+            const uchar* pSrcIndexes = lockSource(srcIdxBuf, sources) +
+                srcIdxData->indexStart * srcIdxBuf->getIndexSize();
             if (mIndexType == HardwareIndexBuffer::IT_32BIT)
             {
-                // Lock source indexes
-                uint32* pSrc = static_cast<uint32*>(
-                    srcIdxData->indexBuffer->lock(
-                        srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                        srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                        HardwareBuffer::HBL_READ_ONLY));
-
-                copyIndexes(pSrc, p32Dest, srcIdxData->indexCount, indexOffset);
+                copyIndexes(reinterpret_cast<const uint32*>(pSrcIndexes), p32Dest,
+                    srcIdxData->indexCount, indexOffset);
                 p32Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
             else
             {
-                // Lock source indexes
-                uint16* pSrc = static_cast<uint16*>(
-                    srcIdxData->indexBuffer->lock(
-                    srcIdxData->indexStart * srcIdxData->indexBuffer->getIndexSize(), 
-                    srcIdxData->indexCount * srcIdxData->indexBuffer->getIndexSize(),
-                    HardwareBuffer::HBL_READ_ONLY));
-
-                copyIndexes(pSrc, p16Dest, srcIdxData->indexCount, indexOffset);
+                copyIndexes(reinterpret_cast<const uint16*>(pSrcIndexes), p16Dest,
+                    srcIdxData->indexCount, indexOffset);
                 p16Dest += srcIdxData->indexCount;
-                srcIdxData->indexBuffer->unlock();
             }
+            unlockSource(srcIdxBuf, sources);
 
             // Now deal with vertex buffers
             // we can rely on buffer counts / formats being the same
@@ -1641,10 +1854,8 @@ namespace Ogre {
             for (b = 0; b < binds->getBufferCount(); ++b)
             {
                 // lock source
-                HardwareVertexBufferSharedPtr srcBuf =
-                    srcBinds->getBuffer(b);
-                uchar* pSrcBase = static_cast<uchar*>(
-                    srcBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+                HardwareVertexBuffer* srcBuf = srcBinds->getBuffer(b).get();
+                const uchar* pSrcBase = lockSource(srcBuf, sources);
                 // Get buffer lock pointer, we'll update this later
                 uchar* pDstBase = destBufferLocks[b];
                 size_t bufInc = srcBuf->getVertexSize();
@@ -1661,7 +1872,7 @@ namespace Ogre {
                     for (ei = elems.begin(); ei != elems.end(); ++ei)
                     {
                         VertexElement& elem = *ei;
-                        elem.baseVertexPointerToElement(pSrcBase, &pSrcReal);
+                        elem.baseVertexPointerToElement(const_cast<uchar*>(pSrcBase), &pSrcReal);
                         elem.baseVertexPointerToElement(pDstBase, &pDstReal);
                         switch (elem.getSemantic())
                         {
@@ -1713,36 +1924,57 @@ namespace Ogre {
 
                 // Update pointer
                 destBufferLocks[b] = pDstBase;
-                srcBuf->unlock();
+                unlockSource(srcBuf, sources);
             }
 
             indexOffset += geom->geometry->vertexData->vertexCount;
         }
 
-        // Unlock everything
-        mIndexData->indexBuffer->unlock();
-        for (b = 0; b < binds->getBufferCount(); ++b)
-        {
-            binds->getBuffer(b)->unlock();
-        }
-
         // If we're dealing with stencil shadows, copy the position data from
         // the early half of the buffer to the latter part
         if (stencilShadows)
         {
-            HardwareVertexBufferSharedPtr buf = binds->getBuffer(posBufferIdx);
-            void* pSrc = buf->lock(HardwareBuffer::HBL_NORMAL);
-            // Point dest at second half (remember vertexcount is original count)
-            void* pDest = static_cast<uchar*>(pSrc) +
-                buf->getVertexSize() * mVertexData->vertexCount;
-            memcpy(pDest, pSrc, buf->getVertexSize() * mVertexData->vertexCount);
-            buf->unlock();
+            vector<uchar>::type& positions = mPendingVertexBuffers[posBufferIdx];
+            memcpy(&positions[positions.size() / 2], &positions[0], positions.size() / 2);
+        }
+    }
+    //--------------------------------------------------------------------------
+    void StaticGeometry::GeometryBucket::_createBuffers(bool stencilShadows)
+    {
+        VertexDeclaration* dcl = mVertexData->vertexDeclaration;
+        VertexBufferBinding* binds = mVertexData->vertexBufferBinding;
+
+        // create index buffer, and fill it
+        mIndexData->indexBuffer = HardwareBufferManager::getSingleton()
+            .createIndexBuffer(mIndexType, mIndexData->indexCount,
+                HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        mIndexData->indexBuffer->writeData(0, mPendingIndexes.size(),
+            &mPendingIndexes[0], true);
+        // create all vertex buffers, and fill them
+        for (ushort b = 0; b < mPendingVertexBuffers.size(); ++b)
+        {
+            size_t vertexSize = dcl->getVertexSize(b);
+            HardwareVertexBufferSharedPtr vbuf =
+                HardwareBufferManager::getSingleton().createVertexBuffer(
+                    vertexSize,
+                    mPendingVertexBuffers[b].size() / vertexSize,
+                    HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            binds->setBinding(b, vbuf);
+            vbuf->writeData(0, mPendingVertexBuffers[b].size(),
+                &mPendingVertexBuffers[b][0], true);
+        }
+        // Free the memory
+        vector<vector<uchar>::type>::type().swap(mPendingVertexBuffers);
+        vector<uchar>::type().swap(mPendingIndexes);
 
-            // Also set up hardware W buffer if appropriate
+        // Set up hardware W buffer for stencil shadows if appropriate
+        if (stencilShadows)
+        {
             RenderSystem* rend = Root::getSingleton().getRenderSystem();
             if (rend && rend->getCapabilities()->hasCapability(RSC_VERTEX_PROGRAM))
             {
-                buf = HardwareBufferManager::getSingleton().createVertexBuffer(
+                HardwareVertexBufferSharedPtr buf = 
+                    HardwareBufferManager::getSingleton().createVertexBuffer(
                     sizeof(float), mVertexData->vertexCount * 2,
                     HardwareBuffer::HBU_STATIC_WRITE_ONLY, false);
                 // Fill the first half with 1.0, second half with 0.0
@@ -133,6 +133,49 @@ namespace Ogre {
         return dest;
     }
     //-----------------------------------------------------------------------
+    void VertexData::transferBuffers(HardwareBufferManagerBase* mgr, bool useShadowBuffers)
+    {
+        if (mgr == mMgr)
+            return;
+
+        VertexDeclaration* newDeclaration = vertexDeclaration->clone(mgr);
+        VertexBufferBinding* newBinding = mgr->createVertexBufferBinding();
+
+        const VertexBufferBinding::VertexBufferBindingMap& bindings = vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator i, iend;
+        iend = bindings.end();
+        for (i = bindings.begin(); i != iend; ++i)
+        {
+            const HardwareVertexBufferSharedPtr& srcbuf = i->second;
+            HardwareVertexBufferSharedPtr dstbuf = mgr->createVertexBuffer(
+                srcbuf->getVertexSize(), srcbuf->getNumVertices(), srcbuf->getUsage(),
+                useShadowBuffers);
+            dstbuf->copyData(*srcbuf.get());
+            newBinding->setBinding(i->first, dstbuf);
+        }
+
+        if (!hardwareShadowVolWBuffer.isNull())
+        {
+            HardwareVertexBufferSharedPtr dstbuf = mgr->createVertexBuffer(
+                hardwareShadowVolWBuffer->getVertexSize(), hardwareShadowVolWBuffer->getNumVertices(),
+                hardwareShadowVolWBuffer->getUsage(), false);
+            dstbuf->copyData(*hardwareShadowVolWBuffer.get());
+            hardwareShadowVolWBuffer = dstbuf;
+        }
+
+        // The old declaration and binding belong to the old manager
+        if (mDeleteDclBinding)
+        {
+            mMgr->destroyVertexBufferBinding(vertexBufferBinding);
+            mMgr->destroyVertexDeclaration(vertexDeclaration);
+        }
+
+        vertexDeclaration = newDeclaration;
+        vertexBufferBinding = newBinding;
+        mMgr = mgr;
+        mDeleteDclBinding = true; // because we created these through a manager
+    }
+    //-----------------------------------------------------------------------
     void VertexData::prepareForShadowVolume(void)
     {
         /* NOTE
@@ -45,6 +45,13 @@ namespace Ogre {
         return i->second;
     }
     //---------------------------------------------------------------------
+    void WorkQueue::parallelFor(ParallelTask* task, size_t count, size_t grainSize)
+    {
+        (void)grainSize;
+        if (count)
+            task->execute(0, count);
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
         : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
     {
@@ -83,6 +90,8 @@ namespace Ogre {
         , mIdleThreadRunning(false)
         , mIdleProcessed(0)
     {
+        mParallelForChannel = getChannel("Ogre/ParallelFor");
+        addRequestHandler(mParallelForChannel, &mParallelForHandler);
     }
     //---------------------------------------------------------------------
     const String& DefaultWorkQueueBase::getName() const
@@ -577,6 +586,63 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::parallelFor(ParallelTask* task, size_t count, size_t grainSize)
+    {
+        grainSize = std::max(grainSize, (size_t)1);
+        size_t numChunks = (count + grainSize - 1) / grainSize;
+
+        if (!OGRE_THREAD_SUPPORT || !mIsRunning || mPaused || !mAcceptRequests ||
+            mShuttingDown || !mWorkerThreadCount || numChunks < 2)
+        {
+            // nobody to share with, just do it here
+            WorkQueue::parallelFor(task, count, grainSize);
+            return;
+        }
+
+        ParallelForStatePtr state(OGRE_NEW ParallelForState());
+        state->mTask = task;
+        state->mCount = count;
+        state->mGrainSize = grainSize;
+        state->mNumChunks = numChunks;
+        state->mNextChunk.set(0);
+        state->mCompletedChunks.set(0);
+
+        // One request per helper is enough, each one keeps claiming chunks
+        // until they run out. Requests picked up after that do nothing.
+        size_t numHelpers = std::min(mWorkerThreadCount, numChunks - 1);
+        for (size_t i = 0; i < numHelpers; ++i)
+            addRequest(mParallelForChannel, 0, Any(state));
+
+        state->run();
+
+        // wait for chunks still being processed by the workers
+        while (state->mCompletedChunks.get() < numChunks)
+        {
+            OGRE_THREAD_YIELD;
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::ParallelForState::run()
+    {
+        size_t chunk;
+        while ((chunk = mNextChunk++) < mNumChunks)
+        {
+            size_t begin = chunk * mGrainSize;
+            size_t end = std::min(begin + mGrainSize, mCount);
+            mTask->execute(begin, end);
+            ++mCompletedChunks;
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* DefaultWorkQueueBase::ParallelForHandler::handleRequest(
+        const Request* req, const WorkQueue* srcQ)
+    {
+        (void)srcQ;
+        ParallelForStatePtr state = any_cast<ParallelForStatePtr>(req->getData());
+        state->run();
+        return OGRE_NEW Response(req, true, Any());
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponses() 
     {
         unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
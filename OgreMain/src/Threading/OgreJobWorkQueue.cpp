@@ -0,0 +1,520 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreJobWorkQueue.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /** Job processing a range of chunks of a parallelFor, which hands the
+            second half of its range to other threads until only one chunk is
+            left. */
+        class RangeJob : public JobWorkQueue::Job
+        {
+        public:
+            JobWorkQueue* queue;
+            WorkQueue::ParallelTask* task;
+            JobWorkQueue::JobCounter* counter;
+            /// All the jobs of the parallelFor, one per chunk at most
+            RangeJob* pool;
+            AtomicScalar<size_t>* nextInPool;
+            size_t count;
+            size_t grainSize;
+            size_t beginChunk;
+            size_t endChunk;
+
+            void execute()
+            {
+                while (endChunk - beginChunk > 1)
+                {
+                    size_t middle = beginChunk + (endChunk - beginChunk) / 2;
+                    RangeJob* other = &pool[(*nextInPool)++];
+                    *other = *this;
+                    other->beginChunk = middle;
+                    endChunk = middle;
+                    queue->addJob(other, counter);
+                }
+                size_t begin = beginChunk * grainSize;
+                task->execute(begin, std::min(begin + grainSize, count));
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::JobCounter::JobCounter()
+        : mCount(0), mSignalling(0), mWaiting(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::JobCounter::~JobCounter()
+    {
+        assert(isDone() && "Destroying a counter with jobs still to run");
+    }
+    //---------------------------------------------------------------------
+    bool JobWorkQueue::JobDeque::push(Job* job)
+    {
+        ptrdiff_t bottom = mBottom.get();
+        if (bottom - mTop.get() >= CAPACITY)
+            return false;
+
+        mJobs[bottom & (CAPACITY - 1)] = job;
+        // atomic, so the job is visible before the new bottom
+        ++mBottom;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::Job* JobWorkQueue::JobDeque::pop()
+    {
+        // claim the bottom slot before looking at the top, which thieves move
+        ptrdiff_t bottom = --mBottom;
+        ptrdiff_t top = mTop.get();
+        if (bottom < top)
+        {
+            // was empty
+            mBottom.set(bottom + 1);
+            return 0;
+        }
+
+        Job* job = mJobs[bottom & (CAPACITY - 1)];
+        if (bottom == top)
+        {
+            // last one, race the thieves for it
+            if (!mTop.cas(top, top + 1))
+                job = 0;
+            mBottom.set(top + 1);
+        }
+        return job;
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::Job* JobWorkQueue::JobDeque::steal()
+    {
+        ptrdiff_t top = mTop.get();
+        ptrdiff_t bottom = mBottom.get();
+        if (bottom <= top)
+            return 0;
+
+        Job* job = mJobs[top & (CAPACITY - 1)];
+        if (!mTop.cas(top, top + 1))
+            return 0;
+        return job;
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::JobWorkQueue(const String& name)
+        : DefaultWorkQueueBase(name)
+        , mSharedJobCount(0)
+        , mNextWorkerIndex(0)
+        , mStartedWorkers(0)
+        , mStealSeed(0)
+        , mWorkSignal(0)
+        , mSleepingWorkers(0)
+        , mNumThreadsRegisteredWithRS(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::~JobWorkQueue()
+    {
+        shutdown();
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::startup(bool forceRestart)
+    {
+        if (mIsRunning)
+        {
+            if (forceRestart)
+                shutdown();
+            else
+                return;
+        }
+
+        mShuttingDown = false;
+
+        mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
+
+        LogManager::getSingleton().stream() <<
+            "JobWorkQueue('" << mName << "') initialising on thread " <<
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_CURRENT_ID
+#else
+            "main"
+#endif
+            << ".";
+
+#if OGRE_THREAD_SUPPORT
+        // The deques must all exist, and know their thread, before any job is added
+        for (size_t i = 0; i <= mWorkerThreadCount; ++i)
+            mDeques.push_back(OGRE_NEW JobDeque());
+        mDeques[0]->mThread = OGRE_THREAD_CURRENT_ID;
+        mNextWorkerIndex.set(1);
+        mStartedWorkers.set(0);
+
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+        mNumThreadsRegisteredWithRS = 0;
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+        {
+            OGRE_THREAD_CREATE(t, *mWorkerFunc);
+            mWorkers.push_back(t);
+        }
+
+        while (mStartedWorkers.get() < mWorkerThreadCount)
+            OGRE_THREAD_YIELD;
+
+        if (mWorkerRenderSystemAccess)
+        {
+            OGRE_LOCK_MUTEX_NAMED(mInitMutex, initLock);
+            // have to wait until all threads are registered with the render system
+            while (mNumThreadsRegisteredWithRS < mWorkerThreadCount)
+                OGRE_THREAD_WAIT(mInitSync, mInitMutex, initLock);
+
+            Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+        }
+#endif
+
+        mIsRunning = true;
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::shutdown()
+    {
+        if (!mIsRunning)
+            return;
+
+        LogManager::getSingleton().stream() <<
+            "JobWorkQueue('" << mName << "') shutting down on thread " <<
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_CURRENT_ID
+#else
+            "main"
+#endif
+            << ".";
+
+        mShuttingDown = true;
+        abortAllRequests();
+#if OGRE_THREAD_SUPPORT
+        ++mWorkSignal;
+        {
+            OGRE_LOCK_MUTEX(mSleepMutex);
+            OGRE_THREAD_NOTIFY_ALL(mSleepCondition);
+        }
+
+        for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            (*i)->join();
+            OGRE_THREAD_DESTROY(*i);
+        }
+        mWorkers.clear();
+
+        // Jobs may be waited for, so finish the ones left here
+        while (Job* job = findJob(0))
+            runJob(job);
+#endif
+        mIsRunning = false;
+
+        for (JobDequeList::iterator i = mDeques.begin(); i != mDeques.end(); ++i)
+            OGRE_DELETE *i;
+        mDeques.clear();
+
+        OGRE_DELETE_T(mWorkerFunc, WorkerFunc, MEMCATEGORY_GENERAL);
+        mWorkerFunc = 0;
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::_threadMain()
+    {
+#if OGRE_THREAD_SUPPORT
+        size_t index = mNextWorkerIndex++;
+        mDeques[index]->mThread = OGRE_THREAD_CURRENT_ID;
+        ++mStartedWorkers;
+
+        LogManager::getSingleton().stream() <<
+            "JobWorkQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " starting.";
+
+        // Initialise the thread for RS if necessary
+        if (mWorkerRenderSystemAccess)
+        {
+            Root::getSingleton().getRenderSystem()->registerThread();
+            OGRE_LOCK_MUTEX(mInitMutex);
+            ++mNumThreadsRegisteredWithRS;
+            OGRE_THREAD_NOTIFY_ALL(mInitSync);
+        }
+
+        while (!isShuttingDown())
+        {
+            // Any work added after this is noticed before sleeping
+            size_t signal = mWorkSignal.get();
+
+            if (Job* job = findJob(index))
+            {
+                runJob(job);
+                continue;
+            }
+            if (processNextRequest())
+                continue;
+
+            OGRE_LOCK_MUTEX_NAMED(mSleepMutex, sleepLock);
+            ++mSleepingWorkers;
+            if (!isShuttingDown() && mWorkSignal.get() == signal)
+                OGRE_THREAD_WAIT(mSleepCondition, mSleepMutex, sleepLock);
+            --mSleepingWorkers;
+        }
+
+        LogManager::getSingleton().stream() <<
+            "JobWorkQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " stopped.";
+#endif
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::_processNextRequest()
+    {
+        processNextRequest();
+    }
+    //---------------------------------------------------------------------
+    bool JobWorkQueue::processNextRequest()
+    {
+        if (processIdleRequests())
+            return true;
+
+        Request* request = 0;
+        {
+            OGRE_LOCK_MUTEX(mProcessMutex);
+            {
+                OGRE_LOCK_MUTEX(mRequestMutex);
+
+                if (!mRequestQueue.empty())
+                {
+                    request = mRequestQueue.front();
+                    mRequestQueue.pop_front();
+                    mProcessQueue.push_back(request);
+                }
+            }
+        }
+
+        if (!request)
+            return false;
+
+        processRequestResponse(request, false);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::notifyWorkers()
+    {
+        // Called with mRequestMutex held, which the workers never take while
+        // holding mSleepMutex
+        wakeWorker();
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::wakeWorker()
+    {
+#if OGRE_THREAD_SUPPORT
+        ++mWorkSignal;
+        if (mSleepingWorkers.get() > 0)
+        {
+            OGRE_LOCK_MUTEX(mSleepMutex);
+            OGRE_THREAD_NOTIFY_ONE(mSleepCondition);
+        }
+#endif
+    }
+    //---------------------------------------------------------------------
+    size_t JobWorkQueue::getThreadDequeIndex() const
+    {
+#if OGRE_THREAD_SUPPORT
+        OGRE_THREAD_ID_TYPE current = OGRE_THREAD_CURRENT_ID;
+        for (size_t i = 0; i < mDeques.size(); ++i)
+        {
+            if (mDeques[i]->mThread == current)
+                return i;
+        }
+#endif
+        return mDeques.size();
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::addJob(Job* job, JobCounter* counter, JobCounter* dependency)
+    {
+        job->mCounter = counter;
+        job->mNextWaiting = 0;
+        if (counter)
+            ++counter->mCount;
+
+        if (dependency)
+        {
+            OGRE_LOCK_MUTEX(dependency->mWaitingMutex);
+            if (dependency->mCount.get() != 0)
+            {
+                // released by the last job of the dependency
+                job->mNextWaiting = dependency->mWaiting;
+                dependency->mWaiting = job;
+                return;
+            }
+        }
+
+        pushJob(job);
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::pushJob(Job* job)
+    {
+        if (!OGRE_THREAD_SUPPORT || !mIsRunning || mShuttingDown)
+        {
+            runJob(job);
+            return;
+        }
+
+        size_t index = getThreadDequeIndex();
+        if (index < mDeques.size())
+        {
+            if (!mDeques[index]->push(job))
+            {
+                // full, no point in adding more
+                runJob(job);
+                return;
+            }
+        }
+        else
+        {
+            OGRE_LOCK_MUTEX(mSharedJobsMutex);
+            mSharedJobs.push_back(job);
+            ++mSharedJobCount;
+        }
+
+        wakeWorker();
+    }
+    //---------------------------------------------------------------------
+    JobWorkQueue::Job* JobWorkQueue::findJob(size_t dequeIndex)
+    {
+        if (dequeIndex < mDeques.size())
+        {
+            if (Job* job = mDeques[dequeIndex]->pop())
+                return job;
+        }
+
+        if (mSharedJobCount.get() > 0)
+        {
+            OGRE_LOCK_MUTEX(mSharedJobsMutex);
+            if (!mSharedJobs.empty())
+            {
+                Job* job = mSharedJobs.front();
+                mSharedJobs.pop_front();
+                --mSharedJobCount;
+                return job;
+            }
+        }
+
+        size_t numDeques = mDeques.size();
+        size_t start = mStealSeed++;
+        for (size_t i = 0; i < numDeques; ++i)
+        {
+            size_t victim = (start + i) % numDeques;
+            if (victim == dequeIndex)
+                continue;
+            if (Job* job = mDeques[victim]->steal())
+                return job;
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::runJob(Job* job)
+    {
+        // the job may be destroyed as soon as its counter is done
+        JobCounter* counter = job->mCounter;
+        job->execute();
+        if (counter)
+            signalCounter(counter);
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::signalCounter(JobCounter* counter)
+    {
+        // Keep the counter from looking done, and being destroyed, until the
+        // jobs waiting for it are released
+        ++counter->mSignalling;
+        if (--counter->mCount == 0)
+        {
+            Job* waiting;
+            {
+                OGRE_LOCK_MUTEX(counter->mWaitingMutex);
+                waiting = counter->mWaiting;
+                counter->mWaiting = 0;
+            }
+            while (waiting)
+            {
+                Job* next = waiting->mNextWaiting;
+                pushJob(waiting);
+                waiting = next;
+            }
+        }
+        --counter->mSignalling;
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::waitForCounter(JobCounter* counter)
+    {
+        size_t index = getThreadDequeIndex();
+        while (!counter->isDone())
+        {
+            if (Job* job = findJob(index))
+                runJob(job);
+            else
+                OGRE_THREAD_YIELD;
+        }
+    }
+    //---------------------------------------------------------------------
+    void JobWorkQueue::parallelFor(ParallelTask* task, size_t count, size_t grainSize)
+    {
+        grainSize = std::max(grainSize, (size_t)1);
+        size_t numChunks = (count + grainSize - 1) / grainSize;
+
+        if (!OGRE_THREAD_SUPPORT || !mIsRunning || mShuttingDown ||
+            !mWorkerThreadCount || numChunks < 2)
+        {
+            // nobody to share with, just do it here
+            WorkQueue::parallelFor(task, count, grainSize);
+            return;
+        }
+
+        // Every split makes one more job, so there are at most as many jobs
+        // as chunks
+        vector<RangeJob>::type jobs(numChunks);
+        AtomicScalar<size_t> nextInPool(1);
+        JobCounter counter;
+
+        RangeJob& first = jobs[0];
+        first.queue = this;
+        first.task = task;
+        first.counter = &counter;
+        first.pool = &jobs[0];
+        first.nextInPool = &nextInPool;
+        first.count = count;
+        first.grainSize = grainSize;
+        first.beginChunk = 0;
+        first.endChunk = numChunks;
+
+        addJob(&first, &counter);
+        waitForCounter(&counter);
+    }
+
+}
@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgrePlane.h"
 
 #include <directxmath.h>
 using namespace DirectX;
@@ -159,6 +160,15 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes,
+            size_t numPlanes,
+            const Vector3* centres,
+            const Vector3* halfSizes,
+            uint32* visibilityMask,
+            size_t numBoxes);
     };
 
 //---------------------------------------------------------------------
@@ -2032,6 +2042,51 @@ static OGRE_FORCE_INLINE bool _isAlignedForDirectXMath(const void *p)
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::cullAxisAlignedBoxes(
+        const Plane* planes,
+        size_t numPlanes,
+        const Vector3* centres,
+        const Vector3* halfSizes,
+        uint32* visibilityMask,
+        size_t numBoxes)
+    {
+        uint32 mask = 0;
+        uint32 bit = 1;
+        for (size_t box = 0; box < numBoxes; ++box)
+        {
+            XMVECTOR centre = XMLoadFloat3((const XMFLOAT3*)&centres[box]);
+            XMVECTOR halfSize = XMLoadFloat3((const XMFLOAT3*)&halfSizes[box]);
+
+            bool visible = true;
+            for (size_t plane = 0; plane < numPlanes; ++plane)
+            {
+                XMVECTOR normal = XMLoadFloat3((const XMFLOAT3*)&planes[plane].normal);
+                XMVECTOR dist = XMVectorAdd(XMVector3Dot(normal, centre),
+                    XMVectorReplicate(planes[plane].d));
+                XMVECTOR maxAbsDist = XMVector3Dot(XMVectorAbs(normal), halfSize);
+                if (XMVectorGetX(dist) < -XMVectorGetX(maxAbsDist))
+                {
+                    visible = false;
+                    break;
+                }
+            }
+
+            if (visible)
+                mask |= bit;
+
+            bit <<= 1;
+            if (!bit)
+            {
+                *visibilityMask++ = mask;
+                mask = 0;
+                bit = 1;
+            }
+        }
+
+        if (bit != 1)
+            *visibilityMask = mask;
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void)
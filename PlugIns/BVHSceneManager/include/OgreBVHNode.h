@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHNode_H__
+#define __BVHNode_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneNode.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    *  @{
+    */
+    /** Specialised SceneNode which is kept in the bounding volume hierarchy of
+        a BVHSceneManager.
+    @remarks
+        As with the OctreeNode, the bounds of a BVHNode only cover its own
+        attached objects and not its children, since every node is a separate
+        leaf of the hierarchy.
+    */
+    class _OgreBVHPluginExport BVHNode : public SceneNode
+    {
+    public:
+        /** Standard constructor */
+        BVHNode(SceneManager* creator);
+        /** Standard constructor */
+        BVHNode(SceneManager* creator, const String& name);
+        /** Standard destructor */
+        ~BVHNode();
+
+        /** Overridden from Node to remove the node from the hierarchy */
+        Node* removeChild(unsigned short index);
+
+        /** Overridden from Node to remove the node from the hierarchy */
+        Node* removeChild(const String& name);
+
+        /** Overridden from Node to remove the node from the hierarchy */
+        Node* removeChild(Node* child);
+
+        /** Overridden from Node to remove the node from the hierarchy */
+        void removeAllChildren(void);
+
+        /** Gets the id of the proxy of this node in the hierarchy, or
+            BVHTree::NULL_NODE if it is not in it.
+        */
+        int32 getProxyId(void) const { return mProxyId; }
+
+        /** Sets the id of the proxy of this node in the hierarchy, internal method. */
+        void setProxyId(int32 proxyId) { mProxyId = proxyId; }
+
+        /** Gets whether this node has infinite bounds and is kept outside the hierarchy. */
+        bool isUnbounded(void) const { return mUnbounded; }
+
+        /** Sets whether this node has infinite bounds, internal method. */
+        void setUnbounded(bool unbounded) { mUnbounded = unbounded; }
+
+        /** Adds the attached objects of this node to the render queue. */
+        void _addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+            VisibleObjectsBoundsInfo* visibleBounds);
+
+    protected:
+        /** Internal method for updating the bounds for this BVHNode.
+        @remarks
+            This method determines the bounds solely from the attached objects,
+            not any children, and then updates the node in the hierarchy.
+        */
+        void _updateBounds(void);
+
+        void _removeNodeAndChildren(void);
+
+        /// Id of the proxy in the hierarchy
+        int32 mProxyId;
+        /// Whether the node is in the list of nodes with infinite bounds
+        bool mUnbounded;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,201 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHSceneManager_H__
+#define __BVHSceneManager_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreSceneManager.h"
+#include "OgreBVHTree.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \addtogroup BVH BVHSceneManager
+    *  @{
+    */
+    class BVHNode;
+
+    /** Specialised SceneManager which keeps the scene nodes in a dynamic 
+        bounding volume hierarchy, to speed up culling and spatial queries.
+    @remarks
+        Unlike the octree, the hierarchy adapts to the scene and has no fixed
+        extent or depth. Every node with attached objects is a leaf of a BVHTree,
+        which only needs updating when a node leaves the enlarged box it was last
+        inserted with. Once a large number of nodes has been added since the
+        last time, typically when a level or other static content is loaded, the
+        tree is rebuilt with a surface area heuristic before it is next used.
+    @par
+        Nodes with infinite bounds are kept in a separate list and are always
+        considered visible.
+    */
+    class _OgreBVHPluginExport BVHSceneManager : public SceneManager
+    {
+        friend class BVHRaySceneQuery;
+        friend class BVHSphereSceneQuery;
+        friend class BVHAxisAlignedBoxSceneQuery;
+        friend class BVHPlaneBoundedVolumeListSceneQuery;
+
+    public:
+        typedef vector<BVHNode*>::type BVHNodeList;
+
+        /** Standard constructor. */
+        BVHSceneManager(const String& name);
+        /** Standard destructor. */
+        ~BVHSceneManager();
+
+        /// @copydoc SceneManager::getTypeName
+        const String& getTypeName(void) const;
+
+        /** Creates a specialised BVHNode */
+        SceneNode* createSceneNodeImpl(void);
+        /** Creates a specialised BVHNode */
+        SceneNode* createSceneNodeImpl(const String& name);
+
+        /** Deletes a scene node */
+        void destroySceneNode(const String& name);
+
+        /** Updates the scene graph, then rebuilds the hierarchy if enough nodes
+            have been added since the last build. */
+        void _updateSceneGraph(Camera* cam);
+
+        /** Walks the hierarchy, adding the objects of the visible nodes to the render queue. */
+        void _findVisibleObjects(Camera* cam, 
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+
+        /** Adds, moves or removes the given node in the hierarchy according to
+            its bounds, internal method. */
+        void _updateBVHNode(BVHNode* node);
+
+        /** Removes the given node from the hierarchy, internal method. */
+        void _removeBVHNode(BVHNode* node);
+
+        /** Rebuilds the whole hierarchy using the surface area heuristic.
+        @remarks
+            This is done automatically unless disabled with the "AutoRebuild"
+            option, but can also be called when it is known that the bulk of the
+            scene has just been set up.
+        */
+        void rebuildTree(void);
+
+        /** Gets the hierarchy of the scene nodes. */
+        const BVHTree& getTree(void) const { return *mTree; }
+
+        /** Finds the nodes whose bounds intersect the given box.
+        @remarks
+            The results are based on the enlarged boxes of the nodes, so they may
+            include nodes which do not intersect the box, but never miss any. Nodes
+            with infinite bounds are always included.
+        */
+        void findNodesIn(const AxisAlignedBox& box, BVHNodeList& list);
+
+        /** Finds the nodes whose bounds intersect the given sphere. */
+        void findNodesIn(const Sphere& sphere, BVHNodeList& list);
+
+        /** Finds the nodes whose bounds intersect the given volume. */
+        void findNodesIn(const PlaneBoundedVolume& volume, BVHNodeList& list);
+
+        /** Finds the nodes whose bounds are hit by the given ray. */
+        void findNodesIn(const Ray& ray, BVHNodeList& list);
+
+        /** Sets the given option for the SceneManager.
+        @remarks
+            Options are:
+            "Margin", Real *, the fraction of their size by which the boxes of
+                the nodes are enlarged in the hierarchy;
+            "AutoRebuild", bool *, whether the hierarchy is rebuilt once many
+                nodes have been added.
+            The read only options "TreeHeight", int *, and "NodeCount", int *,
+            can be used to inspect the hierarchy.
+        */
+        bool setOption(const String& key, const void* val);
+        /** Gets the given option for the SceneManager.
+        @remarks
+            See setOption
+        */
+        bool getOption(const String& key, void* val);
+
+        bool hasOption(const String& key) const;
+        bool getOptionValues(const String& key, StringVector& refValueList);
+        bool getOptionKeys(StringVector& refKeys);
+
+        /** Overridden from SceneManager */
+        void clearScene(void);
+
+        AxisAlignedBoxSceneQuery* createAABBQuery(const AxisAlignedBox& box, uint32 mask);
+        SphereSceneQuery* createSphereQuery(const Sphere& sphere, uint32 mask);
+        PlaneBoundedVolumeListSceneQuery* createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes, uint32 mask);
+        RaySceneQuery* createRayQuery(const Ray& ray, uint32 mask);
+
+    protected:
+        typedef set<BVHNode*>::type BVHNodeSet;
+
+        /// The hierarchy of the nodes with finite bounds
+        BVHTree* mTree;
+        /// Nodes with infinite bounds, which are not in the hierarchy
+        BVHNodeSet mUnboundedNodes;
+        /// Whether to rebuild the hierarchy once many nodes have been added
+        bool mAutoRebuild;
+        /// Number of nodes added to the hierarchy since it was last rebuilt
+        size_t mInsertedSinceRebuild;
+
+        /// Scratch lists for the results of the hierarchy
+        BVHTree::ResultList mInside;
+        BVHTree::ResultList mIntersecting;
+        /// Scratch arrays for testing the bounds of the nodes against the camera
+        vector<Vector3>::type mCentres;
+        vector<Vector3>::type mHalfSizes;
+        vector<uint32>::type mVisibilityMask;
+
+        /// Appends the nodes in the results of the hierarchy to the list
+        void appendNodes(const BVHTree::ResultList& results, BVHNodeList& list) const;
+
+        /// Adds the objects of a visible node to the render queue
+        void addVisibleNode(BVHNode* node, Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+    };
+
+    /// Factory for BVHSceneManager
+    class BVHSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData(void) const;
+    public:
+        BVHSceneManagerFactory() {}
+        ~BVHSceneManagerFactory() {}
+        /// Factory type name
+        static const String FACTORY_TYPE_NAME;
+        SceneManager* createInstance(const String& instanceName);
+        void destroyInstance(SceneManager* instance);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BVHTree_H__
+#define __BVHTree_H__
+
+#include "OgreBVHPrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins Plugins
+    *  @{
+    */
+    /** \defgroup BVH BVHSceneManager
+    * Bounding volume hierarchy for managing scene nodes.
+    *  @{
+    */
+    /** Dynamic bounding volume hierarchy of axis aligned boxes.
+    @remarks
+        The tree is a binary hierarchy stored in a flat array of nodes, which
+        are linked by index rather than by pointer and recycled through a free
+        list, so the whole tree lives in one block of memory. Each leaf is a
+        proxy for an object of the caller, and stores a box enlarged by a 
+        margin; as long as the object stays inside that box, moving it does not
+        touch the tree at all.
+    @par
+        Leaves are inserted next to the sibling which gives the smallest
+        increase in surface area, and the ancestors are refitted and rotated
+        on the way back up to keep the tree balanced. This keeps updates
+        cheap, but the tree built this way is not as good as one built with
+        all the leaves known up front, so rebuild() rebuilds the whole hierarchy
+        top-down using a binned surface area heuristic (SAH). This is meant to
+        be called once bulk or static content has been added.
+    @par
+        Proxy ids are the indices of the leaves and stay valid until the proxy
+        is destroyed, even across a rebuild.
+    */
+    class _OgreBVHPluginExport BVHTree : public SceneMgtAlloc
+    {
+    public:
+        /// Id which does not refer to any node
+        static const int32 NULL_NODE = -1;
+
+        /// List of user data pointers returned by queries
+        typedef vector<void*>::type ResultList;
+
+        BVHTree();
+        ~BVHTree();
+
+        /** Adds a proxy for a box to the tree.
+        @param box The finite, non-null box of the object.
+        @param userData Pointer returned by queries for this proxy.
+        @return The id of the proxy.
+        */
+        int32 createProxy(const AxisAlignedBox& box, void* userData);
+
+        /** Removes a proxy from the tree. */
+        void destroyProxy(int32 proxyId);
+
+        /** Updates the box of a proxy.
+        @remarks
+            The proxy is only moved within the tree if the new box is not
+            contained by its enlarged box.
+        @return true if the proxy had to be moved.
+        */
+        bool moveProxy(int32 proxyId, const AxisAlignedBox& box);
+
+        /** Gets the user data of a proxy. */
+        void* getUserData(int32 proxyId) const { return mNodes[proxyId].userData; }
+
+        /** Gets the enlarged box stored for a proxy. */
+        AxisAlignedBox getFatBox(int32 proxyId) const;
+
+        /** Removes all the proxies. */
+        void clear(void);
+
+        /** Rebuilds the hierarchy from scratch using a binned SAH build.
+        @remarks
+            Proxy ids and enlarged boxes are kept, only the inner nodes are 
+            rebuilt.
+        */
+        void rebuild(void);
+
+        /** Sets the margin by which the box of a proxy is enlarged, as a fraction
+            of its size along each axis.
+        @remarks
+            Larger margins mean objects can move further before the tree needs
+            to be updated, at the price of looser culling. Only affects proxies
+            which are created or moved afterwards.
+        */
+        void setMargin(Real margin) { mMargin = margin; }
+
+        /** Gets the margin by which the box of a proxy is enlarged. */
+        Real getMargin(void) const { return mMargin; }
+
+        /** Gets the number of proxies in the tree. */
+        size_t getProxyCount(void) const { return mProxyCount; }
+
+        /** Gets the height of the tree, a tree with a single leaf has height 0. */
+        int32 getHeight(void) const;
+
+        /** Gets the summed surface area of all the nodes relative to the surface
+            area of the root, the lower the better.
+        @remarks
+            This is proportional to the expected number of nodes visited by a
+            random query and is a measure of the quality of the tree.
+        */
+        Real getAreaRatio(void) const;
+
+        /** Checks the structure of the tree, for debugging.
+        @return true if every link, height and box in the tree is consistent.
+        */
+        bool validate(void) const;
+
+        /** Finds the proxies whose enlarged box intersects the given box. */
+        void findProxies(const AxisAlignedBox& box, ResultList& results) const;
+
+        /** Finds the proxies whose enlarged box intersects the given sphere. */
+        void findProxies(const Sphere& sphere, ResultList& results) const;
+
+        /** Finds the proxies whose enlarged box is hit by the given ray. */
+        void findProxies(const Ray& ray, ResultList& results) const;
+
+        /** Finds the proxies whose enlarged box is not entirely on the negative
+            side of any of the given planes.
+        @remarks
+            This is the test used for frustum culling and plane bounded volumes.
+            Subtrees which are entirely on the positive side of a plane are not
+            tested against it again, and the proxies of subtrees on the positive 
+            side of all planes are returned without any more tests.
+        @param planes The planes to test against, the volume is on their positive side.
+        @param numPlanes The number of planes, at most 32.
+        @param inside Receives the proxies which are entirely within the volume.
+        @param intersecting Receives the other proxies, which may intersect the volume.
+        */
+        void findProxies(const Plane* planes, size_t numPlanes, 
+            ResultList& inside, ResultList& intersecting) const;
+
+    protected:
+        /// Node of the tree, a leaf when child1 is NULL_NODE
+        struct TreeNode
+        {
+            /// Enlarged box of a leaf, or the union of the children
+            Vector3 minimum;
+            Vector3 maximum;
+            void* userData;
+            /// Parent node, or next free node when on the free list
+            int32 parent;
+            int32 child1;
+            int32 child2;
+            /// Height of the subtree, 0 for leaves and -1 for free nodes
+            int32 height;
+
+            bool isLeaf(void) const { return child1 == NULL_NODE; }
+        };
+        typedef vector<TreeNode>::type NodeArray;
+        typedef vector<int32>::type IndexList;
+
+        NodeArray mNodes;
+        int32 mRoot;
+        int32 mFreeList;
+        size_t mProxyCount;
+        Real mMargin;
+
+        int32 allocateNode(void);
+        void freeNode(int32 index);
+        void setFatBox(TreeNode& node, const AxisAlignedBox& box) const;
+        void insertLeaf(int32 leaf);
+        void removeLeaf(int32 leaf);
+        /// Refits and rebalances the ancestors, starting at the given node
+        void refitUpwards(int32 index);
+        /// Performs a rotation at the given node if it is unbalanced, returns the new subtree root
+        int32 balance(int32 index);
+        /// Builds a subtree over the given leaves, returns its root
+        int32 buildSAH(int32* leaves, size_t count);
+        /// Adds the user data of every proxy in the subtree to the results
+        void collectProxies(int32 index, ResultList& results) const;
+        bool validate(int32 index, int32 parent) const;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
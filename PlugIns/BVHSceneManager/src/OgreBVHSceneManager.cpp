@@ -0,0 +1,434 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHSceneManager.h"
+#include "OgreBVHNode.h"
+#include "OgreBVHSceneQuery.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+#include "OgreStringConverter.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Number of added nodes below which the hierarchy is never rebuilt automatically
+        const size_t AUTO_REBUILD_MIN_INSERTED = 64;
+    }
+    //-----------------------------------------------------------------------
+    BVHSceneManager::BVHSceneManager(const String& name)
+        : SceneManager(name)
+        , mTree(OGRE_NEW BVHTree())
+        , mAutoRebuild(true)
+        , mInsertedSinceRebuild(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BVHSceneManager::~BVHSceneManager()
+    {
+        // The nodes are destroyed by the base class, after the hierarchy
+        OGRE_DELETE mTree;
+        mTree = 0;
+    }
+    //-----------------------------------------------------------------------
+    const String& BVHSceneManager::getTypeName(void) const
+    {
+        return BVHSceneManagerFactory::FACTORY_TYPE_NAME;
+    }
+    //-----------------------------------------------------------------------
+    SceneNode* BVHSceneManager::createSceneNodeImpl(void)
+    {
+        return OGRE_NEW BVHNode(this);
+    }
+    //-----------------------------------------------------------------------
+    SceneNode* BVHSceneManager::createSceneNodeImpl(const String& name)
+    {
+        return OGRE_NEW BVHNode(this, name);
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::destroySceneNode(const String& name)
+    {
+        BVHNode* node = static_cast<BVHNode*>(getSceneNode(name));
+        _removeBVHNode(node);
+
+        SceneManager::destroySceneNode(name);
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::_updateBVHNode(BVHNode* node)
+    {
+        // Skip if the hierarchy has been destroyed (shutdown conditions)
+        if (!mTree)
+            return;
+
+        const AxisAlignedBox& box = node->_getWorldAABB();
+        int32 proxyId = node->getProxyId();
+
+        if (box.isInfinite())
+        {
+            if (proxyId != BVHTree::NULL_NODE)
+            {
+                mTree->destroyProxy(proxyId);
+                node->setProxyId(BVHTree::NULL_NODE);
+            }
+            if (!node->isUnbounded())
+            {
+                mUnboundedNodes.insert(node);
+                node->setUnbounded(true);
+            }
+            return;
+        }
+
+        if (node->isUnbounded())
+        {
+            mUnboundedNodes.erase(node);
+            node->setUnbounded(false);
+        }
+
+        if (box.isNull())
+        {
+            if (proxyId != BVHTree::NULL_NODE)
+            {
+                mTree->destroyProxy(proxyId);
+                node->setProxyId(BVHTree::NULL_NODE);
+            }
+        }
+        else if (proxyId == BVHTree::NULL_NODE)
+        {
+            node->setProxyId(mTree->createProxy(box, node));
+            ++mInsertedSinceRebuild;
+        }
+        else
+        {
+            mTree->moveProxy(proxyId, box);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::_removeBVHNode(BVHNode* node)
+    {
+        // Skip if the hierarchy has been destroyed (shutdown conditions)
+        if (!mTree)
+            return;
+
+        if (node->getProxyId() != BVHTree::NULL_NODE)
+        {
+            mTree->destroyProxy(node->getProxyId());
+            node->setProxyId(BVHTree::NULL_NODE);
+        }
+        if (node->isUnbounded())
+        {
+            mUnboundedNodes.erase(node);
+            node->setUnbounded(false);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::rebuildTree(void)
+    {
+        mTree->rebuild();
+        mInsertedSinceRebuild = 0;
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::_updateSceneGraph(Camera* cam)
+    {
+        SceneManager::_updateSceneGraph(cam);
+
+        // Rebuild once a good part of the hierarchy has been built incrementally
+        if (mAutoRebuild && mInsertedSinceRebuild >= AUTO_REBUILD_MIN_INSERTED &&
+            mInsertedSinceRebuild * 2 >= mTree->getProxyCount())
+        {
+            rebuildTree();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::addVisibleNode(BVHNode* node, Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        node->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+
+        if (mDisplayNodes)
+            queue->addRenderable(node->getDebugRenderable());
+
+        // check if the scene manager or this node wants the bounding box shown.
+        if (node->getShowBoundingBox() || mShowBoundingBoxes)
+            node->_addBoundingBoxToQueue(queue);
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::_findVisibleObjects(Camera* cam, 
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        const Frustum* frustum = cam->getCullingFrustum();
+        if (!frustum)
+            frustum = cam;
+
+        Plane planes[6];
+        size_t numPlanes = 0;
+        const Plane* frustumPlanes = frustum->getFrustumPlanes();
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+                continue;
+
+            planes[numPlanes++] = frustumPlanes[plane];
+        }
+
+        mInside.clear();
+        mIntersecting.clear();
+        mTree->findProxies(planes, numPlanes, mInside, mIntersecting);
+
+        RenderQueue* queue = getRenderQueue();
+
+        BVHTree::ResultList::const_iterator it, itend = mInside.end();
+        for (it = mInside.begin(); it != itend; ++it)
+        {
+            addVisibleNode(static_cast<BVHNode*>(*it), cam, queue, visibleBounds, onlyShadowCasters);
+        }
+
+        // The enlarged boxes of these intersect the frustum, test the actual
+        // bounds of the nodes in one batch
+        size_t count = mIntersecting.size();
+        if (count)
+        {
+            mCentres.resize(count);
+            mHalfSizes.resize(count);
+            mVisibilityMask.resize((count + 31) / 32);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const AxisAlignedBox& box = static_cast<BVHNode*>(mIntersecting[i])->_getWorldAABB();
+                mCentres[i] = box.getCenter();
+                mHalfSizes[i] = box.getHalfSize();
+            }
+
+            cam->isVisible(&mCentres[0], &mHalfSizes[0], count, &mVisibilityMask[0]);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (mVisibilityMask[i / 32] & (1u << (i % 32)))
+                {
+                    addVisibleNode(static_cast<BVHNode*>(mIntersecting[i]), cam, queue, 
+                        visibleBounds, onlyShadowCasters);
+                }
+            }
+        }
+
+        BVHNodeSet::const_iterator ui, uiend = mUnboundedNodes.end();
+        for (ui = mUnboundedNodes.begin(); ui != uiend; ++ui)
+        {
+            addVisibleNode(*ui, cam, queue, visibleBounds, onlyShadowCasters);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::appendNodes(const BVHTree::ResultList& results, BVHNodeList& list) const
+    {
+        BVHTree::ResultList::const_iterator it, itend = results.end();
+        for (it = results.begin(); it != itend; ++it)
+        {
+            list.push_back(static_cast<BVHNode*>(*it));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::findNodesIn(const AxisAlignedBox& box, BVHNodeList& list)
+    {
+        mInside.clear();
+        mTree->findProxies(box, mInside);
+        appendNodes(mInside, list);
+        list.insert(list.end(), mUnboundedNodes.begin(), mUnboundedNodes.end());
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::findNodesIn(const Sphere& sphere, BVHNodeList& list)
+    {
+        mInside.clear();
+        mTree->findProxies(sphere, mInside);
+        appendNodes(mInside, list);
+        list.insert(list.end(), mUnboundedNodes.begin(), mUnboundedNodes.end());
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::findNodesIn(const PlaneBoundedVolume& volume, BVHNodeList& list)
+    {
+        // The hierarchy wants the volume on the positive side of the planes,
+        // and only takes 32 of them; more planes only make the results looser
+        Plane planes[32];
+        size_t numPlanes = std::min(volume.planes.size(), static_cast<size_t>(32));
+        for (size_t i = 0; i < numPlanes; ++i)
+        {
+            planes[i] = volume.planes[i];
+            if (volume.outside == Plane::POSITIVE_SIDE)
+                planes[i] = -planes[i];
+        }
+
+        mInside.clear();
+        mIntersecting.clear();
+        mTree->findProxies(planes, numPlanes, mInside, mIntersecting);
+        appendNodes(mInside, list);
+        appendNodes(mIntersecting, list);
+        list.insert(list.end(), mUnboundedNodes.begin(), mUnboundedNodes.end());
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::findNodesIn(const Ray& ray, BVHNodeList& list)
+    {
+        mInside.clear();
+        mTree->findProxies(ray, mInside);
+        appendNodes(mInside, list);
+        list.insert(list.end(), mUnboundedNodes.begin(), mUnboundedNodes.end());
+    }
+    //-----------------------------------------------------------------------
+    bool BVHSceneManager::setOption(const String& key, const void* val)
+    {
+        if (key == "Margin")
+        {
+            mTree->setMargin(*static_cast<const Real*>(val));
+            return true;
+        }
+        else if (key == "AutoRebuild")
+        {
+            mAutoRebuild = *static_cast<const bool*>(val);
+            return true;
+        }
+
+        return SceneManager::setOption(key, val);
+    }
+    //-----------------------------------------------------------------------
+    bool BVHSceneManager::getOption(const String& key, void* val)
+    {
+        if (key == "Margin")
+        {
+            *static_cast<Real*>(val) = mTree->getMargin();
+            return true;
+        }
+        else if (key == "AutoRebuild")
+        {
+            *static_cast<bool*>(val) = mAutoRebuild;
+            return true;
+        }
+        else if (key == "TreeHeight")
+        {
+            *static_cast<int*>(val) = static_cast<int>(mTree->getHeight());
+            return true;
+        }
+        else if (key == "NodeCount")
+        {
+            *static_cast<int*>(val) = static_cast<int>(mTree->getProxyCount());
+            return true;
+        }
+
+        return SceneManager::getOption(key, val);
+    }
+    //-----------------------------------------------------------------------
+    bool BVHSceneManager::hasOption(const String& key) const
+    {
+        if (key == "Margin" || key == "AutoRebuild" || key == "TreeHeight" || key == "NodeCount")
+            return true;
+
+        return SceneManager::hasOption(key);
+    }
+    //-----------------------------------------------------------------------
+    bool BVHSceneManager::getOptionValues(const String& key, StringVector& refValueList)
+    {
+        return SceneManager::getOptionValues(key, refValueList);
+    }
+    //-----------------------------------------------------------------------
+    bool BVHSceneManager::getOptionKeys(StringVector& refKeys)
+    {
+        SceneManager::getOptionKeys(refKeys);
+        refKeys.push_back("Margin");
+        refKeys.push_back("AutoRebuild");
+        refKeys.push_back("TreeHeight");
+        refKeys.push_back("NodeCount");
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManager::clearScene(void)
+    {
+        SceneManager::clearScene();
+
+        // All the nodes have been destroyed, but the root may still have a proxy
+        mTree->clear();
+        mUnboundedNodes.clear();
+        mInsertedSinceRebuild = 0;
+        BVHNode* root = static_cast<BVHNode*>(getRootSceneNode());
+        root->setProxyId(BVHTree::NULL_NODE);
+        root->setUnbounded(false);
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBoxSceneQuery*
+    BVHSceneManager::createAABBQuery(const AxisAlignedBox& box, uint32 mask)
+    {
+        BVHAxisAlignedBoxSceneQuery* q = OGRE_NEW BVHAxisAlignedBoxSceneQuery(this);
+        q->setBox(box);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    SphereSceneQuery*
+    BVHSceneManager::createSphereQuery(const Sphere& sphere, uint32 mask)
+    {
+        BVHSphereSceneQuery* q = OGRE_NEW BVHSphereSceneQuery(this);
+        q->setSphere(sphere);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    PlaneBoundedVolumeListSceneQuery*
+    BVHSceneManager::createPlaneBoundedVolumeQuery(const PlaneBoundedVolumeList& volumes,
+            uint32 mask)
+    {
+        BVHPlaneBoundedVolumeListSceneQuery* q = OGRE_NEW BVHPlaneBoundedVolumeListSceneQuery(this);
+        q->setVolumes(volumes);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    RaySceneQuery*
+    BVHSceneManager::createRayQuery(const Ray& ray, uint32 mask)
+    {
+        BVHRaySceneQuery* q = OGRE_NEW BVHRaySceneQuery(this);
+        q->setRay(ray);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    const String BVHSceneManagerFactory::FACTORY_TYPE_NAME = "BVHSceneManager";
+    //-----------------------------------------------------------------------
+    void BVHSceneManagerFactory::initMetaData(void) const
+    {
+        mMetaData.typeName = FACTORY_TYPE_NAME;
+        mMetaData.description = "Scene manager organising the scene in a dynamic bounding volume hierarchy.";
+        mMetaData.sceneTypeMask = 0xFFFF; // support all types
+        mMetaData.worldGeometrySupported = false;
+    }
+    //-----------------------------------------------------------------------
+    SceneManager* BVHSceneManagerFactory::createInstance(
+        const String& instanceName)
+    {
+        return OGRE_NEW BVHSceneManager(instanceName);
+    }
+    //-----------------------------------------------------------------------
+    void BVHSceneManagerFactory::destroyInstance(SceneManager* instance)
+    {
+        OGRE_DELETE instance;
+    }
+}
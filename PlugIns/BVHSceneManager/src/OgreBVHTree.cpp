@@ -0,0 +1,885 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBVHTree.h"
+#include "OgreSphere.h"
+#include "OgreRay.h"
+#include "OgrePlane.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Number of bins used along each axis by the SAH build
+        const int SAH_BIN_COUNT = 16;
+
+        /** Stack used to walk the tree without recursion, which only allocates
+            memory once the tree is unusually deep.
+        */
+        template <typename T>
+        class TraversalStack
+        {
+        public:
+            TraversalStack() : mSize(0) {}
+
+            void push(const T& value)
+            {
+                if (mSize < FIXED_CAPACITY)
+                    mFixed[mSize] = value;
+                else
+                    mOverflow.push_back(value);
+                ++mSize;
+            }
+
+            T pop(void)
+            {
+                --mSize;
+                if (mSize < FIXED_CAPACITY)
+                    return mFixed[mSize];
+                T value = mOverflow.back();
+                mOverflow.pop_back();
+                return value;
+            }
+
+            bool empty(void) const { return mSize == 0; }
+
+        private:
+            enum { FIXED_CAPACITY = 64 };
+            T mFixed[FIXED_CAPACITY];
+            typename vector<T>::type mOverflow;
+            size_t mSize;
+        };
+
+        /// Node waiting to be tested against a set of planes
+        struct PlaneStackEntry
+        {
+            int32 index;
+            /// Planes the node still has to be tested against
+            uint32 mask;
+        };
+
+        /// Half the surface area of a box, only used to compare costs
+        inline Real surfaceArea(const Vector3& minimum, const Vector3& maximum)
+        {
+            Vector3 size = maximum - minimum;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+
+        inline Real unionArea(const Vector3& min1, const Vector3& max1,
+            const Vector3& min2, const Vector3& max2)
+        {
+            Vector3 minimum = min1, maximum = max1;
+            minimum.makeFloor(min2);
+            maximum.makeCeil(max2);
+            return surfaceArea(minimum, maximum);
+        }
+
+        inline bool overlaps(const Vector3& min1, const Vector3& max1,
+            const Vector3& min2, const Vector3& max2)
+        {
+            return min1.x <= max2.x && min1.y <= max2.y && min1.z <= max2.z &&
+                max1.x >= min2.x && max1.y >= min2.y && max1.z >= min2.z;
+        }
+    }
+    //-----------------------------------------------------------------------
+    BVHTree::BVHTree()
+        : mRoot(NULL_NODE)
+        , mFreeList(NULL_NODE)
+        , mProxyCount(0)
+        , mMargin(0.1f)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BVHTree::~BVHTree()
+    {
+    }
+    //-----------------------------------------------------------------------
+    int32 BVHTree::allocateNode(void)
+    {
+        int32 index;
+        if (mFreeList != NULL_NODE)
+        {
+            index = mFreeList;
+            mFreeList = mNodes[index].parent;
+        }
+        else
+        {
+            index = static_cast<int32>(mNodes.size());
+            mNodes.push_back(TreeNode());
+        }
+
+        TreeNode& node = mNodes[index];
+        node.userData = 0;
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::freeNode(int32 index)
+    {
+        TreeNode& node = mNodes[index];
+        node.parent = mFreeList;
+        node.height = -1;
+        mFreeList = index;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::setFatBox(TreeNode& node, const AxisAlignedBox& box) const
+    {
+        const Vector3& minimum = box.getMinimum();
+        const Vector3& maximum = box.getMaximum();
+        Vector3 margin = (maximum - minimum) * mMargin;
+        node.minimum = minimum - margin;
+        node.maximum = maximum + margin;
+    }
+    //-----------------------------------------------------------------------
+    int32 BVHTree::createProxy(const AxisAlignedBox& box, void* userData)
+    {
+        assert(box.isFinite() && "Only finite boxes can be added to the tree");
+
+        int32 proxyId = allocateNode();
+        TreeNode& node = mNodes[proxyId];
+        setFatBox(node, box);
+        node.userData = userData;
+
+        insertLeaf(proxyId);
+        ++mProxyCount;
+        return proxyId;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::destroyProxy(int32 proxyId)
+    {
+        assert(mNodes[proxyId].isLeaf() && mNodes[proxyId].height == 0);
+
+        removeLeaf(proxyId);
+        freeNode(proxyId);
+        --mProxyCount;
+    }
+    //-----------------------------------------------------------------------
+    bool BVHTree::moveProxy(int32 proxyId, const AxisAlignedBox& box)
+    {
+        assert(box.isFinite() && "Only finite boxes can be added to the tree");
+
+        TreeNode& node = mNodes[proxyId];
+        const Vector3& minimum = box.getMinimum();
+        const Vector3& maximum = box.getMaximum();
+        if (node.minimum.x <= minimum.x && node.minimum.y <= minimum.y && node.minimum.z <= minimum.z &&
+            node.maximum.x >= maximum.x && node.maximum.y >= maximum.y && node.maximum.z >= maximum.z)
+        {
+            // Still within the enlarged box
+            return false;
+        }
+
+        removeLeaf(proxyId);
+        setFatBox(mNodes[proxyId], box);
+        insertLeaf(proxyId);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBox BVHTree::getFatBox(int32 proxyId) const
+    {
+        const TreeNode& node = mNodes[proxyId];
+        return AxisAlignedBox(node.minimum, node.maximum);
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::clear(void)
+    {
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mProxyCount = 0;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::insertLeaf(int32 leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Walk down to the sibling for which the leaf adds the least surface
+        // area, stopping as soon as descending further cannot be cheaper
+        const Vector3 leafMin = mNodes[leaf].minimum;
+        const Vector3 leafMax = mNodes[leaf].maximum;
+        int32 index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const TreeNode& node = mNodes[index];
+            Real area = surfaceArea(node.minimum, node.maximum);
+            Real combinedArea = unionArea(node.minimum, node.maximum, leafMin, leafMax);
+
+            // Cost of pairing the leaf with this node under a new parent
+            Real cost = 2 * combinedArea;
+            // Cost of growing this node, paid whichever child the leaf goes to
+            Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real childCost[2];
+            int32 children[2] = { node.child1, node.child2 };
+            for (int i = 0; i < 2; ++i)
+            {
+                const TreeNode& child = mNodes[children[i]];
+                Real childArea = unionArea(child.minimum, child.maximum, leafMin, leafMax);
+                if (!child.isLeaf())
+                    childArea -= surfaceArea(child.minimum, child.maximum);
+                childCost[i] = childArea + inheritanceCost;
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+
+            index = childCost[0] < childCost[1] ? children[0] : children[1];
+        }
+
+        int32 sibling = index;
+        int32 oldParent = mNodes[sibling].parent;
+        int32 newParent = allocateNode();
+
+        TreeNode& parent = mNodes[newParent];
+        parent.parent = oldParent;
+        parent.minimum = leafMin;
+        parent.minimum.makeFloor(mNodes[sibling].minimum);
+        parent.maximum = leafMax;
+        parent.maximum.makeCeil(mNodes[sibling].maximum);
+        parent.height = mNodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+
+        refitUpwards(oldParent);
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::removeLeaf(int32 leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int32 parent = mNodes[leaf].parent;
+        int32 grandParent = mNodes[parent].parent;
+        int32 sibling = mNodes[parent].child1 == leaf ? 
+            mNodes[parent].child2 : mNodes[parent].child1;
+
+        // Replace the parent by the sibling
+        if (grandParent != NULL_NODE)
+        {
+            if (mNodes[grandParent].child1 == parent)
+                mNodes[grandParent].child1 = sibling;
+            else
+                mNodes[grandParent].child2 = sibling;
+            mNodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            refitUpwards(grandParent);
+        }
+        else
+        {
+            mRoot = sibling;
+            mNodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+
+        mNodes[leaf].parent = NULL_NODE;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::refitUpwards(int32 index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.minimum = child1.minimum;
+            node.minimum.makeFloor(child2.minimum);
+            node.maximum = child1.maximum;
+            node.maximum.makeCeil(child2.maximum);
+
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    int32 BVHTree::balance(int32 iA)
+    {
+        TreeNode* A = &mNodes[iA];
+        if (A->isLeaf() || A->height < 2)
+            return iA;
+
+        int32 iB = A->child1;
+        int32 iC = A->child2;
+        TreeNode* B = &mNodes[iB];
+        TreeNode* C = &mNodes[iC];
+
+        int32 balance = C->height - B->height;
+
+        if (balance > 1)
+        {
+            // Rotate C up
+            int32 iF = C->child1;
+            int32 iG = C->child2;
+            TreeNode* F = &mNodes[iF];
+            TreeNode* G = &mNodes[iG];
+
+            // Swap A and C
+            C->child1 = iA;
+            C->parent = A->parent;
+            A->parent = iC;
+
+            if (C->parent != NULL_NODE)
+            {
+                if (mNodes[C->parent].child1 == iA)
+                    mNodes[C->parent].child1 = iC;
+                else
+                    mNodes[C->parent].child2 = iC;
+            }
+            else
+            {
+                mRoot = iC;
+            }
+
+            // Keep the taller grandchild under C
+            if (F->height < G->height)
+            {
+                std::swap(iF, iG);
+                std::swap(F, G);
+            }
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+
+            A->minimum = B->minimum;
+            A->minimum.makeFloor(G->minimum);
+            A->maximum = B->maximum;
+            A->maximum.makeCeil(G->maximum);
+            C->minimum = A->minimum;
+            C->minimum.makeFloor(F->minimum);
+            C->maximum = A->maximum;
+            C->maximum.makeCeil(F->maximum);
+
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+            return iC;
+        }
+
+        if (balance < -1)
+        {
+            // Rotate B up
+            int32 iD = B->child1;
+            int32 iE = B->child2;
+            TreeNode* D = &mNodes[iD];
+            TreeNode* E = &mNodes[iE];
+
+            // Swap A and B
+            B->child1 = iA;
+            B->parent = A->parent;
+            A->parent = iB;
+
+            if (B->parent != NULL_NODE)
+            {
+                if (mNodes[B->parent].child1 == iA)
+                    mNodes[B->parent].child1 = iB;
+                else
+                    mNodes[B->parent].child2 = iB;
+            }
+            else
+            {
+                mRoot = iB;
+            }
+
+            // Keep the taller grandchild under B
+            if (D->height < E->height)
+            {
+                std::swap(iD, iE);
+                std::swap(D, E);
+            }
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+
+            A->minimum = C->minimum;
+            A->minimum.makeFloor(E->minimum);
+            A->maximum = C->maximum;
+            A->maximum.makeCeil(E->maximum);
+            B->minimum = A->minimum;
+            B->minimum.makeFloor(D->minimum);
+            B->maximum = A->maximum;
+            B->maximum.makeCeil(D->maximum);
+
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+            return iB;
+        }
+
+        return iA;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::rebuild(void)
+    {
+        if (mRoot == NULL_NODE)
+            return;
+
+        // Gather the leaves and release every inner node, which leaves exactly
+        // as many free nodes as the new hierarchy needs
+        IndexList leaves;
+        leaves.reserve(mProxyCount);
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            if (mNodes[i].height < 0)
+                continue;
+
+            if (mNodes[i].isLeaf())
+                leaves.push_back(static_cast<int32>(i));
+            else
+                freeNode(static_cast<int32>(i));
+        }
+
+        mRoot = buildSAH(&leaves[0], leaves.size());
+        mNodes[mRoot].parent = NULL_NODE;
+    }
+    //-----------------------------------------------------------------------
+    int32 BVHTree::buildSAH(int32* leaves, size_t count)
+    {
+        if (count == 1)
+            return leaves[0];
+
+        // Bounds of the centres of the leaves, which are what gets binned
+        Vector3 centreMin(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY);
+        Vector3 centreMax(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const TreeNode& node = mNodes[leaves[i]];
+            Vector3 centre = (node.minimum + node.maximum) * 0.5f;
+            centreMin.makeFloor(centre);
+            centreMax.makeCeil(centre);
+        }
+
+        int bestAxis = -1;
+        int bestSplit = 0;
+        Real bestCost = Math::POS_INFINITY;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            Real extent = centreMax[axis] - centreMin[axis];
+            if (extent <= 0)
+                continue;
+            Real scale = SAH_BIN_COUNT / extent;
+
+            size_t binCount[SAH_BIN_COUNT];
+            Vector3 binMin[SAH_BIN_COUNT];
+            Vector3 binMax[SAH_BIN_COUNT];
+            for (int b = 0; b < SAH_BIN_COUNT; ++b)
+            {
+                binCount[b] = 0;
+                binMin[b] = Vector3(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY);
+                binMax[b] = Vector3(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY);
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const TreeNode& node = mNodes[leaves[i]];
+                Real centre = (node.minimum[axis] + node.maximum[axis]) * 0.5f;
+                int b = std::min(static_cast<int>((centre - centreMin[axis]) * scale), SAH_BIN_COUNT - 1);
+                ++binCount[b];
+                binMin[b].makeFloor(node.minimum);
+                binMax[b].makeCeil(node.maximum);
+            }
+
+            // Sweep from the right to get the cost of the right side of each split
+            Real rightCost[SAH_BIN_COUNT];
+            Vector3 sweepMin = binMin[SAH_BIN_COUNT - 1], sweepMax = binMax[SAH_BIN_COUNT - 1];
+            size_t sweepCount = binCount[SAH_BIN_COUNT - 1];
+            for (int b = SAH_BIN_COUNT - 2; b >= 0; --b)
+            {
+                rightCost[b] = sweepCount ? surfaceArea(sweepMin, sweepMax) * sweepCount : 0;
+                sweepMin.makeFloor(binMin[b]);
+                sweepMax.makeCeil(binMax[b]);
+                sweepCount += binCount[b];
+            }
+
+            // Then from the left, splitting after bin b
+            sweepMin = binMin[0];
+            sweepMax = binMax[0];
+            sweepCount = 0;
+            for (int b = 0; b < SAH_BIN_COUNT - 1; ++b)
+            {
+                sweepMin.makeFloor(binMin[b]);
+                sweepMax.makeCeil(binMax[b]);
+                sweepCount += binCount[b];
+                if (sweepCount == 0 || sweepCount == count)
+                    continue;
+
+                Real cost = surfaceArea(sweepMin, sweepMax) * sweepCount + rightCost[b];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        size_t mid;
+        if (bestAxis < 0)
+        {
+            // All the centres coincide, any split is as good as another
+            mid = count / 2;
+        }
+        else
+        {
+            Real scale = SAH_BIN_COUNT / (centreMax[bestAxis] - centreMin[bestAxis]);
+            size_t left = 0, right = count;
+            while (left < right)
+            {
+                const TreeNode& node = mNodes[leaves[left]];
+                Real centre = (node.minimum[bestAxis] + node.maximum[bestAxis]) * 0.5f;
+                int b = std::min(static_cast<int>((centre - centreMin[bestAxis]) * scale), SAH_BIN_COUNT - 1);
+                if (b <= bestSplit)
+                    ++left;
+                else
+                    std::swap(leaves[left], leaves[--right]);
+            }
+            mid = left;
+        }
+
+        int32 index = allocateNode();
+        int32 child1 = buildSAH(leaves, mid);
+        int32 child2 = buildSAH(leaves + mid, count - mid);
+
+        TreeNode& node = mNodes[index];
+        const TreeNode& node1 = mNodes[child1];
+        const TreeNode& node2 = mNodes[child2];
+        node.child1 = child1;
+        node.child2 = child2;
+        node.height = 1 + std::max(node1.height, node2.height);
+        node.minimum = node1.minimum;
+        node.minimum.makeFloor(node2.minimum);
+        node.maximum = node1.maximum;
+        node.maximum.makeCeil(node2.maximum);
+        mNodes[child1].parent = index;
+        mNodes[child2].parent = index;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    int32 BVHTree::getHeight(void) const
+    {
+        return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height;
+    }
+    //-----------------------------------------------------------------------
+    Real BVHTree::getAreaRatio(void) const
+    {
+        if (mRoot == NULL_NODE)
+            return 0;
+
+        Real rootArea = surfaceArea(mNodes[mRoot].minimum, mNodes[mRoot].maximum);
+        if (rootArea <= 0)
+            return 0;
+
+        Real totalArea = 0;
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            if (mNodes[i].height >= 0)
+                totalArea += surfaceArea(mNodes[i].minimum, mNodes[i].maximum);
+        }
+        return totalArea / rootArea;
+    }
+    //-----------------------------------------------------------------------
+    bool BVHTree::validate(void) const
+    {
+        if (mRoot == NULL_NODE)
+            return mProxyCount == 0;
+
+        size_t freeCount = 0;
+        for (int32 index = mFreeList; index != NULL_NODE; index = mNodes[index].parent)
+        {
+            if (mNodes[index].height != -1)
+                return false;
+            ++freeCount;
+        }
+
+        size_t leafCount = 0;
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            if (mNodes[i].height == 0)
+                ++leafCount;
+        }
+
+        // A tree with n leaves has n - 1 inner nodes
+        return leafCount == mProxyCount &&
+            freeCount + 2 * mProxyCount - 1 == mNodes.size() &&
+            validate(mRoot, NULL_NODE);
+    }
+    //-----------------------------------------------------------------------
+    bool BVHTree::validate(int32 index, int32 parent) const
+    {
+        const TreeNode& node = mNodes[index];
+        if (node.parent != parent)
+            return false;
+
+        if (node.isLeaf())
+            return node.height == 0 && node.child2 == NULL_NODE;
+
+        if (!validate(node.child1, index) || !validate(node.child2, index))
+            return false;
+
+        const TreeNode& child1 = mNodes[node.child1];
+        const TreeNode& child2 = mNodes[node.child2];
+        Vector3 minimum = child1.minimum, maximum = child1.maximum;
+        minimum.makeFloor(child2.minimum);
+        maximum.makeCeil(child2.maximum);
+
+        return node.height == 1 + std::max(child1.height, child2.height) &&
+            node.minimum == minimum && node.maximum == maximum;
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::collectProxies(int32 index, ResultList& results) const
+    {
+        TraversalStack<int32> stack;
+        stack.push(index);
+        while (!stack.empty())
+        {
+            const TreeNode& node = mNodes[stack.pop()];
+            if (node.isLeaf())
+            {
+                results.push_back(node.userData);
+            }
+            else
+            {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::findProxies(const AxisAlignedBox& box, ResultList& results) const
+    {
+        if (mRoot == NULL_NODE || box.isNull())
+            return;
+
+        if (box.isInfinite())
+        {
+            collectProxies(mRoot, results);
+            return;
+        }
+
+        const Vector3& minimum = box.getMinimum();
+        const Vector3& maximum = box.getMaximum();
+
+        TraversalStack<int32> stack;
+        stack.push(mRoot);
+        while (!stack.empty())
+        {
+            const TreeNode& node = mNodes[stack.pop()];
+            if (!overlaps(node.minimum, node.maximum, minimum, maximum))
+                continue;
+
+            if (node.isLeaf())
+            {
+                results.push_back(node.userData);
+            }
+            else
+            {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::findProxies(const Sphere& sphere, ResultList& results) const
+    {
+        if (mRoot == NULL_NODE)
+            return;
+
+        const Vector3& centre = sphere.getCenter();
+        Real radiusSquared = sphere.getRadius() * sphere.getRadius();
+
+        TraversalStack<int32> stack;
+        stack.push(mRoot);
+        while (!stack.empty())
+        {
+            const TreeNode& node = mNodes[stack.pop()];
+
+            // Squared distance from the centre to the closest point of the box
+            Real distanceSquared = 0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (centre[axis] < node.minimum[axis])
+                    distanceSquared += Math::Sqr(node.minimum[axis] - centre[axis]);
+                else if (centre[axis] > node.maximum[axis])
+                    distanceSquared += Math::Sqr(centre[axis] - node.maximum[axis]);
+            }
+            if (distanceSquared > radiusSquared)
+                continue;
+
+            if (node.isLeaf())
+            {
+                results.push_back(node.userData);
+            }
+            else
+            {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::findProxies(const Ray& ray, ResultList& results) const
+    {
+        if (mRoot == NULL_NODE)
+            return;
+
+        const Vector3& origin = ray.getOrigin();
+        const Vector3& direction = ray.getDirection();
+        Vector3 invDirection;
+        bool parallel[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            parallel[axis] = direction[axis] == 0;
+            invDirection[axis] = parallel[axis] ? 0 : 1 / direction[axis];
+        }
+
+        TraversalStack<int32> stack;
+        stack.push(mRoot);
+        while (!stack.empty())
+        {
+            const TreeNode& node = mNodes[stack.pop()];
+
+            // Slab test, only the part of the line in front of the origin counts
+            Real tmin = 0, tmax = Math::POS_INFINITY;
+            bool hit = true;
+            for (int axis = 0; axis < 3 && hit; ++axis)
+            {
+                if (parallel[axis])
+                {
+                    hit = origin[axis] >= node.minimum[axis] && origin[axis] <= node.maximum[axis];
+                }
+                else
+                {
+                    Real t1 = (node.minimum[axis] - origin[axis]) * invDirection[axis];
+                    Real t2 = (node.maximum[axis] - origin[axis]) * invDirection[axis];
+                    if (t1 > t2)
+                        std::swap(t1, t2);
+                    tmin = std::max(tmin, t1);
+                    tmax = std::min(tmax, t2);
+                    hit = tmin <= tmax;
+                }
+            }
+            if (!hit)
+                continue;
+
+            if (node.isLeaf())
+            {
+                results.push_back(node.userData);
+            }
+            else
+            {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BVHTree::findProxies(const Plane* planes, size_t numPlanes, 
+        ResultList& inside, ResultList& intersecting) const
+    {
+        assert(numPlanes <= 32 && "Too many planes");
+
+        if (mRoot == NULL_NODE)
+            return;
+
+        TraversalStack<PlaneStackEntry> stack;
+        PlaneStackEntry entry;
+        entry.index = mRoot;
+        entry.mask = numPlanes < 32 ? (1u << numPlanes) - 1 : 0xFFFFFFFF;
+        stack.push(entry);
+        while (!stack.empty())
+        {
+            entry = stack.pop();
+            const TreeNode& node = mNodes[entry.index];
+
+            // Same test as Plane::getSide(centre, halfSize)
+            Vector3 centre = (node.minimum + node.maximum) * 0.5f;
+            Vector3 halfSize = (node.maximum - node.minimum) * 0.5f;
+            bool culled = false;
+            for (size_t i = 0; i < numPlanes; ++i)
+            {
+                uint32 bit = 1u << i;
+                if (!(entry.mask & bit))
+                    continue;
+
+                const Plane& plane = planes[i];
+                Real dist = plane.normal.dotProduct(centre) + plane.d;
+                Real maxAbsDist = plane.normal.absDotProduct(halfSize);
+                if (dist < -maxAbsDist)
+                {
+                    culled = true;
+                    break;
+                }
+                if (dist > maxAbsDist)
+                    entry.mask &= ~bit;
+            }
+            if (culled)
+                continue;
+
+            if (entry.mask == 0)
+            {
+                // Entirely within the volume, no need to test the subtree
+                collectProxies(entry.index, inside);
+            }
+            else if (node.isLeaf())
+            {
+                intersecting.push_back(node.userData);
+            }
+            else
+            {
+                int32 child2 = node.child2;
+                entry.index = node.child1;
+                stack.push(entry);
+                entry.index = child2;
+                stack.push(entry);
+            }
+        }
+    }
+}
@@ -75,6 +75,10 @@ namespace Ogre
         /* Overridden isVisible function for aabb */
         virtual bool isVisible( const AxisAlignedBox &bound, FrustumPlane *culledBy=0) const;
 
+        /* Overridden batch isVisible function, to check the extra culling planes as well */
+        virtual void isVisible(const Vector3* centres, const Vector3* halfSizes, 
+            size_t count, uint32* visibilityMask) const;
+
         /* isVisible() function for portals */
         bool isVisible(PortalBase* portal, FrustumPlane* culledBy = 0) const;
 
@@ -85,6 +85,12 @@ namespace Ogre
         return true;
    }
 
+    void PCZCamera::isVisible(const Vector3* centres, const Vector3* halfSizes, 
+        size_t count, uint32* visibilityMask) const
+    {
+        isVisibleOneByOne(centres, halfSizes, count, visibilityMask);
+    }
+
     /* A 'more detailed' check for visibility of an AAB.  This function returns
       none, partial, or full for visibility of the box.  This is useful for 
       stuff like Octree leaf culling */
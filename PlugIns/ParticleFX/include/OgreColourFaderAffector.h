@@ -88,6 +88,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed);
+
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
             Sets the adjustment to be made to each of the colour components per second. These
@@ -90,6 +90,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed);
+
 
 
         /** Sets the minimum rotation speed of particles to be emitted. */
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleData.h"
+#include "OgreOptimisedUtil.h"
 
 
 namespace Ogre {
@@ -90,6 +92,20 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool ColourFaderAffector::_affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+    {
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        size_t count = data.getCount();
+
+        // Scale adjustments by time, and limit to [0, 1]
+        util->multiplyAddClampArray(data.mColourR, 1, mRedAdj * timeElapsed, 0, 1, count);
+        util->multiplyAddClampArray(data.mColourG, 1, mGreenAdj * timeElapsed, 0, 1, count);
+        util->multiplyAddClampArray(data.mColourB, 1, mBlueAdj * timeElapsed, 0, 1, count);
+        util->multiplyAddClampArray(data.mColourA, 1, mAlphaAdj * timeElapsed, 0, 1, count);
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector::setAdjust(float red, float green, float blue, float alpha)
     {
         mRedAdj = red;
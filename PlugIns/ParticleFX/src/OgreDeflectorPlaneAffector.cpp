@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "OgreDeflectorPlaneAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleData.h"
+#include "OgreOptimisedUtil.h"
 #include "OgreStringConverter.h"
 
 
@@ -92,6 +94,42 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    bool DeflectorPlaneAffector::_affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+    {
+        // precalculate distance of plane from origin
+        Real planeDistance = - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal));
+        Real nx = mPlaneNormal.x, ny = mPlaneNormal.y, nz = mPlaneNormal.z;
+
+        for (size_t i = 0, count = data.getCount(); i < count; ++i)
+        {
+            Real dx = data.mDirectionX[i] * timeElapsed;
+            Real dy = data.mDirectionY[i] * timeElapsed;
+            Real dz = data.mDirectionZ[i] * timeElapsed;
+            Real a = nx * data.mPositionX[i] + ny * data.mPositionY[i] + nz * data.mPositionZ[i] + planeDistance;
+
+            // Same test as _affectParticles, most particles do not cross the plane
+            if (a + nx * dx + ny * dy + nz * dz > 0.0 || a <= 0.0)
+                continue;
+
+            Vector3 direction(dx, dy, dz);
+            Vector3 directionPart = direction * (- a / direction.dotProduct( mPlaneNormal ));
+            Vector3 position = Vector3(data.mPositionX[i], data.mPositionY[i], data.mPositionZ[i]) +
+                directionPart + ((directionPart - direction) * mBounce);
+            data.mPositionX[i] = position.x;
+            data.mPositionY[i] = position.y;
+            data.mPositionZ[i] = position.z;
+
+            // reflect direction vector
+            Vector3 velocity(data.mDirectionX[i], data.mDirectionY[i], data.mDirectionZ[i]);
+            velocity = (velocity - (2.0f * velocity.dotProduct( mPlaneNormal ) * mPlaneNormal)) * mBounce;
+            data.mDirectionX[i] = velocity.x;
+            data.mDirectionY[i] = velocity.y;
+            data.mDirectionZ[i] = velocity.z;
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void DeflectorPlaneAffector::setPlanePoint(const Vector3& pos)
     {
         mPlanePoint = pos;
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "OgreLinearForceAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleData.h"
+#include "OgreOptimisedUtil.h"
 #include "OgreStringConverter.h"
 
 
@@ -95,6 +97,36 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    bool LinearForceAffector::_affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+    {
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        size_t count = data.getCount();
+
+        if (mForceApplication == FA_ADD)
+        {
+            // Scale force by time
+            Vector3 scaledVector = mForceVector * timeElapsed;
+            util->multiplyAddClampArray(data.mDirectionX, 1, scaledVector.x,
+                Math::NEG_INFINITY, Math::POS_INFINITY, count);
+            util->multiplyAddClampArray(data.mDirectionY, 1, scaledVector.y,
+                Math::NEG_INFINITY, Math::POS_INFINITY, count);
+            util->multiplyAddClampArray(data.mDirectionZ, 1, scaledVector.z,
+                Math::NEG_INFINITY, Math::POS_INFINITY, count);
+        }
+        else // FA_AVERAGE
+        {
+            Vector3 halfVector = mForceVector * 0.5f;
+            util->multiplyAddClampArray(data.mDirectionX, 0.5f, halfVector.x,
+                Math::NEG_INFINITY, Math::POS_INFINITY, count);
+            util->multiplyAddClampArray(data.mDirectionY, 0.5f, halfVector.y,
+                Math::NEG_INFINITY, Math::POS_INFINITY, count);
+            util->multiplyAddClampArray(data.mDirectionZ, 0.5f, halfVector.z,
+                Math::NEG_INFINITY, Math::POS_INFINITY, count);
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void LinearForceAffector::setForceVector(const Vector3& force)
     {
         mForceVector = force;
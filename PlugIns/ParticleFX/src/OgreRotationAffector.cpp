@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleData.h"
+#include "OgreOptimisedUtil.h"
 
 
 namespace Ogre {
@@ -107,6 +109,19 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool RotationAffector::_affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+    {
+        size_t count = data.getCount();
+        if (!count)
+            return true;
+
+        OptimisedUtil::getImplementation()->addScaledArray(
+            data.mRotation, data.mRotationSpeed, timeElapsed, count);
+
+        pSystem->_notifyParticleRotated();
+        return true;
+    }
+    //-----------------------------------------------------------------------
     const Radian& RotationAffector::getRotationSpeedRangeStart(void) const
     {
         return mRotationSpeedRangeStart;
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleData.h"
+#include "OgreOptimisedUtil.h"
 
 
 namespace Ogre {
@@ -85,6 +87,35 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool ScaleAffector::_affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+    {
+        size_t count = data.getCount();
+        if (!count)
+            return true;
+
+        // Particles without dimensions of their own start from the defaults
+        Real defaultWidth = pSystem->getDefaultWidth();
+        Real defaultHeight = pSystem->getDefaultHeight();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!data.mOwnDimensions[i])
+            {
+                data.mOwnDimensions[i] = true;
+                data.mWidth[i] = defaultWidth;
+                data.mHeight[i] = defaultHeight;
+            }
+        }
+
+        // Scale adjustments by time, dimensions can not be negative
+        Real ds = mScaleAdj * timeElapsed;
+        OptimisedUtil* util = OptimisedUtil::getImplementation();
+        util->multiplyAddClampArray(data.mWidth, 1, ds, 0, Math::POS_INFINITY, count);
+        util->multiplyAddClampArray(data.mHeight, 1, ds, 0, Math::POS_INFINITY, count);
+
+        pSystem->_notifyParticleResized();
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
     {
         mScaleAdj = rate;
@@ -39,6 +39,10 @@ public:
     virtual bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const {return true;};
     virtual bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const {return true;};
     virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const {return true;};
+    virtual void isVisible(const Vector3* centres, const Vector3* halfSizes, size_t count, uint32* visibilityMask) const
+    {
+        std::fill(visibilityMask, visibilityMask + (count + 31) / 32, 0xFFFFFFFF);
+    };
     bool projectSphere(const Sphere& sphere, 
         Real* left, Real* top, Real* right, Real* bottom) const {*left = *bottom = -1.0f; *right = *top = 1.0f; return true;};
     Real getNearClipDistance(void) const {return 1.0;};
@@ -0,0 +1,207 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+/*  Measures the pair throughput of the default IntersectionSceneQuery, which
+    gameplay code may run every frame, against the pairwise comparison of
+    every object with every other one that it replaced. The scene is a set of
+    small objects scattered over a flat area, a tenth of which move every
+    frame.
+
+    Usage: Benchmark_IntersectionSceneQuery [number of objects]
+*/
+
+#include "Ogre.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Object with a fixed box which does not add anything to the queue
+    class BenchmarkObject : public MovableObject
+    {
+        AxisAlignedBox mBox;
+    public:
+        BenchmarkObject(const String& name)
+            : MovableObject(name), mBox(-2, -2, -2, 2, 2, 2) {}
+        const String& getMovableType(void) const
+        {
+            static String type = "BenchmarkObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(12); }
+        void _updateRenderQueue(RenderQueue*) {}
+        void visitRenderables(Renderable::Visitor*, bool) {}
+    };
+
+    /// Factory for BenchmarkObject, the scene queries only return objects made by factories
+    class BenchmarkObjectFactory : public MovableObjectFactory
+    {
+    protected:
+        MovableObject* createInstanceImpl(const String& name, const NameValuePairList*)
+        {
+            return OGRE_NEW BenchmarkObject(name);
+        }
+    public:
+        const String& getType(void) const
+        {
+            static String type = "BenchmarkObject";
+            return type;
+        }
+        void destroyInstance(MovableObject* obj) { OGRE_DELETE obj; }
+    };
+
+    /// Counts the pairs so the queries can not be optimised away
+    class CountingListener : public IntersectionSceneQueryListener
+    {
+    public:
+        size_t count;
+        CountingListener() : count(0) {}
+        bool queryResult(MovableObject*, MovableObject*) { ++count; return true; }
+        bool queryResult(MovableObject*, SceneQuery::WorldFragment*) { return true; }
+    };
+
+    /// Compares every object with every other one
+    size_t bruteForce(const vector<MovableObject*>::type& objects)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            const AxisAlignedBox& box1 = objects[i]->getWorldBoundingBox();
+            for (size_t j = i + 1; j < objects.size(); ++j)
+            {
+                if (box1.intersects(objects[j]->getWorldBoundingBox()))
+                    ++count;
+            }
+        }
+        return count;
+    }
+
+    const int FRAMES = 100;
+
+    /// Milliseconds elapsed since the timer was reset
+    double elapsed(Timer& timer)
+    {
+        return timer.getMicroseconds() / 1000.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t numObjects = 20000;
+    if (argc > 1)
+        numObjects = StringConverter::parseUnsignedInt(argv[1], 20000);
+
+    // Keep the log out of the results
+    LogManager* logMgr = OGRE_NEW LogManager();
+    logMgr->createLog("Benchmark_IntersectionSceneQuery.log", true, false, true);
+    Root* root = OGRE_NEW Root("", "", "");
+    DefaultHardwareBufferManager* bufferMgr = OGRE_NEW DefaultHardwareBufferManager();
+    BenchmarkObjectFactory factory;
+    root->addMovableObjectFactory(&factory);
+
+    SceneManager* sceneMgr = root->createSceneManager(ST_GENERIC);
+    // The same density of objects whatever their number
+    Real extent = Math::Sqrt(Real(numObjects)) * 15;
+    vector<SceneNode*>::type nodes;
+    vector<MovableObject*>::type objects;
+    srand(1);
+    for (size_t i = 0; i < numObjects; ++i)
+    {
+        SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(Math::RangeRandom(-extent, extent), Math::RangeRandom(-5, 5),
+                    Math::RangeRandom(-extent, extent)));
+        MovableObject* obj = sceneMgr->createMovableObject("BenchmarkObject");
+        node->attachObject(obj);
+        nodes.push_back(node);
+        objects.push_back(obj);
+    }
+    sceneMgr->getRootSceneNode()->_update(true, false);
+
+    IntersectionSceneQuery* query = sceneMgr->createIntersectionQuery();
+    CountingListener listener;
+
+    Timer timer;
+    size_t referencePairs = bruteForce(objects);
+    double bruteForceTime = elapsed(timer);
+
+    // The first execution sorts from scratch
+    timer.reset();
+    query->execute(&listener);
+    double firstTime = elapsed(timer);
+    size_t firstPairs = listener.count;
+
+    // Later ones only catch up with the objects which moved
+    size_t framePairs = 0;
+    double frameTime = 0;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        for (size_t i = frame % 10; i < nodes.size(); i += 10)
+            nodes[i]->translate(Math::RangeRandom(-2, 2), 0, Math::RangeRandom(-2, 2));
+        sceneMgr->getRootSceneNode()->_update(true, false);
+
+        listener.count = 0;
+        timer.reset();
+        query->execute(&listener);
+        frameTime += elapsed(timer);
+        framePairs += listener.count;
+    }
+    frameTime /= FRAMES;
+    framePairs /= FRAMES;
+
+    std::cout << numObjects << " objects" << std::endl;
+    std::cout << std::left << std::setw(22) << "Method" << std::right
+              << std::setw(12) << "pairs" << std::setw(12) << "ms"
+              << std::setw(16) << "pairs per ms" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(22) << "all against all" << std::right
+              << std::setw(12) << referencePairs << std::setw(12) << bruteForceTime
+              << std::setw(16) << referencePairs / bruteForceTime << std::endl;
+    std::cout << std::left << std::setw(22) << "query, first" << std::right
+              << std::setw(12) << firstPairs << std::setw(12) << firstTime
+              << std::setw(16) << firstPairs / firstTime << std::endl;
+    std::cout << std::left << std::setw(22) << "query, per frame" << std::right
+              << std::setw(12) << framePairs << std::setw(12) << frameTime
+              << std::setw(16) << framePairs / frameTime << std::endl;
+    if (firstPairs != referencePairs)
+        std::cout << "Mismatch: the query found " << firstPairs << " pairs instead of "
+                  << referencePairs << std::endl;
+
+    sceneMgr->destroyQuery(query);
+    root->destroySceneManager(sceneMgr);
+    root->removeMovableObjectFactory(&factory);
+    OGRE_DELETE bufferMgr;
+    OGRE_DELETE root;
+    OGRE_DELETE logMgr;
+    return firstPairs == referencePairs ? 0 : 1;
+}
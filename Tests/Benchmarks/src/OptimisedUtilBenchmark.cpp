@@ -0,0 +1,235 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+/*  Measures the kernels of every OptimisedUtil implementation the CPU can
+    run, on buffers of the size of a detailed character: software skinning
+    with four weights per vertex, with shared and separate position / normal
+    buffers, morphing, matrix concatenation for a skeleton, and the stencil
+    shadow stages (face normals, light facing, extrusion).
+
+    Usage: Benchmark_OptimisedUtil [number of vertices]
+*/
+
+#include "OgreOptimisedUtil.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreTimer.h"
+#include "OgreStringConverter.h"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace
+{
+    const size_t NUM_BONES = 64;
+    const size_t NUM_WEIGHTS = 4;
+    const int REPEATS = 200;
+
+    /// Input and output buffers shared by every implementation
+    struct Buffers
+    {
+        size_t numVertices;
+        size_t numTriangles;
+        vector<float>::type shared;
+        vector<float>::type positions;
+        vector<float>::type normals;
+        vector<float>::type morphTarget;
+        vector<float>::type weights;
+        vector<unsigned char>::type indices;
+        vector<Matrix4>::type bones;
+        const Matrix4* bonePointers[NUM_BONES];
+        vector<EdgeData::Triangle>::type triangles;
+        vector<Vector4>::type faceNormals;
+        vector<char>::type lightFacings;
+        vector<float>::type output;
+
+        Buffers(size_t vertices)
+            : numVertices(vertices), numTriangles(vertices * 2)
+            , shared(vertices * 6), positions(vertices * 3), normals(vertices * 3)
+            , morphTarget(vertices * 3)
+            , weights(vertices * NUM_WEIGHTS), indices(vertices * NUM_WEIGHTS)
+            , bones(NUM_BONES), triangles(vertices * 2), faceNormals(vertices * 2)
+            , lightFacings(vertices * 2), output(vertices * 6)
+        {
+            for (size_t i = 0; i < shared.size(); ++i)
+                shared[i] = Math::RangeRandom(-1, 1);
+            for (size_t i = 0; i < positions.size(); ++i)
+            {
+                positions[i] = Math::RangeRandom(-1, 1);
+                normals[i] = Math::RangeRandom(-1, 1);
+                morphTarget[i] = Math::RangeRandom(-1, 1);
+            }
+            for (size_t v = 0; v < vertices; ++v)
+            {
+                for (size_t w = 0; w < NUM_WEIGHTS; ++w)
+                {
+                    weights[v * NUM_WEIGHTS + w] = 1.0f / NUM_WEIGHTS;
+                    indices[v * NUM_WEIGHTS + w] = (unsigned char)(rand() % NUM_BONES);
+                }
+            }
+            for (size_t b = 0; b < NUM_BONES; ++b)
+            {
+                bones[b].makeTransform(
+                    Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1)),
+                    Vector3::UNIT_SCALE,
+                    Quaternion(Radian(Math::RangeRandom(-Math::PI, Math::PI)), Vector3::UNIT_Y));
+                bonePointers[b] = &bones[b];
+            }
+            for (size_t t = 0; t < numTriangles; ++t)
+            {
+                // Neighbouring vertices, as in a real mesh
+                size_t first = (t / 2) % (vertices - 2);
+                triangles[t].vertIndex[0] = first;
+                triangles[t].vertIndex[1] = first + 1 + (t & 1);
+                triangles[t].vertIndex[2] = first + 2 - (t & 1);
+            }
+        }
+    };
+
+    /// One kernel on the buffers
+    typedef void (*Kernel)(OptimisedUtil* impl, Buffers& b);
+
+    void skinShared(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->softwareVertexSkinning(&b.shared[0], &b.output[0], &b.shared[3], &b.output[3],
+            &b.weights[0], &b.indices[0], b.bonePointers,
+            24, 24, 24, 24, NUM_WEIGHTS * sizeof(float), NUM_WEIGHTS, NUM_WEIGHTS, b.numVertices);
+    }
+    void skinSeparate(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->softwareVertexSkinning(&b.positions[0], &b.output[0], &b.normals[0], &b.output[b.numVertices * 3],
+            &b.weights[0], &b.indices[0], b.bonePointers,
+            12, 12, 12, 12, NUM_WEIGHTS * sizeof(float), NUM_WEIGHTS, NUM_WEIGHTS, b.numVertices);
+    }
+    void skinPositions(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->softwareVertexSkinning(&b.positions[0], &b.output[0], 0, 0,
+            &b.weights[0], &b.indices[0], b.bonePointers,
+            12, 12, 0, 0, NUM_WEIGHTS * sizeof(float), NUM_WEIGHTS, NUM_WEIGHTS, b.numVertices);
+    }
+    void morphPositions(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->softwareVertexMorph(0.3f, &b.positions[0], &b.morphTarget[0], &b.output[0],
+            12, 12, 12, b.numVertices, false);
+    }
+    void morphNormals(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->softwareVertexMorph(0.3f, &b.shared[0], &b.shared[0], &b.output[0],
+            24, 24, 24, b.numVertices, true);
+    }
+    void concatenate(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->concatenateAffineMatrices(b.bones[0], &b.bones[0], (Matrix4*)&b.output[0],
+            std::min(NUM_BONES, b.output.size() / 16));
+    }
+    void faceNormals(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->calculateFaceNormals(&b.positions[0], &b.triangles[0], &b.faceNormals[0], b.numTriangles);
+    }
+    void lightFacing(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->calculateLightFacing(Vector4(3, 4, 5, 1), &b.faceNormals[0], &b.lightFacings[0], b.numTriangles);
+    }
+    void extrudePoint(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->extrudeVertices(Vector4(3, 4, 5, 1), 100, &b.positions[0], &b.output[0], b.numVertices);
+    }
+    void extrudeDirectional(OptimisedUtil* impl, Buffers& b)
+    {
+        impl->extrudeVertices(Vector4(0, -1, 0, 0), 100, &b.positions[0], &b.output[0], b.numVertices);
+    }
+
+    struct KernelEntry
+    {
+        const char* name;
+        Kernel kernel;
+    };
+    const KernelEntry KERNELS[] =
+    {
+        { "skinning, shared", skinShared },
+        { "skinning, separate", skinSeparate },
+        { "skinning, positions", skinPositions },
+        { "morph, positions", morphPositions },
+        { "morph, normals", morphNormals },
+        { "concatenate", concatenate },
+        { "face normals", faceNormals },
+        { "light facing", lightFacing },
+        { "extrude, point", extrudePoint },
+        { "extrude, directional", extrudeDirectional },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    size_t numVertices = 10000;
+    if (argc > 1)
+        numVertices = std::max(3u, StringConverter::parseUnsignedInt(argv[1], 10000));
+
+    srand(1);
+    Buffers buffers(numVertices);
+    OptimisedUtil::ImplementationMap implementations = OptimisedUtil::getAvailableImplementations();
+
+    std::cout << numVertices << " vertices, " << buffers.numTriangles << " triangles, "
+              << NUM_BONES << " bones; microseconds per call" << std::endl;
+    std::cout << std::left << std::setw(24) << "Kernel" << std::right;
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+        std::cout << std::setw(14) << i->first;
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    Timer timer;
+    for (size_t k = 0; k < sizeof(KERNELS) / sizeof(KERNELS[0]); ++k)
+    {
+        std::cout << std::left << std::setw(24) << KERNELS[k].name << std::right;
+        for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+        {
+            // Warm up the caches, then keep the best of several runs
+            KERNELS[k].kernel(i->second, buffers);
+            unsigned long best = ~0ul;
+            for (int run = 0; run < 5; ++run)
+            {
+                timer.reset();
+                for (int r = 0; r < REPEATS; ++r)
+                    KERNELS[k].kernel(i->second, buffers);
+                best = std::min(best, timer.getMicroseconds());
+            }
+            std::cout << std::setw(14) << double(best) / REPEATS;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Implementation in use: ";
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+    {
+        if (i->second == OptimisedUtil::getImplementation())
+            std::cout << i->first;
+    }
+    std::cout << std::endl;
+    return 0;
+}
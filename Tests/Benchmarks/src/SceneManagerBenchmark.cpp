@@ -0,0 +1,245 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+/*  Compares the scene managers on the work they do every frame: inserting
+    nodes, moving them, culling the scene against a camera and running
+    scene queries. The scene is a set of small objects scattered over a
+    large flat area, which is the case spatial structures are meant for.
+
+    Usage: Benchmark_SceneManager [number of nodes]
+*/
+
+#include "Ogre.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreOctreeSceneManager.h"
+#include "OgreBVHSceneManager.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Object with a fixed unit box which does not add anything to the queue
+    class BenchmarkObject : public MovableObject
+    {
+        AxisAlignedBox mBox;
+    public:
+        BenchmarkObject(const String& name)
+            : MovableObject(name), mBox(-1, -1, -1, 1, 1, 1) {}
+        const String& getMovableType(void) const
+        {
+            static String type = "BenchmarkObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+        void _updateRenderQueue(RenderQueue*) {}
+        void visitRenderables(Renderable::Visitor*, bool) {}
+    };
+
+    /// Factory for BenchmarkObject, the scene queries only return objects made by factories
+    class BenchmarkObjectFactory : public MovableObjectFactory
+    {
+    protected:
+        MovableObject* createInstanceImpl(const String& name, const NameValuePairList*)
+        {
+            return OGRE_NEW BenchmarkObject(name);
+        }
+    public:
+        const String& getType(void) const
+        {
+            static String type = "BenchmarkObject";
+            return type;
+        }
+        void destroyInstance(MovableObject* obj) { OGRE_DELETE obj; }
+    };
+
+    /// Counts the query results so the queries can not be optimised away
+    class CountingListener : public RaySceneQueryListener, public SceneQueryListener
+    {
+    public:
+        size_t count;
+        CountingListener() : count(0) {}
+        bool queryResult(MovableObject*, Real) { ++count; return true; }
+        bool queryResult(SceneQuery::WorldFragment*, Real) { return true; }
+        bool queryResult(MovableObject*) { ++count; return true; }
+        bool queryResult(SceneQuery::WorldFragment*) { return true; }
+    };
+
+    struct Timings
+    {
+        String name;
+        double insert, move, cull, rayQuery, sphereQuery, boxQuery;
+    };
+
+    const int FRAMES = 100;
+    const int QUERIES = 1000;
+
+    /// Milliseconds elapsed since the timer was reset
+    double elapsed(Timer& timer)
+    {
+        return timer.getMicroseconds() / 1000.0;
+    }
+
+    Timings run(SceneManager* sceneMgr, size_t numNodes)
+    {
+        Timings timings;
+        timings.name = sceneMgr->getTypeName();
+
+        Camera* cam = sceneMgr->createCamera("BenchmarkCamera");
+        cam->setPosition(Vector3::ZERO);
+        cam->setNearClipDistance(1);
+        cam->setFarClipDistance(1000);
+
+        vector<SceneNode*>::type nodes;
+        nodes.reserve(numNodes);
+        srand(1);
+
+        Timer timer;
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(Math::RangeRandom(-2000, 2000), Math::RangeRandom(-20, 20),
+                        Math::RangeRandom(-2000, 2000)));
+            node->attachObject(sceneMgr->createMovableObject("BenchmarkObject"));
+            nodes.push_back(node);
+        }
+        sceneMgr->_updateSceneGraph(cam);
+        timings.insert = elapsed(timer);
+
+        // A tenth of the nodes move every frame
+        timer.reset();
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            for (size_t i = frame % 10; i < nodes.size(); i += 10)
+                nodes[i]->translate(Math::RangeRandom(-5, 5), 0, Math::RangeRandom(-5, 5));
+            sceneMgr->_updateSceneGraph(cam);
+        }
+        timings.move = elapsed(timer) / FRAMES;
+
+        // The camera turns around on the spot
+        timer.reset();
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            cam->setOrientation(Quaternion(Degree(frame * 360.0f / FRAMES), Vector3::UNIT_Y));
+            sceneMgr->_findVisibleObjects(cam, 0, false);
+        }
+        timings.cull = elapsed(timer) / FRAMES;
+
+        CountingListener listener;
+        RaySceneQuery* rayQuery = sceneMgr->createRayQuery(Ray());
+        timer.reset();
+        for (int i = 0; i < QUERIES; ++i)
+        {
+            Radian angle(Math::TWO_PI * i / QUERIES);
+            rayQuery->setRay(Ray(Vector3(0, 0, 0), Vector3(Math::Cos(angle), 0, Math::Sin(angle))));
+            rayQuery->execute(&listener);
+        }
+        timings.rayQuery = elapsed(timer) * 1000.0 / QUERIES;
+        sceneMgr->destroyQuery(rayQuery);
+
+        SphereSceneQuery* sphereQuery = sceneMgr->createSphereQuery(Sphere());
+        timer.reset();
+        for (int i = 0; i < QUERIES; ++i)
+        {
+            sphereQuery->setSphere(Sphere(
+                Vector3(Math::RangeRandom(-2000, 2000), 0, Math::RangeRandom(-2000, 2000)), 50));
+            sphereQuery->execute(&listener);
+        }
+        timings.sphereQuery = elapsed(timer) * 1000.0 / QUERIES;
+        sceneMgr->destroyQuery(sphereQuery);
+
+        AxisAlignedBoxSceneQuery* boxQuery = sceneMgr->createAABBQuery(AxisAlignedBox());
+        timer.reset();
+        for (int i = 0; i < QUERIES; ++i)
+        {
+            Vector3 centre(Math::RangeRandom(-2000, 2000), 0, Math::RangeRandom(-2000, 2000));
+            boxQuery->setBox(AxisAlignedBox(centre - Vector3(50), centre + Vector3(50)));
+            boxQuery->execute(&listener);
+        }
+        timings.boxQuery = elapsed(timer) * 1000.0 / QUERIES;
+        sceneMgr->destroyQuery(boxQuery);
+
+        sceneMgr->clearScene();
+        sceneMgr->destroyAllCameras();
+        return timings;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t numNodes = 20000;
+    if (argc > 1)
+        numNodes = StringConverter::parseUnsignedInt(argv[1], 20000);
+
+    // Keep the log out of the results
+    LogManager* logMgr = OGRE_NEW LogManager();
+    logMgr->createLog("Benchmark_SceneManager.log", true, false, true);
+    Root* root = OGRE_NEW Root("", "", "");
+    DefaultHardwareBufferManager* bufferMgr = OGRE_NEW DefaultHardwareBufferManager();
+    MaterialManager::getSingleton().initialise();
+    BenchmarkObjectFactory factory;
+    root->addMovableObjectFactory(&factory);
+
+    vector<Timings>::type results;
+    SceneManager* sceneMgr = root->createSceneManager(ST_GENERIC);
+    results.push_back(run(sceneMgr, numNodes));
+    root->destroySceneManager(sceneMgr);
+
+    sceneMgr = OGRE_NEW OctreeSceneManager("Octree");
+    results.push_back(run(sceneMgr, numNodes));
+    OGRE_DELETE sceneMgr;
+
+    sceneMgr = OGRE_NEW BVHSceneManager("BVH");
+    results.push_back(run(sceneMgr, numNodes));
+    OGRE_DELETE sceneMgr;
+
+    std::cout << numNodes << " nodes" << std::endl;
+    std::cout << std::left << std::setw(22) << "Scene manager" << std::right
+              << std::setw(12) << "insert ms" << std::setw(12) << "move ms"
+              << std::setw(12) << "cull ms" << std::setw(12) << "ray us"
+              << std::setw(12) << "sphere us" << std::setw(12) << "box us" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Timings& t = results[i];
+        std::cout << std::left << std::setw(22) << t.name << std::right
+                  << std::setw(12) << t.insert << std::setw(12) << t.move
+                  << std::setw(12) << t.cull << std::setw(12) << t.rayQuery
+                  << std::setw(12) << t.sphereQuery << std::setw(12) << t.boxQuery << std::endl;
+    }
+
+    root->removeMovableObjectFactory(&factory);
+    OGRE_DELETE bufferMgr;
+    OGRE_DELETE root;
+    OGRE_DELETE logMgr;
+    return 0;
+}
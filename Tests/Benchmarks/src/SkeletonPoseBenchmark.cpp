@@ -0,0 +1,191 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/*  Measures the posing of a crowd of skeletons, through the Bone nodes as
+    Entity does by default and through SkeletonPoseEvaluator. Each skeleton
+    blends two animations, one of them with a blend mask, at its own time
+    position.
+
+    Usage: Benchmark_SkeletonPose [number of skeletons] [number of bones]
+*/
+
+#include "Ogre.h"
+#include "OgreSkeletonPoseEvaluator.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace Ogre;
+
+namespace
+{
+    const int FRAMES = 20;
+
+    /// Skeleton of chains of five bones branching from the root, as limbs and fingers
+    SkeletonPtr createSkeleton(unsigned short numBones)
+    {
+        SkeletonPtr skel = SkeletonManager::getSingleton().create("Benchmark.skeleton",
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true).staticCast<Skeleton>();
+        skel->createBone(0);
+        for (unsigned short h = 1; h < numBones; ++h)
+        {
+            Bone* bone = skel->createBone(h);
+            skel->getBone(h % 5 == 1 ? 0 : h - 1)->addChild(bone);
+            bone->setPosition(Math::RangeRandom(-1, 1), 1, Math::RangeRandom(-1, 1));
+        }
+        skel->setBindingPose();
+
+        const char* names[2] = { "Walk", "Wave" };
+        for (size_t a = 0; a < 2; ++a)
+        {
+            Animation* anim = skel->createAnimation(names[a], 1);
+            for (unsigned short h = 0; h < numBones; ++h)
+            {
+                NodeAnimationTrack* track = anim->createNodeTrack(h, skel->getBone(h));
+                for (size_t k = 0; k <= 30; ++k)
+                {
+                    TransformKeyFrame* kf = track->createNodeKeyFrame(k / 30.0f);
+                    kf->setRotation(Quaternion(Radian(Math::RangeRandom(-1, 1)), Vector3::UNIT_X));
+                    kf->setTranslate(Vector3(0, Math::RangeRandom(-0.1f, 0.1f), 0));
+                }
+            }
+        }
+        return skel;
+    }
+
+    /// A skeleton of the crowd with its animation states
+    struct Character
+    {
+        SkeletonInstance* skeleton;
+        AnimationStateSet states;
+        vector<Matrix4>::type matrices;
+    };
+    typedef vector<Character*>::type CharacterList;
+
+    void advance(CharacterList& characters, Real timeSinceLastFrame)
+    {
+        for (size_t c = 0; c < characters.size(); ++c)
+        {
+            characters[c]->states.getAnimationState("Walk")->addTime(timeSinceLastFrame);
+            characters[c]->states.getAnimationState("Wave")->addTime(timeSinceLastFrame);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t numSkeletons = 1000;
+    unsigned short numBones = 60;
+    if (argc > 1)
+        numSkeletons = StringConverter::parseUnsignedInt(argv[1], 1000);
+    if (argc > 2)
+        numBones = std::max(1u, StringConverter::parseUnsignedInt(argv[2], 60));
+
+    // Keep the log out of the results
+    LogManager* logMgr = OGRE_NEW LogManager();
+    logMgr->createLog("Benchmark_SkeletonPose.log", true, false, true);
+    Root* root = OGRE_NEW Root("", "", "");
+
+    srand(1);
+    SkeletonPtr skel = createSkeleton(numBones);
+    CharacterList characters;
+    for (size_t c = 0; c < numSkeletons; ++c)
+    {
+        Character* character = OGRE_NEW_T(Character, MEMCATEGORY_GENERAL)();
+        character->skeleton = OGRE_NEW SkeletonInstance(skel);
+        character->skeleton->load();
+        character->skeleton->_initAnimationState(&character->states);
+        character->matrices.resize(numBones);
+
+        AnimationState* walk = character->states.getAnimationState("Walk");
+        walk->setEnabled(true);
+        walk->setLoop(true);
+        walk->setTimePosition(Math::UnitRandom());
+        AnimationState* wave = character->states.getAnimationState("Wave");
+        wave->setEnabled(true);
+        wave->setLoop(true);
+        wave->setWeight(0.5f);
+        wave->setTimePosition(Math::UnitRandom());
+        wave->createBlendMask(numBones, 0);
+        for (unsigned short h = 0; h < numBones / 3; ++h)
+            wave->setBlendMaskEntry(h, 1);
+
+        characters.push_back(character);
+    }
+
+    std::cout << numSkeletons << " skeletons of " << numBones
+              << " bones; microseconds per frame" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    Timer timer;
+    unsigned long nodeTime = ~0ul, evaluatorTime = ~0ul;
+    for (int run = 0; run < 3; ++run)
+    {
+        // Bone nodes, as Entity::cacheBoneMatrices
+        timer.reset();
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            advance(characters, 1 / 60.0f);
+            for (size_t c = 0; c < characters.size(); ++c)
+            {
+                characters[c]->skeleton->setAnimationState(characters[c]->states);
+                characters[c]->skeleton->_getBoneMatrices(&characters[c]->matrices[0]);
+            }
+        }
+        nodeTime = std::min(nodeTime, timer.getMicroseconds());
+
+        timer.reset();
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            advance(characters, 1 / 60.0f);
+            for (size_t c = 0; c < characters.size(); ++c)
+            {
+                characters[c]->skeleton->_getPoseEvaluator()->evaluate(
+                    characters[c]->states, &characters[c]->matrices[0]);
+            }
+        }
+        evaluatorTime = std::min(evaluatorTime, timer.getMicroseconds());
+    }
+
+    std::cout << std::left << std::setw(20) << "Bone nodes" << std::right
+              << std::setw(12) << double(nodeTime) / FRAMES << std::endl;
+    std::cout << std::left << std::setw(20) << "Pose evaluator" << std::right
+              << std::setw(12) << double(evaluatorTime) / FRAMES << std::endl;
+    std::cout << "Speed-up: " << std::setprecision(2)
+              << double(nodeTime) / std::max(1ul, evaluatorTime) << std::endl;
+
+    for (size_t c = 0; c < characters.size(); ++c)
+    {
+        OGRE_DELETE characters[c]->skeleton;
+        OGRE_DELETE_T(characters[c], Character, MEMCATEGORY_GENERAL);
+    }
+    skel.setNull();
+    OGRE_DELETE root;
+    OGRE_DELETE logMgr;
+    return 0;
+}
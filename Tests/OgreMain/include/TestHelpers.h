@@ -0,0 +1,71 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef TESTS_OGREMAIN_INCLUDE_TESTHELPERS_H_
+#define TESTS_OGREMAIN_INCLUDE_TESTHELPERS_H_
+
+#include <OgreRoot.h>
+#include <OgreResourceGroupManager.h>
+#include "Threading/OgreJobWorkQueue.h"
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+#include "macUtils.h"
+#endif
+
+/** Creates and initialises a resource group declaring meshes of the sample media.
+*/
+inline void declareSampleMeshes(const Ogre::String& group, const char* const meshes[], size_t numMeshes)
+{
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+    Ogre::String mediaPath = Ogre::macBundlePath() + "/Contents/Resources/Media/models";
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    Ogre::String mediaPath = "../../Samples/Media/models";
+#else
+    Ogre::String mediaPath = "./Samples/Media/models";
+#endif
+    Ogre::ResourceGroupManager& rgm = Ogre::ResourceGroupManager::getSingleton();
+    rgm.createResourceGroup(group);
+    rgm.addResourceLocation(mediaPath, "FileSystem", group);
+    for (size_t i = 0; i < numMeshes; ++i)
+        rgm.declareResource(meshes[i], "Mesh", group);
+    rgm.initialiseResourceGroup(group);
+}
+
+/** Starts a JobWorkQueue with some worker threads and hands it over to Root,
+    which destroys it.
+*/
+inline Ogre::JobWorkQueue* startJobWorkQueue(const Ogre::String& name, size_t numThreads = 4)
+{
+    Ogre::JobWorkQueue* queue = OGRE_NEW Ogre::JobWorkQueue(name);
+    queue->setWorkerThreadCount(numThreads);
+    queue->startup();
+    Ogre::Root::getSingleton().setWorkQueue(queue);
+    return queue;
+}
+
+#endif /* TESTS_OGREMAIN_INCLUDE_TESTHELPERS_H_ */
@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreAnimationPoseCache.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture AnimationPoseCacheTests;
+
+namespace {
+    /// A crowd of robots, in three groups playing the same animation in step
+    struct Crowd
+    {
+        SceneManager* sceneMgr;
+        vector<Entity*>::type entities;
+
+        Crowd(bool caching)
+        {
+            sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+            sceneMgr->setAnimationPoseCaching(caching);
+            EXPECT_EQ(caching, sceneMgr->getAnimationPoseCaching());
+            for (int i = 0; i < 12; ++i)
+            {
+                Entity* ent = sceneMgr->createEntity("robot.mesh");
+                sceneMgr->getRootSceneNode()->createChildSceneNode(
+                    Vector3(Real(i) * 100, 0, 0))->attachObject(ent);
+                entities.push_back(ent);
+
+                AnimationState* state = ent->getAnimationState(i % 3 ? "Walk" : "Shoot");
+                state->setEnabled(true);
+                state->setTimePosition(state->getLength() * Real(i % 2) / 4);
+            }
+        }
+
+        ~Crowd()
+        {
+            MeshPtr meshPtr = entities[0]->getMesh();
+            sceneMgr->clearScene();
+            SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+            MeshManager::getSingleton().remove(meshPtr->getHandle());
+        }
+
+        /// Starts a new frame and animates the whole crowd, even the unchanged entities
+        void animate(vector<Matrix4>::type& boneMatrices)
+        {
+            FrameEvent evt;
+            Root::getSingleton()._fireFrameRenderingQueued(evt);
+            boneMatrices.clear();
+            for (size_t i = 0; i < entities.size(); ++i)
+            {
+                entities[i]->getAllAnimationStates()->_notifyDirty();
+                entities[i]->_updateAnimation();
+                const Matrix4* matrices = entities[i]->_getBoneMatrices();
+                boneMatrices.insert(boneMatrices.end(),
+                    matrices, matrices + entities[i]->_getNumBoneMatrices());
+            }
+        }
+    };
+
+    void expectNear(const vector<Matrix4>::type& expected, const vector<Matrix4>::type& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t b = 0; b < expected.size(); ++b)
+        {
+            for (size_t i = 0; i < 16; ++i)
+                EXPECT_NEAR(expected[b][i / 4][i % 4], actual[b][i / 4][i % 4], 1e-3f) << b;
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(AnimationPoseCacheTests, SharesIdenticalPoses)
+{
+    vector<Matrix4>::type expected, actual;
+    {
+        Crowd crowd(false);
+        crowd.animate(expected);
+    }
+
+    Crowd crowd(true);
+    crowd.animate(actual);
+    expectNear(expected, actual);
+
+    // Shoot at two time positions, Walk at two time positions
+    AnimationPoseCache* cache = crowd.sceneMgr->getAnimationPoseCache();
+    EXPECT_EQ(4u, cache->getNumPoses());
+    EXPECT_EQ(8u, cache->getNumHits());
+}
+//--------------------------------------------------------------------------
+TEST_F(AnimationPoseCacheTests, DivergingStates)
+{
+    Crowd crowd(true);
+    AnimationPoseCache* cache = crowd.sceneMgr->getAnimationPoseCache();
+    vector<Matrix4>::type matrices;
+    crowd.animate(matrices);
+
+    // An entity whose state diverges gets a pose of its own
+    crowd.entities[1]->getAnimationState("Walk")->setWeight(0.5f);
+    crowd.entities[4]->getAnimationState("Walk")->addTime(0.1f);
+    crowd.animate(matrices);
+    EXPECT_EQ(6u, cache->getNumPoses());
+    EXPECT_EQ(6u, cache->getNumHits());
+
+    // And shares it again once back in step
+    crowd.entities[1]->getAnimationState("Walk")->setWeight(1);
+    crowd.entities[4]->getAnimationState("Walk")->addTime(-0.1f);
+    crowd.animate(matrices);
+    EXPECT_EQ(4u, cache->getNumPoses());
+
+    // Quantised time positions let entities slightly apart share a pose
+    cache->setTimeQuantum(0.05f);
+    crowd.entities[4]->getAnimationState("Walk")->addTime(0.01f);
+    crowd.animate(matrices);
+    EXPECT_EQ(4u, cache->getNumPoses());
+
+    // Objects attached to the bones need the entity's own bones
+    Entity* sword = crowd.sceneMgr->createEntity("Sword", "robot.mesh");
+    crowd.entities[4]->attachObjectToBone(crowd.entities[4]->getSkeleton()->getBone(1)->getName(), sword);
+    crowd.entities[4]->getAnimationState("Walk")->addTime(-0.01f);
+    crowd.animate(matrices);
+    EXPECT_EQ(4u, cache->getNumPoses());
+    EXPECT_EQ(7u, cache->getNumHits());
+
+    crowd.sceneMgr->setAnimationPoseCaching(false);
+    EXPECT_TRUE(crowd.sceneMgr->getAnimationPoseCache() == 0);
+}
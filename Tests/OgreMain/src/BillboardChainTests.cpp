@@ -0,0 +1,440 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include <OgreDefaultHardwareBufferManager.h>
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// A lock of a buffer, as seen by the buffer manager below
+    struct BufferLock
+    {
+        HardwareBuffer* buffer;
+        size_t offset;
+        size_t length;
+        HardwareBuffer::LockOptions options;
+    };
+    typedef vector<BufferLock>::type BufferLockList;
+
+    /** Overwrites what a real render system does not preserve when locking:
+        the whole buffer when discarding, the locked range otherwise.
+    */
+    void poisonLockedData(HardwareBuffer* buffer, unsigned char* data, size_t offset,
+        size_t length, HardwareBuffer::LockOptions options, BufferLockList& locks)
+    {
+        BufferLock lock = { buffer, offset, length, options };
+        locks.push_back(lock);
+        if (options == HardwareBuffer::HBL_DISCARD)
+            memset(data, 0xCD, buffer->getSizeInBytes());
+        else if (options == HardwareBuffer::HBL_NO_OVERWRITE)
+            memset(data + offset, 0xCD, length);
+    }
+
+    class PoisonedVertexBuffer : public DefaultHardwareVertexBuffer
+    {
+        BufferLockList& mLocks;
+    public:
+        PoisonedVertexBuffer(HardwareBufferManagerBase* mgr, size_t vertexSize, size_t numVertices,
+            HardwareBuffer::Usage usage, BufferLockList& locks)
+            : DefaultHardwareVertexBuffer(mgr, vertexSize, numVertices, usage), mLocks(locks) {}
+        void* lock(size_t offset, size_t length, LockOptions options, UploadOptions uploadOpt)
+        {
+            poisonLockedData(this, mData, offset, length, options, mLocks);
+            return DefaultHardwareVertexBuffer::lock(offset, length, options, uploadOpt);
+        }
+    };
+
+    class PoisonedIndexBuffer : public DefaultHardwareIndexBuffer
+    {
+        BufferLockList& mLocks;
+    public:
+        PoisonedIndexBuffer(IndexType idxType, size_t numIndexes, HardwareBuffer::Usage usage,
+            BufferLockList& locks)
+            : DefaultHardwareIndexBuffer(idxType, numIndexes, usage), mLocks(locks) {}
+        void* lock(size_t offset, size_t length, LockOptions options, UploadOptions uploadOpt)
+        {
+            poisonLockedData(this, mData, offset, length, options, mLocks);
+            return DefaultHardwareIndexBuffer::lock(offset, length, options, uploadOpt);
+        }
+    };
+
+    class PoisonedBufferManagerBase : public DefaultHardwareBufferManagerBase
+    {
+    public:
+        BufferLockList mLocks;
+
+        HardwareVertexBufferSharedPtr createVertexBuffer(size_t vertexSize, size_t numVerts,
+            HardwareBuffer::Usage usage, bool useShadowBuffer = false)
+        {
+            return HardwareVertexBufferSharedPtr(
+                OGRE_NEW PoisonedVertexBuffer(this, vertexSize, numVerts, usage, mLocks));
+        }
+        HardwareIndexBufferSharedPtr createIndexBuffer(HardwareIndexBuffer::IndexType itype,
+            size_t numIndexes, HardwareBuffer::Usage usage, bool useShadowBuffer = false)
+        {
+            return HardwareIndexBufferSharedPtr(
+                OGRE_NEW PoisonedIndexBuffer(itype, numIndexes, usage, mLocks));
+        }
+    };
+
+    class PoisonedBufferManager : public HardwareBufferManager
+    {
+    public:
+        PoisonedBufferManager() : HardwareBufferManager(OGRE_NEW PoisonedBufferManagerBase()) {}
+        ~PoisonedBufferManager() { OGRE_DELETE mImpl; }
+
+        BufferLockList& getLocks() { return static_cast<PoisonedBufferManagerBase*>(mImpl)->mLocks; }
+    };
+
+    /// The DefaultHardwareBufferManager ignores lock options, this one doesn't
+    class BillboardChainTests : public RootWithoutRenderSystemFixture
+    {
+    public:
+        PoisonedBufferManager* mPoisonedHBM;
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            delete mHBM;
+            mHBM = mPoisonedHBM = new PoisonedBufferManager;
+        }
+    };
+
+    class TestChain : public BillboardChain
+    {
+    public:
+        TestChain(const String& name) : BillboardChain(name, 10, 2) {}
+        using BillboardChain::updateVertexBuffer;
+        using BillboardChain::updateIndexBuffer;
+
+        BillboardChainBatch* getBatch() { return mBatch; }
+
+        /// Queues a streamed chain into its batch, as _updateRenderQueue would
+        void queueStreamed(Camera* cam)
+        {
+            updateBatch();
+            if (hasQuads())
+                mBatch->_notifyChainVisible(this, cam);
+        }
+
+        /// The vertices of the elements in use
+        vector<char>::type readVertices()
+        {
+            RenderOperation op;
+            getRenderOperation(op);
+            HardwareVertexBufferSharedPtr buffer = op.vertexData->vertexBufferBinding->getBuffer(0);
+            size_t elementSize = buffer->getVertexSize() * 2;
+            vector<char>::type contents;
+            for (size_t c = 0; c < mChainSegmentList.size(); ++c)
+            {
+                const ChainSegment& seg = mChainSegmentList[c];
+                if (seg.head == SEGMENT_EMPTY || seg.head == seg.tail)
+                    continue;
+                for (size_t e = seg.head; ; e = (e + 1) % mMaxElementsPerChain)
+                {
+                    // Streamed elements are wherever they were last written
+                    size_t index = seg.start + e;
+                    size_t slot = mStreaming ? mElementSlots[index] : index;
+                    size_t end = contents.size();
+                    contents.resize(end + elementSize);
+                    buffer->readData(slot * elementSize, elementSize, &contents[end]);
+                    if (e == seg.tail)
+                        break;
+                }
+            }
+            return contents;
+        }
+
+        /// The triangles drawn, without degenerate ones, numbered by element
+        vector<uint64>::type readTriangles()
+        {
+            RenderOperation op;
+            getRenderOperation(op);
+            vector<uint32>::type indices(op.indexData->indexCount);
+            if (!indices.empty())
+            {
+                HardwareIndexBufferSharedPtr buffer = op.indexData->indexBuffer;
+                size_t indexSize = buffer->getIndexSize();
+                vector<char>::type data(indices.size() * indexSize);
+                buffer->readData(op.indexData->indexStart * indexSize, data.size(), &data[0]);
+                for (size_t i = 0; i < indices.size(); ++i)
+                {
+                    if (buffer->getType() == HardwareIndexBuffer::IT_32BIT)
+                        indices[i] = reinterpret_cast<uint32*>(&data[0])[i];
+                    else
+                        indices[i] = reinterpret_cast<uint16*>(&data[0])[i];
+                }
+            }
+
+            // Number the streamed vertices like the ones of a full rewrite
+            if (mStreaming)
+            {
+                map<uint32, uint32>::type elementOfSlot;
+                for (size_t c = 0; c < mChainSegmentList.size(); ++c)
+                {
+                    const ChainSegment& seg = mChainSegmentList[c];
+                    if (seg.head == SEGMENT_EMPTY || seg.head == seg.tail)
+                        continue;
+                    for (size_t e = seg.head; ; e = (e + 1) % mMaxElementsPerChain)
+                    {
+                        elementOfSlot[mElementSlots[seg.start + e]] = static_cast<uint32>(seg.start + e);
+                        if (e == seg.tail)
+                            break;
+                    }
+                }
+                for (size_t i = 0; i < indices.size(); ++i)
+                {
+                    EXPECT_TRUE(elementOfSlot.count(indices[i] / 2) != 0);
+                    indices[i] = elementOfSlot[indices[i] / 2] * 2 + indices[i] % 2;
+                }
+            }
+
+            vector<uint64>::type triangles;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                if (indices[i] == indices[i + 1] || indices[i] == indices[i + 2] ||
+                    indices[i + 1] == indices[i + 2])
+                    continue;
+                triangles.push_back((uint64(indices[i]) << 32) |
+                    (uint64(indices[i + 1]) << 16) | indices[i + 2]);
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+    };
+
+    /// The vertices referred to by the indices of a render operation
+    set<size_t>::type readIndexedVertices(const RenderOperation& op)
+    {
+        set<size_t>::type vertices;
+        HardwareIndexBufferSharedPtr buffer = op.indexData->indexBuffer;
+        for (size_t i = 0; i < op.indexData->indexCount; ++i)
+        {
+            uint32 index = 0;
+            buffer->readData((op.indexData->indexStart + i) * buffer->getIndexSize(),
+                buffer->getIndexSize(), &index);
+            vertices.insert(index);
+        }
+        return vertices;
+    }
+
+    /// Positions of the vertices moved by a transform
+    vector<char>::type transformPositions(vector<char>::type vertices, size_t vertexSize,
+        const Matrix4& xform)
+    {
+        for (size_t v = 0; v < vertices.size(); v += vertexSize)
+        {
+            float* pFloat = reinterpret_cast<float*>(&vertices[v]);
+            Vector3 pos = xform.transformAffine(Vector3(pFloat[0], pFloat[1], pFloat[2]));
+            pFloat[0] = pos.x;
+            pFloat[1] = pos.y;
+            pFloat[2] = pos.z;
+        }
+        return vertices;
+    }
+    void changeChain(BillboardChain* chain, size_t step)
+    {
+        for (size_t c = 0; c < chain->getNumberOfChains(); ++c)
+        {
+            chain->addChainElement(c, BillboardChain::Element(
+                Vector3(Real(c), Real(step), Real(step * step % 7)), 1, Real(step),
+                ColourValue::White, Quaternion::IDENTITY));
+            if (step % 3 == 0)
+                chain->removeChainElement(c);
+            if (chain->getNumChainElements(c) > 2)
+            {
+                BillboardChain::Element elem = chain->getChainElement(c, 1);
+                elem.width += 1;
+                chain->updateChainElement(c, 1, elem);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(BillboardChainTests, StreamingMatchesFullRewrite)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Camera* cam = sceneMgr->createCamera("Camera");
+    BufferLockList& locks = mPoisonedHBM->getLocks();
+
+    for (int faceCamera = 0; faceCamera < 2; ++faceCamera)
+    {
+        cam->setPosition(5, 5, 20);
+        TestChain full("Full");
+        TestChain streamed("Streamed");
+        streamed.setStreamingEnabled(true);
+        EXPECT_TRUE(streamed.getStreamingEnabled());
+
+        TestChain* chains[2] = { &full, &streamed };
+        for (int i = 0; i < 2; ++i)
+        {
+            // Converting colours needs a render system
+            chains[i]->setUseVertexColours(false);
+            chains[i]->setFaceCamera(faceCamera != 0, Vector3::UNIT_Z);
+            sceneMgr->getRootSceneNode()->attachObject(chains[i]);
+        }
+
+        // What the previous frame drew, which the GPU may still be reading
+        set<size_t>::type drawnVertices;
+        size_t drawnIndexStart = 0, drawnIndexEnd = 0;
+        size_t discards = 0, appends = 0;
+
+        // Enough steps to wrap the elements around the chains, and the
+        // streamed elements around the buffers
+        for (size_t step = 0; step < 25; ++step)
+        {
+            if (step == 12)
+                cam->setPosition(-5, 5, 20);
+
+            for (int i = 0; i < 2; ++i)
+                changeChain(chains[i], step);
+            full.updateVertexBuffer(cam);
+            full.updateIndexBuffer();
+
+            locks.clear();
+            streamed.queueStreamed(cam);
+            streamed.getBatch()->_updateBuffers(cam);
+
+            RenderOperation op;
+            streamed.getRenderOperation(op);
+            HardwareVertexBufferSharedPtr vbuf = op.vertexData->vertexBufferBinding->getBuffer(0);
+            size_t vertexSize = vbuf->getVertexSize();
+            size_t indexSize = op.indexData->indexBuffer->getIndexSize();
+            for (BufferLockList::iterator l = locks.begin(); l != locks.end(); ++l)
+            {
+                if (l->options == HardwareBuffer::HBL_DISCARD)
+                {
+                    ++discards;
+                    continue;
+                }
+                ++appends;
+                EXPECT_EQ(HardwareBuffer::HBL_NO_OVERWRITE, l->options);
+                if (l->buffer == vbuf.get())
+                {
+                    for (set<size_t>::type::iterator v = drawnVertices.begin();
+                        v != drawnVertices.end(); ++v)
+                    {
+                        EXPECT_TRUE((*v + 1) * vertexSize <= l->offset ||
+                            *v * vertexSize >= l->offset + l->length);
+                    }
+                }
+                else
+                {
+                    EXPECT_TRUE(drawnIndexEnd * indexSize <= l->offset ||
+                        drawnIndexStart * indexSize >= l->offset + l->length);
+                }
+            }
+
+            EXPECT_TRUE(full.readVertices() == streamed.readVertices());
+            EXPECT_TRUE(full.readTriangles() == streamed.readTriangles());
+
+            drawnVertices = readIndexedVertices(op);
+            drawnIndexStart = op.indexData->indexStart;
+            drawnIndexEnd = drawnIndexStart + op.indexData->indexCount;
+        }
+        EXPECT_GT(discards, 0u);
+        EXPECT_GT(appends, 0u);
+
+        sceneMgr->getRootSceneNode()->detachAllObjects();
+    }
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+TEST_F(BillboardChainTests, SharedBuffersHoldWorldSpaceChains)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Camera* cam = sceneMgr->createCamera("Camera");
+    cam->setPosition(5, 5, 20);
+
+    SceneNode* nodes[2] =
+    {
+        sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(10, 0, 0)),
+        sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, -4, 2),
+            Quaternion(Degree(30), Vector3::UNIT_Y))
+    };
+    sceneMgr->getRootSceneNode()->_update(true, false);
+
+    TestChain full0("Full0"), full1("Full1"), shared0("Shared0"), shared1("Shared1");
+    TestChain* full[2] = { &full0, &full1 };
+    TestChain* shared[2] = { &shared0, &shared1 };
+    for (int i = 0; i < 2; ++i)
+    {
+        shared[i]->setStreamingEnabled(true);
+        shared[i]->setBufferSharingEnabled(true);
+        EXPECT_TRUE(shared[i]->getBufferSharingEnabled());
+        full[i]->setUseVertexColours(false);
+        shared[i]->setUseVertexColours(false);
+        nodes[i]->attachObject(full[i]);
+        nodes[i]->attachObject(shared[i]);
+    }
+
+    for (size_t step = 0; step < 10; ++step)
+    {
+        size_t indexCount = 0;
+        for (int i = 0; i < 2; ++i)
+        {
+            changeChain(full[i], step);
+            changeChain(shared[i], step);
+            full[i]->updateVertexBuffer(cam);
+            full[i]->updateIndexBuffer();
+            RenderOperation op;
+            full[i]->getRenderOperation(op);
+            indexCount += op.indexData->indexCount;
+
+            shared[i]->queueStreamed(cam);
+        }
+
+        // Both chains are drawn by one operation, in world space
+        ASSERT_EQ(shared0.getBatch(), shared1.getBatch());
+        shared0.getBatch()->_updateBuffers(cam);
+        RenderOperation op;
+        shared0.getRenderOperation(op);
+        EXPECT_EQ(indexCount, op.indexData->indexCount);
+
+        size_t vertexSize = op.vertexData->vertexDeclaration->getVertexSize(0);
+        for (int i = 0; i < 2; ++i)
+        {
+            EXPECT_TRUE(transformPositions(full[i]->readVertices(), vertexSize,
+                nodes[i]->_getFullTransform()) == shared[i]->readVertices());
+        }
+    }
+
+    // A chain which stops sharing gets its own batch
+    shared1.setBufferSharingEnabled(false);
+    shared1.queueStreamed(cam);
+    EXPECT_NE(shared0.getBatch(), shared1.getBatch());
+    EXPECT_FALSE(shared1.getBatch()->isShared());
+
+    for (int i = 0; i < 2; ++i)
+        nodes[i]->detachAllObjects();
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
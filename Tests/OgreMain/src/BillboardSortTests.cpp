@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture BillboardSortTests;
+
+namespace {
+    BillboardSet* createSortedSet(SceneManager* sceneMgr, int count)
+    {
+        BillboardSet* set = sceneMgr->createBillboardSet(count);
+        sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(set);
+        set->setSortingEnabled(true);
+        for (int i = 0; i < count; ++i)
+        {
+            set->createBillboard(Math::RangeRandom(-100, 100),
+                Math::RangeRandom(-100, 100), Math::RangeRandom(-100, 100));
+        }
+        return set;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(BillboardSortTests, BackToFront)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Camera* cam = sceneMgr->createCamera("Camera");
+    // Enough billboards for the keys to be sorted with several passes
+    BillboardSet* set = createSortedSet(sceneMgr, 3001);
+
+    // Looking down -Z from the origin, along the camera direction
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    for (int i = 1; i < set->getNumBillboards(); ++i)
+    {
+        EXPECT_LE(set->getBillboard(i - 1)->getPosition().z, set->getBillboard(i)->getPosition().z);
+    }
+
+    // By distance
+    set->setUseAccurateFacing(true);
+    cam->setPosition(10, 20, 30);
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    for (int i = 1; i < set->getNumBillboards(); ++i)
+    {
+        Real previous = set->getBillboard(i - 1)->getPosition().squaredDistance(cam->getPosition());
+        Real current = set->getBillboard(i)->getPosition().squaredDistance(cam->getPosition());
+        EXPECT_GE(previous, current * (1 - 1e-5f));
+    }
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+TEST_F(BillboardSortTests, ReusedWhileCameraMovesLittle)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Camera* cam = sceneMgr->createCamera("Camera");
+    BillboardSet* set = createSortedSet(sceneMgr, 2);
+    set->getBillboard(0)->setPosition(0, 0, -10);
+    set->getBillboard(1)->setPosition(0, 0, -20);
+    set->setSortingReuseDistance(1);
+    EXPECT_EQ(1, set->getSortingReuseDistance());
+
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    Billboard* farthest = set->getBillboard(0);
+    EXPECT_EQ(-20, farthest->getPosition().z);
+
+    // Swap the depths unnoticed, the camera turning by less than the reuse
+    // distance over the radius of the billboards keeps the order
+    farthest->mPosition.z = -5;
+    cam->yaw(Degree(1));
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    EXPECT_EQ(farthest, set->getBillboard(0));
+
+    // Moving a billboard sorts them again
+    farthest->setPosition(0, 0, -5);
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    EXPECT_NE(farthest, set->getBillboard(0));
+
+    // As does turning further
+    set->getBillboard(0)->mPosition.z = -1;
+    cam->yaw(Degree(10));
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    EXPECT_EQ(farthest, set->getBillboard(0));
+
+    // As does creating a billboard
+    set->getBillboard(0)->setPosition(0, 0, -30);
+    set->createBillboard(0, 0, -40);
+    set->_notifyCurrentCamera(cam);
+    set->_sortBillboards(cam);
+    EXPECT_EQ(-40, set->getBillboard(0)->getPosition().z);
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
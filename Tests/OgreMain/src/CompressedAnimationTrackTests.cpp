@@ -0,0 +1,253 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreCompressedTransformTrack.h"
+#include "OgreSkeletonSerializer.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture CompressedAnimationTrackTests;
+
+namespace {
+    /// Fills a track with swinging and moving keyframes, of constant scale
+    void createKeyFrames(NodeAnimationTrack* track, size_t numKeyFrames, Real length)
+    {
+        for (size_t k = 0; k < numKeyFrames; ++k)
+        {
+            Real t = length * k / (numKeyFrames - 1);
+            TransformKeyFrame* kf = track->createNodeKeyFrame(t);
+            kf->setRotation(Quaternion(Radian(Math::Sin(t) * 2), Vector3(1, 2, 3).normalisedCopy()));
+            kf->setTranslate(Vector3(Math::Cos(t) * 40, t * 3, 5));
+            kf->setScale(Vector3(2, 2, 2));
+        }
+    }
+
+    void expectNear(const TransformKeyFrame& expected, const TransformKeyFrame& actual,
+        Real rotationTolerance, Real vectorTolerance)
+    {
+        for (size_t c = 0; c < 4; ++c)
+            EXPECT_NEAR(expected.getRotation()[c], actual.getRotation()[c], rotationTolerance);
+        for (size_t c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(expected.getTranslate()[c], actual.getTranslate()[c], vectorTolerance);
+            EXPECT_NEAR(expected.getScale()[c], actual.getScale()[c], vectorTolerance);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST_F(CompressedAnimationTrackTests, QuantisedRotations)
+{
+    srand(4);
+    for (int i = 0; i < 1000; ++i)
+    {
+        Quaternion q(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1),
+            Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+        q.normalise();
+
+        uint16 quantised[3];
+        CompressedTransformTrack::encodeRotation(q, quantised);
+        Quaternion decoded = CompressedTransformTrack::decodeRotation(quantised);
+        // The same quaternion, not its opposite
+        for (size_t c = 0; c < 4; ++c)
+            EXPECT_NEAR(q[c], decoded[c], 5e-5f);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(CompressedAnimationTrackTests, MatchesKeyFrames)
+{
+    Animation anim("Swing", 8);
+    NodeAnimationTrack* plain = anim.createNodeTrack(0);
+    NodeAnimationTrack* compressed = anim.createNodeTrack(1);
+    createKeyFrames(plain, 33, 8);
+    createKeyFrames(compressed, 33, 8);
+
+    compressed->compress();
+    ASSERT_TRUE(compressed->isCompressed());
+    EXPECT_EQ(33, compressed->getNumKeyFrames());
+    const CompressedTransformTrack* keyFrames = compressed->getCompressedKeyFrames();
+    EXPECT_FALSE(keyFrames->isRotationConstant());
+    EXPECT_FALSE(keyFrames->isTranslateConstant());
+    EXPECT_TRUE(keyFrames->isScaleConstant());
+    EXPECT_LT(keyFrames->getMemoryUsage(), 33 * sizeof(TransformKeyFrame));
+
+    for (int i = 0; i <= 100; ++i)
+    {
+        // With and without the global key index, and wrapping around
+        Real time = Real(i) * Real(0.09);
+        TimeIndex indices[2] = { anim._getTimeIndex(time), TimeIndex(time) };
+        for (size_t j = 0; j < 2; ++j)
+        {
+            TransformKeyFrame expected(0, time), actual(0, time);
+            plain->getInterpolatedKeyFrame(indices[j], &expected);
+            compressed->getInterpolatedKeyFrame(indices[j], &actual);
+            expectNear(expected, actual, 1e-4f, 1e-3f);
+        }
+    }
+
+    anim.setInterpolationMode(Animation::IM_SPLINE);
+    for (int i = 0; i < 50; ++i)
+    {
+        Real time = Real(i) * Real(0.15);
+        TransformKeyFrame expected(0, time), actual(0, time);
+        plain->getInterpolatedKeyFrame(anim._getTimeIndex(time), &expected);
+        compressed->getInterpolatedKeyFrame(anim._getTimeIndex(time), &actual);
+        expectNear(expected, actual, 1e-3f, 1e-2f);
+    }
+    EXPECT_TRUE(compressed->isCompressed());
+
+    // Reading a keyframe decodes a copy, which leaves the track compressed
+    const NodeAnimationTrack* reader = compressed;
+    const TransformKeyFrame* kf = reader->getNodeKeyFrame(3);
+    EXPECT_TRUE(compressed->isCompressed());
+    EXPECT_EQ(plain->getNodeKeyFrame(3)->getTime(), kf->getTime());
+    expectNear(*plain->getNodeKeyFrame(3), *kf, 1e-4f, 1e-3f);
+    KeyFrame *kf1, *kf2;
+    unsigned short firstKeyIndex;
+    reader->getKeyFramesAtTime(anim._getTimeIndex(0.3f), &kf1, &kf2, &firstKeyIndex);
+    EXPECT_EQ(1, firstKeyIndex);
+    EXPECT_EQ(reader->getKeyFrame(1), kf1);
+    EXPECT_EQ(reader->getKeyFrame(2), kf2);
+    EXPECT_TRUE(compressed->isCompressed());
+
+    // Decompressing gives back editable keyframes
+    compressed->decompress();
+    EXPECT_FALSE(compressed->isCompressed());
+    kf = compressed->getNodeKeyFrame(3);
+    expectNear(*plain->getNodeKeyFrame(3), *kf, 1e-4f, 1e-3f);
+}
+//--------------------------------------------------------------------------
+TEST_F(CompressedAnimationTrackTests, EditingDecompresses)
+{
+    Animation anim("Edit", 2);
+    NodeAnimationTrack* track = anim.createNodeTrack(0);
+    createKeyFrames(track, 9, 2);
+    track->compress();
+
+    // Getting a keyframe to change it must not hand out a detached copy
+    track->getNodeKeyFrame(4)->setTranslate(Vector3(7, 8, 9));
+    EXPECT_FALSE(track->isCompressed());
+    EXPECT_EQ(Vector3(7, 8, 9), track->getNodeKeyFrame(4)->getTranslate());
+    TransformKeyFrame sampled(0, 0);
+    track->getInterpolatedKeyFrame(anim._getTimeIndex(track->getNodeKeyFrame(4)->getTime()), &sampled);
+    EXPECT_EQ(Vector3(7, 8, 9), sampled.getTranslate());
+
+    track->compress();
+    KeyFrame *kf1, *kf2;
+    track->getKeyFramesAtTime(anim._getTimeIndex(0.3f), &kf1, &kf2);
+    EXPECT_FALSE(track->isCompressed());
+    EXPECT_EQ(track->getKeyFrame(1), kf1);
+    static_cast<TransformKeyFrame*>(kf1)->setScale(Vector3(3, 3, 3));
+    EXPECT_EQ(Vector3(3, 3, 3), track->getNodeKeyFrame(1)->getScale());
+}
+//--------------------------------------------------------------------------
+TEST_F(CompressedAnimationTrackTests, BaseKeyFrameKeepsTolerance)
+{
+    Animation anim("Sway", 4);
+    NodeAnimationTrack* track = anim.createNodeTrack(0);
+    for (size_t k = 0; k < 5; ++k)
+    {
+        // Moves less than the tolerance below
+        TransformKeyFrame* kf = track->createNodeKeyFrame(Real(k));
+        kf->setTranslate(Vector3(0, Real(k) / 100, 0));
+    }
+
+    track->compress(0.1f);
+    EXPECT_TRUE(track->getCompressedKeyFrames()->isTranslateConstant());
+
+    TransformKeyFrame base(0, 0);
+    base.setTranslate(Vector3(1, 0, 0));
+    track->_applyBaseKeyFrame(&base);
+    ASSERT_TRUE(track->isCompressed());
+    EXPECT_TRUE(track->getCompressedKeyFrames()->isTranslateConstant());
+    const NodeAnimationTrack* reader = track;
+    EXPECT_NEAR(-1, reader->getNodeKeyFrame(0)->getTranslate().x, 1e-4f);
+    EXPECT_TRUE(track->isCompressed());
+}
+//--------------------------------------------------------------------------
+TEST_F(CompressedAnimationTrackTests, Serialisation)
+{
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("Compressed.skeleton",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true).staticCast<Skeleton>();
+    Bone* bone = skel->createBone("Root", 0);
+    skel->createBone("Child", 1);
+    bone->addChild(skel->getBone(1));
+    skel->setBindingPose();
+
+    Animation* anim = skel->createAnimation("Swing", 4);
+    createKeyFrames(anim->createNodeTrack(0, bone), 17, 4);
+    createKeyFrames(anim->createNodeTrack(1, skel->getBone(1)), 5, 4);
+    anim->getNodeTrack(0)->compress();
+    const CompressedTransformTrack* source = anim->getNodeTrack(0)->getCompressedKeyFrames();
+
+    SkeletonSerializer serializer;
+    SkeletonVersion versions[2] = { SKELETON_VERSION_LATEST, SKELETON_VERSION_1_8 };
+    for (size_t v = 0; v < 2; ++v)
+    {
+        MemoryDataStream* memory = OGRE_NEW MemoryDataStream(65536);
+        DataStreamPtr stream(memory);
+        serializer.exportSkeleton(skel.get(), stream, versions[v]);
+        // The source track is not decompressed to be written
+        EXPECT_TRUE(anim->getNodeTrack(0)->isCompressed());
+
+        DataStreamPtr written(OGRE_NEW MemoryDataStream(memory->getPtr(), stream->tell()));
+        SkeletonPtr loaded = SkeletonManager::getSingleton().create("Loaded.skeleton",
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true).staticCast<Skeleton>();
+        serializer.importSkeleton(written, loaded.get());
+
+        Animation* loadedAnim = loaded->getAnimation("Swing");
+        NodeAnimationTrack* track = loadedAnim->getNodeTrack(0);
+        EXPECT_EQ(v == 0, track->isCompressed());
+        EXPECT_FALSE(loadedAnim->getNodeTrack(1)->isCompressed());
+        ASSERT_EQ(17, track->getNumKeyFrames());
+        for (size_t k = 0; k < 17; ++k)
+        {
+            TransformKeyFrame expected(0, source->getTimes()[k]);
+            expected.setRotation(source->getRotation(k));
+            expected.setTranslate(source->getTranslate(k));
+            expected.setScale(source->getScale(k));
+            TransformKeyFrame actual(0, 0);
+            track->getInterpolatedKeyFrame(loadedAnim->_getTimeIndex(expected.getTime()), &actual);
+            expectNear(expected, actual, 0, 0);
+        }
+
+        SkeletonManager::getSingleton().remove(loaded->getHandle());
+    }
+
+    // Without compressed tracks, the latest version is the one before
+    anim->getNodeTrack(0)->decompress();
+    MemoryDataStream* memory = OGRE_NEW MemoryDataStream(65536);
+    DataStreamPtr stream(memory);
+    serializer.exportSkeleton(skel.get(), stream);
+    String header(reinterpret_cast<const char*>(memory->getPtr()) + sizeof(uint16), 18);
+    EXPECT_EQ("[Serializer_v1.80]", header);
+
+    SkeletonManager::getSingleton().remove(skel->getHandle());
+}
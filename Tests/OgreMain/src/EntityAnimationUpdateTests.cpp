@@ -0,0 +1,201 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreEntityAnimationUpdater.h"
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture EntityAnimationUpdateTests;
+
+namespace {
+    /** Keeps the renderables out of the render queue, as there is no render
+        system to give them a technique. */
+    class RejectRenderables : public RenderQueue::RenderableListener
+    {
+    public:
+        bool renderableQueued(Renderable*, uint8, ushort, Technique**, RenderQueue*)
+        {
+            return false;
+        }
+    };
+    RejectRenderables rejectRenderables;
+
+    /// Bone matrices and software skinned positions of a whole scene
+    struct AnimationResult
+    {
+        vector<Matrix4>::type boneMatrices;
+        vector<float>::type positions;
+    };
+
+    void readPositions(const VertexData* vertexData, vector<float>::type& positions)
+    {
+        const VertexElement* posElem =
+            vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf =
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        unsigned char* pVertex = static_cast<unsigned char*>(vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        for (size_t v = 0; v < vertexData->vertexCount; ++v, pVertex += vbuf->getVertexSize())
+        {
+            float* pFloat;
+            posElem->baseVertexPointerToElement(pVertex, &pFloat);
+            positions.insert(positions.end(), pFloat, pFloat + 3);
+        }
+        vbuf->unlock();
+    }
+
+    /** Animates a crowd of robots, a few of them behind the camera, and
+        queues the visible ones as _renderScene would. */
+    void animateCrowd(bool parallel, AnimationResult& result)
+    {
+        SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+        sceneMgr->setParallelAnimation(parallel);
+        sceneMgr->getRenderQueue()->setRenderableListener(&rejectRenderables);
+        EXPECT_EQ(parallel, sceneMgr->getParallelAnimation());
+        if (parallel)
+            sceneMgr->_getEntityAnimationUpdater()->setBatchSize(2);
+
+        Camera* cam = sceneMgr->createCamera("Cam");
+        cam->setPosition(Vector3::ZERO);
+        cam->lookAt(Vector3::NEGATIVE_UNIT_Z);
+
+        vector<Entity*>::type entities;
+        for (int i = 0; i < 24; ++i)
+        {
+            Entity* ent = sceneMgr->createEntity("robot.mesh");
+            Real z = i < 20 ? Real(-500) : Real(500);
+            sceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(Real(i % 5 - 2) * 100, 0, z))->attachObject(ent);
+            entities.push_back(ent);
+
+            AnimationState* state = ent->getAnimationState(i % 3 ? "Walk" : "Shoot");
+            state->setEnabled(true);
+            state->setTimePosition(state->getLength() * Real(i) / 24);
+        }
+        // Two robots sharing a skeleton, and one skinned in software
+        entities[4]->shareSkeletonInstanceWith(entities[5]);
+        entities[7]->addSoftwareAnimationRequest(false);
+
+        sceneMgr->_updateSceneGraph(cam);
+        sceneMgr->_findVisibleObjects(cam, 0, false);
+        sceneMgr->_updateEntityAnimations();
+
+        for (size_t i = 0; i < 20; ++i)
+        {
+            const Matrix4* matrices = entities[i]->_getBoneMatrices();
+            result.boneMatrices.insert(result.boneMatrices.end(),
+                matrices, matrices + entities[i]->_getNumBoneMatrices());
+        }
+        const Mesh* mesh = entities[7]->getMesh().get();
+        if (mesh->sharedVertexData)
+            readPositions(entities[7]->_getSkelAnimVertexData(), result.positions);
+        for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+        {
+            if (!mesh->getSubMesh(s)->useSharedVertices)
+                readPositions(entities[7]->getSubEntity(s)->_getSkelAnimVertexData(), result.positions);
+        }
+
+        MeshPtr meshPtr = entities[0]->getMesh();
+        sceneMgr->clearScene();
+        SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+        MeshManager::getSingleton().remove(meshPtr->getHandle());
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST_F(EntityAnimationUpdateTests, MatchesSerialUpdate)
+{
+    AnimationResult serial, parallel;
+    startJobWorkQueue("EntityAnimationUpdate");
+    animateCrowd(false, serial);
+    animateCrowd(true, parallel);
+
+    ASSERT_EQ(serial.boneMatrices.size(), parallel.boneMatrices.size());
+    for (size_t i = 0; i < serial.boneMatrices.size(); ++i)
+        EXPECT_EQ(serial.boneMatrices[i], parallel.boneMatrices[i]);
+
+    ASSERT_FALSE(serial.positions.empty());
+    ASSERT_EQ(serial.positions.size(), parallel.positions.size());
+    for (size_t i = 0; i < serial.positions.size(); ++i)
+        EXPECT_EQ(serial.positions[i], parallel.positions[i]);
+}
+//--------------------------------------------------------------------------
+TEST_F(EntityAnimationUpdateTests, QueuedUntilUpdated)
+{
+    startJobWorkQueue("EntityAnimationUpdate");
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    EXPECT_FALSE(sceneMgr->getParallelAnimation());
+    EXPECT_TRUE(sceneMgr->_getEntityAnimationUpdater() == 0);
+    sceneMgr->getRenderQueue()->setRenderableListener(&rejectRenderables);
+
+    Camera* cam = sceneMgr->createCamera("Cam");
+    cam->setPosition(Vector3::ZERO);
+    cam->lookAt(Vector3::NEGATIVE_UNIT_Z);
+    Entity* ent = sceneMgr->createEntity("robot.mesh");
+    sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, -500))->attachObject(ent);
+    AnimationState* state = ent->getAnimationState("Walk");
+    state->setEnabled(true);
+    state->setTimePosition(state->getLength() * 0.5f);
+
+    sceneMgr->setParallelAnimation(true);
+    sceneMgr->_updateSceneGraph(cam);
+    sceneMgr->_findVisibleObjects(cam, 0, false);
+    sceneMgr->_updateEntityAnimations();
+    Matrix4 first = ent->_getBoneMatrices()[1];
+
+    // In the next frame, the queued entity is not updated until the scene
+    // manager says so
+    FrameEvent evt;
+    Root::getSingleton()._fireFrameRenderingQueued(evt);
+    state->setTimePosition(state->getLength() * 0.25f);
+    sceneMgr->_findVisibleObjects(cam, 0, false);
+    EXPECT_EQ(first, ent->_getBoneMatrices()[1]);
+    sceneMgr->_updateEntityAnimations();
+    Matrix4 second = ent->_getBoneMatrices()[1];
+    EXPECT_NE(first, second);
+
+    // Nor updated again while its animation is unchanged
+    sceneMgr->_findVisibleObjects(cam, 0, false);
+    sceneMgr->_updateEntityAnimations();
+    EXPECT_EQ(second, ent->_getBoneMatrices()[1]);
+
+    // Destroying a queued entity takes it out of the queue
+    Root::getSingleton()._fireFrameRenderingQueued(evt);
+    state->setTimePosition(state->getLength() * 0.75f);
+    sceneMgr->_findVisibleObjects(cam, 0, false);
+    MeshPtr meshPtr = ent->getMesh();
+    sceneMgr->destroyEntity(ent);
+    sceneMgr->_updateEntityAnimations();
+
+    sceneMgr->setParallelAnimation(false);
+    EXPECT_TRUE(sceneMgr->_getEntityAnimationUpdater() == 0);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+    MeshManager::getSingleton().remove(meshPtr->getHandle());
+}
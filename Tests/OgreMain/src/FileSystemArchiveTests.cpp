@@ -283,6 +283,30 @@ TEST_F(FileSystemArchiveTests,FileRead)
     EXPECT_TRUE(stream->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MappedFileRead)
+{
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+
+    // Only the larger file is mapped
+    FileSystemArchive::setMemoryMappingThreshold(mFileSizeRoot2);
+    DataStreamPtr unmapped = arch.open("rootfile.txt");
+    DataStreamPtr stream = arch.open("rootfile2.txt");
+    FileSystemArchive::setMemoryMappingThreshold(0);
+    EXPECT_TRUE(dynamic_cast<MappedFileDataStream*>(unmapped.get()) == 0);
+    MappedFileDataStream* mapped = dynamic_cast<MappedFileDataStream*>(stream.get());
+    ASSERT_TRUE(mapped != 0);
+
+    EXPECT_EQ((size_t)mFileSizeRoot2, stream->size());
+    EXPECT_EQ(0, memcmp("this is line 1 in file 2", mapped->getPtr(), 24));
+    EXPECT_EQ(String("this is line 1 in file 2"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 2"), stream->getLine());
+
+    // Read-only
+    EXPECT_EQ((size_t)0, stream->write("x", 1));
+    stream->close();
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,ReadInterleave)
 {
     // Test overlapping reads from same archive
@@ -0,0 +1,181 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreMovableObject.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture IntersectionSceneQueryTests;
+
+namespace {
+    /// Object with a box of a given size
+    class BoxObject : public MovableObject
+    {
+        AxisAlignedBox mBox;
+    public:
+        BoxObject(const String& name) : MovableObject(name), mBox(-1, -1, -1, 1, 1, 1) {}
+        const String& getMovableType(void) const
+        {
+            static String type = "BoxObject";
+            return type;
+        }
+        void setBoundingBox(const AxisAlignedBox& box) { mBox = box; }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return mBox.isFinite() ? mBox.getHalfSize().length() : 0; }
+        void _updateRenderQueue(RenderQueue*) {}
+        void visitRenderables(Renderable::Visitor*, bool) {}
+    };
+
+    /// Scene queries only return objects made by factories
+    class BoxObjectFactory : public MovableObjectFactory
+    {
+    protected:
+        MovableObject* createInstanceImpl(const String& name, const NameValuePairList*)
+        {
+            return OGRE_NEW BoxObject(name);
+        }
+    public:
+        const String& getType(void) const
+        {
+            static String type = "BoxObject";
+            return type;
+        }
+        void destroyInstance(MovableObject* obj) { OGRE_DELETE obj; }
+    };
+
+    typedef std::set<std::pair<MovableObject*, MovableObject*> > PairSet;
+
+    std::pair<MovableObject*, MovableObject*> makePair(MovableObject* a, MovableObject* b)
+    {
+        return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+    }
+
+    /// Collects the pairs, checking that none is reported twice
+    class PairListener : public IntersectionSceneQueryListener
+    {
+    public:
+        PairSet pairs;
+        size_t limit;
+        PairListener() : limit(0) {}
+        bool queryResult(MovableObject* first, MovableObject* second)
+        {
+            EXPECT_NE(first, second);
+            EXPECT_TRUE(pairs.insert(makePair(first, second)).second);
+            return limit == 0 || pairs.size() < limit;
+        }
+        bool queryResult(MovableObject*, SceneQuery::WorldFragment*) { return true; }
+    };
+
+    /// Every pair of objects whose world boxes intersect
+    PairSet bruteForce(const vector<MovableObject*>::type& objects, uint32 mask)
+    {
+        PairSet pairs;
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            for (size_t j = i + 1; j < objects.size(); ++j)
+            {
+                MovableObject* a = objects[i];
+                MovableObject* b = objects[j];
+                if ((a->getQueryFlags() & mask) && (b->getQueryFlags() & mask) &&
+                    a->getWorldBoundingBox().intersects(b->getWorldBoundingBox()))
+                    pairs.insert(makePair(a, b));
+            }
+        }
+        return pairs;
+    }
+}
+
+TEST_F(IntersectionSceneQueryTests, MatchesBruteForce)
+{
+    BoxObjectFactory factory;
+    mRoot->addMovableObjectFactory(&factory);
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+
+    vector<SceneNode*>::type nodes;
+    vector<MovableObject*>::type objects;
+    for (int i = 0; i < 500; ++i)
+    {
+        SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(Math::RangeRandom(-100, 100), Math::RangeRandom(-10, 10), Math::RangeRandom(-100, 100)));
+        BoxObject* obj = static_cast<BoxObject*>(sceneMgr->createMovableObject("BoxObject"));
+        obj->setBoundingBox(AxisAlignedBox(Vector3(-Math::RangeRandom(0.5, 4)), Vector3(Math::RangeRandom(0.5, 4))));
+        obj->setQueryFlags(i % 7 == 0 ? 2 : 1);
+        node->attachObject(obj);
+        nodes.push_back(node);
+        objects.push_back(obj);
+    }
+    // Boxes which overlap everything or nothing
+    static_cast<BoxObject*>(objects[10])->setBoundingBox(AxisAlignedBox::BOX_INFINITE);
+    static_cast<BoxObject*>(objects[20])->setBoundingBox(AxisAlignedBox::BOX_NULL);
+
+    IntersectionSceneQuery* query = sceneMgr->createIntersectionQuery(1);
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        sceneMgr->getRootSceneNode()->_update(true, false);
+
+        PairListener listener;
+        query->execute(&listener);
+        PairSet expected = bruteForce(objects, 1);
+        EXPECT_GT(expected.size(), 0u);
+        EXPECT_TRUE(expected == listener.pairs);
+
+        // The collection version goes through the same path
+        IntersectionSceneQueryResult& result = query->execute();
+        EXPECT_EQ(expected.size(), result.movables2movables.size());
+
+        // Move some of the nodes, and change the set of objects now and then
+        for (size_t i = frame % 3; i < nodes.size(); i += 3)
+            nodes[i]->translate(Math::RangeRandom(-5, 5), Math::RangeRandom(-1, 1), Math::RangeRandom(-5, 5));
+        if (frame == 4)
+        {
+            sceneMgr->destroyMovableObject(objects.back());
+            objects.pop_back();
+        }
+        if (frame == 6)
+        {
+            // Spread out along y, to make the query change its axis
+            for (size_t i = 0; i < nodes.size(); ++i)
+                nodes[i]->translate(0, Math::RangeRandom(-2000, 2000), 0);
+        }
+    }
+
+    // Stopping early from the listener
+    PairListener listener;
+    listener.limit = 3;
+    query->execute(&listener);
+    EXPECT_EQ(3u, listener.pairs.size());
+
+    sceneMgr->destroyQuery(query);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+    mRoot->removeMovableObjectFactory(&factory);
+}
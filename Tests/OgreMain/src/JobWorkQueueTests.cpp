@@ -0,0 +1,225 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreRoot.h"
+#include "Threading/OgreJobWorkQueue.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture JobWorkQueueTests;
+
+namespace {
+    /// Writes the square of every index, and runs a nested parallelFor for some of them
+    class SquareTask : public WorkQueue::ParallelTask
+    {
+    public:
+        WorkQueue* queue;
+        vector<size_t>::type* results;
+        AtomicScalar<size_t> calls;
+        bool nested;
+
+        void execute(size_t begin, size_t end)
+        {
+            ++calls;
+            for (size_t i = begin; i < end; ++i)
+                (*results)[i] = i * i;
+            if (nested && begin == 0)
+            {
+                vector<size_t>::type inner(1000, 0);
+                SquareTask task;
+                task.queue = queue;
+                task.results = &inner;
+                task.calls.set(0);
+                task.nested = false;
+                queue->parallelFor(&task, inner.size(), 7);
+                for (size_t i = 0; i < inner.size(); ++i)
+                    EXPECT_EQ(i * i, inner[i]);
+            }
+        }
+    };
+
+    /// Marks itself run, and checks that the jobs it depends on have run
+    class FlagJob : public JobWorkQueue::Job
+    {
+    public:
+        AtomicScalar<size_t> runs;
+        const vector<FlagJob*>::type* prerequisites;
+        bool prerequisitesDone;
+
+        FlagJob() : runs(0), prerequisites(0), prerequisitesDone(true) {}
+
+        void execute()
+        {
+            // Take a little time, so the dependent jobs would catch up otherwise
+            volatile size_t spin = 0;
+            for (size_t i = 0; i < 1000; ++i)
+                spin = spin + i;
+
+            if (prerequisites)
+            {
+                for (size_t i = 0; i < prerequisites->size(); ++i)
+                {
+                    if ((*prerequisites)[i]->runs.get() != 1)
+                        prerequisitesDone = false;
+                }
+            }
+            ++runs;
+        }
+    };
+
+    class EchoHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+    public:
+        size_t responses;
+        EchoHandler() : responses(0) {}
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            return OGRE_NEW WorkQueue::Response(req, true, req->getData());
+        }
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            EXPECT_TRUE(res->succeeded());
+            EXPECT_EQ(res->getRequest()->getType(), any_cast<uint16>(res->getData()));
+            ++responses;
+        }
+    };
+
+    void testParallelFor(JobWorkQueue& queue)
+    {
+        vector<size_t>::type results(100003, 0);
+        SquareTask task;
+        task.queue = &queue;
+        task.results = &results;
+        task.calls.set(0);
+        task.nested = true;
+        queue.parallelFor(&task, results.size(), 100);
+        if (queue.getWorkerThreadCount())
+            EXPECT_EQ((results.size() + 99) / 100, task.calls.get());
+        for (size_t i = 0; i < results.size(); ++i)
+            ASSERT_EQ(i * i, results[i]);
+    }
+
+    void testDependencies(JobWorkQueue& queue)
+    {
+        // Three layers of jobs, each one depending on the whole previous one
+        const size_t layerSize = 200;
+        vector<FlagJob>::type jobs(layerSize * 3);
+        vector<FlagJob*>::type layers[3];
+        JobWorkQueue::JobCounter counters[3];
+        for (size_t layer = 0; layer < 3; ++layer)
+        {
+            for (size_t i = 0; i < layerSize; ++i)
+                layers[layer].push_back(&jobs[layer * layerSize + i]);
+        }
+        // A dependency is on the jobs added with the counter so far, so the
+        // layers are added in order, while the first ones are still running
+        for (size_t layer = 0; layer < 3; ++layer)
+        {
+            for (size_t i = 0; i < layerSize; ++i)
+            {
+                FlagJob* job = layers[layer][i];
+                job->prerequisites = layer ? &layers[layer - 1] : 0;
+                queue.addJob(job, &counters[layer], layer ? &counters[layer - 1] : 0);
+            }
+        }
+        queue.waitForCounter(&counters[2]);
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            EXPECT_EQ(1u, jobs[i].runs.get());
+            EXPECT_TRUE(jobs[i].prerequisitesDone);
+        }
+        EXPECT_TRUE(counters[0].isDone());
+        EXPECT_TRUE(counters[1].isDone());
+    }
+}
+
+TEST_F(JobWorkQueueTests, ParallelFor)
+{
+    JobWorkQueue queue("Test");
+    queue.setWorkerThreadCount(4);
+    queue.startup();
+    for (int i = 0; i < 20; ++i)
+        testParallelFor(queue);
+    queue.shutdown();
+
+    // Without workers everything runs on the calling thread
+    queue.setWorkerThreadCount(0);
+    queue.startup();
+    testParallelFor(queue);
+    queue.shutdown();
+}
+
+TEST_F(JobWorkQueueTests, Dependencies)
+{
+    JobWorkQueue queue("Test");
+    queue.setWorkerThreadCount(3);
+    queue.startup();
+    for (int i = 0; i < 20; ++i)
+        testDependencies(queue);
+    queue.shutdown();
+
+    queue.setWorkerThreadCount(0);
+    queue.startup();
+    testDependencies(queue);
+    queue.shutdown();
+
+    // Not started, the jobs run as they are added
+    testDependencies(queue);
+}
+
+TEST_F(JobWorkQueueTests, Requests)
+{
+    JobWorkQueue queue("Test");
+    queue.setWorkerThreadCount(2);
+    queue.startup();
+
+    EchoHandler handler;
+    uint16 channel = queue.getChannel("Test/Echo");
+    queue.addRequestHandler(channel, &handler);
+    queue.addResponseHandler(channel, &handler);
+
+    const uint16 numRequests = 100;
+    for (uint16 i = 0; i < numRequests; ++i)
+        EXPECT_NE(0u, queue.addRequest(channel, i, Any(i)));
+
+    // Jobs and requests share the workers
+    testParallelFor(queue);
+
+    for (int tries = 0; tries < 10000 && handler.responses < numRequests; ++tries)
+    {
+        queue.processResponses();
+        OGRE_THREAD_SLEEP(1);
+    }
+    EXPECT_EQ(numRequests, handler.responses);
+
+    queue.removeRequestHandler(channel, &handler);
+    queue.removeResponseHandler(channel, &handler);
+    queue.shutdown();
+}
@@ -0,0 +1,184 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+namespace {
+    const char* MESHES[] = { "ninja.mesh", "facial.mesh", "knot.mesh", "ogrehead.mesh" };
+    const size_t NUM_MESHES = sizeof(MESHES) / sizeof(MESHES[0]);
+
+    void appendBuffer(String& out, HardwareBuffer* buf)
+    {
+        const char* data = static_cast<const char*>(buf->lock(HardwareBuffer::HBL_READ_ONLY));
+        out.append(data, buf->getSizeInBytes());
+        buf->unlock();
+    }
+
+    void appendVertexData(String& out, const VertexData* data)
+    {
+        out += StringConverter::toString(data->vertexCount) + " " +
+            StringConverter::toString(data->vertexDeclaration->getElementCount()) + "\n";
+        const VertexBufferBinding::VertexBufferBindingMap& bindings = data->vertexBufferBinding->getBindings();
+        for (VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+            i != bindings.end(); ++i)
+        {
+            appendBuffer(out, i->second.get());
+        }
+    }
+
+    /// Returns the contents of all the geometry buffers of a mesh
+    String geometryOf(const MeshPtr& mesh)
+    {
+        String out;
+        if (mesh->sharedVertexData)
+            appendVertexData(out, mesh->sharedVertexData);
+        for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i)
+        {
+            SubMesh* sub = mesh->getSubMesh(i);
+            if (!sub->useSharedVertices)
+                appendVertexData(out, sub->vertexData);
+            if (!sub->indexData->indexBuffer.isNull())
+                appendBuffer(out, sub->indexData->indexBuffer.get());
+        }
+        return out;
+    }
+
+    /// Returns the manager of the first vertex buffer of a mesh
+    HardwareBufferManagerBase* managerOf(const MeshPtr& mesh)
+    {
+        const VertexData* data = mesh->getSubMesh(0)->useSharedVertices ?
+            mesh->sharedVertexData : mesh->getSubMesh(0)->vertexData;
+        return data->vertexBufferBinding->getBuffer(0)->getManager();
+    }
+}
+
+class MeshStagedLoadingTests : public RootWithoutRenderSystemFixture
+{
+public:
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        declareSampleMeshes("Staged", MESHES, NUM_MESHES);
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+
+        // Reference geometry, loaded the usual way
+        rgm.loadResourceGroup("Staged");
+        for (size_t i = 0; i < NUM_MESHES; ++i)
+        {
+            MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[i], "Staged");
+            mGeometry.push_back(geometryOf(mesh));
+            mBounds.push_back(mesh->getBounds());
+            mSkeletons.push_back(mesh->getSkeletonName());
+        }
+        rgm.unloadResourceGroup("Staged");
+        SkeletonManager::getSingleton().unloadAll();
+
+        EXPECT_FALSE(MeshManager::getSingleton().getDeferHardwareBufferCreation());
+        MeshManager::getSingleton().setDeferHardwareBufferCreation(true);
+        EXPECT_TRUE(MeshManager::getSingleton().getDeferHardwareBufferCreation());
+    }
+    void TearDown()
+    {
+        // The meshes need the buffer manager to be destroyed
+        ResourceGroupManager::getSingleton().destroyResourceGroup("Staged");
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    /// Checks a loaded mesh matches the reference
+    void checkLoaded(size_t i)
+    {
+        MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[i], "Staged");
+        ASSERT_TRUE(mesh->isLoaded()) << MESHES[i];
+        EXPECT_EQ(mGeometry[i], geometryOf(mesh)) << MESHES[i];
+        EXPECT_EQ(mBounds[i], mesh->getBounds()) << MESHES[i];
+        EXPECT_EQ(mSkeletons[i], mesh->getSkeletonName()) << MESHES[i];
+        if (mesh->hasSkeleton())
+        {
+            ASSERT_FALSE(mesh->getSkeleton().isNull()) << MESHES[i];
+            EXPECT_TRUE(mesh->getSkeleton()->isLoaded()) << MESHES[i];
+        }
+    }
+
+    StringVector mGeometry;
+    vector<AxisAlignedBox>::type mBounds;
+    StringVector mSkeletons;
+};
+
+//--------------------------------------------------------------------------
+TEST_F(MeshStagedLoadingTests, PrepareParsesLoadUploads)
+{
+    for (size_t i = 0; i < NUM_MESHES; ++i)
+    {
+        MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[i], "Staged");
+        mesh->prepare();
+        ASSERT_TRUE(mesh->isPrepared()) << MESHES[i];
+
+        // Parsed into system memory, the skeleton isn't loaded yet
+        ASSERT_GT(mesh->getNumSubMeshes(), 0u) << MESHES[i];
+        HardwareBufferManagerBase* staging = managerOf(mesh);
+        EXPECT_EQ(mGeometry[i], geometryOf(mesh)) << MESHES[i];
+        if (mesh->hasSkeleton())
+            EXPECT_FALSE(mesh->getSkeleton()->isLoaded()) << MESHES[i];
+
+        mesh->load();
+        EXPECT_NE(staging, managerOf(mesh)) << MESHES[i];
+        checkLoaded(i);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshStagedLoadingTests, UnprepareDropsGeometry)
+{
+    MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[0], "Staged");
+    mesh->prepare();
+    ASSERT_GT(mesh->getNumSubMeshes(), 0u);
+
+    mesh->unload();
+    EXPECT_FALSE(mesh->isPrepared());
+    EXPECT_EQ(0u, mesh->getNumSubMeshes());
+    EXPECT_TRUE(mesh->getSkeleton().isNull());
+
+    mesh->load();
+    checkLoaded(0);
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshStagedLoadingTests, PrepareOnWorkerThreads)
+{
+    startJobWorkQueue("Resources");
+
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    rgm.setParallelGroupLoading(true);
+    rgm.prepareResourceGroup("Staged");
+    rgm.loadResourceGroup("Staged");
+    for (size_t i = 0; i < NUM_MESHES; ++i)
+        checkLoaded(i);
+}
@@ -0,0 +1,299 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreMeshTriangleBVH.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture MeshTriangleBVHTests;
+
+namespace {
+    typedef vector<Vector3>::type PositionList;
+
+    /// Reads the positions of some vertex data
+    void readPositions(const VertexData* vertexData, PositionList& positions)
+    {
+        const VertexElement* posElem =
+            vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf =
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        unsigned char* pVertex = static_cast<unsigned char*>(vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        positions.resize(vbuf->getNumVertices());
+        for (size_t v = 0; v < positions.size(); ++v, pVertex += vbuf->getVertexSize())
+        {
+            float* pFloat;
+            posElem->baseVertexPointerToElement(pVertex, &pFloat);
+            positions[v] = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+        }
+        vbuf->unlock();
+    }
+
+    /** Tests a ray against every triangle of a mesh with Math::intersects,
+        using the given vertex data in place of that of the mesh. */
+    MeshTriangleBVH::Hit bruteForce(const Mesh* mesh, const VertexData* sharedVertexData,
+        const vector<const VertexData*>::type& subMeshVertexData, const Ray& ray)
+    {
+        MeshTriangleBVH::Hit best;
+        best.distance = Math::POS_INFINITY;
+
+        PositionList sharedPositions;
+        if (sharedVertexData)
+            readPositions(sharedVertexData, sharedPositions);
+
+        for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+        {
+            const SubMesh* sub = mesh->getSubMesh(s);
+            EXPECT_EQ(RenderOperation::OT_TRIANGLE_LIST, sub->operationType);
+            PositionList ownPositions;
+            if (!sub->useSharedVertices)
+                readPositions(subMeshVertexData[s], ownPositions);
+            const PositionList& positions = sub->useSharedVertices ? sharedPositions : ownPositions;
+
+            const IndexData* indexData = sub->indexData;
+            HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+            bool use32 = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+            void* pIndex = ibuf->lock(HardwareBuffer::HBL_READ_ONLY);
+            for (size_t t = 0; t < indexData->indexCount / 3; ++t)
+            {
+                uint32 idx[3];
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    size_t i = indexData->indexStart + t * 3 + k;
+                    idx[k] = use32 ? static_cast<uint32*>(pIndex)[i] : static_cast<uint16*>(pIndex)[i];
+                }
+                std::pair<bool, Real> res = Math::intersects(ray,
+                    positions[idx[0]], positions[idx[1]], positions[idx[2]], true, true);
+                if (res.first && res.second < best.distance)
+                {
+                    best.distance = res.second;
+                    best.subMeshIndex = s;
+                    best.triangleIndex = static_cast<uint32>(t);
+                }
+            }
+            ibuf->unlock();
+        }
+        return best;
+    }
+
+    /// Rays from all around the mesh towards random points of its bounds
+    void makeRays(const AxisAlignedBox& bounds, Real radius, const Matrix4& xform,
+        size_t count, vector<Ray>::type& rays)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 from = bounds.getCenter() + Vector3(
+                Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1))
+                .normalisedCopy() * radius * 2;
+            Vector3 to = bounds.getMinimum() + bounds.getSize() *
+                Vector3(Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom());
+            from = xform.transformAffine(from);
+            to = xform.transformAffine(to);
+            rays.push_back(Ray(from, (to - from).normalisedCopy()));
+        }
+    }
+
+    void expectSameHit(const MeshTriangleBVH::Hit& expected, const MeshTriangleBVH::Hit& actual)
+    {
+        if (expected.distance == Math::POS_INFINITY)
+        {
+            EXPECT_EQ(Math::POS_INFINITY, actual.distance);
+        }
+        else
+        {
+            // Triangles may share the nearest distance, so only it is compared
+            EXPECT_NEAR(expected.distance, actual.distance, 1e-3f * expected.distance);
+        }
+    }
+}
+
+TEST_F(MeshTriangleBVHTests, MatchesBruteForce)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("robot.mesh", ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+    const MeshTriangleBVH* bvh = mesh->getTriangleBVH();
+    ASSERT_TRUE(bvh != 0);
+    EXPECT_GT(bvh->getTriangleCount(), 0u);
+    EXPECT_EQ(bvh, mesh->getTriangleBVH());
+
+    vector<const VertexData*>::type subVertexData;
+    for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+        subVertexData.push_back(mesh->getSubMesh(s)->vertexData);
+
+    vector<Ray>::type rays;
+    makeRays(mesh->getBounds(), mesh->getBoundingSphereRadius(), Matrix4::IDENTITY, 500, rays);
+
+    vector<MeshTriangleBVH::Hit>::type batch(rays.size());
+    size_t batchHits = bvh->intersect(&rays[0], rays.size(), &batch[0], true, true);
+
+    size_t hits = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        MeshTriangleBVH::Hit expected = bruteForce(mesh.get(), mesh->sharedVertexData, subVertexData, rays[i]);
+        MeshTriangleBVH::Hit single;
+        bool hit = bvh->intersect(rays[i], single);
+        EXPECT_EQ(expected.distance != Math::POS_INFINITY, hit);
+        expectSameHit(expected, single);
+
+        // The packets give exactly the same answer as single rays
+        EXPECT_EQ(single.distance, batch[i].distance);
+        if (hit)
+        {
+            EXPECT_EQ(single.subMeshIndex, batch[i].subMeshIndex);
+            EXPECT_EQ(single.triangleIndex, batch[i].triangleIndex);
+            ++hits;
+        }
+    }
+    EXPECT_EQ(hits, batchHits);
+    // Most of the rays aim at the robot, but its bounds are mostly empty
+    EXPECT_GT(hits, 0u);
+    EXPECT_LT(hits, rays.size());
+
+    mesh->freeTriangleBVH();
+    MeshManager::getSingleton().remove(mesh->getHandle());
+}
+
+TEST_F(MeshTriangleBVHTests, FaceCulling)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("robot.mesh", ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+    const MeshTriangleBVH* bvh = mesh->getTriangleBVH();
+
+    // Through the middle of the robot, a closed mesh: the first face hit is a
+    // front face and the last one a back face
+    Vector3 centre = mesh->getBounds().getCenter();
+    Ray ray(centre + Vector3(0, 0, 1000), Vector3::NEGATIVE_UNIT_Z);
+    MeshTriangleBVH::Hit both, front, back;
+    ASSERT_TRUE(bvh->intersect(ray, both));
+    ASSERT_TRUE(bvh->intersect(ray, front, true, false));
+    ASSERT_TRUE(bvh->intersect(ray, back, false, true));
+    EXPECT_EQ(both.distance, front.distance);
+    EXPECT_GT(back.distance, front.distance);
+    EXPECT_FALSE(bvh->intersect(ray, both, false, false));
+
+    MeshManager::getSingleton().remove(mesh->getHandle());
+}
+
+TEST_F(MeshTriangleBVHTests, RaySceneQuery)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Entity* entity = sceneMgr->createEntity("robot.mesh");
+    SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode();
+    node->attachObject(entity);
+    node->setPosition(Vector3(100, -20, 50));
+    node->setOrientation(Quaternion(Degree(40), Vector3(1, 2, 3).normalisedCopy()));
+    node->setScale(Vector3(1.5, 0.5, 2));
+    sceneMgr->getRootSceneNode()->_update(true, false);
+
+    const Mesh* mesh = entity->getMesh().get();
+    vector<const VertexData*>::type subVertexData;
+    for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+        subVertexData.push_back(mesh->getSubMesh(s)->vertexData);
+
+    vector<Ray>::type rays;
+    Matrix4 xform = node->_getFullTransform();
+    makeRays(mesh->getBounds(), mesh->getBoundingSphereRadius(), xform, 100, rays);
+
+    RaySceneQuery* query = sceneMgr->createRayQuery(Ray());
+    EXPECT_FALSE(query->getTriangleIntersection());
+    query->setTriangleIntersection(true);
+    EXPECT_TRUE(query->getTriangleIntersection());
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        // The expected hit is found in mesh space, which keeps the ray parameter
+        Ray local(xform.inverseAffine().transformAffine(rays[i].getOrigin()),
+            xform.inverseAffine().transformDirectionAffine(rays[i].getDirection()));
+        MeshTriangleBVH::Hit expected = bruteForce(mesh, mesh->sharedVertexData, subVertexData, local);
+
+        query->setRay(rays[i]);
+        RaySceneQueryResult& result = query->execute();
+        if (expected.distance == Math::POS_INFINITY)
+        {
+            EXPECT_TRUE(result.empty());
+        }
+        else
+        {
+            ASSERT_EQ(1u, result.size());
+            EXPECT_EQ(entity, result[0].movable);
+            EXPECT_TRUE(result[0].hasTriangle);
+            EXPECT_EQ(result[0].distance, result[0].triangle.distance);
+            expectSameHit(expected, result[0].triangle);
+        }
+    }
+
+    sceneMgr->destroyQuery(query);
+    MeshPtr meshPtr = entity->getMesh();
+    sceneMgr->destroyEntity(entity);
+    MeshManager::getSingleton().remove(meshPtr->getHandle());
+}
+
+TEST_F(MeshTriangleBVHTests, AnimatedPose)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    Entity* entity = sceneMgr->createEntity("robot.mesh");
+    sceneMgr->getRootSceneNode()->attachObject(entity);
+    ASSERT_TRUE(entity->hasSkeleton());
+
+    entity->addSoftwareAnimationRequest(false);
+    AnimationState* state = entity->getAnimationState("Walk");
+    state->setEnabled(true);
+    state->setTimePosition(state->getLength() * 0.3f);
+    entity->_updateAnimation();
+
+    const Mesh* mesh = entity->getMesh().get();
+    vector<const VertexData*>::type subVertexData, bindSubVertexData;
+    for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+    {
+        const SubMesh* sub = mesh->getSubMesh(s);
+        subVertexData.push_back(sub->useSharedVertices ?
+            0 : entity->getSubEntity(s)->_getSkelAnimVertexData());
+        bindSubVertexData.push_back(sub->vertexData);
+    }
+    const VertexData* sharedVertexData = mesh->sharedVertexData ? entity->_getSkelAnimVertexData() : 0;
+
+    vector<Ray>::type rays;
+    makeRays(entity->getBoundingBox(), entity->getBoundingRadius(), Matrix4::IDENTITY, 200, rays);
+
+    size_t differences = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        MeshTriangleBVH::Hit expected = bruteForce(mesh, sharedVertexData, subVertexData, rays[i]);
+        MeshTriangleBVH::Hit bindPose = bruteForce(mesh, mesh->sharedVertexData, bindSubVertexData, rays[i]);
+        MeshTriangleBVH::Hit hit;
+        entity->intersectTriangles(rays[i], hit);
+        expectSameHit(expected, hit);
+        if (expected.distance != bindPose.distance)
+            ++differences;
+    }
+    // Otherwise the test says nothing about the pose
+    EXPECT_GT(differences, 0u);
+
+    MeshPtr meshPtr = entity->getMesh();
+    sceneMgr->destroyEntity(entity);
+    MeshManager::getSingleton().remove(meshPtr->getHandle());
+}
@@ -0,0 +1,503 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreOptimisedUtil.h"
+#include "OgrePlane.h"
+#include "OgreMath.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+namespace {
+    //--------------------------------------------------------------------------
+    void fillRandom(float* values, size_t count, Real range)
+    {
+        for (size_t i = 0; i < count; ++i)
+            values[i] = Math::RangeRandom(-range, range);
+    }
+    //--------------------------------------------------------------------------
+    /// Compares with a tolerance relative to the magnitude of the expected values
+    void expectNear(const float* expected, const float* actual, size_t count, float tolerance)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            EXPECT_NEAR(expected[i], actual[i], tolerance * std::max(1.0f, std::abs(expected[i]))) << "element " << i;
+        }
+    }
+    //--------------------------------------------------------------------------
+    Matrix4 randomAffineMatrix()
+    {
+        Vector3 axis(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+        axis.normalise();
+        Matrix4 m;
+        m.makeTransform(
+            Vector3(Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10)),
+            Vector3(Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2), Math::RangeRandom(0.5, 2)),
+            Quaternion(Radian(Math::RangeRandom(-Math::PI, Math::PI)), axis));
+        return m;
+    }
+    //--------------------------------------------------------------------------
+    /// The implementations to compare with the general one
+    OptimisedUtil::ImplementationMap getOtherImplementations()
+    {
+        OptimisedUtil::ImplementationMap implementations = OptimisedUtil::getAvailableImplementations();
+        implementations.erase("General");
+        return implementations;
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,CullAxisAlignedBoxes)
+{
+    Plane planes[6];
+    for (int i = 0; i < 6; ++i)
+    {
+        Vector3 normal(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1));
+        normal.normalise();
+        planes[i] = Plane(normal, Math::RangeRandom(-5, 5));
+    }
+
+    // Cover the partial groups of four and the partial mask words
+    for (size_t count = 0; count < 70; ++count)
+    {
+        vector<Vector3>::type centres(count + 1);
+        vector<Vector3>::type halfSizes(count + 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            centres[i] = Vector3(Math::RangeRandom(-20, 20), Math::RangeRandom(-20, 20), Math::RangeRandom(-20, 20));
+            halfSizes[i] = Vector3(Math::RangeRandom(0, 5), Math::RangeRandom(0, 5), Math::RangeRandom(0, 5));
+        }
+
+        for (size_t numPlanes = 0; numPlanes <= 6; numPlanes += 3)
+        {
+            vector<uint32>::type mask((count + 31) / 32 + 1, 0xDEADBEEF);
+            OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(
+                planes, numPlanes, &centres[0], &halfSizes[0], &mask[0], count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                bool visible = true;
+                for (size_t p = 0; p < numPlanes; ++p)
+                {
+                    if (planes[p].getSide(centres[i], halfSizes[i]) == Plane::NEGATIVE_SIDE)
+                        visible = false;
+                }
+                EXPECT_EQ(visible, (mask[i / 32] & (1u << (i % 32))) != 0) << "box " << i << " of " << count;
+            }
+
+            // Unused bits are cleared, and nothing is written past the end
+            if (count % 32)
+            {
+                EXPECT_EQ(0u, mask[count / 32] >> (count % 32));
+            }
+            EXPECT_EQ(0xDEADBEEF, mask[(count + 31) / 32]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,AvailableImplementations)
+{
+    OptimisedUtil::ImplementationMap implementations = OptimisedUtil::getAvailableImplementations();
+    ASSERT_TRUE(implementations.count("General"));
+
+    // The implementation in use is one of them
+    bool found = false;
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+        found |= (i->second == OptimisedUtil::getImplementation());
+    EXPECT_TRUE(found);
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,SoftwareVertexSkinning)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t numBones = 8;
+    vector<Matrix4>::type bones(numBones);
+    const Matrix4* bonePointers[numBones];
+    for (size_t i = 0; i < numBones; ++i)
+    {
+        bones[i] = randomAffineMatrix();
+        bonePointers[i] = &bones[i];
+    }
+
+    // Shared position / normal buffers, separate packed buffers, and
+    // positions only, with enough vertices to cover the unrolled loops
+    const size_t numVertices = 67;
+    for (size_t numWeights = 1; numWeights <= 4; ++numWeights)
+    {
+        vector<float>::type weights(numVertices * numWeights);
+        vector<unsigned char>::type indices(numVertices * numWeights);
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            float total = 0;
+            for (size_t w = 0; w < numWeights; ++w)
+            {
+                weights[v * numWeights + w] = Math::RangeRandom(0.1, 1);
+                total += weights[v * numWeights + w];
+                indices[v * numWeights + w] = (unsigned char)Math::RangeRandom(0, numBones - 0.01);
+            }
+            for (size_t w = 0; w < numWeights; ++w)
+                weights[v * numWeights + w] /= total;
+        }
+
+        vector<float>::type source(numVertices * 6);
+        fillRandom(&source[0], source.size(), 10);
+
+        for (int layout = 0; layout < 3; ++layout)
+        {
+            const bool shared = (layout == 0);
+            const bool normals = (layout != 2);
+            const size_t posStride = (shared ? 6 : 3) * sizeof(float);
+            const float* srcNorm = normals ? &source[shared ? 3 : numVertices * 3] : 0;
+
+            vector<float>::type expected(numVertices * 6, 0.0f);
+            float* expectedNorm = normals ? &expected[shared ? 3 : numVertices * 3] : 0;
+            general->softwareVertexSkinning(
+                &source[0], &expected[0], srcNorm, expectedNorm,
+                &weights[0], &indices[0], bonePointers,
+                posStride, posStride, posStride, posStride,
+                numWeights * sizeof(float), numWeights,
+                numWeights, numVertices);
+
+            for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+            {
+                SCOPED_TRACE(i->first + " layout " + StringConverter::toString(layout) +
+                    " weights " + StringConverter::toString(numWeights));
+                vector<float>::type result(numVertices * 6, 0.0f);
+                float* resultNorm = normals ? &result[shared ? 3 : numVertices * 3] : 0;
+                i->second->softwareVertexSkinning(
+                    &source[0], &result[0], srcNorm, resultNorm,
+                    &weights[0], &indices[0], bonePointers,
+                    posStride, posStride, posStride, posStride,
+                    numWeights * sizeof(float), numWeights,
+                    numWeights, numVertices);
+
+                // Normals may be normalised with a reciprocal square root estimate
+                if (shared)
+                {
+                    for (size_t v = 0; v < numVertices; ++v)
+                    {
+                        expectNear(&expected[v * 6], &result[v * 6], 3, 1e-4f);
+                        expectNear(&expected[v * 6 + 3], &result[v * 6 + 3], 3, 2e-3f);
+                    }
+                }
+                else
+                {
+                    expectNear(&expected[0], &result[0], numVertices * 3, 1e-4f);
+                    expectNear(&expected[numVertices * 3], &result[numVertices * 3], numVertices * 3, 2e-3f);
+                }
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,SoftwareVertexMorph)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t numVertices = 37;
+    const Real t = 0.3;
+    vector<float>::type source1(numVertices * 8), source2(numVertices * 8);
+    fillRandom(&source1[0], source1.size(), 10);
+    fillRandom(&source2[0], source2.size(), 10);
+
+    // Packed positions and normals, then vertices with other elements
+    for (int morphNormals = 0; morphNormals < 2; ++morphNormals)
+    {
+        for (int padded = 0; padded < 2; ++padded)
+        {
+            const size_t components = morphNormals ? 6 : 3;
+            const size_t size1 = (components + (padded ? 2 : 0)) * sizeof(float);
+            const size_t size2 = (components + (padded ? 1 : 0)) * sizeof(float);
+            const size_t dstSize = (components + (padded ? 2 : 0)) * sizeof(float);
+
+            vector<float>::type expected(numVertices * 8, 0.0f);
+            general->softwareVertexMorph(t, &source1[0], &source2[0], &expected[0],
+                size1, size2, dstSize, numVertices, morphNormals != 0);
+
+            for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+            {
+                // The SSE implementation only handles packed buffers
+                if (padded && i->first == "SSE")
+                    continue;
+
+                SCOPED_TRACE(i->first + " normals " + StringConverter::toString(morphNormals) +
+                    " padded " + StringConverter::toString(padded));
+                vector<float>::type result(numVertices * 8, 0.0f);
+                i->second->softwareVertexMorph(t, &source1[0], &source2[0], &result[0],
+                    size1, size2, dstSize, numVertices, morphNormals != 0);
+                expectNear(&expected[0], &result[0], result.size(), 2e-3f);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,ConcatenateAffineMatrices)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t numMatrices = 13;
+    Matrix4 base = randomAffineMatrix();
+    vector<Matrix4>::type source(numMatrices), expected(numMatrices);
+    for (size_t i = 0; i < numMatrices; ++i)
+        source[i] = randomAffineMatrix();
+    general->concatenateAffineMatrices(base, &source[0], &expected[0], numMatrices);
+
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+    {
+        SCOPED_TRACE(i->first);
+        vector<Matrix4>::type result(numMatrices, Matrix4::ZERO);
+        i->second->concatenateAffineMatrices(base, &source[0], &result[0], numMatrices);
+        for (size_t m = 0; m < numMatrices; ++m)
+            expectNear(expected[m][0], result[m][0], 16, 1e-4f);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,CalculateFaceNormals)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t numVertices = 50, numTriangles = 29;
+    vector<float>::type positions(numVertices * 3);
+    fillRandom(&positions[0], positions.size(), 10);
+    vector<EdgeData::Triangle>::type triangles(numTriangles);
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        for (size_t c = 0; c < 3; ++c)
+            triangles[t].vertIndex[c] = (size_t)Math::RangeRandom(0, numVertices - 0.01);
+    }
+
+    vector<Vector4>::type expected(numTriangles);
+    general->calculateFaceNormals(&positions[0], &triangles[0], &expected[0], numTriangles);
+
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+    {
+        SCOPED_TRACE(i->first);
+        vector<Vector4>::type result(numTriangles, Vector4::ZERO);
+        i->second->calculateFaceNormals(&positions[0], &triangles[0], &result[0], numTriangles);
+        expectNear(expected[0].ptr(), result[0].ptr(), numTriangles * 4, 1e-4f);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,CalculateLightFacing)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t numFaces = 77;
+    vector<Vector4>::type faceNormals(numFaces);
+    fillRandom(faceNormals[0].ptr(), numFaces * 4, 1);
+
+    Vector4 lights[2] = {
+        Vector4(Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10), Math::RangeRandom(-10, 10), 1),
+        Vector4(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 0) };
+
+    for (int l = 0; l < 2; ++l)
+    {
+        vector<char>::type expected(numFaces + 1, 2);
+        general->calculateLightFacing(lights[l], &faceNormals[0], &expected[0], numFaces);
+
+        for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+        {
+            SCOPED_TRACE(i->first);
+            vector<char>::type result(numFaces + 1, 2);
+            i->second->calculateLightFacing(lights[l], &faceNormals[0], &result[0], numFaces);
+            for (size_t f = 0; f < numFaces; ++f)
+            {
+                // Faces almost edge on may go either way with rounding
+                if (std::abs(lights[l].dotProduct(faceNormals[f])) > 1e-4f)
+                    EXPECT_EQ(expected[f] != 0, result[f] != 0) << "face " << f;
+            }
+            EXPECT_EQ(2, result[numFaces]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,ExtrudeVertices)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t numVertices = 37;
+    vector<float>::type source(numVertices * 3);
+    fillRandom(&source[0], source.size(), 10);
+
+    Vector4 lights[2] = {
+        Vector4(Math::RangeRandom(-20, 20), Math::RangeRandom(-20, 20), Math::RangeRandom(-20, 20), 1),
+        Vector4(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 0) };
+
+    for (int l = 0; l < 2; ++l)
+    {
+        vector<float>::type expected(numVertices * 3 + 1, 0.0f);
+        general->extrudeVertices(lights[l], 100, &source[0], &expected[0], numVertices);
+
+        for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+        {
+            SCOPED_TRACE(i->first + " light " + StringConverter::toString(l));
+            vector<float>::type result(numVertices * 3 + 1, 0.0f);
+            i->second->extrudeVertices(lights[l], 100, &source[0], &result[0], numVertices);
+            expectNear(&expected[0], &result[0], result.size(), 2e-3f);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,AddScaledArray)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    // Unaligned start and a count covering the remainder loops
+    const size_t count = 37;
+    vector<float>::type source(count + 1), destination(count + 2);
+    fillRandom(&source[0], source.size(), 10);
+    fillRandom(&destination[0], destination.size(), 10);
+
+    vector<float>::type expected(destination);
+    general->addScaledArray(&expected[1], &source[1], 0.25f, count);
+    EXPECT_EQ(destination[0], expected[0]);
+    EXPECT_EQ(destination[count + 1], expected[count + 1]);
+    EXPECT_NEAR(destination[1] + source[1] * 0.25f, expected[1], 1e-5f);
+
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+    {
+        SCOPED_TRACE(i->first);
+        vector<float>::type result(destination);
+        i->second->addScaledArray(&result[1], &source[1], 0.25f, count);
+        expectNear(&expected[0], &result[0], result.size(), 1e-5f);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,MultiplyAddClampArray)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t count = 37;
+    vector<float>::type data(count + 2);
+    fillRandom(&data[0], data.size(), 2);
+
+    vector<float>::type expected(data);
+    general->multiplyAddClampArray(&expected[1], 0.5f, 0.1f, 0, 1, count);
+    EXPECT_EQ(data[0], expected[0]);
+    EXPECT_EQ(data[count + 1], expected[count + 1]);
+    for (size_t j = 1; j <= count; ++j)
+    {
+        EXPECT_GE(expected[j], 0.0f);
+        EXPECT_LE(expected[j], 1.0f);
+    }
+
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+    {
+        SCOPED_TRACE(i->first);
+        vector<float>::type result(data);
+        i->second->multiplyAddClampArray(&result[1], 0.5f, 0.1f, 0, 1, count);
+        expectNear(&expected[0], &result[0], result.size(), 1e-5f);
+
+        // Unbounded
+        vector<float>::type unbounded(data), unboundedExpected(data);
+        general->multiplyAddClampArray(&unboundedExpected[0], -2, 3, Math::NEG_INFINITY, Math::POS_INFINITY, data.size());
+        i->second->multiplyAddClampArray(&unbounded[0], -2, 3, Math::NEG_INFINITY, Math::POS_INFINITY, data.size());
+        expectNear(&unboundedExpected[0], &unbounded[0], unbounded.size(), 1e-5f);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,GenerateBillboardVertices)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t count = 13;
+    vector<float>::type billboards(count * 4 + 1);
+    fillRandom(&billboards[1], billboards.size() - 1, 100);
+    // Colours whose bits make all sorts of floats, including NaNs
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32 colour = 0xFF8000FF + static_cast<uint32>(i) * 0x01020304;
+        memcpy(&billboards[1 + i * 4 + 3], &colour, sizeof(uint32));
+    }
+    float offsets[12], texcoords[8] = { 0, 0, 0.5f, 0, 0, 0.25f, 0.5f, 0.25f };
+    fillRandom(offsets, 12, 5);
+
+    vector<float>::type expected(count * 24 + 2, 0);
+    general->generateBillboardVertices(&billboards[1], offsets, texcoords, &expected[1], count);
+    EXPECT_EQ(0, expected[0]);
+    EXPECT_EQ(0, expected[count * 24 + 1]);
+    EXPECT_EQ(billboards[1] + offsets[0], expected[1]);
+    EXPECT_EQ(0, memcmp(&billboards[4], &expected[4], sizeof(float)));
+    EXPECT_EQ(0.5f, expected[1 + 6 + 4]);
+
+    for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+    {
+        SCOPED_TRACE(i->first);
+        vector<float>::type result(count * 24 + 2, 0);
+        i->second->generateBillboardVertices(&billboards[1], offsets, texcoords, &result[1], count);
+        // Same additions, so the same bits
+        EXPECT_EQ(0, memcmp(&expected[0], &result[0], result.size() * sizeof(float)));
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,CalculateDepthKeys)
+{
+    OptimisedUtil* general = OptimisedUtil::getAvailableImplementations()["General"];
+    OptimisedUtil::ImplementationMap implementations = getOtherImplementations();
+
+    const size_t count = 37;
+    vector<float>::type positions(count * 3 + 1);
+    fillRandom(&positions[0], positions.size(), 100);
+    const float* posX = &positions[1];
+    const float* posY = posX + count;
+    const float* posZ = posY + count;
+    Vector3 origin(1, 2, 3);
+    Vector3 direction(0.6f, 0, -0.8f);
+
+    for (int byDistance = 0; byDistance < 2; ++byDistance)
+    {
+        vector<float>::type expected(count + 2, 0);
+        general->calculateDepthKeys(posX, posY, posZ, origin, direction, byDistance != 0, &expected[1], count);
+        EXPECT_EQ(0, expected[0]);
+        EXPECT_EQ(0, expected[count + 1]);
+        Vector3 pos(posX[5], posY[5], posZ[5]);
+        EXPECT_NEAR(byDistance ? -pos.squaredDistance(origin) : direction.dotProduct(pos - origin),
+            expected[6], 1e-3f);
+
+        for (OptimisedUtil::ImplementationMap::iterator i = implementations.begin(); i != implementations.end(); ++i)
+        {
+            SCOPED_TRACE(i->first);
+            vector<float>::type result(count + 2, 0);
+            i->second->calculateDepthKeys(posX, posY, posZ, origin, direction, byDistance != 0, &result[1], count);
+            expectNear(&expected[0], &result[0], result.size(), 1e-5f);
+        }
+    }
+}
+//--------------------------------------------------------------------------
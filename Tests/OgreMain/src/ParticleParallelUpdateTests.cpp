@@ -0,0 +1,206 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreParticleEmitterFactory.h"
+#include "ParticleSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+class ParticleParallelUpdateTests : public ParticleSystemFixture
+{
+};
+
+namespace {
+    /// Emits particles at random around its position, in random directions
+    class ScatterEmitter : public ParticleEmitter
+    {
+    public:
+        ScatterEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "TestScatter"; }
+
+        unsigned short _getEmissionCount(Real timeElapsed)
+        {
+            return genConstantEmissionCount(timeElapsed);
+        }
+
+        void _initParticle(Particle* pParticle)
+        {
+            ParticleEmitter::_initParticle(pParticle);
+            pParticle->mPosition = mPosition + Vector3(Math::SymmetricRandom(),
+                Math::SymmetricRandom(), Math::SymmetricRandom()) * 10;
+            genEmissionDirection(pParticle->mPosition, pParticle->mDirection);
+            genEmissionVelocity(pParticle->mDirection);
+            pParticle->mTimeToLive = pParticle->mTotalTimeToLive = genEmissionTTL();
+        }
+    };
+
+    class ScatterEmitterFactory : public ParticleEmitterFactory
+    {
+    public:
+        String getName() const { return "TestScatter"; }
+        ParticleEmitter* createEmitter(ParticleSystem* psys)
+        {
+            ParticleEmitter* emitter = OGRE_NEW ScatterEmitter(psys);
+            mEmitters.push_back(emitter);
+            return emitter;
+        }
+    };
+
+    typedef vector<ParticleSystem*>::type ParticleSystemList;
+
+    ParticleSystemList createSystems(SceneManager* sceneMgr)
+    {
+        ParticleSystemList systems;
+        for (int i = 0; i < 16; ++i)
+        {
+            ParticleSystem* system = sceneMgr->createParticleSystem(
+                "System" + StringConverter::toString(i), 200);
+            ParticleEmitter* emitter = system->addEmitter("TestScatter");
+            emitter->setAngle(Degree(30));
+            emitter->setParticleVelocity(1, 5);
+            emitter->setTimeToLive(0.5, 1.5);
+            emitter->setEmissionRate(100);
+            sceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(Real(i) * 50, 0, 0))->attachObject(system);
+            systems.push_back(system);
+        }
+        return systems;
+    }
+
+    /// Positions of the particles of all the systems, and their bounds
+    vector<Vector3>::type getPositions(const ParticleSystemList& systems)
+    {
+        vector<Vector3>::type positions;
+        for (size_t s = 0; s < systems.size(); ++s)
+        {
+            ParticleIterator pi = systems[s]->_getIterator();
+            while (!pi.end())
+                positions.push_back(pi.getNext()->mPosition);
+            positions.push_back(systems[s]->getBoundingBox().getMinimum());
+            positions.push_back(systems[s]->getBoundingBox().getMaximum());
+        }
+        return positions;
+    }
+
+    /** Updates the systems of a new scene over a few frames, through the queue
+        of the particle system manager or one system at a time. */
+    vector<Vector3>::type runSystems(bool queued)
+    {
+        SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+        ParticleSystemList systems = createSystems(sceneMgr);
+        ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+        for (int frame = 0; frame < 20; ++frame)
+        {
+            for (size_t s = 0; s < systems.size(); ++s)
+            {
+                if (queued)
+                {
+                    mgr._queueUpdate(systems[s], 0.05f);
+                }
+                else if (systems[s]->_prepareUpdate(0.05f))
+                {
+                    systems[s]->_updateParticles(true);
+                    systems[s]->_finishUpdate();
+                }
+            }
+            mgr._updateQueuedSystems();
+        }
+        vector<Vector3>::type positions = getPositions(systems);
+        SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+        return positions;
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST_F(ParticleParallelUpdateTests, IndependentOfThreads)
+{
+    ScatterEmitterFactory factory;
+    ParticleSystemManager::getSingleton().addEmitterFactory(&factory);
+
+    // Each system has its own random sequence, whichever thread updates it
+    vector<Vector3>::type expected = runSystems(false);
+    ASSERT_GT(expected.size(), 16u * 50);
+
+    startJobWorkQueue("Particles");
+    for (int run = 0; run < 3; ++run)
+    {
+        vector<Vector3>::type positions = runSystems(true);
+        ASSERT_EQ(expected.size(), positions.size());
+        for (size_t i = 0; i < positions.size(); ++i)
+            EXPECT_EQ(expected[i], positions[i]);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ParticleParallelUpdateTests, QueuedByController)
+{
+    ScatterEmitterFactory factory;
+    ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+    mgr.addEmitterFactory(&factory);
+    EXPECT_FALSE(mgr.getParallelUpdate());
+
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    ParticleSystemList systems = createSystems(sceneMgr);
+    for (size_t s = 0; s < systems.size(); ++s)
+        systems[s]->setRandomSeed(42);
+    EXPECT_EQ(42u, systems[0]->getRandomSeed());
+
+    // The controller queues the update until the manager runs them
+    mgr.setParallelUpdate(true);
+    EXPECT_TRUE(mgr.getParallelUpdate());
+    FrameEvent evt;
+    evt.timeSinceLastFrame = 0.1f;
+    evt.timeSinceLastEvent = 0.1f;
+    Root::getSingleton()._fireFrameStarted(evt);
+    Root::getSingleton()._fireFrameRenderingQueued(evt);
+    ControllerManager::getSingleton().updateAllControllers();
+    EXPECT_EQ(0u, systems[0]->getNumParticles());
+    mgr._updateQueuedSystems();
+    EXPECT_EQ(10u, systems[0]->getNumParticles());
+
+    // With the same seed, the systems emit the same particles
+    vector<Vector3>::type first, last;
+    ParticleIterator pi = systems[0]->_getIterator();
+    while (!pi.end())
+        first.push_back(pi.getNext()->mDirection);
+    pi = systems[15]->_getIterator();
+    while (!pi.end())
+        last.push_back(pi.getNext()->mDirection);
+    EXPECT_TRUE(first == last);
+
+    // Destroying a system takes it out of the queue, and disabling the mode
+    // runs the remaining updates
+    mgr._queueUpdate(systems[0], 0.1f);
+    mgr._queueUpdate(systems[1], 0.1f);
+    mgr._queueUpdate(systems[1], 0.1f);
+    sceneMgr->destroyParticleSystem(systems[0]);
+    mgr.setParallelUpdate(false);
+    EXPECT_EQ(30u, systems[1]->getNumParticles());
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
@@ -0,0 +1,258 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreParticleData.h"
+#include "OgreParticleAffectorFactory.h"
+#include "OgreOptimisedUtil.h"
+#include "ParticleSystemFixture.h"
+
+using namespace Ogre;
+
+class ParticleStorageTests : public ParticleSystemFixture
+{
+};
+
+namespace {
+    /// Slows the particles down, through the Particle instances only
+    class DragAffector : public ParticleAffector
+    {
+    public:
+        DragAffector(ParticleSystem* parent) : ParticleAffector(parent) { mType = "TestDrag"; }
+
+        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+        {
+            ParticleIterator pi = pSystem->_getIterator();
+            while (!pi.end())
+                pi.getNext()->mDirection *= 1 - timeElapsed / 2;
+        }
+    };
+
+    /// Fades the particles out, through the arrays as well
+    class FadeAffector : public ParticleAffector
+    {
+    public:
+        FadeAffector(ParticleSystem* parent) : ParticleAffector(parent) { mType = "TestFade"; }
+
+        void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+        {
+            ParticleIterator pi = pSystem->_getIterator();
+            while (!pi.end())
+            {
+                Particle* p = pi.getNext();
+                p->mColour.a = std::max(p->mColour.a - timeElapsed, 0.0f);
+            }
+        }
+
+        bool _affectParticleData(ParticleSystem* pSystem, ParticleData& data, Real timeElapsed)
+        {
+            OptimisedUtil::getImplementation()->multiplyAddClampArray(
+                data.mColourA, 1, -timeElapsed, 0, 1, data.getCount());
+            return true;
+        }
+    };
+
+    template <class T>
+    class TestAffectorFactory : public ParticleAffectorFactory
+    {
+        String mName;
+    public:
+        TestAffectorFactory(const String& name) : mName(name) {}
+        String getName() const { return mName; }
+        ParticleAffector* createAffector(ParticleSystem* psys)
+        {
+            ParticleAffector* affector = OGRE_NEW T(psys);
+            mAffectors.push_back(affector);
+            return affector;
+        }
+    };
+
+    /// Creates a system full of particles with different lifetimes and directions
+    ParticleSystem* createSystem(SceneManager* sceneMgr, ParticleStorageMode mode)
+    {
+        ParticleSystem* system = sceneMgr->createParticleSystem(50);
+        system->setStorageMode(mode);
+        EXPECT_EQ(mode, system->getStorageMode());
+        system->addAffector("TestDrag");
+        system->addAffector("TestFade");
+        sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(system);
+
+        // Allocates the particles
+        system->_update(0);
+        for (size_t i = 0; i < 50; ++i)
+        {
+            Particle* p = system->createParticle();
+            EXPECT_TRUE(p != 0);
+            p->mPosition = Vector3::ZERO;
+            p->mDirection = Vector3(Real(i), 1, -Real(i) / 2);
+            p->mColour = ColourValue::White;
+            p->mTimeToLive = p->mTotalTimeToLive = Real(i + 1) / 10 + 0.05f;
+        }
+        EXPECT_TRUE(system->createParticle() == 0);
+        return system;
+    }
+
+    /// The particles of a system, in order of their unique time to live
+    typedef map<Real, Particle>::type ParticleStates;
+    ParticleStates getStates(ParticleSystem* system)
+    {
+        ParticleStates states;
+        ParticleIterator pi = system->_getIterator();
+        while (!pi.end())
+        {
+            Particle* p = pi.getNext();
+            states[p->mTimeToLive] = *p;
+        }
+        EXPECT_EQ(system->getNumParticles(), states.size());
+        return states;
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST_F(ParticleStorageTests, MatchesListStorage)
+{
+    TestAffectorFactory<DragAffector> dragFactory("TestDrag");
+    TestAffectorFactory<FadeAffector> fadeFactory("TestFade");
+    ParticleSystemManager::getSingleton().addAffectorFactory(&dragFactory);
+    ParticleSystemManager::getSingleton().addAffectorFactory(&fadeFactory);
+
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    ParticleSystem* listSystem = createSystem(sceneMgr, PSM_LIST);
+    ParticleSystem* arraysSystem = createSystem(sceneMgr, PSM_ARRAYS);
+    EXPECT_EQ("arrays", arraysSystem->getParameter("storage_mode"));
+
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        listSystem->_update(0.1f);
+        arraysSystem->_update(0.1f);
+
+        ParticleStates expected = getStates(listSystem);
+        ParticleStates actual = getStates(arraysSystem);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (ParticleStates::iterator e = expected.begin(), a = actual.begin(); e != expected.end(); ++e, ++a)
+        {
+            EXPECT_EQ(e->first, a->first);
+            EXPECT_TRUE(e->second.mPosition.positionEquals(a->second.mPosition, 1e-3f));
+            EXPECT_TRUE(e->second.mDirection.positionEquals(a->second.mDirection, 1e-3f));
+            EXPECT_FLOAT_EQ(e->second.mColour.a, a->second.mColour.a);
+        }
+        const AxisAlignedBox& expectedBox = listSystem->getBoundingBox();
+        const AxisAlignedBox& actualBox = arraysSystem->getBoundingBox();
+        EXPECT_TRUE(expectedBox.getMinimum().positionEquals(actualBox.getMinimum(), 1e-3f));
+        EXPECT_TRUE(expectedBox.getMaximum().positionEquals(actualBox.getMaximum(), 1e-3f));
+    }
+    EXPECT_EQ(21u, arraysSystem->getNumParticles());
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+TEST_F(ParticleStorageTests, ChangesThroughParticles)
+{
+    TestAffectorFactory<DragAffector> dragFactory("TestDrag");
+    TestAffectorFactory<FadeAffector> fadeFactory("TestFade");
+    ParticleSystemManager::getSingleton().addAffectorFactory(&dragFactory);
+    ParticleSystemManager::getSingleton().addAffectorFactory(&fadeFactory);
+
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    ParticleSystem* system = createSystem(sceneMgr, PSM_ARRAYS);
+
+    // Killing a particle manually, as documented for createParticle
+    system->getParticle(10)->mTimeToLive = 0;
+    Particle* stopped = system->getParticle(20);
+    stopped->mDirection = Vector3::ZERO;
+    Particle* moving = system->getParticle(30);
+    system->_update(0.01f);
+    EXPECT_EQ(49u, system->getNumParticles());
+
+    // The instances are brought up to date when they are accessed
+    system->_getIterator();
+    EXPECT_EQ(Vector3::ZERO, stopped->mPosition);
+    EXPECT_NE(Vector3::ZERO, moving->mPosition);
+
+    // Switching back keeps the particles
+    system->setStorageMode(PSM_LIST);
+    EXPECT_EQ(PSM_LIST, system->getStorageMode());
+    EXPECT_EQ(49u, system->getNumParticles());
+    system->setParameter("storage_mode", "arrays");
+    EXPECT_EQ(PSM_ARRAYS, system->getStorageMode());
+    EXPECT_EQ(49u, system->getNumParticles());
+    EXPECT_TRUE(system->createParticle() != 0);
+    EXPECT_TRUE(system->createParticle() == 0);
+
+    // The whole quota is free again once cleared
+    system->clear();
+    EXPECT_EQ(0u, system->getNumParticles());
+    for (size_t i = 0; i < 50; ++i)
+        EXPECT_TRUE(system->createParticle() != 0);
+    EXPECT_TRUE(system->createParticle() == 0);
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+TEST_F(ParticleStorageTests, CreateBetweenUpdates)
+{
+    TestAffectorFactory<DragAffector> dragFactory("TestDrag");
+    TestAffectorFactory<FadeAffector> fadeFactory("TestFade");
+    ParticleSystemManager::getSingleton().addAffectorFactory(&dragFactory);
+    ParticleSystemManager::getSingleton().addAffectorFactory(&fadeFactory);
+
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    ParticleSystem* listSystem = createSystem(sceneMgr, PSM_LIST);
+    ParticleSystem* arraysSystem = createSystem(sceneMgr, PSM_ARRAYS);
+
+    // Frees the first particle, the others are only moved in the arrays
+    listSystem->_update(0.2f);
+    arraysSystem->_update(0.2f);
+
+    // Creating one must not bring back the state from before the update
+    ParticleSystem* systems[] = { listSystem, arraysSystem };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        Particle* p = systems[i]->createParticle();
+        ASSERT_TRUE(p != 0);
+        p->mPosition = Vector3::ZERO;
+        p->mDirection = Vector3::UNIT_Y;
+        p->mColour = ColourValue::White;
+        p->mTimeToLive = p->mTotalTimeToLive = 10;
+    }
+    listSystem->_update(0.1f);
+    arraysSystem->_update(0.1f);
+
+    ParticleStates expected = getStates(listSystem);
+    ParticleStates actual = getStates(arraysSystem);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (ParticleStates::iterator e = expected.begin(), a = actual.begin(); e != expected.end(); ++e, ++a)
+    {
+        EXPECT_EQ(e->first, a->first);
+        EXPECT_TRUE(e->second.mPosition.positionEquals(a->second.mPosition, 1e-3f));
+        EXPECT_TRUE(e->second.mDirection.positionEquals(a->second.mDirection, 1e-3f));
+        EXPECT_FLOAT_EQ(e->second.mColour.a, a->second.mColour.a);
+    }
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "RadixSortTests.h"
 #include "OgreRadixSort.h"
 #include "OgreMath.h"
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
 
 
 using namespace Ogre;
@@ -62,6 +64,23 @@ public:
     }
 };
 //--------------------------------------------------------------------------
+struct PairFirstLess
+{
+    bool operator()(const std::pair<uint64, int>& a, const std::pair<uint64, int>& b) const
+    {
+        return a.first < b.first;
+    }
+};
+//--------------------------------------------------------------------------
+class UInt64PairSortFunctor
+{
+public:
+    uint64 operator()(const std::pair<uint64, int>& p) const
+    {
+        return p.first;
+    }
+};
+//--------------------------------------------------------------------------
 class UnsignedIntSortFunctor
 {
 public:
@@ -203,5 +222,75 @@ TEST_F(RadixSortTests,IntVector)
     }
 }
 //--------------------------------------------------------------------------
+TEST_F(RadixSortTests,ParallelUInt64Stable)
+{
+    typedef std::vector<std::pair<uint64, int> > PairVector;
+    PairVector container;
+    ParallelRadixSort<PairVector> sorter;
+    // Several chunks, sorted on the calling thread
+    sorter.setBatchSize(100);
 
+    for (int i = 0; i < 1000; ++i)
+    {
+        // Few distinct high words and a constant byte to skip, plus duplicates
+        uint64 high = (uint64)Math::RangeRandom(0, 8);
+        uint64 low = (uint64)Math::RangeRandom(0, 64) | 0x1200;
+        container.push_back(std::make_pair((high << 40) | low, i));
+    }
 
+    PairVector expected = container;
+    std::stable_sort(expected.begin(), expected.end(), PairFirstLess());
+
+    sorter.sort(container, UInt64PairSortFunctor());
+
+    EXPECT_TRUE(container == expected);
+}
+//--------------------------------------------------------------------------
+typedef RootWithoutRenderSystemFixture ParallelRadixSortTests;
+TEST_F(ParallelRadixSortTests,UInt64StableOnWorkQueue)
+{
+    typedef std::vector<std::pair<uint64, int> > PairVector;
+    PairVector container;
+    ParallelRadixSort<PairVector> sorter;
+    // Many chunks, histogrammed and scattered on the worker threads
+    sorter.setBatchSize(64);
+    WorkQueue* workQueue = startJobWorkQueue("RadixSort");
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint64 high = (uint64)Math::RangeRandom(0, 16);
+        uint64 low = (uint64)Math::RangeRandom(0, 1024) | 0x120000;
+        container.push_back(std::make_pair((high << 48) | low, i));
+    }
+
+    PairVector expected = container;
+    std::stable_sort(expected.begin(), expected.end(), PairFirstLess());
+
+    sorter.sort(container, UInt64PairSortFunctor(), workQueue);
+    EXPECT_TRUE(container == expected);
+
+    // Sorting again reuses the buffers
+    std::reverse(container.begin(), container.end());
+    expected = container;
+    std::stable_sort(expected.begin(), expected.end(), PairFirstLess());
+    sorter.sort(container, UInt64PairSortFunctor(), workQueue);
+    EXPECT_TRUE(container == expected);
+}
+//--------------------------------------------------------------------------
+TEST_F(RadixSortTests,ParallelFloatKey)
+{
+    std::vector<float> values;
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back((float)Math::RangeRandom(-1e10, 1e10));
+    }
+    values.push_back(0.0f);
+    std::sort(values.begin(), values.end());
+
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        EXPECT_TRUE(ParallelRadixSort<std::vector<float> >::floatToKey(values[i - 1]) <=
+            ParallelRadixSort<std::vector<float> >::floatToKey(values[i]));
+    }
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreRenderable.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture RenderQueueTests;
+
+namespace {
+    /// Renderable at a given depth
+    class DepthRenderable : public Renderable
+    {
+        MaterialPtr mMaterial;
+        LightList mLights;
+    public:
+        Real mDepth;
+
+        DepthRenderable(const MaterialPtr& mat) : mMaterial(mat), mDepth(0) {}
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation&) {}
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        Real getSquaredViewDepth(const Camera*) const { return mDepth; }
+        const LightList& getLights(void) const { return mLights; }
+    };
+
+    /// Records the order of the items
+    class OrderVisitor : public QueuedRenderableVisitor
+    {
+    public:
+        vector<Renderable*>::type mOrder;
+        void visit(RenderablePass* rp) { mOrder.push_back(rp->renderable); }
+        bool visit(const Pass*) { return true; }
+        void visit(Renderable* r) { mOrder.push_back(r); }
+    };
+}
+
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests, RetainedSortMatchesFullSort)
+{
+    MaterialPtr mat = MaterialManager::getSingleton().create("RetainedSortTest",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Pass* pass = mat->getTechnique(0)->getPass(0);
+
+    vector<DepthRenderable*>::type renderables;
+    for (int i = 0; i < 3000; ++i)
+        renderables.push_back(new DepthRenderable(mat));
+
+    QueuedRenderableCollection full, retained;
+    full.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+    retained.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+    retained.setRetainSortOrder(true);
+
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        full.clear();
+        retained.clear();
+
+        for (size_t i = 0; i < renderables.size(); ++i)
+        {
+            // Small moves, except for a frame which reverses everything
+            Real base = frame == 3 ? Real(renderables.size() - i) : Real(i);
+            renderables[i]->mDepth = base * 10 + Math::RangeRandom(-15, 15);
+
+            // Drop a different set of items every frame
+            if ((i + frame) % 7 == 0)
+                continue;
+
+            full.addRenderable(pass, renderables[i]);
+            retained.addRenderable(pass, renderables[i]);
+        }
+
+        full.sort(0);
+        retained.sort(0);
+
+        OrderVisitor fullOrder, retainedOrder;
+        full.acceptVisitor(&fullOrder, QueuedRenderableCollection::OM_SORT_DESCENDING);
+        retained.acceptVisitor(&retainedOrder, QueuedRenderableCollection::OM_SORT_DESCENDING);
+        // Items at the same depth keep their previous order in retained mode,
+        // so compare the depths and then the items regardless of order
+        ASSERT_EQ(fullOrder.mOrder.size(), retainedOrder.mOrder.size());
+        for (size_t i = 0; i < fullOrder.mOrder.size(); ++i)
+        {
+            EXPECT_EQ(static_cast<DepthRenderable*>(fullOrder.mOrder[i])->mDepth,
+                      static_cast<DepthRenderable*>(retainedOrder.mOrder[i])->mDepth) << "frame " << frame;
+        }
+        std::sort(fullOrder.mOrder.begin(), fullOrder.mOrder.end());
+        std::sort(retainedOrder.mOrder.begin(), retainedOrder.mOrder.end());
+        EXPECT_TRUE(fullOrder.mOrder == retainedOrder.mOrder) << "frame " << frame;
+    }
+
+    for (size_t i = 0; i < renderables.size(); ++i)
+        delete renderables[i];
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,205 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Counts the events fired for the resources of a group
+    class CountingListener : public ResourceGroupListener, public Resource::Listener
+    {
+    public:
+        size_t expected, started, ended, completed;
+        StringVector scripts;
+        CountingListener() : expected(0), started(0), ended(0), completed(0) {}
+
+        void resourceGroupScriptingStarted(const String&, size_t) {}
+        void scriptParseStarted(const String& name, bool&) { scripts.push_back(name); }
+        void scriptParseEnded(const String&, bool) {}
+        void resourceGroupScriptingEnded(const String&) {}
+        void resourceGroupPrepareStarted(const String&, size_t count) { expected = count; }
+        void resourcePrepareStarted(const ResourcePtr&) { ++started; }
+        void resourcePrepareEnded(void) { ++ended; }
+        void resourceGroupLoadStarted(const String&, size_t count) { expected = count; }
+        void resourceLoadStarted(const ResourcePtr&) { ++started; }
+        void resourceLoadEnded(void) { ++ended; }
+        void worldGeometryStageStarted(const String&) {}
+        void worldGeometryStageEnded(void) {}
+        void resourceGroupLoadEnded(const String&) {}
+
+        void preparingComplete(Resource*) { ++completed; }
+        void loadingComplete(Resource*) { ++completed; }
+    };
+
+    const char* MESHES[] = { "Barrel.mesh", "WoodPallet.mesh", "column.mesh", "cube.mesh",
+        "Sphere1000.mesh", "ogrehead.mesh" };
+    const size_t NUM_MESHES = sizeof(MESHES) / sizeof(MESHES[0]);
+
+    /// Initialises a group holding the test scripts, returning the ambient colour of its materials
+    vector<ColourValue>::type initialiseScripts()
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
+        String scriptPath = macBundlePath() + "/Contents/Resources/Media/misc/ScriptTest";
+#elif OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        String scriptPath = "../../Tests/OgreMain/misc/ScriptTest";
+#else
+        String scriptPath = "./Tests/OgreMain/misc/ScriptTest";
+#endif
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        rgm.createResourceGroup("Scripts");
+        rgm.addResourceLocation(scriptPath, "FileSystem", "Scripts");
+        rgm.initialiseResourceGroup("Scripts");
+
+        const char* materials[] = { "ScriptTest/Red", "ScriptTest/Green", "ScriptTest/Plain" };
+        vector<ColourValue>::type ambients;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            MaterialPtr mat = MaterialManager::getSingleton().getByName(materials[i], "Scripts");
+            EXPECT_FALSE(mat.isNull()) << materials[i];
+            if (!mat.isNull())
+                ambients.push_back(mat->getTechnique(0)->getPass(0)->getAmbient());
+        }
+        EXPECT_TRUE(MaterialManager::getSingleton().getByName("ScriptTest/Base", "Scripts").isNull());
+
+        rgm.destroyResourceGroup("Scripts");
+        return ambients;
+    }
+}
+
+class ResourceGroupLoadingTests : public RootWithoutRenderSystemFixture
+{
+public:
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        declareSampleMeshes("Level", MESHES, NUM_MESHES);
+        startJobWorkQueue("Resources");
+
+        ResourceGroupManager::getSingleton().addResourceGroupListener(&mListener);
+        for (size_t i = 0; i < NUM_MESHES; ++i)
+            MeshManager::getSingleton().getByName(MESHES[i], "Level")->addListener(&mListener);
+    }
+    void TearDown()
+    {
+        ResourceGroupManager::getSingleton().removeResourceGroupListener(&mListener);
+        // The meshes need the buffer manager to be destroyed
+        ResourceGroupManager::getSingleton().destroyResourceGroup("Level");
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    CountingListener mListener;
+};
+
+//--------------------------------------------------------------------------
+TEST_F(ResourceGroupLoadingTests, ParallelPrepare)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    EXPECT_FALSE(rgm.getParallelGroupLoading());
+    rgm.setParallelGroupLoading(true);
+    EXPECT_TRUE(rgm.getParallelGroupLoading());
+
+    rgm.prepareResourceGroup("Level");
+
+    // One event for each resource on this thread, as in the serial case
+    EXPECT_EQ(NUM_MESHES, mListener.expected);
+    EXPECT_EQ(NUM_MESHES, mListener.started);
+    EXPECT_EQ(NUM_MESHES, mListener.ended);
+    EXPECT_EQ(NUM_MESHES, mListener.completed);
+    for (size_t i = 0; i < NUM_MESHES; ++i)
+    {
+        MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[i], "Level");
+        EXPECT_TRUE(mesh->isPrepared()) << MESHES[i];
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceGroupLoadingTests, ParallelLoad)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+
+    // Reference from a serial load
+    rgm.loadResourceGroup("Level");
+    vector<size_t>::type vertexCounts;
+    for (size_t i = 0; i < NUM_MESHES; ++i)
+    {
+        MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[i], "Level");
+        ASSERT_TRUE(mesh->isLoaded());
+        vertexCounts.push_back(mesh->getSubMesh(0)->vertexData ?
+            mesh->getSubMesh(0)->vertexData->vertexCount : mesh->sharedVertexData->vertexCount);
+    }
+    rgm.unloadResourceGroup("Level");
+    mListener = CountingListener();
+
+    rgm.setParallelGroupLoading(true);
+    rgm.loadResourceGroup("Level");
+    EXPECT_TRUE(rgm.isResourceGroupLoaded("Level"));
+    EXPECT_EQ(NUM_MESHES, mListener.expected);
+    EXPECT_EQ(NUM_MESHES, mListener.started);
+    EXPECT_EQ(NUM_MESHES, mListener.ended);
+    EXPECT_EQ(NUM_MESHES, mListener.completed);
+    for (size_t i = 0; i < NUM_MESHES; ++i)
+    {
+        MeshPtr mesh = MeshManager::getSingleton().getByName(MESHES[i], "Level");
+        ASSERT_TRUE(mesh->isLoaded()) << MESHES[i];
+        EXPECT_EQ(vertexCounts[i], mesh->getSubMesh(0)->vertexData ?
+            mesh->getSubMesh(0)->vertexData->vertexCount : mesh->sharedVertexData->vertexCount);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceGroupLoadingTests, ParallelPrepareMissingFile)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    MeshManager::getSingleton().create("missing.mesh", "Level");
+    rgm.setParallelGroupLoading(true);
+
+    // The failure on the worker is reported on this thread
+    EXPECT_THROW(rgm.prepareResourceGroup("Level"), FileNotFoundException);
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceGroupLoadingTests, ParallelScriptParsing)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    vector<ColourValue>::type expected = initialiseScripts();
+    ASSERT_EQ(3u, expected.size());
+    EXPECT_EQ(ColourValue::Red, expected[0]);
+    EXPECT_EQ(ColourValue::Green, expected[1]);
+    StringVector scripts = mListener.scripts;
+    ASSERT_EQ(3u, scripts.size());
+
+    // Same materials and the same events in the same order
+    EXPECT_FALSE(rgm.getParallelScriptParsing());
+    rgm.setParallelScriptParsing(true);
+    EXPECT_TRUE(rgm.getParallelScriptParsing());
+    mListener.scripts.clear();
+    vector<ColourValue>::type ambients = initialiseScripts();
+    EXPECT_TRUE(expected == ambients);
+    EXPECT_TRUE(scripts == mListener.scripts);
+}
@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMovableObject.h"
+#include "OgreStringConverter.h"
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture SceneGraphCullingTests;
+
+namespace {
+    typedef StringVector ObjectLog;
+
+    /// Object which records its name when it is queued for rendering
+    class RecordingObject : public MovableObject
+    {
+        AxisAlignedBox mBox;
+        ObjectLog* mLog;
+    public:
+        RecordingObject(const String& name, ObjectLog* log)
+            : MovableObject(name), mBox(-1, -1, -1, 1, 1, 1), mLog(log) {}
+        const String& getMovableType(void) const
+        {
+            static String type = "RecordingObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+        void _updateRenderQueue(RenderQueue*) { mLog->push_back(mName); }
+        void visitRenderables(Renderable::Visitor*, bool) {}
+    };
+
+    /** Camera which only sees the left half of its frustum, as custom cameras may
+        cull differently. A box containing a visible one may be culled, as by an
+        occlusion or portal camera. */
+    class LeftCamera : public Camera
+    {
+    public:
+        LeftCamera(const String& name, SceneManager* sm) : Camera(name, sm) {}
+        using Camera::isVisible;
+        bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const
+        {
+            return bound.getMaximum().x < 0 && Camera::isVisible(bound, culledBy);
+        }
+        void isVisible(const Vector3* centres, const Vector3* halfSizes, 
+            size_t count, uint32* visibilityMask) const
+        {
+            isVisibleOneByOne(centres, halfSizes, count, visibilityMask);
+        }
+    };
+
+    /// Queue a scene full of objects, some in front of the camera and some behind
+    void findVisible(bool parallel, ObjectLog& visible, bool leftOnly = false)
+    {
+        SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+        sceneMgr->setParallelCulling(parallel);
+        EXPECT_EQ(parallel, sceneMgr->getParallelCulling());
+
+        Camera* cam = leftOnly ? OGRE_NEW LeftCamera("Cam", sceneMgr) : sceneMgr->createCamera("Cam");
+        cam->setPosition(Vector3::ZERO);
+        cam->lookAt(Vector3::NEGATIVE_UNIT_Z);
+
+        vector<RecordingObject*>::type objects;
+        for (int i = 0; i < 2000; ++i)
+        {
+            SceneNode* parent = sceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(Real(i % 40 - 20) * 10, 0, Real(i / 40 - 25) * 100));
+            SceneNode* node = parent->createChildSceneNode(Vector3(0, Real(i % 3), 0));
+            objects.push_back(new RecordingObject(StringConverter::toString(i), &visible));
+            node->attachObject(objects.back());
+        }
+
+        sceneMgr->_updateSceneGraph(cam);
+        sceneMgr->_findVisibleObjects(cam, 0, false);
+
+        sceneMgr->clearScene();
+        for (size_t i = 0; i < objects.size(); ++i)
+            delete objects[i];
+        if (leftOnly)
+            OGRE_DELETE cam;
+        SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST_F(SceneGraphCullingTests, MatchesRecursiveSearch)
+{
+    ObjectLog recursive, parallel;
+    findVisible(false, recursive);
+    findVisible(true, parallel);
+
+    EXPECT_FALSE(recursive.empty());
+    EXPECT_LT(recursive.size(), 2000u);
+
+    // Child nodes are kept in a hash map keyed on the generated node names,
+    // so the order can only be compared within one scene
+    std::sort(recursive.begin(), recursive.end());
+    std::sort(parallel.begin(), parallel.end());
+    ASSERT_EQ(recursive.size(), parallel.size());
+    for (size_t i = 0; i < recursive.size(); ++i)
+        EXPECT_EQ(recursive[i], parallel[i]);
+}
+//--------------------------------------------------------------------------
+TEST_F(SceneGraphCullingTests, CustomCameraVisibility)
+{
+    ObjectLog all, recursive, parallel;
+    findVisible(false, all);
+    startJobWorkQueue("SceneGraphCulling");
+    findVisible(false, recursive, true);
+    findVisible(true, parallel, true);
+
+    // The parallel search goes through the overridden test as well, and like
+    // the recursive walk leaves out the nodes below a culled one: the root
+    // node reaches into the right half, so nothing is found even though the
+    // nodes on the left would pass on their own
+    EXPECT_FALSE(all.empty());
+    EXPECT_TRUE(recursive.empty());
+    std::sort(recursive.begin(), recursive.end());
+    std::sort(parallel.begin(), parallel.end());
+    EXPECT_TRUE(recursive == parallel);
+}
@@ -0,0 +1,139 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreSceneGraphUpdater.h"
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture SceneGraphUpdateTests;
+
+namespace {
+    /// Builds the same hierarchy in any scene manager, 4 levels deep
+    void buildHierarchy(SceneManager* sceneMgr, vector<SceneNode*>::type& nodes)
+    {
+        nodes.push_back(sceneMgr->getRootSceneNode());
+        for (size_t i = 0; nodes.size() < 400; ++i)
+        {
+            SceneNode* parent = nodes[i / 4];
+            Real f = Real(i);
+            SceneNode* node = parent->createChildSceneNode(
+                Vector3(f, -0.5f * f, 3.0f),
+                Quaternion(Radian(0.1f * f), Vector3(1, f, 2).normalisedCopy()));
+            node->setScale(1.0f + 0.01f * f, 1.0f, 2.0f - 0.01f * f);
+            node->setInheritOrientation(i % 5 != 0);
+            node->setInheritScale(i % 7 != 0);
+            nodes.push_back(node);
+        }
+    }
+
+    void expectSameTransforms(const vector<SceneNode*>::type& a, const vector<SceneNode*>::type& b)
+    {
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            EXPECT_EQ(a[i]->_getDerivedPosition(), b[i]->_getDerivedPosition());
+            EXPECT_EQ(a[i]->_getDerivedOrientation(), b[i]->_getDerivedOrientation());
+            EXPECT_EQ(a[i]->_getDerivedScale(), b[i]->_getDerivedScale());
+        }
+    }
+
+    struct CountingListener : public Node::Listener
+    {
+        size_t mUpdates;
+        CountingListener() : mUpdates(0) {}
+        void nodeUpdated(const Node*) { ++mUpdates; }
+    };
+}
+
+//--------------------------------------------------------------------------
+TEST_F(SceneGraphUpdateTests, MatchesRecursiveUpdate)
+{
+    SceneManager* recursive = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    SceneManager* batched = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    batched->setParallelSceneGraphUpdate(true);
+    EXPECT_TRUE(batched->getParallelSceneGraphUpdate());
+    // Small batches on worker threads, so that each level is split up
+    batched->_getSceneGraphUpdater()->setBatchSize(16);
+    startJobWorkQueue("SceneGraphUpdate");
+
+    vector<SceneNode*>::type a, b;
+    buildHierarchy(recursive, a);
+    buildHierarchy(batched, b);
+
+    recursive->_updateSceneGraph(0);
+    batched->_updateSceneGraph(0);
+    expectSameTransforms(a, b);
+
+    // Partial update, only some branches are dirty
+    for (size_t i = 3; i < a.size(); i += 37)
+    {
+        a[i]->translate(1, 2, 3);
+        b[i]->translate(1, 2, 3);
+        a[i]->roll(Radian(0.5f));
+        b[i]->roll(Radian(0.5f));
+    }
+    recursive->_updateSceneGraph(0);
+    batched->_updateSceneGraph(0);
+    expectSameTransforms(a, b);
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(recursive);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(batched);
+}
+//--------------------------------------------------------------------------
+TEST_F(SceneGraphUpdateTests, ListenersCalledOnce)
+{
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    sceneMgr->setParallelSceneGraphUpdate(true);
+    sceneMgr->_getSceneGraphUpdater()->setBatchSize(1);
+    startJobWorkQueue("SceneGraphUpdate");
+
+    SceneNode* parent = sceneMgr->getRootSceneNode()->createChildSceneNode();
+    SceneNode* child = parent->createChildSceneNode(Vector3(1, 0, 0));
+    CountingListener listener;
+    child->setListener(&listener);
+
+    sceneMgr->_updateSceneGraph(0);
+    EXPECT_EQ(1u, listener.mUpdates);
+
+    // Nothing changed
+    sceneMgr->_updateSceneGraph(0);
+    EXPECT_EQ(1u, listener.mUpdates);
+
+    parent->setPosition(0, 5, 0);
+    sceneMgr->_updateSceneGraph(0);
+    EXPECT_EQ(2u, listener.mUpdates);
+    EXPECT_EQ(Vector3(1, 5, 0), child->_getDerivedPosition());
+
+    child->setListener(0);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+}
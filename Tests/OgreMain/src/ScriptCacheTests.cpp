@@ -0,0 +1,183 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreScriptCompiler.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture ScriptCacheTests;
+
+namespace {
+    const char* SCRIPT =
+        "abstract material Cached/Base\n"
+        "{\n"
+        "    technique\n"
+        "    {\n"
+        "        pass\n"
+        "        {\n"
+        "            ambient $ambient\n"
+        "            diffuse 0.5 0.5 0.5 1\n"
+        "            depth_bias 2\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+        "// a comment\n"
+        "material Cached/Derived : Cached/Base\n"
+        "{\n"
+        "    set $ambient \"0.1 0.2 0.3\"\n"
+        "    receive_shadows off\n"
+        "}\n";
+
+    /// What the script sets on the material
+    struct MaterialState
+    {
+        ColourValue ambient, diffuse;
+        float depthBias;
+        bool receiveShadows;
+        size_t numTechniques, numPasses;
+
+        MaterialState(const String& name)
+        {
+            MaterialPtr mat = MaterialManager::getSingleton().getByName(name);
+            EXPECT_FALSE(mat.isNull());
+            Pass* pass = mat->getTechnique(0)->getPass(0);
+            ambient = pass->getAmbient();
+            diffuse = pass->getDiffuse();
+            depthBias = pass->getDepthBiasConstant();
+            receiveShadows = mat->getReceiveShadows();
+            numTechniques = mat->getNumTechniques();
+            numPasses = mat->getTechnique(0)->getNumPasses();
+        }
+        bool operator==(const MaterialState& rhs) const
+        {
+            return ambient == rhs.ambient && diffuse == rhs.diffuse && depthBias == rhs.depthBias &&
+                receiveShadows == rhs.receiveShadows && numTechniques == rhs.numTechniques &&
+                numPasses == rhs.numPasses;
+        }
+    };
+
+    MaterialState compileScript(const String& script)
+    {
+        MaterialManager::getSingleton().remove("Cached/Derived");
+        String copy = script;
+        DataStreamPtr stream(OGRE_NEW MemoryDataStream("cached.material", &copy[0], copy.size()));
+        ScriptCompilerManager::getSingleton().parseScript(stream, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        return MaterialState("Cached/Derived");
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST_F(ScriptCacheTests, CachedMatchesUncached)
+{
+    ScriptCompilerManager& mgr = ScriptCompilerManager::getSingleton();
+    EXPECT_FALSE(mgr.getScriptCacheEnabled());
+    MaterialState uncached = compileScript(SCRIPT);
+    EXPECT_EQ(ColourValue(0.1f, 0.2f, 0.3f), uncached.ambient);
+    EXPECT_FALSE(uncached.receiveShadows);
+    EXPECT_FALSE(mgr.isScriptCacheDirty());
+
+    // First run, the script goes into the cache
+    mgr.setScriptCacheEnabled(true);
+    EXPECT_TRUE(compileScript(SCRIPT) == uncached);
+    EXPECT_TRUE(mgr.isScriptCacheDirty());
+
+    DataStreamPtr cache(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveScriptCache(cache);
+    cache->seek(0);
+    mgr.clearScriptCache();
+
+    // Next run, the script comes from the cache
+    mgr.loadScriptCache(cache);
+    EXPECT_FALSE(mgr.isScriptCacheDirty());
+    EXPECT_TRUE(compileScript(SCRIPT) == uncached);
+    EXPECT_FALSE(mgr.isScriptCacheDirty());
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCacheTests, ChangedScriptIsParsedAgain)
+{
+    ScriptCompilerManager& mgr = ScriptCompilerManager::getSingleton();
+    mgr.setScriptCacheEnabled(true);
+    compileScript(SCRIPT);
+    DataStreamPtr cache(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveScriptCache(cache);
+    cache->seek(0);
+    mgr.loadScriptCache(cache);
+
+    String changed = SCRIPT;
+    changed.replace(changed.find("0.5 0.5 0.5"), 11, "0.7 0.7 0.7");
+    MaterialState state = compileScript(changed);
+    EXPECT_TRUE(mgr.isScriptCacheDirty());
+    EXPECT_EQ(ColourValue(0.7f, 0.7f, 0.7f), state.diffuse);
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCacheTests, UnusedScriptsNotSaved)
+{
+    ScriptCompilerManager& mgr = ScriptCompilerManager::getSingleton();
+    mgr.setScriptCacheEnabled(true);
+    String changed = SCRIPT;
+    changed.replace(changed.find("0.5 0.5 0.5"), 11, "0.7 0.7 0.7");
+    compileScript(SCRIPT);
+    compileScript(changed);
+    DataStreamPtr cache(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveScriptCache(cache);
+    size_t fullSize = cache->tell();
+    cache->seek(0);
+
+    // Only the changed script is used in the next run
+    mgr.loadScriptCache(cache);
+    compileScript(changed);
+    EXPECT_FALSE(mgr.isScriptCacheDirty());
+    DataStreamPtr pruned(OGRE_NEW MemoryDataStream(64 * 1024));
+    mgr.saveScriptCache(pruned);
+    EXPECT_LT(pruned->tell(), fullSize);
+    pruned->seek(0);
+
+    mgr.loadScriptCache(pruned);
+    compileScript(changed);
+    EXPECT_FALSE(mgr.isScriptCacheDirty());
+    compileScript(SCRIPT);
+    EXPECT_TRUE(mgr.isScriptCacheDirty());
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCacheTests, OtherVersionIgnored)
+{
+    ScriptCompilerManager& mgr = ScriptCompilerManager::getSingleton();
+    mgr.setScriptCacheEnabled(true);
+    compileScript(SCRIPT);
+
+    uint32 header[3] = { 0x43534F47, 0, 1 };
+    DataStreamPtr cache(OGRE_NEW MemoryDataStream(header, sizeof(header)));
+    mgr.loadScriptCache(cache);
+    EXPECT_FALSE(mgr.isScriptCacheDirty());
+
+    // Parsed again, as nothing was loaded
+    compileScript(SCRIPT);
+    EXPECT_TRUE(mgr.isScriptCacheDirty());
+}
@@ -0,0 +1,158 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "OgreSkeletonPoseEvaluator.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture SkeletonPoseEvaluatorTests;
+
+namespace {
+    const unsigned short NUM_BONES = 23;
+
+    /** Creates a skeleton whose parents have higher handles than their
+        children, so that the order by depth is not that of the handles.
+    */
+    SkeletonPtr createSkeleton(const String& name)
+    {
+        SkeletonPtr skel = SkeletonManager::getSingleton().create(name,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true).staticCast<Skeleton>();
+        srand(5);
+        for (unsigned short h = 0; h < NUM_BONES; ++h)
+            skel->createBone(h);
+        for (unsigned short h = NUM_BONES - 1; h-- > 0; )
+        {
+            unsigned short parent = h + 1 + rand() % (NUM_BONES - 1 - h) / 3;
+            Bone* bone = skel->getBone(h);
+            skel->getBone(parent)->addChild(bone);
+            bone->setPosition(Math::RangeRandom(-2, 2), Math::RangeRandom(0, 3), Math::RangeRandom(-2, 2));
+            bone->setOrientation(Quaternion(Radian(Math::RangeRandom(-1, 1)),
+                Vector3(Math::RangeRandom(-1, 1), 1, Math::RangeRandom(-1, 1)).normalisedCopy()));
+            bone->setScale(Vector3(Math::RangeRandom(0.8f, 1.2f)));
+        }
+        skel->setBindingPose();
+
+        const char* names[2] = { "Walk", "Wave" };
+        for (size_t a = 0; a < 2; ++a)
+        {
+            Animation* anim = skel->createAnimation(names[a], 2);
+            for (unsigned short h = 0; h < NUM_BONES; ++h)
+            {
+                NodeAnimationTrack* track = anim->createNodeTrack(h, skel->getBone(h));
+                for (size_t k = 0; k < 5; ++k)
+                {
+                    TransformKeyFrame* kf = track->createNodeKeyFrame(k * 0.5f);
+                    kf->setRotation(Quaternion(Radian(Math::RangeRandom(-2, 2)),
+                        Vector3(Math::RangeRandom(-1, 1), 1, Math::RangeRandom(-1, 1)).normalisedCopy()));
+                    kf->setTranslate(Vector3(Math::RangeRandom(-1, 1), Math::RangeRandom(-1, 1), 0));
+                    kf->setScale(Vector3(Math::RangeRandom(0.9f, 1.1f), 1, 1));
+                }
+            }
+        }
+        return skel;
+    }
+
+    void expectNear(const vector<Matrix4>::type& expected, const vector<Matrix4>::type& actual)
+    {
+        for (size_t b = 0; b < expected.size(); ++b)
+        {
+            for (size_t i = 0; i < 16; ++i)
+                EXPECT_NEAR(expected[b][i / 4][i % 4], actual[b][i / 4][i % 4], 1e-4f) << b;
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(SkeletonPoseEvaluatorTests, MatchesBones)
+{
+    SkeletonPtr skel = createSkeleton("Evaluated.skeleton");
+    SkeletonInstance instance(skel);
+    instance.load();
+
+    AnimationStateSet states;
+    instance._initAnimationState(&states);
+    AnimationState* walk = states.getAnimationState("Walk");
+    AnimationState* wave = states.getAnimationState("Wave");
+    walk->setEnabled(true);
+    walk->setWeight(0.8f);
+    wave->setEnabled(true);
+    wave->setWeight(0.7f);
+    wave->createBlendMask(NUM_BONES, 1);
+    for (unsigned short h = 0; h < NUM_BONES; h += 2)
+        wave->setBlendMaskEntry(h, 0.25f);
+
+    vector<Matrix4>::type expected(NUM_BONES), actual(NUM_BONES);
+    SkeletonPoseEvaluator* evaluator = instance._getPoseEvaluator();
+    Real times[4] = { 0, 0.3f, 1.1f, 2 };
+    for (size_t t = 0; t < 4; ++t)
+    {
+        walk->setTimePosition(times[t]);
+        wave->setTimePosition(2 - times[t]);
+
+        // Average weights, then cumulative ones
+        for (size_t mode = 0; mode < 2; ++mode)
+        {
+            instance.setBlendMode(mode ? ANIMBLEND_CUMULATIVE : ANIMBLEND_AVERAGE);
+            instance.setAnimationState(states);
+            instance._getBoneMatrices(&expected[0]);
+
+            ASSERT_TRUE(evaluator->evaluate(states, &actual[0]));
+            expectNear(expected, actual);
+        }
+    }
+
+    SkeletonManager::getSingleton().remove(skel->getHandle());
+}
+//--------------------------------------------------------------------------
+TEST_F(SkeletonPoseEvaluatorTests, ManualBones)
+{
+    SkeletonPtr skel = createSkeleton("Manual.skeleton");
+    SkeletonInstance instance(skel);
+    instance.load();
+
+    AnimationStateSet states;
+    instance._initAnimationState(&states);
+    states.getAnimationState("Walk")->setEnabled(true);
+
+    vector<Matrix4>::type matrices(NUM_BONES);
+    SkeletonPoseEvaluator* evaluator = instance._getPoseEvaluator();
+    EXPECT_TRUE(evaluator->evaluate(states, &matrices[0]));
+
+    // Manual bones are left to the nodes
+    instance.getBone(3)->setManuallyControlled(true);
+    EXPECT_FALSE(evaluator->evaluate(states, &matrices[0]));
+    instance.getBone(3)->setManuallyControlled(false);
+    EXPECT_TRUE(evaluator->evaluate(states, &matrices[0]));
+
+    // So are bones which don't inherit the orientation of their parent
+    instance.getBone(5)->setInheritOrientation(false);
+    EXPECT_FALSE(evaluator->evaluate(states, &matrices[0]));
+
+    SkeletonManager::getSingleton().remove(skel->getHandle());
+}
@@ -0,0 +1,131 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "TestHelpers.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture StaticGeometryTests;
+
+namespace {
+    size_t countRegions(StaticGeometry* geom)
+    {
+        StaticGeometry::RegionIterator regions = geom->getRegionIterator();
+        return std::distance(regions.begin(), regions.end());
+    }
+
+    /// The vertex buffer of the only geometry bucket of a region
+    HardwareVertexBufferSharedPtr getRegionVertices(StaticGeometry* geom, const Vector3& point)
+    {
+        StaticGeometry::RegionIterator regions = geom->getRegionIterator();
+        while (regions.hasMoreElements())
+        {
+            StaticGeometry::Region* region = regions.getNext();
+            AxisAlignedBox bounds = region->getBoundingBox();
+            bounds.setExtents(bounds.getMinimum() + region->getCentre(),
+                bounds.getMaximum() + region->getCentre());
+            if (!bounds.contains(point))
+                continue;
+
+            StaticGeometry::LODBucket* lod = region->getLODIterator().getNext();
+            StaticGeometry::MaterialBucket* mat = lod->getMaterialIterator().getNext();
+            const VertexData* vertexData = mat->getGeometryIterator().getNext()->getVertexData();
+            return vertexData->vertexBufferBinding->getBuffer(0);
+        }
+        return HardwareVertexBufferSharedPtr();
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(StaticGeometryTests, RebuildsOnlyChangedRegions)
+{
+    // The regions are built on the worker threads
+    startJobWorkQueue("StaticGeometry");
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    MeshManager::getSingleton().createPlane("Plane", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+        Plane(Vector3::UNIT_Y, 0), 10, 10, 1, 1, true, 1, 1, 1, Vector3::UNIT_Z);
+    Entity* first = sceneMgr->createEntity("Plane");
+    Entity* second = sceneMgr->createEntity("Plane");
+
+    StaticGeometry* geom = sceneMgr->createStaticGeometry("Static");
+    geom->setRegionDimensions(Vector3(100, 100, 100));
+    StaticGeometry::AdditionId firstId = geom->addEntity(first, Vector3(10, 0, 10));
+    StaticGeometry::AdditionId secondId = geom->addEntity(second, Vector3(210, 0, 10));
+    EXPECT_NE(firstId, secondId);
+    geom->build();
+    EXPECT_EQ(2u, countRegions(geom));
+
+    HardwareVertexBufferSharedPtr firstVertices = getRegionVertices(geom, Vector3(10, 0, 10));
+    HardwareVertexBufferSharedPtr secondVertices = getRegionVertices(geom, Vector3(210, 0, 10));
+    ASSERT_FALSE(firstVertices.isNull());
+    ASSERT_FALSE(secondVertices.isNull());
+    EXPECT_EQ(4u, firstVertices->getNumVertices());
+
+    // Adding next to the second only rebuilds its region
+    SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(220, 0, 20));
+    node->attachObject(first);
+    node->_update(true, false);
+    StaticGeometry::AdditionId nodeId = geom->addSceneNode(node);
+    geom->build();
+    EXPECT_EQ(firstVertices, getRegionVertices(geom, Vector3(10, 0, 10)));
+    HardwareVertexBufferSharedPtr rebuiltVertices = getRegionVertices(geom, Vector3(210, 0, 10));
+    ASSERT_FALSE(rebuiltVertices.isNull());
+    EXPECT_NE(secondVertices, rebuiltVertices);
+    EXPECT_EQ(8u, rebuiltVertices->getNumVertices());
+
+    // Removing by identifier takes out the geometry of those additions only,
+    // though the entity they came from is gone
+    sceneMgr->destroySceneNode(node);
+    sceneMgr->destroyEntity(first);
+    geom->removeAddition(firstId);
+    geom->removeAddition(nodeId);
+    geom->build();
+    EXPECT_EQ(1u, countRegions(geom));
+    EXPECT_TRUE(getRegionVertices(geom, Vector3(10, 0, 10)).isNull());
+    rebuiltVertices = getRegionVertices(geom, Vector3(210, 0, 10));
+    ASSERT_FALSE(rebuiltVertices.isNull());
+    EXPECT_EQ(4u, rebuiltVertices->getNumVertices());
+
+    // The geometry is placed relative to the region centre
+    Vector3 centre = geom->getRegionIterator().getNext()->getCentre();
+    const float* positions = static_cast<const float*>(rebuiltVertices->lock(HardwareBuffer::HBL_READ_ONLY));
+    for (size_t v = 0; v < 4; ++v)
+    {
+        const float* pos = positions + v * rebuiltVertices->getVertexSize() / sizeof(float);
+        EXPECT_NEAR(210, pos[0] + centre.x, 5.01f);
+        EXPECT_NEAR(0, pos[1] + centre.y, 1e-4f);
+        EXPECT_NEAR(10, pos[2] + centre.z, 5.01f);
+    }
+    rebuiltVertices->unlock();
+
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+    // Before the buffer manager goes
+    MeshManager::getSingleton().remove("Plane");
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreBVHTree.h"
+#include "OgreBVHSceneManager.h"
+#include "OgreSceneManagerEnumerator.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreMovableObject.h"
+#include "OgreStringConverter.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture BVHSceneManagerTests;
+
+namespace {
+    /// Small deterministic generator, so failures can be reproduced
+    class Random
+    {
+        uint32 mState;
+    public:
+        Random() : mState(12345) {}
+        Real next(Real low, Real high)
+        {
+            mState = mState * 1664525u + 1013904223u;
+            return low + (high - low) * Real(mState >> 8) / Real(1 << 24);
+        }
+    };
+
+    AxisAlignedBox randomBox(Random& random)
+    {
+        Vector3 centre(random.next(-100, 100), random.next(-100, 100), random.next(-100, 100));
+        Vector3 halfSize(random.next(0, 5), random.next(0, 5), random.next(0, 5));
+        return AxisAlignedBox(centre - halfSize, centre + halfSize);
+    }
+
+    typedef vector<size_t>::type IndexList;
+
+    IndexList toIndices(const BVHTree::ResultList& results)
+    {
+        IndexList indices;
+        for (size_t i = 0; i < results.size(); ++i)
+            indices.push_back(reinterpret_cast<size_t>(results[i]));
+        std::sort(indices.begin(), indices.end());
+        return indices;
+    }
+
+    /// Checks every kind of query against testing all the live proxies
+    void checkQueries(const BVHTree& tree, const vector<int32>::type& proxies)
+    {
+        AxisAlignedBox box(-30, -20, -10, 40, 50, 60);
+        Sphere sphere(Vector3(10, -20, 30), 45);
+        Ray ray(Vector3(-150, -5, 3), Vector3(1, 0.1f, -0.05f).normalisedCopy());
+        Plane planes[2] = { Plane(Vector3::UNIT_X, 20), Plane(Vector3(-1, 1, 0).normalisedCopy(), 10) };
+
+        IndexList expectedBox, expectedSphere, expectedRay, expectedPlanes;
+        for (size_t i = 0; i < proxies.size(); ++i)
+        {
+            if (proxies[i] == BVHTree::NULL_NODE)
+                continue;
+
+            AxisAlignedBox fatBox = tree.getFatBox(proxies[i]);
+            if (box.intersects(fatBox))
+                expectedBox.push_back(i);
+            if (sphere.intersects(fatBox))
+                expectedSphere.push_back(i);
+            if (ray.intersects(fatBox).first)
+                expectedRay.push_back(i);
+            if (planes[0].getSide(fatBox) != Plane::NEGATIVE_SIDE &&
+                planes[1].getSide(fatBox) != Plane::NEGATIVE_SIDE)
+                expectedPlanes.push_back(i);
+        }
+
+        BVHTree::ResultList results, intersecting;
+        tree.findProxies(box, results);
+        EXPECT_EQ(expectedBox, toIndices(results));
+        results.clear();
+        tree.findProxies(sphere, results);
+        EXPECT_EQ(expectedSphere, toIndices(results));
+        results.clear();
+        tree.findProxies(ray, results);
+        EXPECT_EQ(expectedRay, toIndices(results));
+        results.clear();
+        tree.findProxies(planes, 2, results, intersecting);
+        results.insert(results.end(), intersecting.begin(), intersecting.end());
+        EXPECT_EQ(expectedPlanes, toIndices(results));
+        EXPECT_FALSE(expectedPlanes.empty());
+    }
+
+    /// Object which records its name when it is queued for rendering
+    class RecordingObject : public MovableObject
+    {
+        AxisAlignedBox mBox;
+        StringVector* mLog;
+    public:
+        RecordingObject(const String& name, StringVector* log)
+            : MovableObject(name), mBox(-1, -1, -1, 1, 1, 1), mLog(log) {}
+        const String& getMovableType(void) const
+        {
+            static String type = "RecordingObject";
+            return type;
+        }
+        const AxisAlignedBox& getBoundingBox(void) const { return mBox; }
+        Real getBoundingRadius(void) const { return Math::Sqrt(3); }
+        void _updateRenderQueue(RenderQueue*) { mLog->push_back(mName); }
+        void visitRenderables(Renderable::Visitor*, bool) {}
+    };
+
+    /// Collects the names of the objects hit by a query
+    class NameCollector : public RaySceneQueryListener, public SceneQueryListener
+    {
+    public:
+        StringVector names;
+        bool queryResult(MovableObject* object, Real) { names.push_back(object->getName()); return true; }
+        bool queryResult(SceneQuery::WorldFragment*, Real) { return true; }
+        bool queryResult(MovableObject* object) { names.push_back(object->getName()); return true; }
+        bool queryResult(SceneQuery::WorldFragment*) { return true; }
+    };
+
+    /// Builds a scene, moves part of it and records what is visible
+    void runScene(SceneManager* sceneMgr, StringVector& visible, bool checkQueries)
+    {
+        Camera* cam = sceneMgr->createCamera("Cam");
+        cam->setPosition(Vector3::ZERO);
+        cam->lookAt(Vector3::NEGATIVE_UNIT_Z);
+
+        Random random;
+        vector<RecordingObject*>::type objects;
+        vector<SceneNode*>::type nodes;
+        for (int i = 0; i < 2000; ++i)
+        {
+            SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(random.next(-500, 500), random.next(-50, 50), random.next(-500, 500)));
+            objects.push_back(new RecordingObject(StringConverter::toString(i), &visible));
+            node->attachObject(objects.back());
+            nodes.push_back(node);
+        }
+        sceneMgr->_updateSceneGraph(cam);
+
+        // Move some, detach some and destroy some of the nodes
+        for (size_t i = 0; i < nodes.size(); i += 3)
+            nodes[i]->translate(random.next(-50, 50), 0, random.next(-50, 50));
+        for (size_t i = 1; i < nodes.size(); i += 7)
+            sceneMgr->getRootSceneNode()->removeChild(nodes[i]);
+        for (size_t i = 2; i < nodes.size(); i += 11)
+        {
+            nodes[i]->detachAllObjects();
+            sceneMgr->destroySceneNode(nodes[i]);
+        }
+
+        sceneMgr->_updateSceneGraph(cam);
+        sceneMgr->_findVisibleObjects(cam, 0, false);
+        std::sort(visible.begin(), visible.end());
+
+        // The default scene queries only know about objects created by factories,
+        // so check the queries against testing every object instead
+        if (checkQueries)
+        {
+            // Aim at a node which was moved but stays in the scene
+            Vector3 origin(-600, 0, 0);
+            Ray ray(origin, (nodes[0]->_getDerivedPosition() - origin).normalisedCopy());
+            Sphere sphere(Vector3(100, 0, -100), 150);
+            StringVector expectedRayHits, expectedSphereHits;
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                if (!objects[i]->isInScene())
+                    continue;
+                if (ray.intersects(objects[i]->getWorldBoundingBox()).first)
+                    expectedRayHits.push_back(objects[i]->getName());
+                if (sphere.intersects(objects[i]->getWorldBoundingBox()))
+                    expectedSphereHits.push_back(objects[i]->getName());
+            }
+            std::sort(expectedRayHits.begin(), expectedRayHits.end());
+            std::sort(expectedSphereHits.begin(), expectedSphereHits.end());
+
+            NameCollector rayHits;
+            RaySceneQuery* rayQuery = sceneMgr->createRayQuery(ray);
+            rayQuery->execute(&rayHits);
+            sceneMgr->destroyQuery(rayQuery);
+            std::sort(rayHits.names.begin(), rayHits.names.end());
+
+            NameCollector sphereHits;
+            SphereSceneQuery* sphereQuery = sceneMgr->createSphereQuery(sphere);
+            sphereQuery->execute(&sphereHits);
+            sceneMgr->destroyQuery(sphereQuery);
+            std::sort(sphereHits.names.begin(), sphereHits.names.end());
+
+            EXPECT_FALSE(expectedRayHits.empty());
+            EXPECT_EQ(expectedRayHits, rayHits.names);
+            EXPECT_FALSE(expectedSphereHits.empty());
+            EXPECT_EQ(expectedSphereHits, sphereHits.names);
+        }
+
+        sceneMgr->clearScene();
+        for (size_t i = 0; i < objects.size(); ++i)
+            delete objects[i];
+    }
+}
+
+//--------------------------------------------------------------------------
+TEST(BVHTree, MatchesBruteForce)
+{
+    BVHTree tree;
+    Random random;
+    vector<int32>::type proxies;
+    for (size_t i = 0; i < 1000; ++i)
+        proxies.push_back(tree.createProxy(randomBox(random), reinterpret_cast<void*>(i)));
+    EXPECT_TRUE(tree.validate());
+    checkQueries(tree, proxies);
+
+    for (size_t i = 0; i < proxies.size(); i += 2)
+        tree.moveProxy(proxies[i], randomBox(random));
+    for (size_t i = 0; i < proxies.size(); i += 5)
+    {
+        tree.destroyProxy(proxies[i]);
+        proxies[i] = BVHTree::NULL_NODE;
+    }
+    EXPECT_EQ(800u, tree.getProxyCount());
+    EXPECT_TRUE(tree.validate());
+    checkQueries(tree, proxies);
+
+    tree.rebuild();
+    EXPECT_TRUE(tree.validate());
+    checkQueries(tree, proxies);
+
+    // The tree keeps working incrementally after a rebuild
+    for (size_t i = 1; i < proxies.size(); i += 3)
+    {
+        if (proxies[i] != BVHTree::NULL_NODE)
+            tree.moveProxy(proxies[i], randomBox(random));
+    }
+    EXPECT_TRUE(tree.validate());
+    checkQueries(tree, proxies);
+}
+//--------------------------------------------------------------------------
+TEST_F(BVHSceneManagerTests, MatchesDefaultSceneManager)
+{
+    StringVector expected;
+    SceneManager* sceneMgr = SceneManagerEnumerator::getSingleton().createSceneManager(ST_GENERIC);
+    runScene(sceneMgr, expected, false);
+    SceneManagerEnumerator::getSingleton().destroySceneManager(sceneMgr);
+
+    StringVector visible;
+    BVHSceneManager* bvhSceneMgr = OGRE_NEW BVHSceneManager("BVH");
+    runScene(bvhSceneMgr, visible, true);
+    EXPECT_EQ(0u, bvhSceneMgr->getTree().getProxyCount());
+    OGRE_DELETE bvhSceneMgr;
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_LT(expected.size(), 2000u);
+    EXPECT_EQ(expected, visible);
+}